@@ -259,6 +259,11 @@ void VM_Version::initialize() {
     FLAG_SET_DEFAULT(UseAdler32Intrinsics, false);
   }
 
+  if (UseMD5Intrinsics) {
+    warning("MD5 intrinsics are not available on this CPU");
+    FLAG_SET_DEFAULT(UseMD5Intrinsics, false);
+  }
+
   // The AES intrinsic stubs require AES instruction support.
   if (has_vcipher()) {
     if (FLAG_IS_DEFAULT(UseAES)) {
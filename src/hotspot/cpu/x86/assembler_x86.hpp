@@ -1453,6 +1453,7 @@ private:
   void evmovdqub(XMMRegister dst, Address src, int vector_len);
   void evmovdqub(XMMRegister dst, XMMRegister src, int vector_len);
   void evmovdqub(XMMRegister dst, KRegister mask, Address src, int vector_len);
+  void evmovdqub(Address dst, KRegister mask, XMMRegister src, int vector_len);
   void evmovdquw(Address dst, XMMRegister src, int vector_len);
   void evmovdquw(Address dst, KRegister mask, XMMRegister src, int vector_len);
   void evmovdquw(XMMRegister dst, Address src, int vector_len);
@@ -1675,6 +1676,10 @@ private:
   void evpmovwb(Address dst, KRegister mask, XMMRegister src, int vector_len);
 
   void vpmovzxwd(XMMRegister dst, XMMRegister src, int vector_len);
+  void vpmovzxwd(XMMRegister dst, Address src, int vector_len);
+  void vpmovsxwd(XMMRegister dst, Address src, int vector_len);
+  void vpmovzxbd(XMMRegister dst, Address src, int vector_len);
+  void vpmovsxbd(XMMRegister dst, Address src, int vector_len);
 
   void evpmovdb(Address dst, XMMRegister src, int vector_len);
 
@@ -1756,6 +1761,7 @@ private:
   void pushq(Address src);
 
   void rcll(Register dst, int imm8);
+  void roll(Register dst, int imm8);
 
   void rclq(Register dst, int imm8);
 
@@ -3450,12 +3450,24 @@ void MacroAssembler::movq(XMMRegister dst, AddressLiteral src) {
 }
 
 #ifdef COMPILER2
-void MacroAssembler::setvectmask(Register dst, Register src) {
+// Set the bits of k1 for the bytes of the first src elements of size
+// 1 << shift. k1 selects the bytes accessed by the masked vector loads and
+// stores of a post loop (see SuperWord::output). A 64 byte vector needs up
+// to 63 bits.
+void MacroAssembler::setvectmask(Register dst, Register src, int shift, Register tmp) {
   guarantee(PostLoopMultiversioning, "must be");
+  Assembler::movl(tmp, src);
+  Assembler::shll(tmp, shift);
   Assembler::movl(dst, 1);
-  Assembler::shlxl(dst, dst, src);
+#ifdef _LP64
+  Assembler::shlxq(dst, dst, tmp);
+  Assembler::decq(dst);
+  Assembler::kmovql(k1, dst);
+#else
+  Assembler::shlxl(dst, dst, tmp);
   Assembler::decl(dst);
   Assembler::kmovdl(k1, dst);
+#endif
   Assembler::movl(dst, src);
 }
 
@@ -5385,16 +5397,6 @@ void MacroAssembler::restore_cpu_control_state_after_jni() {
   }
   // Clear upper bits of YMM registers to avoid SSE <-> AVX transition penalty.
   vzeroupper();
-  // Reset k1 to 0xffff.
-
-#ifdef COMPILER2
-  if (PostLoopMultiversioning && VM_Version::supports_evex()) {
-    push(rcx);
-    movl(rcx, 0xffff);
-    kmovwl(k1, rcx);
-    pop(rcx);
-  }
-#endif // COMPILER2
 
 #ifndef _LP64
   // Either restore the x87 floating pointer control word after returning
@@ -8479,6 +8481,110 @@ void MacroAssembler::vectorized_mismatch(Register obja, Register objb, Register
   bind(DONE);
 }
 
+// Computes the polynomial hash used by String.hashCode() and Arrays.hashCode():
+//
+//   for (int i = 0; i < cnt; i++) {
+//     result = 31 * result + ary[i];
+//   }
+//
+// The elements are of type eltype, where T_BOOLEAN stands for unsigned bytes
+// (Latin1 strings). Blocks of 8 (AVX2) or 16 (AVX-512) elements are widened to
+// ints and accumulated as vresult = vresult * 31^lanes + block. Lane j of the
+// accumulator then holds the sum of the elements at positions j mod lanes,
+// each multiplied by the power of 31 of its distance to the end of the last
+// block, divided by 31^(lanes - 1 - j). Multiplying with [31^(lanes-1), ..., 31^0]
+// and adding up the lanes gives the hash of the blocks. The initial value in
+// result is scaled by 31^lanes per block on the side, the tail is done scalar.
+void MacroAssembler::arrays_hashcode(Register ary, Register cnt, Register result,
+                                     Register tmp1, Register tmp2,
+                                     XMMRegister vnext, XMMRegister vresult, XMMRegister vtmp,
+                                     BasicType eltype) {
+  assert(UseAVX >= 2, "AVX2 must be enabled.");
+  assert_different_registers(ary, cnt, result, tmp1, tmp2);
+  ShortBranchVerifier sbv(this);
+  Label VECTOR_LOOP, SCALAR_TAIL, SCALAR_LOOP, DONE;
+
+  const bool use_evex = (AVX3Threshold == 0) && (UseAVX > 2);
+  const int vector_len = use_evex ? Assembler::AVX_512bit : Assembler::AVX_256bit;
+  const int lanes = use_evex ? 16 : 8;
+  const int elsize = type2aelembytes(eltype);
+  juint next = 1; // 31^lanes
+  for (int i = 0; i < lanes; i++) {
+    next *= 31;
+  }
+
+  movl(tmp1, cnt);
+  andl(tmp1, ~(lanes - 1)); // vector count (in elements)
+  jcc(Assembler::zero, SCALAR_TAIL);
+  andl(cnt, lanes - 1);     // tail count (in elements)
+
+  movl(tmp2, (int32_t)next);
+  movdl(vnext, tmp2);
+  vpbroadcastd(vnext, vnext, vector_len);
+  vpxor(vresult, vresult, vresult, vector_len);
+
+  bind(VECTOR_LOOP);
+  vpmulld(vresult, vresult, vnext, vector_len);
+  switch (eltype) {
+  case T_BOOLEAN: vpmovzxbd(vtmp, Address(ary, 0), vector_len); break;
+  case T_BYTE:    vpmovsxbd(vtmp, Address(ary, 0), vector_len); break;
+  case T_CHAR:    vpmovzxwd(vtmp, Address(ary, 0), vector_len); break;
+  case T_SHORT:   vpmovsxwd(vtmp, Address(ary, 0), vector_len); break;
+  case T_INT:
+    if (use_evex) {
+      evmovdqul(vtmp, Address(ary, 0), vector_len);
+    } else {
+      vmovdqu(vtmp, Address(ary, 0));
+    }
+    break;
+  default:
+    ShouldNotReachHere();
+  }
+  vpaddd(vresult, vresult, vtmp, vector_len);
+  imull(result, result, (int32_t)next);
+  addptr(ary, lanes * elsize);
+  subl(tmp1, lanes);
+  jccb(Assembler::notZero, VECTOR_LOOP);
+
+  // The table holds [31^15, ..., 31^0]
+  lea(tmp2, ExternalAddress(StubRoutines::x86::arrays_hashcode_powers_of_31() + (16 - lanes) * sizeof(jint)));
+  vpmulld(vresult, vresult, Address(tmp2, 0), vector_len);
+  if (use_evex) {
+    vextracti64x4_high(vtmp, vresult);
+    vpaddd(vresult, vresult, vtmp, Assembler::AVX_256bit);
+  }
+  vextracti128_high(vtmp, vresult);
+  vpaddd(vresult, vresult, vtmp, Assembler::AVX_128bit);
+  pshufd(vtmp, vresult, 0xE);
+  vpaddd(vresult, vresult, vtmp, Assembler::AVX_128bit);
+  pshufd(vtmp, vresult, 0x1);
+  vpaddd(vresult, vresult, vtmp, Assembler::AVX_128bit);
+  movdl(tmp1, vresult);
+  addl(result, tmp1);
+
+  bind(SCALAR_TAIL);
+  testl(cnt, cnt);
+  jccb(Assembler::zero, DONE);
+
+  bind(SCALAR_LOOP);
+  imull(result, result, 31);
+  switch (eltype) {
+  case T_BOOLEAN: load_unsigned_byte(tmp1, Address(ary, 0));  break;
+  case T_BYTE:    load_signed_byte(tmp1, Address(ary, 0));    break;
+  case T_CHAR:    load_unsigned_short(tmp1, Address(ary, 0)); break;
+  case T_SHORT:   load_signed_short(tmp1, Address(ary, 0));   break;
+  case T_INT:     movl(tmp1, Address(ary, 0));                break;
+  default:
+    ShouldNotReachHere();
+  }
+  addl(result, tmp1);
+  addptr(ary, elsize);
+  decrementl(cnt);
+  jccb(Assembler::notZero, SCALAR_LOOP);
+
+  bind(DONE);
+}
+
 //Helper functions for square_to_len()
 
 /**
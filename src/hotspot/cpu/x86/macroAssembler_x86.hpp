@@ -158,7 +158,7 @@ class MacroAssembler: public Assembler {
 
 #ifdef COMPILER2
   // special instructions for EVEX
-  void setvectmask(Register dst, Register src);
+  void setvectmask(Register dst, Register src, int shift, Register tmp);
   void restorevectmask();
 #endif
 
@@ -993,6 +993,10 @@ public:
                  Register buf, Register state, Register ofs, Register limit, Register rsp,
                  bool multi_block);
 
+  void fast_md5(Register buf, Register state, Register ofs, Register limit,
+                Register a, Register b, Register c, Register d, Register tmp,
+                bool multi_block);
+
 #ifdef _LP64
   void fast_sha256(XMMRegister msg, XMMRegister state0, XMMRegister state1, XMMRegister msgtmp0,
                    XMMRegister msgtmp1, XMMRegister msgtmp2, XMMRegister msgtmp3, XMMRegister msgtmp4,
@@ -1756,6 +1760,10 @@ public:
   void vectorized_mismatch(Register obja, Register objb, Register length, Register log2_array_indxscale,
                            Register result, Register tmp1, Register tmp2,
                            XMMRegister vec1, XMMRegister vec2, XMMRegister vec3);
+  void arrays_hashcode(Register ary, Register cnt, Register result,
+                       Register tmp1, Register tmp2,
+                       XMMRegister vnext, XMMRegister vresult, XMMRegister vtmp,
+                       BasicType eltype);
 #endif
 
   // CRC32 code for java.util.zip.CRC32::updateBytes() intrinsic.
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "asm/assembler.hpp"
+#include "asm/assembler.inline.hpp"
+#include "macroAssembler_x86.hpp"
+
+// MD5 (RFC 1321) compression of 64-byte blocks.
+//
+// There is no vector form of a single MD5 stream: every step depends on the
+// previous one. The stub keeps the four state words in registers and folds
+// the message words and constants into the adds, which avoids the array
+// accesses and bounds checks of the Java code.
+
+// The additive constants floor(abs(sin(i + 1)) * 2^32)
+static const juint md5_constants[64] = {
+  0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee,
+  0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+  0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+  0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+  0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa,
+  0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+  0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
+  0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+  0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+  0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+  0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05,
+  0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+  0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039,
+  0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+  0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+  0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+static const int md5_shifts[4][4] = {
+  { 7, 12, 17, 22 },
+  { 5,  9, 14, 20 },
+  { 4, 11, 16, 23 },
+  { 6, 10, 15, 21 }
+};
+
+// a = b + ((a + f(b, c, d) + x + t) <<< s), where f is F, G, H or I for the rounds 0 to 3
+static void md5_step(MacroAssembler* masm, int round, Register a, Register b, Register c, Register d,
+                     Address x, juint t, int s, Register tmp) {
+  switch (round) {
+  case 0: // F = (b & c) | (~b & d)
+    masm->movl(tmp, c);
+    masm->xorl(tmp, d);
+    masm->andl(tmp, b);
+    masm->xorl(tmp, d);
+    break;
+  case 1: // G = (b & d) | (c & ~d)
+    masm->movl(tmp, b);
+    masm->xorl(tmp, c);
+    masm->andl(tmp, d);
+    masm->xorl(tmp, c);
+    break;
+  case 2: // H = b ^ c ^ d
+    masm->movl(tmp, b);
+    masm->xorl(tmp, c);
+    masm->xorl(tmp, d);
+    break;
+  case 3: // I = c ^ (b | ~d)
+    masm->movl(tmp, d);
+    masm->notl(tmp);
+    masm->orl(tmp, b);
+    masm->xorl(tmp, c);
+    break;
+  default:
+    ShouldNotReachHere();
+  }
+  masm->addl(a, x);
+  masm->addl(a, (int32_t)t);
+  masm->addl(a, tmp);
+  masm->roll(a, s);
+  masm->addl(a, b);
+}
+
+// ofs and limit are used for multi-block byte array.
+// int com.sun.security.provider.DigestBase.implCompressMultiBlock(byte[] b, int ofs, int limit)
+void MacroAssembler::fast_md5(Register buf, Register state, Register ofs, Register limit,
+                              Register a, Register b, Register c, Register d, Register tmp,
+                              bool multi_block) {
+  assert_different_registers(buf, state, ofs, limit, a, b, c, d, tmp);
+  Label L_loop;
+
+  movl(a, Address(state,  0));
+  movl(b, Address(state,  4));
+  movl(c, Address(state,  8));
+  movl(d, Address(state, 12));
+
+  bind(L_loop);
+  const Register regs[4] = { a, b, c, d };
+  for (int i = 0; i < 64; i++) {
+    int round = i / 16;
+    int k;
+    switch (round) {
+    case 0:  k = i;                break;
+    case 1:  k = (5 * i + 1) % 16; break;
+    case 2:  k = (3 * i + 5) % 16; break;
+    default: k = (7 * i) % 16;     break;
+    }
+    // the registers rotate by one position in every step
+    int r = (4 - i % 4) % 4;
+    md5_step(this, round, regs[r], regs[(r + 1) % 4], regs[(r + 2) % 4], regs[(r + 3) % 4],
+             Address(buf, k * 4), md5_constants[i], md5_shifts[round][i % 4], tmp);
+  }
+
+  // add the result to the state, which also keeps it for the next block
+  addl(Address(state,  0), a);
+  addl(Address(state,  4), b);
+  addl(Address(state,  8), c);
+  addl(Address(state, 12), d);
+
+  if (multi_block) {
+    movl(a, Address(state,  0));
+    movl(b, Address(state,  4));
+    movl(c, Address(state,  8));
+    movl(d, Address(state, 12));
+    addptr(buf, 64);
+    addl(ofs, 64);
+    cmpl(ofs, limit);
+    jcc(Assembler::belowEqual, L_loop);
+    movl(rax, ofs); // return ofs
+  }
+}
@@ -3724,6 +3724,34 @@ class StubGenerator: public StubCodeGenerator {
     return start;
   }
 
+  // ofs and limit are use for multi-block byte array.
+  // int com.sun.security.provider.DigestBase.implCompressMultiBlock(byte[] b, int ofs, int limit)
+  address generate_md5_implCompress(bool multi_block, const char *name) {
+    __ align(CodeEntryAlignment);
+    StubCodeMark mark(this, "StubRoutines", name);
+    address start = __ pc();
+
+    Register buf = c_rarg0;
+    Register state = c_rarg1;
+    Register ofs = c_rarg2;
+    Register limit = c_rarg3;
+
+    __ enter();
+
+    // Save callee-saved registers before using them
+    __ push(rbx);
+    __ push(r12);
+
+    __ fast_md5(buf, state, ofs, limit, rax, rbx, r10, r11, r12, multi_block);
+
+    __ pop(r12);
+    __ pop(rbx);
+
+    __ leave();
+    __ ret(0);
+    return start;
+  }
+
   address generate_pshuffle_byte_flip_mask() {
     __ align(64);
     StubCodeMark mark(this, "StubRoutines", "pshuffle_byte_flip_mask");
@@ -5395,6 +5423,80 @@ address generate_avx_ghash_processBlocks() {
     return start;
   }
 
+  // [31^15, ..., 31^0], the factors of the accumulator lanes in arrays_hashcode
+  address generate_arrays_hashcode_powers_of_31() {
+    __ align(CodeEntryAlignment);
+    StubCodeMark mark(this, "StubRoutines", "arrays_hashcode_powers_of_31");
+    address start = __ pc();
+
+    juint powers[16];
+    juint p = 1;
+    for (int i = 15; i >= 0; i--) {
+      powers[i] = p;
+      p *= 31;
+    }
+    for (int i = 0; i < 16; i++) {
+      __ emit_data((jint)powers[i], relocInfo::none, 0);
+    }
+
+    return start;
+  }
+
+  /**
+  *  Arguments:
+  *
+  *  Input:
+  *    c_rarg0   - ary       address of the first element
+  *    c_rarg1   - cnt       number of elements
+  *    c_rarg2   - initial   initial hash value
+  *    c_rarg3   - type      BasicType of the elements
+  *
+  *  Output:
+  *        rax   - int hash value
+  */
+  address generate_vectorizedHashCode() {
+    __ align(CodeEntryAlignment);
+    StubCodeMark mark(this, "StubRoutines", "vectorizedHashCode");
+    address start = __ pc();
+
+    const Register ary    = c_rarg0;
+    const Register cnt    = c_rarg1;
+    const Register result = rax; // return value
+    const Register type   = c_rarg3;
+    const Register tmp1   = r10;
+    const Register tmp2   = r11;
+    const XMMRegister vnext   = xmm0;
+    const XMMRegister vresult = xmm1;
+    const XMMRegister vtmp    = xmm2;
+
+    BLOCK_COMMENT("Entry:");
+    __ enter();
+
+    __ movl(result, c_rarg2);
+
+    const BasicType types[] = { T_BOOLEAN, T_BYTE, T_CHAR, T_SHORT, T_INT };
+    const int num_types = sizeof(types) / sizeof(types[0]);
+    Label L_type[num_types], L_done;
+    for (int i = 0; i < num_types; i++) {
+      __ cmpl(type, types[i]);
+      __ jcc(Assembler::equal, L_type[i]);
+    }
+    __ stop("vectorizedHashCode: unexpected element type");
+
+    for (int i = 0; i < num_types; i++) {
+      __ bind(L_type[i]);
+      __ arrays_hashcode(ary, cnt, result, tmp1, tmp2, vnext, vresult, vtmp, types[i]);
+      __ jmp(L_done);
+    }
+
+    __ bind(L_done);
+    __ vzeroupper();
+    __ leave();
+    __ ret(0);
+
+    return start;
+  }
+
 /**
    *  Arguments:
    *
@@ -6042,6 +6144,11 @@ address generate_avx_ghash_processBlocks() {
       }
     }
 
+    if (UseMD5Intrinsics) {
+      StubRoutines::_md5_implCompress = generate_md5_implCompress(false, "md5_implCompress");
+      StubRoutines::_md5_implCompressMB = generate_md5_implCompress(true, "md5_implCompressMB");
+    }
+
     if (UseSHA1Intrinsics) {
       StubRoutines::x86::_upper_word_mask_addr = generate_upper_word_mask();
       StubRoutines::x86::_shuffle_byte_flip_mask_addr = generate_shuffle_byte_flip_mask();
@@ -6081,7 +6188,7 @@ address generate_avx_ghash_processBlocks() {
       }
     }
 
-    if (UseBASE64Intrinsics) {
+    if (UseBASE64Intrinsics && (UseAVX > 2) && VM_Version::supports_avx512vlbw()) {
       StubRoutines::x86::_and_mask = base64_and_mask_addr();
       StubRoutines::x86::_bswap_mask = base64_bswap_mask_addr();
       StubRoutines::x86::_base64_charset = base64_charset_addr();
@@ -6122,6 +6229,11 @@ address generate_avx_ghash_processBlocks() {
     if (UseVectorizedMismatchIntrinsic) {
       StubRoutines::_vectorizedMismatch = generate_vectorizedMismatch();
     }
+
+    if (UseVectorizedHashCodeIntrinsic) {
+      StubRoutines::x86::_arrays_hashcode_powers_of_31 = generate_arrays_hashcode_powers_of_31();
+      StubRoutines::_vectorizedHashCode = generate_vectorizedHashCode();
+    }
   }
 
  public:
@@ -33,7 +33,7 @@ static bool returns_to_call_stub(address return_pc) { return return_pc == _call_
 
 enum platform_dependent_constants {
   code_size1 = 20000 LP64_ONLY(+10000),         // simply increase if too small (assembler will crash if too small)
-  code_size2 = 35300 LP64_ONLY(+11000)          // simply increase if too small (assembler will crash if too small)
+  code_size2 = 35300 LP64_ONLY(+18000)          // simply increase if too small (assembler will crash if too small)
 };
 
 class x86 {
@@ -163,6 +163,8 @@ class x86 {
   static address _left_shift_mask;
   static address _and_mask;
   static address _url_charset;
+  // Powers of 31 for arrays hashCode
+  static address _arrays_hashcode_powers_of_31;
 #endif
   // byte flip mask for sha256
   static address _pshuffle_byte_flip_mask_addr;
@@ -266,6 +268,7 @@ class x86 {
   static address base64_and_mask_addr() { return _and_mask; }
   static address counter_mask_addr() { return _counter_mask_addr; }
   static address counter_mask_ones_addr() { return _counter_mask_ones_addr; }
+  static address arrays_hashcode_powers_of_31() { return _arrays_hashcode_powers_of_31; }
 #endif
   static address pshuffle_byte_flip_mask_addr() { return _pshuffle_byte_flip_mask_addr; }
   static void generate_CRC32C_table(bool is_pclmulqdq_supported);
@@ -935,6 +935,19 @@ void VM_Version::get_processor_features() {
     FLAG_SET_DEFAULT(UseFMA, false);
   }
 
+#ifdef _LP64
+  // Only DigestBase.implCompressMultiBlock0 is an intrinsic candidate for
+  // MD5 in this JDK; MD5.implCompress itself is not intrinsified.
+  if (FLAG_IS_DEFAULT(UseMD5Intrinsics)) {
+    UseMD5Intrinsics = true;
+  }
+#else
+  if (UseMD5Intrinsics) {
+    warning("MD5 intrinsic is not available in 32-bit VM");
+    FLAG_SET_DEFAULT(UseMD5Intrinsics, false);
+  }
+#endif // _LP64
+
   if (supports_sha() LP64_ONLY(|| supports_avx2() && supports_bmi2())) {
     if (FLAG_IS_DEFAULT(UseSHA)) {
       UseSHA = true;
@@ -1127,6 +1140,11 @@ void VM_Version::get_processor_features() {
   if (FLAG_IS_DEFAULT(UseMontgomerySquareIntrinsic)) {
     UseMontgomerySquareIntrinsic = true;
   }
+  if (FLAG_IS_DEFAULT(PostLoopMultiversioning) && UseSuperWord && RangeCheckElimination &&
+      MaxVectorSize >= 16 && UseAVX > 2 && supports_avx512vlbw() && supports_bmi2()) {
+    // Vectorize the post loops with masked loads and stores.
+    FLAG_SET_DEFAULT(PostLoopMultiversioning, true);
+  }
 #else
   if (UseMultiplyToLenIntrinsic) {
     if (!FLAG_IS_DEFAULT(UseMultiplyToLenIntrinsic)) {
@@ -1403,6 +1421,13 @@ void VM_Version::get_processor_features() {
       warning("vectorizedMismatch intrinsics are not available on this CPU");
     FLAG_SET_DEFAULT(UseVectorizedMismatchIntrinsic, false);
   }
+  // Not enabled by default: no library method is bound to the stub, since
+  // the hashCode() methods of this JDK are not intrinsic candidates.
+  if (UseVectorizedHashCodeIntrinsic && UseAVX < 2) {
+    if (!FLAG_IS_DEFAULT(UseVectorizedHashCodeIntrinsic))
+      warning("vectorizedHashCode intrinsic is not available on this CPU");
+    FLAG_SET_DEFAULT(UseVectorizedHashCodeIntrinsic, false);
+  }
 #else
   if (UseVectorizedMismatchIntrinsic) {
     if (!FLAG_IS_DEFAULT(UseVectorizedMismatchIntrinsic)) {
@@ -1410,6 +1435,12 @@ void VM_Version::get_processor_features() {
     }
     FLAG_SET_DEFAULT(UseVectorizedMismatchIntrinsic, false);
   }
+  if (UseVectorizedHashCodeIntrinsic) {
+    if (!FLAG_IS_DEFAULT(UseVectorizedHashCodeIntrinsic)) {
+      warning("vectorizedHashCode intrinsic is not available in 32-bit VM");
+    }
+    FLAG_SET_DEFAULT(UseVectorizedHashCodeIntrinsic, false);
+  }
 #endif // _LP64
 
   // Use count leading zeros count instruction if available.
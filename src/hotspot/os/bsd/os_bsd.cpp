@@ -2335,6 +2335,10 @@ bool os::can_execute_large_page_memory() {
   return UseHugeTLBFS;
 }
 
+size_t os::code_large_page_size() {
+  return UseLargePages && can_execute_large_page_memory() ? large_page_size() : vm_page_size();
+}
+
 char* os::pd_attempt_reserve_memory_at(size_t bytes, char* requested_addr, int file_desc) {
   assert(file_desc >= 0, "file_desc is not valid");
   char* result = pd_attempt_reserve_memory_at(bytes, requested_addr);
@@ -3249,11 +3249,20 @@ void os::pd_commit_memory_or_exit(char* addr, size_t size, bool exec,
   #define MADV_HUGEPAGE 14
 #endif
 
+// Page size of the code cache with UseLargePagesInCodeCache, see setup_code_large_pages().
+static size_t _code_large_page_size = 0;
+
 int os::Linux::commit_memory_impl(char* addr, size_t size,
                                   size_t alignment_hint, bool exec) {
   int err = os::Linux::commit_memory_impl(addr, size, exec);
   if (err == 0) {
     realign_memory(addr, size, alignment_hint);
+    if (exec && !UseTransparentHugePages && _code_large_page_size > (size_t)vm_page_size() &&
+        alignment_hint >= _code_large_page_size) {
+      // The code cache is committed in huge page sized chunks; back them
+      // with transparent huge pages before any code is written to them.
+      ::madvise(addr, size, MADV_HUGEPAGE);
+    }
   }
   return err;
 }
@@ -4150,28 +4159,54 @@ bool os::Linux::setup_large_page_type(size_t page_size) {
   return UseSHM;
 }
 
+// With UseLargePagesInCodeCache, the code cache uses the large pages set up
+// for UseLargePages if they can hold code. Otherwise it asks for transparent
+// huge pages with madvise for the code cache alone (see commit_memory_impl()),
+// so that the Java heap is not affected, unless UseTransparentHugePages is
+// explicitly turned off.
+void os::Linux::setup_code_large_pages() {
+  if (!UseLargePagesInCodeCache) {
+    return;
+  }
+  if (UseLargePages && can_execute_large_page_memory()) {
+    _code_large_page_size = _large_page_size;
+  } else if (FLAG_IS_DEFAULT(UseTransparentHugePages) || UseTransparentHugePages) {
+    size_t page_size = find_large_page_size();
+    if (transparent_huge_pages_sanity_check(true, page_size)) {
+      _code_large_page_size = page_size;
+    }
+  }
+  if (_code_large_page_size > (size_t)vm_page_size()) {
+    log_info(pagesize)("Code cache large page size: " SIZE_FORMAT "%s",
+                       byte_size_in_exact_unit(_code_large_page_size),
+                       exact_unit_for_byte_size(_code_large_page_size));
+  } else {
+    log_info(pagesize)("Code cache large pages are not available, using " SIZE_FORMAT "%s pages",
+                       byte_size_in_exact_unit(vm_page_size()),
+                       exact_unit_for_byte_size(vm_page_size()));
+  }
+}
+
 void os::large_page_init() {
   if (!UseLargePages &&
       !UseTransparentHugePages &&
       !UseHugeTLBFS &&
       !UseSHM) {
     // Not using large pages.
-    return;
-  }
-
-  if (!FLAG_IS_DEFAULT(UseLargePages) && !UseLargePages) {
+  } else if (!FLAG_IS_DEFAULT(UseLargePages) && !UseLargePages) {
     // The user explicitly turned off large pages.
     // Ignore the rest of the large pages flags.
     UseTransparentHugePages = false;
     UseHugeTLBFS = false;
     UseSHM = false;
-    return;
-  }
+  } else {
+    size_t large_page_size = Linux::setup_large_page_size();
+    UseLargePages          = Linux::setup_large_page_type(large_page_size);
 
-  size_t large_page_size = Linux::setup_large_page_size();
-  UseLargePages          = Linux::setup_large_page_type(large_page_size);
+    set_coredump_filter(LARGEPAGES_BIT);
+  }
 
-  set_coredump_filter(LARGEPAGES_BIT);
+  Linux::setup_code_large_pages();
 }
 
 #ifndef SHM_HUGETLB
@@ -4542,6 +4577,10 @@ bool os::can_execute_large_page_memory() {
   return UseTransparentHugePages || UseHugeTLBFS;
 }
 
+size_t os::code_large_page_size() {
+  return _code_large_page_size > 0 ? _code_large_page_size : vm_page_size();
+}
+
 char* os::pd_attempt_reserve_memory_at(size_t bytes, char* requested_addr, int file_desc) {
   assert(file_desc >= 0, "file_desc is not valid");
   char* result = pd_attempt_reserve_memory_at(bytes, requested_addr);
@@ -94,6 +94,7 @@ class Linux {
   static size_t setup_large_page_size();
 
   static bool setup_large_page_type(size_t page_size);
+  static void setup_code_large_pages();
   static bool transparent_huge_pages_sanity_check(bool warn, size_t pages_size);
   static bool hugetlbfs_sanity_check(bool warn, size_t page_size);
 
@@ -2895,6 +2895,10 @@ bool os::can_execute_large_page_memory() {
   return true;
 }
 
+size_t os::code_large_page_size() {
+  return UseLargePages && can_execute_large_page_memory() ? large_page_size() : vm_page_size();
+}
+
 // Read calls from inside the vm need to perform state transitions
 size_t os::read(int fd, void *buf, unsigned int nBytes) {
   size_t res;
@@ -3249,6 +3249,10 @@ bool os::can_execute_large_page_memory() {
   return true;
 }
 
+size_t os::code_large_page_size() {
+  return UseLargePages && can_execute_large_page_memory() ? large_page_size() : vm_page_size();
+}
+
 char* os::reserve_memory_special(size_t bytes, size_t alignment, char* addr,
                                  bool exec) {
   assert(UseLargePages, "only for large pages");
@@ -584,6 +584,7 @@ void LinearScan::compute_local_live_sets() {
 
     LIR_OpList* instructions = block->lir()->instructions_list();
     int num_inst = instructions->length();
+    ValueStack* last_info_stack = NULL;
 
     // iterate all instructions of the block. skip the first because it is always a label
     assert(visitor.no_operands(instructions->at(0)), "first operation must always be a label");
@@ -644,6 +645,12 @@ void LinearScan::compute_local_live_sets() {
       for (k = 0; k < n; k++) {
         CodeEmitInfo* info = visitor.info_at(k);
         ValueStack* stack = info->stack();
+        if (stack == last_info_stack) {
+          // live_kill only grows within a block, so visiting the same state
+          // again cannot add anything to live_gen
+          continue;
+        }
+        last_info_stack = stack;
         for_each_state_value(stack, value,
           set_live_gen_kill(value, op, live_gen, live_kill);
           local_has_fpu_registers = local_has_fpu_registers || value->type()->is_float_kind();
@@ -4316,6 +4323,30 @@ Interval* Interval::split_child_before_op_id(int op_id) {
 
 
 // Note: use positions are sorted descending -> first use has highest index
+
+// Returns the index of the first use position at or after the given position,
+// or -2 if there is none. Use positions are found with a binary search so that
+// intervals with many uses (e.g. in huge generated methods) are not scanned
+// linearly for each query.
+int Interval::use_pos_index(int from) const {
+  int lo = 0;
+  int hi = num_use_positions() - 1;
+  int result = -1;
+  while (lo <= hi) {
+    int mid = (lo + hi) >> 1;
+    if (_use_pos_and_kinds.at(mid * 2) >= from) {
+      result = mid;
+      lo = mid + 1;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  assert(result < 0 || _use_pos_and_kinds.at(result * 2) >= from, "use position before from");
+  assert(result + 1 >= num_use_positions() || _use_pos_and_kinds.at((result + 1) * 2) < from,
+         "use position at or after from skipped");
+  return result * 2;
+}
+
 int Interval::first_usage(IntervalUseKind min_use_kind) const {
   assert(LinearScan::is_virtual_interval(this), "cannot access use positions for fixed intervals");
 
@@ -4330,8 +4361,8 @@ int Interval::first_usage(IntervalUseKind min_use_kind) const {
 int Interval::next_usage(IntervalUseKind min_use_kind, int from) const {
   assert(LinearScan::is_virtual_interval(this), "cannot access use positions for fixed intervals");
 
-  for (int i = _use_pos_and_kinds.length() - 2; i >= 0; i -= 2) {
-    if (_use_pos_and_kinds.at(i) >= from && _use_pos_and_kinds.at(i + 1) >= min_use_kind) {
+  for (int i = use_pos_index(from); i >= 0; i -= 2) {
+    if (_use_pos_and_kinds.at(i + 1) >= min_use_kind) {
       return _use_pos_and_kinds.at(i);
     }
   }
@@ -4341,8 +4372,8 @@ int Interval::next_usage(IntervalUseKind min_use_kind, int from) const {
 int Interval::next_usage_exact(IntervalUseKind exact_use_kind, int from) const {
   assert(LinearScan::is_virtual_interval(this), "cannot access use positions for fixed intervals");
 
-  for (int i = _use_pos_and_kinds.length() - 2; i >= 0; i -= 2) {
-    if (_use_pos_and_kinds.at(i) >= from && _use_pos_and_kinds.at(i + 1) == exact_use_kind) {
+  for (int i = use_pos_index(from); i >= 0; i -= 2) {
+    if (_use_pos_and_kinds.at(i + 1) == exact_use_kind) {
       return _use_pos_and_kinds.at(i);
     }
   }
@@ -4352,16 +4383,14 @@ int Interval::next_usage_exact(IntervalUseKind exact_use_kind, int from) const {
 int Interval::previous_usage(IntervalUseKind min_use_kind, int from) const {
   assert(LinearScan::is_virtual_interval(this), "cannot access use positions for fixed intervals");
 
-  int prev = 0;
-  for (int i = _use_pos_and_kinds.length() - 2; i >= 0; i -= 2) {
-    if (_use_pos_and_kinds.at(i) > from) {
-      return prev;
-    }
+  // start with the last use position that is not after from and search backwards
+  int len = _use_pos_and_kinds.length();
+  for (int i = use_pos_index(from + 1) + 2; i < len; i += 2) {
     if (_use_pos_and_kinds.at(i + 1) >= min_use_kind) {
-      prev = _use_pos_and_kinds.at(i);
+      return _use_pos_and_kinds.at(i);
     }
   }
-  return prev;
+  return 0;
 }
 
 void Interval::add_use_pos(int pos, IntervalUseKind use_kind) {
@@ -4470,10 +4499,7 @@ Interval* Interval::split(int split_pos) {
 
   // split list of use positions
   int total_len = _use_pos_and_kinds.length();
-  int start_idx = total_len - 2;
-  while (start_idx >= 0 && _use_pos_and_kinds.at(start_idx) < split_pos) {
-    start_idx -= 2;
-  }
+  int start_idx = use_pos_index(split_pos);
 
   intStack new_use_pos_and_kinds(total_len - start_idx);
   int i;
@@ -531,6 +531,7 @@ class Interval : public CompilationResourceObj {
 
   int              calc_to();
   Interval*        new_split_child();
+  int              use_pos_index(int from) const;
  public:
   Interval(int reg_num);
 
@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "classfile/classFileStream.hpp"
+#include "classfile/classListWriter.hpp"
+#include "classfile/classLoader.hpp"
+#include "classfile/classLoaderData.hpp"
+#include "classfile/systemDictionary.hpp"
+#include "classfile/systemDictionaryShared.hpp"
+#include "logging/log.hpp"
+#include "memory/resourceArea.hpp"
+#include "oops/instanceKlass.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/os.hpp"
+#include "utilities/ostream.hpp"
+#include "utilities/resourceHash.hpp"
+
+typedef ResourceHashtable<
+  const InstanceKlass*, int,
+  primitive_hash<const InstanceKlass*>,
+  primitive_equals<const InstanceKlass*>,
+  15889, // prime number
+  ResourceObj::C_HEAP,
+  mtClass> ClassListIDTable;
+
+static ClassListIDTable* _id_table = NULL;
+int ClassListWriter::_next_id = 0;
+
+bool ClassListWriter::is_enabled() {
+  return DumpLoadedClassList != NULL && classlist_file != NULL && classlist_file->is_open();
+}
+
+// The following functions must be called with ClassListFile_lock held.
+
+bool ClassListWriter::has_id(const InstanceKlass* k) {
+  assert_lock_strong(ClassListFile_lock);
+  return _id_table != NULL && _id_table->get(k) != NULL;
+}
+
+int ClassListWriter::get_id(const InstanceKlass* k) {
+  assert_lock_strong(ClassListFile_lock);
+  if (_id_table == NULL) {
+    _id_table = new (ResourceObj::C_HEAP, mtClass) ClassListIDTable();
+  }
+  int* v = _id_table->get(k);
+  if (v != NULL) {
+    return *v;
+  }
+  int id = _next_id++;
+  _id_table->put(k, id);
+  return id;
+}
+
+void ClassListWriter::write_builtin(const InstanceKlass* k) {
+  MutexLockerEx ml(ClassListFile_lock, Mutex::_no_safepoint_check_flag);
+  if (has_id(k)) {
+    // Already written, e.g. the same class was matched against more than one stream.
+    return;
+  }
+  classlist_file->print_cr("%s id: %d", k->name()->as_C_string(), get_id(k));
+  classlist_file->flush();
+}
+
+void ClassListWriter::write_custom(const InstanceKlass* k, const char* path) {
+  MutexLockerEx ml(ClassListFile_lock, Mutex::_no_safepoint_check_flag);
+  if (has_id(k)) {
+    return;
+  }
+
+  // ClassListParser requires the super class and all local interfaces to be
+  // specified by id, so they must have been written earlier in the list.
+  const InstanceKlass* super = k->java_super();
+  if (super == NULL || !has_id(super)) {
+    log_debug(cds)("Skip writing class %s to classlist: super class not in classlist",
+                   k->name()->as_C_string());
+    return;
+  }
+  Array<Klass*>* interfaces = k->local_interfaces();
+  for (int i = 0; i < interfaces->length(); i++) {
+    if (!has_id(InstanceKlass::cast(interfaces->at(i)))) {
+      log_debug(cds)("Skip writing class %s to classlist: interface %s not in classlist",
+                     k->name()->as_C_string(), interfaces->at(i)->name()->as_C_string());
+      return;
+    }
+  }
+
+  classlist_file->print("%s id: %d super: %d", k->name()->as_C_string(), get_id(k), get_id(super));
+  if (interfaces->length() > 0) {
+    classlist_file->print(" interfaces:");
+    for (int i = 0; i < interfaces->length(); i++) {
+      classlist_file->print(" %d", get_id(InstanceKlass::cast(interfaces->at(i))));
+    }
+  }
+  classlist_file->print_cr(" source: %s", path);
+  classlist_file->flush();
+}
+
+bool ClassListWriter::is_builtin_source_archivable(const InstanceKlass* k, const char* source) {
+  oop class_loader = k->class_loader_data()->class_loader();
+  if (class_loader == NULL || SystemDictionary::is_platform_class_loader(class_loader)) {
+    // For the boot and platform class loaders, skip classes that are not found in the
+    // java runtime image, such as those found in the --patch-module entries.
+    // These classes can't be loaded from the archive during runtime.
+    if (!ClassLoader::is_modules_image(source) && strncmp(source, "jrt:", 4) != 0) {
+      // .. but don't skip the boot classes that are loaded from -Xbootclasspath/a
+      // as they can be loaded from the archive during runtime.
+      return class_loader == NULL && ClassLoader::contains_append_entry(source);
+    }
+  }
+  return true;
+}
+
+// Returns the local file system path that the class was defined from, or NULL if
+// the class cannot be loaded again from <source> by ClassListParser at dump time.
+char* ClassListWriter::custom_loader_source_path(const InstanceKlass* k, const char* source) {
+#if !(defined(_LP64) && (defined(LINUX)|| defined(SOLARIS)))
+  // Must be in sync with ClassListParser::load_class_from_source.
+  return NULL;
+#else
+  if (strncmp(source, "file:", 5) != 0) {
+    // Only classes from local jar files and directories can be archived. Classes
+    // from remote URLs or generated at runtime have no verifiable source.
+    return NULL;
+  }
+  if (strchr(source, '%') != NULL) {
+    // The URL contains escaped characters that do not map 1:1 to a file path.
+    return NULL;
+  }
+  if (k->name()->starts_with("java/")) {
+    // Prohibited package for non-bootstrap classes.
+    return NULL;
+  }
+  size_t len = strlen(source);
+  char* copy = NEW_RESOURCE_ARRAY(char, len + 1);
+  strncpy(copy, source, len + 1);
+  char* path = ClassLoader::skip_uri_protocol(copy);
+
+  struct stat st;
+  if (os::stat(path, &st) != 0) {
+    return NULL;
+  }
+  if ((st.st_mode & S_IFMT) != S_IFREG && (st.st_mode & S_IFMT) != S_IFDIR) {
+    return NULL;
+  }
+  return path;
+#endif
+}
+
+void ClassListWriter::write(const InstanceKlass* k, const ClassFileStream* cfs) {
+  assert(is_enabled(), "must be");
+  const char* source = cfs->source();
+  if (source == NULL || k->is_anonymous()) {
+    // Anonymous classes such as generated LambdaForm classes are not included.
+    return;
+  }
+  if (!ClassLoader::has_jrt_entry()) {
+    warning("DumpLoadedClassList and CDS are not supported in exploded build");
+    DumpLoadedClassList = NULL;
+    return;
+  }
+
+  ResourceMark rm;
+  if (SystemDictionaryShared::is_sharing_possible(k->class_loader_data())) {
+    if (is_builtin_source_archivable(k, source)) {
+      write_builtin(k);
+    } else {
+      tty->print_cr("skip writing class %s from source %s to classlist file",
+                    k->name()->as_C_string(), source);
+    }
+  } else {
+    char* path = custom_loader_source_path(k, source);
+    if (path != NULL) {
+      write_custom(k, path);
+    } else {
+      log_debug(cds)("Skip writing class %s from source %s to classlist: source not supported",
+                     k->name()->as_C_string(), source);
+    }
+  }
+}
+
+void ClassListWriter::write_shared(const InstanceKlass* k) {
+  assert(is_enabled(), "must be");
+  // Only dump the classes that can be stored into CDS archive
+  if (SystemDictionaryShared::is_sharing_possible(k->class_loader_data())) {
+    ResourceMark rm;
+    write_builtin(k);
+  }
+}
+
+void ClassListWriter::handle_class_unloading(const InstanceKlass* k) {
+  if (!is_enabled()) {
+    return;
+  }
+  MutexLockerEx ml(ClassListFile_lock, Mutex::_no_safepoint_check_flag);
+  if (_id_table != NULL) {
+    _id_table->remove(k);
+  }
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_VM_CLASSFILE_CLASSLISTWRITER_HPP
+#define SHARE_VM_CLASSFILE_CLASSLISTWRITER_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/macros.hpp"
+
+class ClassFileStream;
+class InstanceKlass;
+
+// Writes the -XX:DumpLoadedClassList file.
+//
+// Every class written to the list is tagged with an "id:". Classes defined by
+// custom class loaders (e.g. URLClassLoader) from a local jar file or directory
+// are written in the "id: super: interfaces: source:" form understood by
+// ClassListParser, so a single training run produces a class list that covers
+// both the builtin and the custom loaders, and can be passed unmodified to
+// -Xshare:dump -XX:SharedClassListFile=<file>.
+class ClassListWriter : AllStatic {
+  static int _next_id;
+
+  static bool has_id(const InstanceKlass* k);
+  static int  get_id(const InstanceKlass* k);
+  static bool is_builtin_source_archivable(const InstanceKlass* k, const char* source);
+  static char* custom_loader_source_path(const InstanceKlass* k, const char* source);
+  static void write_builtin(const InstanceKlass* k);
+  static void write_custom(const InstanceKlass* k, const char* path);
+public:
+  static bool is_enabled();
+
+  // Called for every class that was parsed from, or matched against, a class file stream.
+  static void write(const InstanceKlass* k, const ClassFileStream* cfs);
+
+  // Called for every class that was loaded from the CDS archive by a builtin loader.
+  static void write_shared(const InstanceKlass* k);
+
+  // Forget the id of an unloaded class, so that its address can be reused.
+  static void handle_class_unloading(const InstanceKlass* k);
+};
+
+#endif // SHARE_VM_CLASSFILE_CLASSLISTWRITER_HPP
@@ -128,12 +128,12 @@ PerfCounter*    ClassLoader::_perf_define_appclass_time = NULL;
 PerfCounter*    ClassLoader::_perf_define_appclass_selftime = NULL;
 PerfCounter*    ClassLoader::_perf_app_classfile_bytes_read = NULL;
 PerfCounter*    ClassLoader::_perf_sys_classfile_bytes_read = NULL;
-PerfCounter*    ClassLoader::_sync_systemLoaderLockContentionRate = NULL;
-PerfCounter*    ClassLoader::_sync_nonSystemLoaderLockContentionRate = NULL;
-PerfCounter*    ClassLoader::_sync_JVMFindLoadedClassLockFreeCounter = NULL;
-PerfCounter*    ClassLoader::_sync_JVMDefineClassLockFreeCounter = NULL;
-PerfCounter*    ClassLoader::_sync_JNIDefineClassLockFreeCounter = NULL;
-PerfCounter*    ClassLoader::_unsafe_defineClassCallCounter = NULL;
+PerfStripedCounter* ClassLoader::_sync_systemLoaderLockContentionRate = NULL;
+PerfStripedCounter* ClassLoader::_sync_nonSystemLoaderLockContentionRate = NULL;
+PerfStripedCounter* ClassLoader::_sync_JVMFindLoadedClassLockFreeCounter = NULL;
+PerfStripedCounter* ClassLoader::_sync_JVMDefineClassLockFreeCounter = NULL;
+PerfStripedCounter* ClassLoader::_sync_JNIDefineClassLockFreeCounter = NULL;
+PerfStripedCounter* ClassLoader::_unsafe_defineClassCallCounter = NULL;
 PerfCounter*    ClassLoader::_load_instance_class_failCounter = NULL;
 
 GrowableArray<ModuleClassPathList*>* ClassLoader::_patch_mod_entries = NULL;
@@ -1684,20 +1684,20 @@ void ClassLoader::initialize() {
     // of the bug fix of 6365597. They are mainly focused on finding out
     // the behavior of system & user-defined classloader lock, whether
     // ClassLoader.loadClass/findClass is being called synchronized or not.
-    NEWPERFEVENTCOUNTER(_sync_systemLoaderLockContentionRate, SUN_CLS,
-                        "systemLoaderLockContentionRate");
-    NEWPERFEVENTCOUNTER(_sync_nonSystemLoaderLockContentionRate, SUN_CLS,
-                        "nonSystemLoaderLockContentionRate");
-    NEWPERFEVENTCOUNTER(_sync_JVMFindLoadedClassLockFreeCounter, SUN_CLS,
-                        "jvmFindLoadedClassNoLockCalls");
-    NEWPERFEVENTCOUNTER(_sync_JVMDefineClassLockFreeCounter, SUN_CLS,
-                        "jvmDefineClassNoLockCalls");
-
-    NEWPERFEVENTCOUNTER(_sync_JNIDefineClassLockFreeCounter, SUN_CLS,
-                        "jniDefineClassNoLockCalls");
-
-    NEWPERFEVENTCOUNTER(_unsafe_defineClassCallCounter, SUN_CLS,
-                        "unsafeDefineClassCalls");
+    NEWPERFSTRIPEDEVENTCOUNTER(_sync_systemLoaderLockContentionRate, SUN_CLS,
+                               "systemLoaderLockContentionRate");
+    NEWPERFSTRIPEDEVENTCOUNTER(_sync_nonSystemLoaderLockContentionRate, SUN_CLS,
+                               "nonSystemLoaderLockContentionRate");
+    NEWPERFSTRIPEDEVENTCOUNTER(_sync_JVMFindLoadedClassLockFreeCounter, SUN_CLS,
+                               "jvmFindLoadedClassNoLockCalls");
+    NEWPERFSTRIPEDEVENTCOUNTER(_sync_JVMDefineClassLockFreeCounter, SUN_CLS,
+                               "jvmDefineClassNoLockCalls");
+
+    NEWPERFSTRIPEDEVENTCOUNTER(_sync_JNIDefineClassLockFreeCounter, SUN_CLS,
+                               "jniDefineClassNoLockCalls");
+
+    NEWPERFSTRIPEDEVENTCOUNTER(_unsafe_defineClassCallCounter, SUN_CLS,
+                               "unsafeDefineClassCalls");
 
     NEWPERFEVENTCOUNTER(_load_instance_class_failCounter, SUN_CLS,
                         "loadInstanceClassFailRate");
@@ -203,13 +203,13 @@ class ClassLoader: AllStatic {
   static PerfCounter* _perf_app_classfile_bytes_read;
   static PerfCounter* _perf_sys_classfile_bytes_read;
 
-  static PerfCounter* _sync_systemLoaderLockContentionRate;
-  static PerfCounter* _sync_nonSystemLoaderLockContentionRate;
-  static PerfCounter* _sync_JVMFindLoadedClassLockFreeCounter;
-  static PerfCounter* _sync_JVMDefineClassLockFreeCounter;
-  static PerfCounter* _sync_JNIDefineClassLockFreeCounter;
+  static PerfStripedCounter* _sync_systemLoaderLockContentionRate;
+  static PerfStripedCounter* _sync_nonSystemLoaderLockContentionRate;
+  static PerfStripedCounter* _sync_JVMFindLoadedClassLockFreeCounter;
+  static PerfStripedCounter* _sync_JVMDefineClassLockFreeCounter;
+  static PerfStripedCounter* _sync_JNIDefineClassLockFreeCounter;
 
-  static PerfCounter* _unsafe_defineClassCallCounter;
+  static PerfStripedCounter* _unsafe_defineClassCallCounter;
   static PerfCounter* _load_instance_class_failCounter;
 
   // The boot class path consists of 3 ordered pieces:
@@ -329,32 +329,32 @@ class ClassLoader: AllStatic {
   static PerfCounter* perf_sys_classfile_bytes_read() { return _perf_sys_classfile_bytes_read; }
 
   // Record how often system loader lock object is contended
-  static PerfCounter* sync_systemLoaderLockContentionRate() {
+  static PerfStripedCounter* sync_systemLoaderLockContentionRate() {
     return _sync_systemLoaderLockContentionRate;
   }
 
   // Record how often non system loader lock object is contended
-  static PerfCounter* sync_nonSystemLoaderLockContentionRate() {
+  static PerfStripedCounter* sync_nonSystemLoaderLockContentionRate() {
     return _sync_nonSystemLoaderLockContentionRate;
   }
 
   // Record how many calls to JVM_FindLoadedClass w/o holding a lock
-  static PerfCounter* sync_JVMFindLoadedClassLockFreeCounter() {
+  static PerfStripedCounter* sync_JVMFindLoadedClassLockFreeCounter() {
     return _sync_JVMFindLoadedClassLockFreeCounter;
   }
 
   // Record how many calls to JVM_DefineClass w/o holding a lock
-  static PerfCounter* sync_JVMDefineClassLockFreeCounter() {
+  static PerfStripedCounter* sync_JVMDefineClassLockFreeCounter() {
     return _sync_JVMDefineClassLockFreeCounter;
   }
 
   // Record how many calls to jni_DefineClass w/o holding a lock
-  static PerfCounter* sync_JNIDefineClassLockFreeCounter() {
+  static PerfStripedCounter* sync_JNIDefineClassLockFreeCounter() {
     return _sync_JNIDefineClassLockFreeCounter;
   }
 
   // Record how many calls to Unsafe_DefineClass
-  static PerfCounter* unsafe_defineClassCallCounter() {
+  static PerfStripedCounter* unsafe_defineClassCallCounter() {
     return _unsafe_defineClassCallCounter;
   }
 
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "jvm.h"
+#include "classfile/classPreloader.hpp"
+#include "classfile/javaClasses.hpp"
+#include "classfile/symbolTable.hpp"
+#include "classfile/systemDictionary.hpp"
+#include "classfile/vmSymbols.hpp"
+#include "logging/log.hpp"
+#include "memory/resourceArea.hpp"
+#include "memory/universe.hpp"
+#include "oops/instanceKlass.hpp"
+#include "oops/symbol.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/handles.inline.hpp"
+#include "runtime/javaCalls.hpp"
+#include "runtime/java.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/os.hpp"
+#include "runtime/thread.hpp"
+
+GrowableArray<Symbol*>* ClassPreloader::_class_names = NULL;
+volatile int ClassPreloader::_next_index = 0;
+volatile int ClassPreloader::_num_loaded = 0;
+volatile int ClassPreloader::_num_running_threads = 0;
+jlong ClassPreloader::_start_time = 0;
+
+// Reads the class names from a class list file. Only the first token of
+// each line is used, so the output of -XX:DumpLoadedClassList can be used
+// as is. Classes of custom loaders ("source:") cannot be loaded by the
+// system class loader and are skipped.
+bool ClassPreloader::read_class_list(const char* file, TRAPS) {
+  // Use os::open() because neither fopen() nor os::fopen()
+  // can handle long path name on Windows.
+  FILE* fp = NULL;
+  int fd = os::open(file, O_RDONLY, S_IREAD);
+  if (fd != -1) {
+    fp = os::open(fd, "r");
+  }
+  if (fp == NULL) {
+    char errmsg[JVM_MAXPATHLEN];
+    os::lasterror(errmsg, JVM_MAXPATHLEN);
+    warning("Cannot open PreloadClassList %s: %s", file, errmsg);
+    return false;
+  }
+
+  _class_names = new (ResourceObj::C_HEAP, mtClass) GrowableArray<Symbol*>(1000, true, mtClass);
+  char line[JVM_MAXPATHLEN + 256];
+  while (fgets(line, sizeof(line), fp) != NULL) {
+    size_t line_len = strlen(line);
+    if (line_len > 0 && line[line_len - 1] != '\n' && !feof(fp)) {
+      // The line was cut off. Skip all of it, as the tail would otherwise be
+      // read as a line of its own and a cut-off name could be that of
+      // another class.
+      log_info(class, preload)("Skipping a line longer than " SIZE_FORMAT " characters in %s",
+                               sizeof(line) - 2, file);
+      int c;
+      while ((c = getc(fp)) != EOF && c != '\n') {
+      }
+      continue;
+    }
+    if (*line == '#' || strstr(line, " source:") != NULL) {
+      continue;
+    }
+    size_t len = strcspn(line, " \t\r\n");
+    if (len == 0 || len > (size_t)Symbol::max_length()) {
+      continue;
+    }
+    Symbol* name = SymbolTable::new_symbol(line, (int)len, THREAD);
+    if (HAS_PENDING_EXCEPTION) {
+      break;
+    }
+    _class_names->append(name);
+  }
+  fclose(fp);
+  return !HAS_PENDING_EXCEPTION;
+}
+
+void ClassPreloader::start(TRAPS) {
+  if (PreloadClassList == NULL || DumpSharedSpaces) {
+    return;
+  }
+  if (!read_class_list(PreloadClassList, THREAD)) {
+    CLEAR_PENDING_EXCEPTION;
+    return;
+  }
+  if (_class_names->is_empty()) {
+    return;
+  }
+
+  _start_time = os::javaTimeNanos();
+  log_info(class, preload)("Preloading %d classes with %u threads",
+                           _class_names->length(), PreloadClassThreads);
+  // Hold a count for the starting thread, so that the statistics are printed
+  // only after all the threads have been started and have finished.
+  _num_running_threads = 1;
+  for (uint i = 0; i < PreloadClassThreads && !HAS_PENDING_EXCEPTION; i++) {
+    make_thread(i, THREAD);
+  }
+  thread_done();
+}
+
+void ClassPreloader::thread_done() {
+  if (Atomic::sub(1, &_num_running_threads) == 0) {
+    log_info(class, preload)("Preloaded %d of %d classes in " JLONG_FORMAT " ms",
+                             _num_loaded, _class_names->length(),
+                             (os::javaTimeNanos() - _start_time) / NANOSECS_PER_MILLISEC);
+  }
+}
+
+void ClassPreloader::make_thread(int index, TRAPS) {
+  char name[64];
+  jio_snprintf(name, sizeof(name), "Class Preload Thread #%d", index);
+  Handle string = java_lang_String::create_from_str(name, CHECK);
+
+  // Initialize thread_oop to put it into the system threadGroup
+  Handle thread_group(THREAD, Universe::system_thread_group());
+  Handle thread_oop = JavaCalls::construct_new_instance(
+                          SystemDictionary::Thread_klass(),
+                          vmSymbols::threadgroup_string_void_signature(),
+                          thread_group,
+                          string,
+                          CHECK);
+
+  MutexLocker mu(Threads_lock, THREAD);
+  JavaThread* thread = new JavaThread(&preload_thread_entry);
+  if (thread == NULL || thread->osthread() == NULL) {
+    // Preloading is only an optimization. Just use fewer threads.
+    log_info(class, preload)("Failed to create preload thread #%d", index);
+    if (thread != NULL) {
+      thread->smr_delete();
+    }
+    return;
+  }
+
+  java_lang_Thread::set_thread(thread_oop(), thread);
+  java_lang_Thread::set_priority(thread_oop(), NormPriority);
+  java_lang_Thread::set_daemon(thread_oop());
+  thread->set_threadObj(thread_oop());
+
+  Atomic::inc(&_num_running_threads);
+  Threads::add(thread);
+  Thread::start(thread);
+}
+
+void ClassPreloader::preload_thread_entry(JavaThread* thread, TRAPS) {
+  Handle loader(THREAD, SystemDictionary::java_system_loader());
+  int length = _class_names->length();
+  while (true) {
+    int i = Atomic::add(1, &_next_index) - 1;
+    if (i >= length) {
+      break;
+    }
+    preload_class(_class_names->at(i), loader, THREAD);
+  }
+  thread_done();
+}
+
+void ClassPreloader::preload_class(Symbol* name, Handle loader, TRAPS) {
+  HandleMark hm(THREAD);
+  Klass* k = SystemDictionary::resolve_or_null(name, loader, Handle(), THREAD);
+  if (!HAS_PENDING_EXCEPTION && k != NULL && k->is_instance_klass()) {
+    // Linking verifies the bytecodes and rewrites them, which is most of the
+    // work left before the class can be initialized.
+    InstanceKlass::cast(k)->link_class(THREAD);
+  }
+  if (HAS_PENDING_EXCEPTION) {
+    // The same error will be thrown when the application uses the class.
+    if (log_is_enabled(Debug, class, preload)) {
+      ResourceMark rm(THREAD);
+      log_debug(class, preload)("Failed to preload %s: %s", name->as_C_string(),
+                                PENDING_EXCEPTION->klass()->external_name());
+    }
+    CLEAR_PENDING_EXCEPTION;
+    return;
+  }
+  if (k == NULL) {
+    if (log_is_enabled(Debug, class, preload)) {
+      ResourceMark rm(THREAD);
+      log_debug(class, preload)("Not found: %s", name->as_C_string());
+    }
+    return;
+  }
+  Atomic::inc(&_num_loaded);
+}
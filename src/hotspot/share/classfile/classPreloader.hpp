@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_VM_CLASSFILE_CLASSPRELOADER_HPP
+#define SHARE_VM_CLASSFILE_CLASSPRELOADER_HPP
+
+#include "memory/allocation.hpp"
+#include "runtime/handles.hpp"
+#include "utilities/growableArray.hpp"
+
+class JavaThread;
+class Symbol;
+
+// Support for -XX:PreloadClassList.
+//
+// The classes named in the list are loaded and linked (which includes
+// bytecode verification) with the system class loader by a pool of
+// PreloadClassThreads background threads, started once the VMInit event has
+// been posted. By then the system class loader is available and the JVMTI
+// and java agents have set up ClassFileLoadHook. The main thread needs no coordination with them:
+// SystemDictionary::resolve_or_fail finds a class that has been preloaded
+// in the dictionary, and a class that is being preloaded is either waited
+// for (boot loader placeholders) or serialized by the parallel capable
+// class loader's per-class lock.
+//
+// Loading and linking do not initialize a class, so no Java static
+// initializers are run ahead of time. Errors are ignored; they are thrown
+// again when the application itself resolves or links the class.
+class ClassPreloader : AllStatic {
+  static GrowableArray<Symbol*>* _class_names;
+  static volatile int _next_index;
+  static volatile int _num_loaded;
+  static volatile int _num_running_threads;
+  static jlong _start_time;
+
+  static bool read_class_list(const char* file, TRAPS);
+  static void preload_thread_entry(JavaThread* thread, TRAPS);
+  static void preload_class(Symbol* name, Handle loader, TRAPS);
+  static void make_thread(int index, TRAPS);
+  static void thread_done();
+public:
+  // Called by the main thread after JvmtiExport::post_vm_initialized().
+  static void start(TRAPS);
+};
+
+#endif // SHARE_VM_CLASSFILE_CLASSPRELOADER_HPP
@@ -30,6 +30,7 @@
 #include "classfile/systemDictionaryShared.hpp"
 #include "logging/log.hpp"
 #include "logging/logStream.hpp"
+#include "memory/archiveUtils.hpp"
 #include "memory/iterator.hpp"
 #include "memory/metaspaceClosure.hpp"
 #include "memory/resourceArea.hpp"
@@ -507,6 +508,22 @@ void Dictionary::reorder_dictionary_for_sharing() {
     set_entry(index, p);
   }
 }
+
+// Mark the pointers in the buckets and entries of the dictionary, after they have
+// been copied into the archive by copy_buckets() and copy_table().
+void Dictionary::mark_archived_pointers() {
+  assert(DumpSharedSpaces, "Should only be used at dump time");
+  for (int i = 0; i < table_size(); ++i) {
+    ArchivePtrMarker::mark_pointer(bucket_addr(i));
+    for (DictionaryEntry* p = bucket(i); p != NULL; p = p->next()) {
+      SharedDictionaryEntry* entry = (SharedDictionaryEntry*)p;
+      ArchivePtrMarker::mark_pointer(entry->next_addr());
+      ArchivePtrMarker::mark_pointer(entry->literal_addr());
+      ArchivePtrMarker::mark_pointer(&entry->_verifier_constraints);
+      ArchivePtrMarker::mark_pointer(&entry->_verifier_constraint_flags);
+    }
+  }
+}
 #endif
 
 SymbolPropertyTable::SymbolPropertyTable(int table_size)
@@ -91,6 +91,7 @@ public:
 
   // Sharing support
   void reorder_dictionary_for_sharing() NOT_CDS_RETURN;
+  void mark_archived_pointers() NOT_CDS_RETURN;
 
   void print_on(outputStream* st) const;
   void verify();
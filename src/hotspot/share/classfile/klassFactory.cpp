@@ -25,6 +25,7 @@
 #include "precompiled.hpp"
 #include "classfile/classFileParser.hpp"
 #include "classfile/classFileStream.hpp"
+#include "classfile/classListWriter.hpp"
 #include "classfile/classLoader.hpp"
 #include "classfile/classLoaderData.hpp"
 #include "classfile/classLoaderData.inline.hpp"
@@ -225,6 +226,9 @@ InstanceKlass* KlassFactory::create_from_stream(ClassFileStream* stream,
   if (DumpSharedSpaces) {
     ClassLoader::record_result(result, stream, THREAD);
   }
+  if (ClassListWriter::is_enabled()) {
+    ClassListWriter::write(result, stream);
+  }
 #endif // INCLUDE_CDS
 
   return result;
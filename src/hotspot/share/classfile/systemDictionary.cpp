@@ -27,6 +27,7 @@
 #include "aot/aotLoader.hpp"
 #include "classfile/classFileParser.hpp"
 #include "classfile/classFileStream.hpp"
+#include "classfile/classListWriter.hpp"
 #include "classfile/classLoader.hpp"
 #include "classfile/classLoaderData.inline.hpp"
 #include "classfile/classLoaderExt.hpp"
@@ -77,6 +78,7 @@
 #include "runtime/javaCalls.hpp"
 #include "runtime/mutexLocker.hpp"
 #include "runtime/orderAccess.hpp"
+#include "runtime/perfData.inline.hpp"
 #include "runtime/sharedRuntime.hpp"
 #include "runtime/signature.hpp"
 #include "services/classLoadingService.hpp"
@@ -1078,6 +1080,9 @@ InstanceKlass* SystemDictionary::resolve_from_stream(Symbol* class_name,
                                                    protection_domain,
                                                    st,
                                                    CHECK_NULL);
+    if (k != NULL && ClassListWriter::is_enabled()) {
+      ClassListWriter::write(k, st);
+    }
   }
 #endif
 
@@ -1359,13 +1364,8 @@ InstanceKlass* SystemDictionary::load_shared_class(InstanceKlass* ik,
       ClassLoader::add_package(ik->name()->as_C_string(), path_index, THREAD);
     }
 
-    if (DumpLoadedClassList != NULL && classlist_file->is_open()) {
-      // Only dump the classes that can be stored into CDS archive
-      if (SystemDictionaryShared::is_sharing_possible(loader_data)) {
-        ResourceMark rm(THREAD);
-        classlist_file->print_cr("%s", ik->name()->as_C_string());
-        classlist_file->flush();
-      }
+    if (ClassListWriter::is_enabled()) {
+      ClassListWriter::write_shared(ik);
     }
 
     // notify a class loaded from shared object
@@ -2901,6 +2901,7 @@ void SystemDictionary::copy_buckets(char* top, char* end) {
 
 void SystemDictionary::copy_table(char* top, char* end) {
   ClassLoaderData::the_null_class_loader_data()->dictionary()->copy_table(top, end);
+  ClassLoaderData::the_null_class_loader_data()->dictionary()->mark_archived_pointers();
 }
 
 // ----------------------------------------------------------------------------
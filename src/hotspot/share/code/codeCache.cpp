@@ -280,15 +280,32 @@ void CodeCache::initialize_heaps() {
         non_nmethod_size/K, min_code_cache_size/K));
   }
 
+  // If large page support is enabled, align code heaps according to large
+  // page size to make sure that code cache is covered by large pages.
+  const size_t alignment = MAX2(page_size(false, 8), (size_t) os::vm_allocation_granularity());
+
+  // The hot code heap is taken from the non-profiled code heap. Its size is
+  // a multiple of the large page size, so that it is fully backed by large pages.
+  size_t hot_size = 0;
+  if (heap_available(CodeBlobType::MethodHot)) {
+    hot_size = align_up((size_t)HotCodeHeapSize, alignment);
+    if (hot_size + min_size > non_profiled_size) {
+      vm_exit_during_initialization(err_msg(
+          "Not enough space in non-profiled code heap for hot code heap: " SIZE_FORMAT "K < " SIZE_FORMAT "K",
+          non_profiled_size/K, (hot_size + min_size)/K));
+    }
+    non_profiled_size -= hot_size;
+  }
+
   // Verify sizes and update flag values
-  assert(non_profiled_size + profiled_size + non_nmethod_size == cache_size, "Invalid code heap sizes");
+  assert(non_profiled_size + profiled_size + non_nmethod_size + hot_size == cache_size, "Invalid code heap sizes");
   FLAG_SET_ERGO(uintx, NonNMethodCodeHeapSize, non_nmethod_size);
   FLAG_SET_ERGO(uintx, ProfiledCodeHeapSize, profiled_size);
   FLAG_SET_ERGO(uintx, NonProfiledCodeHeapSize, non_profiled_size);
+  if (hot_size > 0) {
+    FLAG_SET_ERGO(uintx, HotCodeHeapSize, hot_size);
+  }
 
-  // If large page support is enabled, align code heaps according to large
-  // page size to make sure that code cache is covered by large pages.
-  const size_t alignment = MAX2(page_size(false, 8), (size_t) os::vm_allocation_granularity());
   non_nmethod_size = align_up(non_nmethod_size, alignment);
   profiled_size    = align_down(profiled_size, alignment);
 
@@ -297,11 +314,19 @@ void CodeCache::initialize_heaps() {
   // ---------- high -----------
   //    Non-profiled nmethods
   //      Profiled nmethods
+  //        Hot nmethods
   //         Non-nmethods
   // ---------- low ------------
+  // The hot nmethods are placed next to the stubs they call most.
   ReservedCodeSpace rs = reserve_heap_memory(cache_size);
   ReservedSpace non_method_space    = rs.first_part(non_nmethod_size);
   ReservedSpace rest                = rs.last_part(non_nmethod_size);
+  if (hot_size > 0) {
+    ReservedSpace hot_space         = rest.first_part(hot_size);
+    rest                            = rest.last_part(hot_size);
+    // Tier 4 methods with a high invocation and backedge rate
+    add_heap(hot_space, "CodeHeap 'hot nmethods'", CodeBlobType::MethodHot);
+  }
   ReservedSpace profiled_space      = rest.first_part(profiled_size);
   ReservedSpace non_profiled_space  = rest.last_part(profiled_size);
 
@@ -314,7 +339,10 @@ void CodeCache::initialize_heaps() {
 }
 
 size_t CodeCache::page_size(bool aligned, size_t min_pages) {
-  if (os::can_execute_large_page_memory()) {
+  if (UseLargePagesInCodeCache && os::code_large_page_size() > (size_t)os::vm_page_size()) {
+    // Align all the code heaps to the large page size, see CodeHeap::reserve()
+    return os::code_large_page_size();
+  } else if (os::can_execute_large_page_memory()) {
     if (InitialCodeCacheSize < ReservedCodeCacheSize) {
       // Make sure that the page size allows for an incremental commit of the reserved space
       min_pages = MAX2(min_pages, (size_t)8);
@@ -331,7 +359,10 @@ ReservedCodeSpace CodeCache::reserve_heap_memory(size_t size) {
   const size_t rs_ps = page_size();
   const size_t rs_align = MAX2(rs_ps, (size_t) os::vm_allocation_granularity());
   const size_t rs_size = align_up(size, rs_align);
-  ReservedCodeSpace rs(rs_size, rs_align, rs_ps > (size_t) os::vm_page_size());
+  // Transparent huge pages for the code cache alone are requested when the
+  // memory is committed, the reservation itself uses small pages.
+  const bool large = rs_ps > (size_t) os::vm_page_size() && os::can_execute_large_page_memory();
+  ReservedCodeSpace rs(rs_size, rs_align, large);
   if (!rs.is_reserved()) {
     vm_exit_during_initialization(err_msg("Could not reserve enough space for code cache (" SIZE_FORMAT "K)",
                                           rs_size/K));
@@ -352,8 +383,10 @@ bool CodeCache::heap_available(int code_blob_type) {
     // Interpreter only: we don't need any method code heaps
     return (code_blob_type == CodeBlobType::NonNMethod);
   } else if (TieredCompilation && (TieredStopAtLevel > CompLevel_simple)) {
-    // Tiered compilation: use all code heaps
-    return (code_blob_type < CodeBlobType::All);
+    // Tiered compilation: use all code heaps, the hot code heap only if requested
+    return (code_blob_type < CodeBlobType::All) ||
+           (code_blob_type == CodeBlobType::MethodHot && HotCodeHeapSize > 0 &&
+            TieredStopAtLevel >= CompLevel_full_optimization);
   } else {
     // No TieredCompilation: we only need the non-nmethod and non-profiled code heap
     return (code_blob_type == CodeBlobType::NonNMethod) ||
@@ -361,6 +394,23 @@ bool CodeCache::heap_available(int code_blob_type) {
   }
 }
 
+// A method compiled at tier 4 goes to the hot code heap if its rate of
+// invocations and backedges, as last measured by the tiered policy from the
+// profiling counters, is high. Keeping the hottest code together on a few
+// large pages reduces instruction TLB and cache misses. If the method cools
+// down, the sweeper flushes its nmethod once the hot code heap gets full.
+int CodeCache::get_code_blob_type(Method* method, int comp_level) {
+#ifdef TIERED
+  // The rate is only maintained by the tiered policy.
+  if (comp_level == CompLevel_full_optimization &&
+      heap_available(CodeBlobType::MethodHot) &&
+      method->rate() >= HotCodeHeapMinRate) {
+    return CodeBlobType::MethodHot;
+  }
+#endif
+  return get_code_blob_type(comp_level);
+}
+
 const char* CodeCache::get_code_heap_flag_name(int code_blob_type) {
   switch(code_blob_type) {
   case CodeBlobType::NonNMethod:
@@ -372,6 +422,9 @@ const char* CodeCache::get_code_heap_flag_name(int code_blob_type) {
   case CodeBlobType::MethodProfiled:
     return "ProfiledCodeHeapSize";
     break;
+  case CodeBlobType::MethodHot:
+    return "HotCodeHeapSize";
+    break;
   }
   ShouldNotReachHere();
   return NULL;
@@ -503,6 +556,11 @@ CodeBlob* CodeCache::allocate(int size, int code_blob_type, int orig_code_blob_t
         orig_code_blob_type = code_blob_type;
       }
       // Expansion failed
+      if (code_blob_type == CodeBlobType::MethodHot) {
+        // The hot code heap is only an optimization: if it is full, the
+        // nmethod goes to where it would have gone without it.
+        return allocate(size, CodeBlobType::MethodNonProfiled);
+      }
       if (SegmentedCodeCache) {
         // Fallback solution: Try to store code in another code heap.
         // NonNMethod -> MethodNonProfiled -> MethodProfiled (-> MethodNonProfiled)
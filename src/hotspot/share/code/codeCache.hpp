@@ -242,17 +242,17 @@ class CodeCache : AllStatic {
   }
 
   static bool code_blob_type_accepts_compiled(int type) {
-    bool result = type == CodeBlobType::All || type <= CodeBlobType::MethodProfiled;
+    bool result = type == CodeBlobType::All || type <= CodeBlobType::MethodProfiled || type == CodeBlobType::MethodHot;
     AOT_ONLY( result = result || type == CodeBlobType::AOT; )
     return result;
   }
 
   static bool code_blob_type_accepts_nmethod(int type) {
-    return type == CodeBlobType::All || type <= CodeBlobType::MethodProfiled;
+    return type == CodeBlobType::All || type <= CodeBlobType::MethodProfiled || type == CodeBlobType::MethodHot;
   }
 
   static bool code_blob_type_accepts_allocable(int type) {
-    return type <= CodeBlobType::All;
+    return type <= CodeBlobType::All || type == CodeBlobType::MethodHot;
   }
 
 
@@ -272,6 +272,9 @@ class CodeCache : AllStatic {
     return 0;
   }
 
+  // Returns the CodeBlobType for a new nmethod of the given method
+  static int get_code_blob_type(Method* method, int comp_level);
+
   static void verify_clean_inline_caches();
   static void verify_icholder_relocations();
 
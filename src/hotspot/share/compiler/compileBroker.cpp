@@ -352,6 +352,22 @@ bool CompileBroker::can_remove(CompilerThread *ct, bool do_it) {
   return false;
 }
 
+CompileQueue::CompileQueue(const char* name) {
+  _name = name;
+  _first = NULL;
+  _last = NULL;
+  _size = 0;
+  _first_stale = NULL;
+  _heap = new (ResourceObj::C_HEAP, mtCompiler) GrowableArray<CompileTask*>(64, true, mtCompiler);
+  _last_stale_check = 0;
+  _peak_size = 0;
+  _total_added = 0;
+  _total_selected = 0;
+  _total_stale = 0;
+  _total_wait_ticks = 0;
+  _max_wait_ticks = 0;
+}
+
 /**
  * Add a CompileTask to a CompileQueue.
  */
@@ -374,6 +390,12 @@ void CompileQueue::add(CompileTask* task) {
     _last = task;
   }
   ++_size;
+  _peak_size = MAX2(_peak_size, _size);
+  _total_added++;
+
+  CompilationPolicy::policy()->update_task_priority(task);
+  heap_set(_heap->length(), task);
+  heap_sift_up(task->queue_index());
 
   // Mark the method as being in the compile queue.
   task->method()->set_queued_for_compilation();
@@ -414,6 +436,8 @@ void CompileQueue::free_all() {
   }
   _first = NULL;
   _last = NULL;
+  _size = 0;
+  _heap->clear();
 
   // Wake up all threads that block on the queue.
   MethodCompileQueue_lock->notify_all();
@@ -476,6 +500,11 @@ CompileTask* CompileQueue::get() {
     save_method = methodHandle(task->method());
     save_hot_method = methodHandle(task->hot_method());
 
+    jlong wait_ticks = os::elapsed_counter() - task->time_queued();
+    _total_wait_ticks += wait_ticks;
+    _max_wait_ticks = MAX2(_max_wait_ticks, wait_ticks);
+    _total_selected++;
+
     remove(task);
   }
   purge_stale_tasks(); // may temporarily release MCQ lock
@@ -523,11 +552,14 @@ void CompileQueue::remove(CompileTask* task) {
     _last = task->prev();
   }
   --_size;
+
+  heap_remove(task);
 }
 
 void CompileQueue::remove_and_mark_stale(CompileTask* task) {
   assert(MethodCompileQueue_lock->owned_by_self(), "must own lock");
   remove(task);
+  _total_stale++;
 
   // Enqueue the task for reclamation (should be done outside MCQ lock)
   task->set_next(_first_stale);
@@ -535,6 +567,81 @@ void CompileQueue::remove_and_mark_stale(CompileTask* task) {
   _first_stale = task;
 }
 
+bool CompileQueue::has_higher_priority(CompileTask* x, CompileTask* y) {
+  if (x->is_blocking() != y->is_blocking()) {
+    // In blocking compilation mode, the CompileBroker will make
+    // compilations submitted by a JVMCI compiler thread non-blocking. These
+    // compilations should be scheduled after all blocking compilations
+    // to service non-compiler related compilations sooner and reduce the
+    // chance of such compilations timing out.
+    return x->is_blocking();
+  }
+  if (x->priority_level() != y->priority_level()) {
+    return x->priority_level() > y->priority_level();
+  }
+  if (x->priority() != y->priority()) {
+    return x->priority() > y->priority();
+  }
+  return x->compile_id() < y->compile_id();
+}
+
+void CompileQueue::heap_set(int index, CompileTask* task) {
+  _heap->at_put_grow(index, task);
+  task->set_queue_index(index);
+}
+
+void CompileQueue::heap_sift_up(int index) {
+  CompileTask* task = _heap->at(index);
+  while (index > 0) {
+    int parent = (index - 1) / 2;
+    if (!has_higher_priority(task, _heap->at(parent))) {
+      break;
+    }
+    heap_set(index, _heap->at(parent));
+    index = parent;
+  }
+  heap_set(index, task);
+}
+
+void CompileQueue::heap_sift_down(int index) {
+  CompileTask* task = _heap->at(index);
+  int length = _heap->length();
+  while (true) {
+    int child = 2 * index + 1;
+    if (child >= length) {
+      break;
+    }
+    if (child + 1 < length && has_higher_priority(_heap->at(child + 1), _heap->at(child))) {
+      child++;
+    }
+    if (!has_higher_priority(_heap->at(child), task)) {
+      break;
+    }
+    heap_set(index, _heap->at(child));
+    index = child;
+  }
+  heap_set(index, task);
+}
+
+void CompileQueue::heap_remove(CompileTask* task) {
+  int index = task->queue_index();
+  assert(index >= 0 && index < _heap->length() && _heap->at(index) == task, "not in the heap");
+  CompileTask* last = _heap->pop();
+  if (last != task) {
+    heap_set(index, last);
+    heap_sift_up(index);
+    heap_sift_down(last->queue_index());
+  }
+  task->set_queue_index(-1);
+}
+
+void CompileQueue::update_priority(CompileTask* task) {
+  assert(MethodCompileQueue_lock->owned_by_self(), "must own lock");
+  CompilationPolicy::policy()->update_task_priority(task);
+  heap_sift_up(task->queue_index());
+  heap_sift_down(task->queue_index());
+}
+
 // methods in the compile queue need to be marked as used on the stack
 // so that they don't get reclaimed by Redefine Classes
 void CompileQueue::mark_on_stack() {
@@ -30,6 +30,7 @@
 #include "compiler/compileTask.hpp"
 #include "compiler/compilerDirectives.hpp"
 #include "runtime/perfData.hpp"
+#include "utilities/growableArray.hpp"
 #include "utilities/stack.hpp"
 #if INCLUDE_JVMCI
 #include "jvmci/jvmciCompiler.hpp"
@@ -77,6 +78,12 @@ class CompilerCounters : public CHeapObj<mtCompiler> {
 // CompileQueue
 //
 // A list of CompileTasks.
+//
+// The tasks are kept in the order they were added, and are also indexed
+// by a binary heap ordered by task priority, so that the compilation
+// policy can take the most important task without walking the list.
+// Blocking tasks go first, then the tasks with the highest priority as
+// computed by CompilationPolicy::update_task_priority(), then the oldest.
 class CompileQueue : public CHeapObj<mtCompiler> {
  private:
   const char* _name;
@@ -88,15 +95,28 @@ class CompileQueue : public CHeapObj<mtCompiler> {
 
   int _size;
 
+  GrowableArray<CompileTask*>* _heap;
+
+  // Time (in ms) the compilation policy last checked all tasks for staleness.
+  jlong _last_stale_check;
+
+  // Statistics, reported by the CompileQueueStatistics event.
+  int   _peak_size;
+  jlong _total_added;
+  jlong _total_selected;
+  jlong _total_stale;
+  jlong _total_wait_ticks;
+  jlong _max_wait_ticks;
+
+  static bool has_higher_priority(CompileTask* x, CompileTask* y);
+  void heap_set(int index, CompileTask* task);
+  void heap_sift_up(int index);
+  void heap_sift_down(int index);
+  void heap_remove(CompileTask* task);
+
   void purge_stale_tasks();
  public:
-  CompileQueue(const char* name) {
-    _name = name;
-    _first = NULL;
-    _last = NULL;
-    _size = 0;
-    _first_stale = NULL;
-  }
+  CompileQueue(const char* name);
 
   const char*  name() const                      { return _name; }
 
@@ -106,11 +126,25 @@ class CompileQueue : public CHeapObj<mtCompiler> {
   CompileTask* first()                           { return _first; }
   CompileTask* last()                            { return _last;  }
 
+  // The task with the highest priority.
+  CompileTask* peek() const                      { return _heap->is_empty() ? NULL : _heap->at(0); }
+  // Recompute the priority of a task and restore the heap order.
+  void         update_priority(CompileTask* task);
+
   CompileTask* get();
 
   bool         is_empty() const                  { return _first == NULL; }
   int          size()     const                  { return _size;          }
 
+  jlong        last_stale_check() const          { return _last_stale_check; }
+  void         set_last_stale_check(jlong t)     { _last_stale_check = t; }
+
+  int          peak_size() const                 { return _peak_size;      }
+  jlong        total_added() const               { return _total_added;    }
+  jlong        total_selected() const            { return _total_selected; }
+  jlong        total_stale() const               { return _total_stale;    }
+  jlong        total_wait_ticks() const          { return _total_wait_ticks; }
+  jlong        max_wait_ticks() const            { return _max_wait_ticks; }
 
   // Redefine Classes support
   void mark_on_stack();
@@ -267,7 +301,6 @@ class CompileBroker: AllStatic {
                                   bool blocking,
                                   Thread* thread);
 
-  static CompileQueue* compile_queue(int comp_level);
   static bool init_compiler_runtime();
   static void shutdown_compiler_runtime(AbstractCompiler* comp, CompilerThread* thread);
 
@@ -286,6 +319,7 @@ public:
   static bool compilation_is_complete(const methodHandle& method, int osr_bci, int comp_level);
   static bool compilation_is_in_queue(const methodHandle& method);
   static void print_compile_queues(outputStream* st);
+  static CompileQueue* compile_queue(int comp_level);
   static int queue_size(int comp_level) {
     CompileQueue *q = compile_queue(comp_level);
     return q != NULL ? q->size() : 0;
@@ -108,6 +108,9 @@ void CompileTask::initialize(int compile_id,
   _hot_count = hot_count;
   _time_queued = os::elapsed_counter();
   _time_started = 0;
+  _queue_index = -1;
+  _priority_level = 0;
+  _priority = 0.0;
   _compile_reason = compile_reason;
   _failure_reason = NULL;
 
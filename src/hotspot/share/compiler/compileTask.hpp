@@ -93,6 +93,10 @@ class CompileTask : public CHeapObj<mtCompiler> {
   nmethodLocker* _code_handle;  // holder of eventual result
   CompileTask* _next, *_prev;
   bool         _is_free;
+  // Position in the priority heap of the CompileQueue and the key it is ordered by
+  int          _queue_index;
+  int          _priority_level;
+  double       _priority;
   // Fields used for logging why the compilation was initiated:
   jlong        _time_queued;  // time when task was enqueued
   jlong        _time_started; // time when compilation started
@@ -184,6 +188,16 @@ class CompileTask : public CHeapObj<mtCompiler> {
   void         set_is_free(bool val)             { _is_free = val; }
   bool         is_unloaded() const;
 
+  int          queue_index() const               { return _queue_index; }
+  void         set_queue_index(int index)        { _queue_index = index; }
+  int          priority_level() const            { return _priority_level; }
+  double       priority() const                  { return _priority; }
+  void         set_priority(int level, double priority) {
+    _priority_level = level;
+    _priority = priority;
+  }
+  jlong        time_queued() const               { return _time_queued; }
+
   // RedefineClasses support
   void         metadata_do(void f(Metadata*));
   void         mark_on_stack();
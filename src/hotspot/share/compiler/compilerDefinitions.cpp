@@ -428,6 +428,11 @@ void CompilerConfig::ergo_initialize() {
     }
   }
 
+  if (DumpMethodProfilesAtExit != NULL || LoadMethodProfiles != NULL) {
+    // Saved method profiles are keyed by the class fingerprint.
+    FLAG_SET_ERGO(bool, CalculateClassFingerprint, true);
+  }
+
   if (UseOnStackReplacement && !UseLoopCounter) {
     warning("On-stack-replacement requires loop counters; enabling loop counters");
     FLAG_SET_DEFAULT(UseLoopCounter, true);
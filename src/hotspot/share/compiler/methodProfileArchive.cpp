@@ -0,0 +1,734 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "jvm.h"
+#include "classfile/classLoaderData.hpp"
+#include "classfile/symbolTable.hpp"
+#include "classfile/systemDictionary.hpp"
+#include "compiler/compilerDefinitions.hpp"
+#include "compiler/methodProfileArchive.hpp"
+#include "logging/log.hpp"
+#include "memory/allocation.inline.hpp"
+#include "memory/iterator.hpp"
+#include "memory/resourceArea.hpp"
+#include "oops/instanceKlass.hpp"
+#include "oops/method.hpp"
+#include "oops/methodCounters.hpp"
+#include "oops/methodData.hpp"
+#include "oops/symbol.hpp"
+#include "runtime/compilationPolicy.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/handles.inline.hpp"
+#include "runtime/os.hpp"
+#include "runtime/thread.hpp"
+#include "runtime/vmThread.hpp"
+#include "runtime/vmOperations.hpp"
+#include "runtime/vm_version.hpp"
+#include "utilities/copy.hpp"
+#include "utilities/growableArray.hpp"
+#include "utilities/ostream.hpp"
+#include "utilities/resourceHash.hpp"
+
+// File layout, in the native byte order:
+//
+//   u4 magic, u4 version, VM info string
+//   per class:  name, u8 fingerprint, u4 method count
+//   per method: name, signature,
+//               u4 invocation count, u4 backedge count   (MethodCounters)
+//               u4 invocation count, u4 backedge count   (MethodData)
+//               u4 data size, data section of the MethodData
+//               u4 klass count, per klass: u4 cell index, name
+//
+// Strings are written as a u2 length followed by the UTF-8 bytes. The Klass
+// cells in the saved data section are cleared, except for the status bits
+// of type entries.
+static const juint METHOD_PROFILES_MAGIC   = 0xfaceb00c;
+static const juint METHOD_PROFILES_VERSION = 1;
+
+struct SavedKlassCell {
+  int     _index;   // in words, from the start of the data section
+  Symbol* _name;
+};
+
+class SavedMethodProfile {
+ public:
+  Symbol*         _name;
+  Symbol*         _signature;
+  int             _invocation_count;
+  int             _backedge_count;
+  int             _mdo_invocation_count;
+  int             _mdo_backedge_count;
+  int             _data_size;
+  intptr_t*       _data;
+  int             _klass_count;
+  SavedKlassCell* _klasses;
+};
+
+class SavedClassProfiles : public CHeapObj<mtCompiler> {
+ public:
+  uint64_t            _fingerprint;
+  int                 _method_count;
+  SavedMethodProfile* _methods;
+  SavedClassProfiles* _next;   // another class with the same name
+};
+
+typedef ResourceHashtable<
+  Symbol*, SavedClassProfiles*,
+  primitive_hash<Symbol*>,
+  primitive_equals<Symbol*>,
+  15889, // prime number
+  ResourceObj::C_HEAP,
+  mtCompiler> SavedProfilesTable;
+
+static SavedProfilesTable* _saved_profiles = NULL;
+bool MethodProfileArchive::_has_saved_profiles = false;
+
+// Visits the cells of the data section of a MethodData that hold a Klass*.
+// Saving and restoring a profile visit the cells in the same order.
+class KlassCellClosure : public StackObj {
+ public:
+  virtual void do_receiver(ReceiverTypeData* data, uint row) = 0;
+  virtual void do_type(ProfileData* data, ByteSize offset) = 0;
+#if INCLUDE_JVMCI
+  virtual void do_method(VirtualCallData* data, uint row) {}
+#endif
+};
+
+template <class T> static void call_type_cells_do(T* data, KlassCellClosure* cl) {
+  if (data->has_arguments()) {
+    for (int i = 0; i < data->number_of_arguments(); i++) {
+      cl->do_type(data, data->argument_type_offset(i));
+    }
+  }
+  if (data->has_return()) {
+    cl->do_type(data, data->return_type_offset());
+  }
+}
+
+static void klass_cells_do(MethodData* mdo, KlassCellClosure* cl) {
+  for (ProfileData* pd = mdo->first_data(); mdo->is_valid(pd); pd = mdo->next_data(pd)) {
+    if (pd->is_ReceiverTypeData()) {
+      ReceiverTypeData* data = pd->as_ReceiverTypeData();
+      for (uint row = 0; row < data->row_limit(); row++) {
+        cl->do_receiver(data, row);
+      }
+    }
+#if INCLUDE_JVMCI
+    if (pd->is_VirtualCallData()) {
+      VirtualCallData* data = pd->as_VirtualCallData();
+      for (uint row = 0; row < data->method_row_limit(); row++) {
+        cl->do_method(data, row);
+      }
+    }
+#endif
+    if (pd->is_CallTypeData()) {
+      call_type_cells_do(pd->as_CallTypeData(), cl);
+    } else if (pd->is_VirtualCallTypeData()) {
+      call_type_cells_do(pd->as_VirtualCallTypeData(), cl);
+    }
+  }
+}
+
+static int cell_index(MethodData* mdo, address cell) {
+  return (int)((cell - mdo->data_base()) / wordSize);
+}
+
+static int counter_value(InvocationCounter* c) {
+  return c->carry() ? (int)InvocationCounter::count_limit : c->count();
+}
+
+static void set_counter_value(InvocationCounter* c, int count) {
+  if (count >= (int)InvocationCounter::count_limit) {
+    c->set(c->state(), InvocationCounter::count_limit - 1);
+    c->set_carry_flag();
+  } else {
+    c->set(c->state(), MAX2(count, 0));
+  }
+}
+
+// Dumping
+
+class ProfileWriter : public StackObj {
+  fileStream* _out;
+ public:
+  ProfileWriter(fileStream* out) : _out(out) {}
+
+  template <typename T> void write(T value) {
+    _out->write((const char*)&value, sizeof(T));
+  }
+  void write_bytes(const void* buf, size_t size) {
+    _out->write((const char*)buf, size);
+  }
+  void write_string(const char* s, int len) {
+    write((u2)len);
+    write_bytes(s, len);
+  }
+  void write_symbol(Symbol* s) {
+    write_string((const char*)s->bytes(), s->utf8_length());
+  }
+};
+
+// Clears the Klass cells of the copy of a data section and collects the
+// klasses that they referred to.
+class SaveKlassCells : public KlassCellClosure {
+  MethodData*                _mdo;
+  intptr_t*                  _copy;
+  GrowableArray<int>         _indices;
+  GrowableArray<Klass*>      _klasses;
+
+  void add(int index, Klass* k) {
+    _indices.append(index);
+    _klasses.append(k);
+  }
+ public:
+  SaveKlassCells(MethodData* mdo, intptr_t* copy) : _mdo(mdo), _copy(copy) {}
+
+  virtual void do_receiver(ReceiverTypeData* data, uint row) {
+    int index = cell_index(_mdo, data->dp() + in_bytes(ReceiverTypeData::receiver_offset(row)));
+    Klass* k = data->receiver(row);
+    _copy[index] = 0;
+    if (k != NULL) {
+      add(index, k);
+    }
+  }
+
+  virtual void do_type(ProfileData* data, ByteSize offset) {
+    address cell = data->dp() + in_bytes(offset);
+    int index = cell_index(_mdo, cell);
+    intptr_t v = *(intptr_t*)cell;
+    _copy[index] = v & TypeEntries::status_bits;
+    Klass* k = TypeEntries::valid_klass(v);
+    if (k != NULL) {
+      add(index, k);
+    }
+  }
+
+#if INCLUDE_JVMCI
+  virtual void do_method(VirtualCallData* data, uint row) {
+    // Method profiles are not saved.
+    _copy[cell_index(_mdo, data->dp() + in_bytes(VirtualCallData::method_offset(row)))] = 0;
+    _copy[cell_index(_mdo, data->dp() + in_bytes(VirtualCallData::method_count_offset(row)))] = 0;
+  }
+#endif
+
+  void write(ProfileWriter* writer) {
+    writer->write((u4)_indices.length());
+    for (int i = 0; i < _indices.length(); i++) {
+      writer->write((u4)_indices.at(i));
+      writer->write_symbol(_klasses.at(i)->name());
+    }
+  }
+};
+
+class DumpProfilesClosure : public KlassClosure {
+  ProfileWriter* _writer;
+  int            _class_count;
+  int            _method_count;
+
+  static bool is_hot(Method* m) {
+    return m->method_data() != NULL && m->method_counters() != NULL &&
+           (m->highest_comp_level() == CompLevel_full_optimization ||
+            m->highest_osr_comp_level() == CompLevel_full_optimization);
+  }
+
+  void write_method(Method* m) {
+    ResourceMark rm;
+    MethodData* mdo = m->method_data();
+    MethodCounters* mcs = m->method_counters();
+    int words = mdo->data_size() / wordSize;
+    intptr_t* copy = NEW_RESOURCE_ARRAY(intptr_t, words);
+    Copy::disjoint_words((HeapWord*)mdo->data_base(), (HeapWord*)copy, words);
+    SaveKlassCells klass_cells(mdo, copy);
+    klass_cells_do(mdo, &klass_cells);
+
+    _writer->write_symbol(m->name());
+    _writer->write_symbol(m->signature());
+    _writer->write((u4)counter_value(mcs->invocation_counter()));
+    _writer->write((u4)counter_value(mcs->backedge_counter()));
+    _writer->write((u4)counter_value(mdo->invocation_counter()));
+    _writer->write((u4)counter_value(mdo->backedge_counter()));
+    _writer->write((u4)mdo->data_size());
+    _writer->write_bytes(copy, words * wordSize);
+    klass_cells.write(_writer);
+  }
+
+ public:
+  DumpProfilesClosure(ProfileWriter* writer) : _writer(writer), _class_count(0), _method_count(0) {}
+
+  int class_count() const  { return _class_count; }
+  int method_count() const { return _method_count; }
+
+  virtual void do_klass(Klass* k) {
+    if (!k->is_instance_klass()) {
+      return;
+    }
+    InstanceKlass* ik = InstanceKlass::cast(k);
+    if (!ik->is_initialized() || ik->is_anonymous() || !ik->has_stored_fingerprint()) {
+      return;
+    }
+    Array<Method*>* methods = ik->methods();
+    int count = 0;
+    for (int i = 0; i < methods->length(); i++) {
+      if (is_hot(methods->at(i))) {
+        count++;
+      }
+    }
+    if (count == 0) {
+      return;
+    }
+    _writer->write_symbol(ik->name());
+    _writer->write((u8)ik->get_stored_fingerprint());
+    _writer->write((u4)count);
+    for (int i = 0; i < methods->length(); i++) {
+      if (is_hot(methods->at(i))) {
+        write_method(methods->at(i));
+      }
+    }
+    _class_count++;
+    _method_count += count;
+  }
+};
+
+class VM_DumpMethodProfiles : public VM_Operation {
+  DumpProfilesClosure* _closure;
+ public:
+  VM_DumpMethodProfiles(DumpProfilesClosure* closure) : _closure(closure) {}
+  VMOp_Type type() const { return VMOp_DumpMethodProfiles; }
+  void doit() {
+    // The Klass cells of the profiles are stable at a safepoint.
+    ClassLoaderDataGraph::loaded_classes_do(_closure);
+  }
+};
+
+bool MethodProfileArchive::dump(const char* file, outputStream* out) {
+  fileStream fs(file, "wb");
+  if (!fs.is_open()) {
+    if (out != NULL) {
+      out->print_cr("Cannot open method profile file %s", file);
+    } else {
+      warning("Cannot open method profile file %s", file);
+    }
+    return false;
+  }
+
+  ProfileWriter writer(&fs);
+  const char* vm_info = VM_Version::internal_vm_info_string();
+  writer.write(METHOD_PROFILES_MAGIC);
+  writer.write(METHOD_PROFILES_VERSION);
+  writer.write_string(vm_info, (int)strlen(vm_info));
+
+  DumpProfilesClosure closure(&writer);
+  VM_DumpMethodProfiles op(&closure);
+  VMThread::execute(&op);
+
+  log_info(jit, profile)("Saved the profiles of %d methods in %d classes to %s",
+                         closure.method_count(), closure.class_count(), file);
+  if (out != NULL) {
+    out->print_cr("Saved the profiles of %d methods in %d classes to %s",
+                  closure.method_count(), closure.class_count(), file);
+  }
+  return true;
+}
+
+// Loading
+
+class ProfileReader : public StackObj {
+  const char* _pos;
+  const char* _end;
+  bool        _error;
+ public:
+  ProfileReader(const char* buf, size_t size) : _pos(buf), _end(buf + size), _error(false) {}
+
+  bool has_error() const { return _error; }
+  void set_error()       { _error = true; }
+  bool at_end() const    { return _pos == _end; }
+
+  template <typename T> T read() {
+    T value = 0;
+    if (!_error && (size_t)(_end - _pos) >= sizeof(T)) {
+      memcpy(&value, _pos, sizeof(T));
+      _pos += sizeof(T);
+    } else {
+      _error = true;
+    }
+    return value;
+  }
+
+  const char* read_bytes(size_t size) {
+    if (_error || (size_t)(_end - _pos) < size) {
+      _error = true;
+      return NULL;
+    }
+    const char* result = _pos;
+    _pos += size;
+    return result;
+  }
+
+  Symbol* read_symbol(TRAPS) {
+    u2 len = read<u2>();
+    const char* bytes = read_bytes(len);
+    if (bytes == NULL) {
+      return NULL;
+    }
+    return SymbolTable::new_symbol(bytes, len, THREAD);
+  }
+};
+
+static void release_symbol(Symbol* s) {
+  if (s != NULL) {
+    s->decrement_refcount();
+  }
+}
+
+// Frees the method profiles of a class, including ones that were only
+// partially read. The array must have been cleared before reading.
+static void free_method_profiles(SavedMethodProfile* methods, int count) {
+  for (int i = 0; i < count; i++) {
+    SavedMethodProfile* mp = &methods[i];
+    release_symbol(mp->_name);
+    release_symbol(mp->_signature);
+    if (mp->_klasses != NULL) {
+      for (int k = 0; k < mp->_klass_count; k++) {
+        release_symbol(mp->_klasses[k]._name);
+      }
+      FREE_C_HEAP_ARRAY(SavedKlassCell, mp->_klasses);
+    }
+    if (mp->_data != NULL) {
+      FREE_C_HEAP_ARRAY(intptr_t, mp->_data);
+    }
+  }
+  FREE_C_HEAP_ARRAY(SavedMethodProfile, methods);
+}
+
+class FreeSavedProfiles : public StackObj {
+ public:
+  bool do_entry(Symbol* const& name, SavedClassProfiles* const& head) {
+    SavedClassProfiles* cp = head;
+    while (cp != NULL) {
+      SavedClassProfiles* next = cp->_next;
+      free_method_profiles(cp->_methods, cp->_method_count);
+      delete cp;
+      release_symbol(name);   // one reference per saved class
+      cp = next;
+    }
+    return true;
+  }
+};
+
+static void free_saved_profiles() {
+  if (_saved_profiles != NULL) {
+    FreeSavedProfiles free_profiles;
+    _saved_profiles->iterate(&free_profiles);
+    delete _saved_profiles;
+    _saved_profiles = NULL;
+  }
+}
+
+// Reads the profiles of the methods of one class. Returns false if the
+// file is corrupt or an exception is pending.
+static bool read_method_profiles(ProfileReader* reader, SavedMethodProfile* methods, int count, TRAPS) {
+  for (int i = 0; i < count; i++) {
+    SavedMethodProfile* mp = &methods[i];
+    mp->_name = reader->read_symbol(CHECK_false);
+    mp->_signature = reader->read_symbol(CHECK_false);
+    mp->_invocation_count = (int)reader->read<u4>();
+    mp->_backedge_count = (int)reader->read<u4>();
+    mp->_mdo_invocation_count = (int)reader->read<u4>();
+    mp->_mdo_backedge_count = (int)reader->read<u4>();
+    mp->_data_size = (int)reader->read<u4>();
+    if (reader->has_error() || mp->_data_size < 0 || !is_aligned(mp->_data_size, wordSize)) {
+      reader->set_error();
+      return false;
+    }
+    const char* data = reader->read_bytes(mp->_data_size);
+    int klass_count = (int)reader->read<u4>();
+    if (data == NULL || klass_count < 0 || klass_count > mp->_data_size / wordSize) {
+      reader->set_error();
+      return false;
+    }
+    mp->_data = NEW_C_HEAP_ARRAY(intptr_t, mp->_data_size / wordSize, mtCompiler);
+    memcpy(mp->_data, data, mp->_data_size);
+    mp->_klasses = NEW_C_HEAP_ARRAY(SavedKlassCell, klass_count, mtCompiler);
+    memset(mp->_klasses, 0, klass_count * sizeof(SavedKlassCell));
+    mp->_klass_count = klass_count;
+    for (int k = 0; k < klass_count; k++) {
+      mp->_klasses[k]._index = (int)reader->read<u4>();
+      mp->_klasses[k]._name = reader->read_symbol(CHECK_false);
+      if (reader->has_error() || mp->_klasses[k]._index < 0 ||
+          mp->_klasses[k]._index >= mp->_data_size / wordSize) {
+        reader->set_error();
+        return false;
+      }
+    }
+  }
+  return !reader->has_error();
+}
+
+bool MethodProfileArchive::parse(const char* buf, size_t size, TRAPS) {
+  ProfileReader reader(buf, size);
+  if (reader.read<juint>() != METHOD_PROFILES_MAGIC ||
+      reader.read<juint>() != METHOD_PROFILES_VERSION) {
+    warning("Ignoring LoadMethodProfiles %s: not a method profile file", LoadMethodProfiles);
+    return false;
+  }
+  const char* vm_info = VM_Version::internal_vm_info_string();
+  u2 len = reader.read<u2>();
+  const char* saved_vm_info = reader.read_bytes(len);
+  if (saved_vm_info == NULL || len != strlen(vm_info) || strncmp(saved_vm_info, vm_info, len) != 0) {
+    warning("Ignoring LoadMethodProfiles %s: it was created by a different VM", LoadMethodProfiles);
+    return false;
+  }
+
+  _saved_profiles = new (ResourceObj::C_HEAP, mtCompiler) SavedProfilesTable();
+  int class_count = 0;
+  int method_count = 0;
+  while (!reader.at_end() && !reader.has_error() && !HAS_PENDING_EXCEPTION) {
+    Symbol* class_name = reader.read_symbol(THREAD);
+    if (class_name == NULL) {
+      break;
+    }
+    uint64_t fingerprint = reader.read<u8>();
+    int count = (int)reader.read<u4>();
+    if (reader.has_error() || count <= 0 || count > max_jushort) {
+      reader.set_error();
+      release_symbol(class_name);
+      break;
+    }
+    SavedMethodProfile* methods = NEW_C_HEAP_ARRAY(SavedMethodProfile, count, mtCompiler);
+    memset(methods, 0, count * sizeof(SavedMethodProfile));
+    if (!read_method_profiles(&reader, methods, count, THREAD)) {
+      free_method_profiles(methods, count);
+      release_symbol(class_name);
+      break;
+    }
+    SavedClassProfiles* cp = new SavedClassProfiles();
+    cp->_fingerprint = fingerprint;
+    cp->_method_count = count;
+    cp->_methods = methods;
+    SavedClassProfiles** head = _saved_profiles->get(class_name);
+    cp->_next = (head != NULL) ? *head : NULL;
+    _saved_profiles->put(class_name, cp);
+    class_count++;
+    method_count += count;
+  }
+
+  if (reader.has_error() || HAS_PENDING_EXCEPTION) {
+    // Do not apply any part of a truncated or corrupt file.
+    if (!HAS_PENDING_EXCEPTION) {
+      warning("Ignoring LoadMethodProfiles %s: the file is corrupt", LoadMethodProfiles);
+    }
+    free_saved_profiles();
+    return false;
+  }
+  log_info(jit, profile)("Loaded the profiles of %d methods in %d classes from %s",
+                         method_count, class_count, LoadMethodProfiles);
+  return true;
+}
+
+void MethodProfileArchive::load(TRAPS) {
+  if (LoadMethodProfiles == NULL) {
+    return;
+  }
+  struct stat st;
+  int fd = -1;
+  if (os::stat(LoadMethodProfiles, &st) == 0) {
+    fd = os::open(LoadMethodProfiles, O_RDONLY | O_BINARY, 0);
+  }
+  if (fd < 0) {
+    char errmsg[JVM_MAXPATHLEN];
+    os::lasterror(errmsg, JVM_MAXPATHLEN);
+    warning("Cannot open LoadMethodProfiles %s: %s", LoadMethodProfiles, errmsg);
+    return;
+  }
+  size_t size = (size_t)st.st_size;
+  char* buf = NEW_C_HEAP_ARRAY(char, size, mtCompiler);
+  size_t n = os::read(fd, buf, (unsigned int)size);
+  os::close(fd);
+  if (n == size) {
+    _has_saved_profiles = parse(buf, size, THREAD);
+    if (HAS_PENDING_EXCEPTION) {
+      // Out of memory for the symbols. Start without the profiles.
+      CLEAR_PENDING_EXCEPTION;
+      _has_saved_profiles = false;
+    }
+  } else {
+    warning("Cannot read LoadMethodProfiles %s", LoadMethodProfiles);
+  }
+  FREE_C_HEAP_ARRAY(char, buf);
+}
+
+// Sets the Klass cells of a restored data section. The Klass cells are
+// visited in the order in which they were saved.
+class RestoreKlassCells : public KlassCellClosure {
+  MethodData*         _mdo;
+  SavedMethodProfile* _saved;
+  Handle              _loader;
+  Thread*             _thread;
+  int                 _next;
+  int                 _unresolved;
+
+  // Returns true if the cell had a klass. *k is set to NULL if the
+  // klass is not loaded by, or visible to, the loader of the holder.
+  bool saved_klass(address cell, Klass** k) {
+    if (_next >= _saved->_klass_count || _saved->_klasses[_next]._index != cell_index(_mdo, cell)) {
+      return false;
+    }
+    Thread* THREAD = _thread;
+    *k = SystemDictionary::find_instance_or_array_klass(_saved->_klasses[_next++]._name,
+                                                        _loader, Handle(), THREAD);
+    if (HAS_PENDING_EXCEPTION) {
+      CLEAR_PENDING_EXCEPTION;
+      *k = NULL;
+    }
+    if (*k == NULL) {
+      _unresolved++;
+    }
+    return true;
+  }
+ public:
+  RestoreKlassCells(MethodData* mdo, SavedMethodProfile* saved, Handle loader, Thread* thread) :
+    _mdo(mdo), _saved(saved), _loader(loader), _thread(thread), _next(0), _unresolved(0) {}
+
+  int unresolved() const { return _unresolved; }
+
+  virtual void do_receiver(ReceiverTypeData* data, uint row) {
+    Klass* k;
+    if (saved_klass(data->dp() + in_bytes(ReceiverTypeData::receiver_offset(row)), &k)) {
+      if (k != NULL) {
+        data->set_receiver(row, k);
+      } else {
+        // Count the receiver as one that did not fit into the rows.
+        data->set_count(data->count() + data->receiver_count(row));
+        data->set_receiver_count(row, 0);
+      }
+    }
+  }
+
+  virtual void do_type(ProfileData* data, ByteSize offset) {
+    address cell = data->dp() + in_bytes(offset);
+    Klass* k;
+    if (saved_klass(cell, &k)) {
+      intptr_t status = *(intptr_t*)cell;
+      *(intptr_t*)cell = (k != NULL) ? TypeEntries::with_status(k, status)
+                                     : TypeEntries::with_status(TypeEntries::type_unknown, status);
+    }
+  }
+};
+
+// Checks that the saved data section has the same layout as the one of
+// the MethodData, i.e., the same profile data at the same offsets.
+static bool layout_matches(MethodData* mdo, SavedMethodProfile* saved) {
+  if (mdo->data_size() != saved->_data_size) {
+    return false;
+  }
+  ResourceMark rm;
+  for (ProfileData* pd = mdo->first_data(); mdo->is_valid(pd); pd = mdo->next_data(pd)) {
+    DataLayout* dl = (DataLayout*)((address)saved->_data + mdo->dp_to_di(pd->dp()));
+    if (dl->tag() != pd->data()->tag() || dl->bci() != pd->bci() ||
+        dl->data_in()->cell_count() != pd->cell_count()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool MethodProfileArchive::restore(const methodHandle& mh, SavedMethodProfile* saved, JavaThread* thread) {
+  Thread* THREAD = thread;
+  if (mh->method_data() != NULL) {
+    // The method has already been profiled in this run.
+    return false;
+  }
+  MethodCounters* mcs = Method::build_method_counters(mh(), THREAD);
+  Method::build_interpreter_method_data(mh, THREAD);
+  if (HAS_PENDING_EXCEPTION) {
+    CLEAR_PENDING_EXCEPTION;
+    return false;
+  }
+  MethodData* mdo = mh->method_data();
+  if (mcs == NULL || mdo == NULL) {
+    return false;
+  }
+  if (!layout_matches(mdo, saved)) {
+    if (log_is_enabled(Info, jit, profile)) {
+      ResourceMark rm;
+      log_info(jit, profile)("The profile of %s does not match its MethodData", mh->name_and_sig_as_C_string());
+    }
+    return false;
+  }
+
+  ResourceMark rm(THREAD);
+  // The method may already be running in other threads. Copy whole words
+  // so that they never see a partially written Klass*.
+  Copy::disjoint_words_atomic((HeapWord*)saved->_data, (HeapWord*)mdo->data_base(),
+                              saved->_data_size / wordSize);
+  RestoreKlassCells klass_cells(mdo, saved, Handle(THREAD, mh->method_holder()->class_loader()), THREAD);
+  klass_cells_do(mdo, &klass_cells);
+
+  set_counter_value(mcs->invocation_counter(), saved->_invocation_count);
+  set_counter_value(mcs->backedge_counter(), saved->_backedge_count);
+  set_counter_value(mdo->invocation_counter(), saved->_mdo_invocation_count);
+  set_counter_value(mdo->backedge_counter(), saved->_mdo_backedge_count);
+
+  if (log_is_enabled(Debug, jit, profile)) {
+    ResourceMark rm;
+    log_debug(jit, profile)("Restored the profile of %s (%d unknown classes)",
+                            mh->name_and_sig_as_C_string(), klass_cells.unresolved());
+  }
+  return true;
+}
+
+void MethodProfileArchive::apply(SavedClassProfiles* cp, InstanceKlass* ik, JavaThread* thread) {
+  for (int i = 0; i < cp->_method_count; i++) {
+    SavedMethodProfile* mp = &cp->_methods[i];
+    Method* m = ik->find_method(mp->_name, mp->_signature);
+    if (m == NULL || m->is_native() || m->is_abstract()) {
+      continue;
+    }
+    methodHandle mh(thread, m);
+    if (restore(mh, mp, thread)) {
+      CompilationPolicy::policy()->profile_preloaded(mh, thread);
+    }
+  }
+}
+
+void MethodProfileArchive::class_initialized_impl(InstanceKlass* ik, JavaThread* thread) {
+  if (ik->is_anonymous() || !ik->has_stored_fingerprint()) {
+    return;
+  }
+  SavedClassProfiles** head = _saved_profiles->get(ik->name());
+  if (head == NULL) {
+    return;
+  }
+  for (SavedClassProfiles* cp = *head; cp != NULL; cp = cp->_next) {
+    if (cp->_fingerprint == ik->get_stored_fingerprint()) {
+      apply(cp, ik, thread);
+      return;
+    }
+  }
+  if (log_is_enabled(Info, jit, profile)) {
+    ResourceMark rm;
+    log_info(jit, profile)("Class %s has changed, its saved profiles are ignored", ik->external_name());
+  }
+}
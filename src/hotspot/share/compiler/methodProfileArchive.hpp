@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_VM_COMPILER_METHODPROFILEARCHIVE_HPP
+#define SHARE_VM_COMPILER_METHODPROFILEARCHIVE_HPP
+
+#include "memory/allocation.hpp"
+#include "runtime/handles.hpp"
+#include "utilities/exceptions.hpp"
+
+class InstanceKlass;
+class JavaThread;
+class outputStream;
+class SavedClassProfiles;
+class SavedMethodProfile;
+
+// Support for -XX:DumpMethodProfilesAtExit, -XX:LoadMethodProfiles and the
+// Compiler.dump_profiles diagnostic command.
+//
+// The interpreter and C1 profiles (MethodCounters and the data section of
+// the MethodData) of the methods that have been compiled by C2 are saved
+// to a file, keyed by the name and the fingerprint of the class file of the
+// method holder. Klass pointers in the profile are saved as class names.
+// The file can only be loaded by the same VM build.
+//
+// When a class whose fingerprint matches a saved class is initialized, the
+// saved profiles are copied into fresh MethodData of its methods and the
+// compilation policy is notified, so that the methods can be compiled at
+// the highest tier without warming up first. A profile whose layout does
+// not match the MethodData of the method is ignored, and classes named by
+// the profile that cannot be found are treated as unknown types.
+class MethodProfileArchive : AllStatic {
+  static bool _has_saved_profiles;
+
+  static bool parse(const char* buf, size_t size, TRAPS);
+  static void apply(SavedClassProfiles* profiles, InstanceKlass* ik, JavaThread* thread);
+  static bool restore(const methodHandle& mh, SavedMethodProfile* saved, JavaThread* thread);
+  static void class_initialized_impl(InstanceKlass* ik, JavaThread* thread);
+public:
+  // Read the profiles from LoadMethodProfiles. Called during start-up.
+  static void load(TRAPS);
+
+  // Write the profiles of all hot methods to the file. Returns false and
+  // reports the reason on the output stream if that failed.
+  static bool dump(const char* file, outputStream* out);
+
+  static bool has_saved_profiles() { return _has_saved_profiles; }
+
+  // Called when a class has been initialized.
+  static void class_initialized(InstanceKlass* ik, JavaThread* thread) {
+    if (has_saved_profiles()) {
+      class_initialized_impl(ik, thread);
+    }
+  }
+};
+
+#endif // SHARE_VM_COMPILER_METHODPROFILEARCHIVE_HPP
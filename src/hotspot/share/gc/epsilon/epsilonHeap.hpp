@@ -127,6 +127,9 @@ public:
   virtual oop pin_object(JavaThread* thread, oop obj)    { return obj; }
   virtual void unpin_object(JavaThread* thread, oop obj) { }
 
+  // Objects are never moved, so archived heap objects can be loaded anywhere
+  virtual HeapWord* allocate_loaded_archive_space(size_t word_size) { return allocate_work(word_size); }
+
   // No support for block parsing.
   virtual HeapWord* block_start(const void* addr) const { return NULL;  }
   virtual size_t block_size(const HeapWord* addr) const { return 0;     }
@@ -2365,6 +2365,10 @@ void G1CollectedHeap::print_tracing_info() const {
   concurrent_mark()->print_summary_info();
 }
 
+bool G1CollectedHeap::print_concurrent_class_histogram(outputStream* st) {
+  return concurrent_mark()->print_class_histogram(st);
+}
+
 #ifndef PRODUCT
 // Helpful for debugging RSet issues.
 
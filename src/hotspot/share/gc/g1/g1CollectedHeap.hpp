@@ -1407,6 +1407,8 @@ public:
   // Override
   void print_tracing_info() const;
 
+  virtual bool print_concurrent_class_histogram(outputStream* st);
+
   // The following two methods are helpful for debugging RSet issues.
   void print_cset_rsets() PRODUCT_RETURN;
   void print_all_rsets() PRODUCT_RETURN;
@@ -55,6 +55,7 @@
 #include "include/jvm.h"
 #include "logging/log.hpp"
 #include "memory/allocation.hpp"
+#include "memory/heapInspection.hpp"
 #include "memory/iterator.hpp"
 #include "memory/resourceArea.hpp"
 #include "oops/access.inline.hpp"
@@ -62,6 +63,8 @@
 #include "runtime/atomic.hpp"
 #include "runtime/handles.inline.hpp"
 #include "runtime/java.hpp"
+#include "runtime/mutex.hpp"
+#include "runtime/mutexLocker.hpp"
 #include "runtime/prefetch.inline.hpp"
 #include "services/memTracker.hpp"
 #include "utilities/align.hpp"
@@ -395,7 +398,14 @@ G1ConcurrentMark::G1ConcurrentMark(G1CollectedHeap* g1h,
   _max_concurrent_workers(0),
 
   _region_mark_stats(NEW_C_HEAP_ARRAY(G1RegionMarkStats, _g1h->max_regions(), mtGC)),
-  _top_at_rebuild_starts(NEW_C_HEAP_ARRAY(HeapWord*, _g1h->max_regions(), mtGC))
+  _top_at_rebuild_starts(NEW_C_HEAP_ARRAY(HeapWord*, _g1h->max_regions(), mtGC)),
+
+  _class_histogram(NULL),
+  _class_histogram_missed(0),
+  _class_histogram_time(0.0),
+  _class_histogram_text(NULL),
+  _class_histogram_lock(new Mutex(Mutex::leaf, "G1 Class Histogram Lock", true,
+                                  Monitor::_safepoint_check_never))
 {
   _mark_bitmap_1.initialize(g1h->reserved_region(), prev_bitmap_storage);
   _mark_bitmap_2.initialize(g1h->reserved_region(), next_bitmap_storage);
@@ -565,6 +575,12 @@ void G1ConcurrentMark::reset_marking_for_restart() {
     for (uint i = 0; i < max_regions; i++) {
       _region_mark_stats[i].clear_during_overflow();
     }
+
+    // Marking restarts from the bottom of the heap and scans all marked
+    // objects again.
+    for (uint i = 0; i < _max_num_tasks; ++i) {
+      _tasks[i]->reset_class_histogram();
+    }
   }
 
   clear_has_overflown();
@@ -1175,6 +1191,11 @@ void G1ConcurrentMark::remark() {
       flush_all_task_caches();
     }
 
+    if (G1ConcurrentClassHistogram) {
+      GCTraceTime(Debug, gc, phases) debug("Merge Class Histograms", _gc_timer_cm);
+      merge_class_histograms();
+    }
+
     // Install newly created mark bitmap as "prev".
     swap_mark_bitmaps();
     {
@@ -1755,6 +1776,78 @@ void G1ConcurrentMark::report_object_count(bool mark_completed) {
   }
 }
 
+void G1ConcurrentMark::merge_class_histograms() {
+  assert_at_safepoint_on_vm_thread();
+  delete _class_histogram;
+  _class_histogram = NULL;
+
+#if INCLUDE_SERVICES
+  KlassInfoTable* cit = new (std::nothrow) KlassInfoTable(false);
+  bool success = cit != NULL && !cit->allocation_failed();
+  uintx missed = 0;
+  for (uint i = 0; i < _max_num_tasks; ++i) {
+    KlassInfoTable* task_cit = _tasks[i]->class_histogram();
+    if (success) {
+      success = task_cit != NULL && cit->merge(task_cit);
+      missed += _tasks[i]->class_histogram_missed();
+    }
+    _tasks[i]->release_class_histogram();
+  }
+
+  if (success) {
+    _class_histogram = cit;
+    _class_histogram_missed = missed;
+    _class_histogram_time = os::elapsedTime();
+  } else {
+    log_warning(gc)("Ran out of C-heap; class histogram of concurrent mark discarded");
+    delete cit;
+  }
+#endif // INCLUDE_SERVICES
+}
+
+void G1ConcurrentMark::publish_class_histogram() {
+#if INCLUDE_SERVICES
+  // Classes are only unloaded at safepoints, which cannot start while we are joined.
+  SuspendibleThreadSetJoiner sts_join;
+  if (_class_histogram == NULL) {
+    return;
+  }
+
+  ResourceMark rm;
+  stringStream st;
+  st.print_cr("Live objects in the old generation at the start of the concurrent cycle "
+              "completed at %.3fs:", _class_histogram_time);
+  if (_class_histogram_missed != 0) {
+    st.print_cr("WARNING: Ran out of C-heap; undercounted " UINTX_FORMAT
+                " total instances in data below",
+                _class_histogram_missed);
+  }
+  HeapInspection::print_histogram(_class_histogram, &st);
+  delete _class_histogram;
+  _class_histogram = NULL;
+
+  char* text = os::strdup(st.as_string(), mtGC);
+  if (text == NULL) {
+    return;
+  }
+  char* old_text;
+  {
+    MutexLockerEx ml(_class_histogram_lock, Mutex::_no_safepoint_check_flag);
+    old_text = _class_histogram_text;
+    _class_histogram_text = text;
+  }
+  os::free(old_text);
+#endif // INCLUDE_SERVICES
+}
+
+bool G1ConcurrentMark::print_class_histogram(outputStream* st) {
+  MutexLockerEx ml(_class_histogram_lock, Mutex::_no_safepoint_check_flag);
+  if (_class_histogram_text == NULL) {
+    return false;
+  }
+  st->print_raw(_class_histogram_text);
+  return true;
+}
 
 void G1ConcurrentMark::swap_mark_bitmaps() {
   G1CMBitMap* temp = _prev_mark_bitmap;
@@ -2056,7 +2149,11 @@ void G1ConcurrentMark::concurrent_cycle_abort() {
   reset_marking_for_restart();
   for (uint i = 0; i < _max_num_tasks; ++i) {
     _tasks[i]->clear_region_fields();
+    _tasks[i]->release_class_histogram();
   }
+  // The classes of a histogram merged at Remark may be unloaded by the Full GC.
+  delete _class_histogram;
+  _class_histogram = NULL;
   _first_overflow_barrier_sync.abort();
   _second_overflow_barrier_sync.abort();
   _has_aborted = true;
@@ -2203,7 +2300,36 @@ void G1CMTask::reset(G1CMBitMap* next_mark_bitmap) {
   _termination_start_time_ms     = 0.0;
 
   _mark_stats_cache.reset();
+  reset_class_histogram();
+}
+
+#if INCLUDE_SERVICES
+void G1CMTask::reset_class_histogram() {
+  release_class_histogram();
+  if (G1ConcurrentClassHistogram) {
+    KlassInfoTable* cit = new (std::nothrow) KlassInfoTable(false);
+    if (cit != NULL && cit->allocation_failed()) {
+      delete cit;
+      cit = NULL;
+    }
+    // Without a table, the merged histogram is discarded at Remark.
+    _class_histogram = cit;
+  }
+}
+
+void G1CMTask::release_class_histogram() {
+  delete _class_histogram;
+  _class_histogram = NULL;
+  _class_histogram_missed = 0;
+}
+
+void G1CMTask::record_class_histogram(oop obj) {
+  assert(_class_histogram != NULL, "must have a class histogram");
+  if (!_class_histogram->record_instance(obj)) {
+    _class_histogram_missed++;
+  }
 }
+#endif // INCLUDE_SERVICES
 
 bool G1CMTask::should_exit_termination() {
   regular_clock_call();
@@ -2906,6 +3032,8 @@ G1CMTask::G1CMTask(uint worker_id,
   _next_mark_bitmap(NULL),
   _task_queue(task_queue),
   _mark_stats_cache(mark_stats, max_regions, RegionMarkStatsCacheSize),
+  _class_histogram(NULL),
+  _class_histogram_missed(0),
   _calls(0),
   _time_target_ms(0.0),
   _start_time_ms(0.0),
@@ -32,6 +32,7 @@
 #include "gc/g1/heapRegionSet.hpp"
 #include "gc/shared/taskqueue.hpp"
 #include "memory/allocation.hpp"
+#include "utilities/macros.hpp"
 
 class ConcurrentGCTimer;
 class G1ConcurrentMarkThread;
@@ -42,6 +43,8 @@ class G1ConcurrentMark;
 class G1OldTracer;
 class G1RegionToSpaceMapper;
 class G1SurvivorRegions;
+class KlassInfoTable;
+class Mutex;
 class ThreadClosure;
 
 #ifdef _MSC_VER
@@ -468,6 +471,19 @@ class G1ConcurrentMark : public CHeapObj<mtGC> {
   // means that this region does not be scanned during the rebuilding remembered
   // set phase at all.
   HeapWord* volatile* _top_at_rebuild_starts;
+
+  // Class histogram of the live objects below nTAMS, recorded by the tasks while
+  // scanning if G1ConcurrentClassHistogram is set. The task histograms are merged
+  // at Remark. The merged histogram refers to classes that may be unloaded by the
+  // next Remark or Full GC, so the concurrent mark thread prints it to text, which
+  // is kept until the next completed marking.
+  KlassInfoTable* _class_histogram;
+  uintx           _class_histogram_missed;
+  double          _class_histogram_time;
+  char*           _class_histogram_text;
+  Mutex*          _class_histogram_lock;
+
+  void merge_class_histograms();
 public:
   void add_to_liveness(uint worker_id, oop const obj, size_t size);
   // Liveness of the given region as determined by concurrent marking, i.e. the amount of
@@ -569,6 +585,13 @@ public:
 
   void remark();
 
+  // Prints the class histogram merged at the last Remark to text. Called by the
+  // concurrent mark thread after Remark.
+  void publish_class_histogram();
+  // Prints the class histogram of the last completed marking. Returns false if
+  // there is none.
+  bool print_class_histogram(outputStream* st);
+
   void cleanup();
   // Mark in the previous bitmap. Caution: the prev bitmap is usually read-only, so use
   // this carefully.
@@ -646,6 +669,10 @@ private:
   G1CMTaskQueue*              _task_queue;
 
   G1RegionMarkStatsCache      _mark_stats_cache;
+  // Class histogram of the objects scanned by this task, NULL unless G1ConcurrentClassHistogram
+  KlassInfoTable*             _class_histogram;
+  // Number of objects not recorded in the class histogram for lack of C heap
+  uintx                       _class_histogram_missed;
   // Number of calls to this task
   uint                        _calls;
 
@@ -845,6 +872,14 @@ public:
   Pair<size_t, size_t> flush_mark_stats_cache();
   // Prints statistics associated with this task
   void print_stats();
+
+  // Starts a new class histogram, if G1ConcurrentClassHistogram is set.
+  void reset_class_histogram() NOT_SERVICES_RETURN;
+  // Frees the class histogram.
+  void release_class_histogram() NOT_SERVICES_RETURN;
+  void record_class_histogram(oop obj) NOT_SERVICES_RETURN;
+  KlassInfoTable* class_histogram() const { return _class_histogram; }
+  uintx class_histogram_missed() const    { return _class_histogram_missed; }
 };
 
 // Class that's used to to print out per-region liveness
@@ -163,6 +163,10 @@ inline void G1CMTask::process_grey_task_entry(G1TaskQueueEntry task_entry) {
   assert(task_entry.is_array_slice() || _next_mark_bitmap->is_marked((HeapWord*)task_entry.obj()),
          "Any stolen object should be a slice or marked");
 
+  if (_class_histogram != NULL && !task_entry.is_array_slice()) {
+    record_class_histogram(task_entry.obj());
+  }
+
   if (scan) {
     if (task_entry.is_array_slice()) {
       _words_scanned += _objArray_processor.process_slice(task_entry.slice());
@@ -355,6 +355,10 @@ void G1ConcurrentMarkThread::run_service() {
         }
       }
 
+      if (!_cm->has_aborted() && G1ConcurrentClassHistogram) {
+        _cm->publish_class_histogram();
+      }
+
       if (!_cm->has_aborted()) {
         G1ConcPhase p(G1ConcurrentPhase::REBUILD_REMEMBERED_SETS, this);
         _cm->rebuild_rem_set_concurrently();
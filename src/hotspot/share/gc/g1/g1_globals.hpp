@@ -79,6 +79,11 @@
           "draining concurrent marking work queues.")                       \
           range(1, INT_MAX)                                                 \
                                                                             \
+  product(bool, G1ConcurrentClassHistogram, false,                          \
+          "Record a class histogram of the live objects in the old "        \
+          "generation during concurrent marking, which is printed by "      \
+          "the GC.class_histogram -concurrent diagnostic command")          \
+                                                                            \
   experimental(bool, G1UseReferencePrecleaning, true,                       \
                "Concurrently preclean java.lang.ref.references instances "  \
                "before the Remark pause.")                                  \
@@ -705,6 +705,26 @@ void ParallelScavengeHeap::gen_mangle_unused_area() {
 }
 #endif
 
+HeapWord* ParallelScavengeHeap::allocate_loaded_archive_space(size_t word_size) {
+  MutexLocker ml(Heap_lock);
+  if (old_gen()->used_in_bytes() != 0) {
+    // Only the bottom of the old generation is never moved by a full GC.
+    return NULL;
+  }
+  return old_gen()->allocate(word_size);
+}
+
+void ParallelScavengeHeap::complete_loaded_archive_space(MemRegion range) {
+  // PSOldGen::allocate() only recorded the start of the block.
+  ObjectStartArray* start_array = old_gen()->start_array();
+  HeapWord* p = range.start();
+  while (p < range.end()) {
+    start_array->allocate_block(p);
+    p += oop(p)->size();
+  }
+  assert(p == range.end(), "objects must fill the block");
+}
+
 bool ParallelScavengeHeap::is_scavengable(oop obj) {
   return is_in_young(obj);
 }
@@ -187,6 +187,9 @@ class ParallelScavengeHeap : public CollectedHeap {
   // of the old generation.
   HeapWord* failed_mem_allocate(size_t size);
 
+  HeapWord* allocate_loaded_archive_space(size_t word_size);
+  void complete_loaded_archive_space(MemRegion range);
+
   // Support for System.gc()
   void collect(GCCause::Cause cause);
 
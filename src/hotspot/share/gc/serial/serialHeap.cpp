@@ -27,6 +27,9 @@
 #include "gc/serial/serialHeap.hpp"
 #include "gc/serial/tenuredGeneration.inline.hpp"
 #include "gc/shared/genMemoryPools.hpp"
+#include "gc/shared/space.hpp"
+#include "oops/oop.inline.hpp"
+#include "runtime/mutexLocker.hpp"
 #include "services/memoryManager.hpp"
 
 SerialHeap* SerialHeap::heap() {
@@ -76,6 +79,38 @@ void SerialHeap::initialize_serviceability() {
 
 }
 
+HeapWord* SerialHeap::allocate_loaded_archive_space(size_t word_size) {
+  MutexLocker ml(Heap_lock);
+  TenuredGeneration* old = old_gen();
+  if (old->used() != 0) {
+    // Only the bottom of the old generation is never moved by a full GC.
+    return NULL;
+  }
+  HeapWord* result = old->allocate(word_size, false /* is_tlab */);
+  if (result == NULL) {
+    result = old->expand_and_allocate(word_size, false /* is_tlab */);
+  }
+  return result;
+}
+
+void SerialHeap::complete_loaded_archive_space(MemRegion range) {
+  // The block was allocated as a single block, so the block offset table
+  // only knows its first object. Rebuild its entries object by object, the
+  // way the compaction phase of a full GC does.
+  ContiguousSpace* space = old_gen()->space();
+  assert(range.start() == space->bottom(), "must be at the bottom of the old generation");
+  HeapWord* threshold = space->initialize_threshold();
+  HeapWord* p = range.start();
+  while (p < range.end()) {
+    HeapWord* end = p + oop(p)->size();
+    if (end > threshold) {
+      threshold = space->cross_threshold(p, end);
+    }
+    p = end;
+  }
+  assert(p == range.end(), "objects must fill the block");
+}
+
 GrowableArray<GCMemoryManager*> SerialHeap::memory_managers() {
   GrowableArray<GCMemoryManager*> memory_managers(2);
   memory_managers.append(_young_manager);
@@ -74,6 +74,9 @@ public:
     return static_cast<TenuredGeneration*>(_old_gen);
   }
 
+  virtual HeapWord* allocate_loaded_archive_space(size_t word_size);
+  virtual void complete_loaded_archive_space(MemRegion range);
+
   // Apply "cur->do_oop" or "older->do_oop" to all the oops in objects
   // allocated since the last call to save_marks in the young generation.
   // The "cur" closure is applied to references in the younger generation
@@ -60,7 +60,7 @@ size_t CollectedHeap::_filler_array_max_size = 0;
 template <>
 void EventLogBase<GCMessage>::print(outputStream* st, GCMessage& m) {
   st->print_cr("GC heap %s", m.is_before ? "before" : "after");
-  st->print_raw(m);
+  print_raw_bounded(st, m.buffer(), m.size());
 }
 
 void GCHeapLog::log_heap(CollectedHeap* heap, bool before) {
@@ -69,12 +69,14 @@ void GCHeapLog::log_heap(CollectedHeap* heap, bool before) {
   }
 
   double timestamp = fetch_timestamp();
-  MutexLockerEx ml(&_mutex, Mutex::_no_safepoint_check_flag);
-  int index = compute_log_index();
-  _records[index].thread = NULL; // Its the GC thread so it's not that interesting.
-  _records[index].timestamp = timestamp;
-  _records[index].data.is_before = before;
-  stringStream st(_records[index].data.buffer(), _records[index].data.size());
+  EventRecord* r = begin_log();
+  if (r == NULL) {
+    return;
+  }
+  r->thread = NULL; // Its the GC thread so it's not that interesting.
+  r->timestamp = timestamp;
+  r->data.is_before = before;
+  stringStream st(r->data.buffer(), r->data.size());
 
   st.print_cr("{Heap %s GC invocations=%u (full %u):",
                  before ? "before" : "after",
@@ -83,6 +85,7 @@ void GCHeapLog::log_heap(CollectedHeap* heap, bool before) {
 
   heap->print_on(&st);
   st.print_cr("}");
+  end_log(r);
 }
 
 VirtualSpaceSummary CollectedHeap::create_heap_space_summary() {
@@ -595,6 +598,14 @@ void CollectedHeap::unpin_object(JavaThread* thread, oop obj) {
   ShouldNotReachHere();
 }
 
+HeapWord* CollectedHeap::allocate_loaded_archive_space(size_t word_size) {
+  return NULL;
+}
+
+void CollectedHeap::complete_loaded_archive_space(MemRegion range) {
+  // Do nothing, unless overridden in subclass.
+}
+
 void CollectedHeap::deduplicate_string(oop str) {
   // Do nothing, unless overridden in subclass.
 }
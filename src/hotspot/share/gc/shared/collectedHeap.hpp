@@ -532,6 +532,10 @@ class CollectedHeap : public CHeapObj<mtGC> {
   // Default implementation does nothing.
   virtual void print_tracing_info() const = 0;
 
+  // Print the class histogram of live objects recorded by the last concurrent
+  // marking, if the collector records one. Returns false if there is none.
+  virtual bool print_concurrent_class_histogram(outputStream* st) { return false; }
+
   void print_heap_before_gc();
   void print_heap_after_gc();
 
@@ -592,6 +596,22 @@ class CollectedHeap : public CHeapObj<mtGC> {
   virtual oop pin_object(JavaThread* thread, oop obj);
   virtual void unpin_object(JavaThread* thread, oop obj);
 
+  // Support for loading the archived heap objects of the CDS archive with
+  // collectors that cannot map them into dedicated archive regions. Returns
+  // a block of word_size words at the bottom of the old generation, or NULL
+  // if loading is not supported. The objects copied into the block are kept
+  // alive for the lifetime of the VM (see HeapShared::oops_do), so the GC
+  // must guarantee that they never move. Collectors whose regions can all be
+  // evacuated (Shenandoah, ZGC) and CMS, whose old generation is not compacted
+  // from its bottom, keep this default and ignore the archived heap objects.
+  virtual HeapWord* allocate_loaded_archive_space(size_t word_size);
+
+  // Called once the archived objects have been copied into (or a filler has
+  // been put over) the block returned by allocate_loaded_archive_space(), to
+  // record the start of every object in it in the block offset table of the
+  // old generation, as if the objects had been allocated one by one.
+  virtual void complete_loaded_archive_space(MemRegion range);
+
   // Deduplicate the string, iff the GC supports string deduplication.
   virtual void deduplicate_string(oop str);
 
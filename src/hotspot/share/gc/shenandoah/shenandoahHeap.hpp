@@ -548,6 +548,11 @@ public:
   oop pin_object(JavaThread* thread, oop obj);
   void unpin_object(JavaThread* thread, oop obj);
 
+  // The archived heap objects of the CDS archive are not loaded: they would
+  // have to stay in place for the lifetime of the VM, but every regular
+  // region can be evacuated, and region pinning only lasts as long as a
+  // critical section. See CollectedHeap::allocate_loaded_archive_space().
+
   void sync_pinned_region_status();
   void assert_pinned_region_status() NOT_DEBUG_RETURN;
 
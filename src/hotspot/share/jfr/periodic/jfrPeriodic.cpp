@@ -54,6 +54,7 @@
 #include "runtime/thread.inline.hpp"
 #include "runtime/threadSMR.hpp"
 #include "runtime/sweeper.hpp"
+#include "runtime/timer.hpp"
 #include "runtime/vmThread.hpp"
 #include "services/classLoadingService.hpp"
 #include "services/management.hpp"
@@ -529,6 +530,27 @@ TRACE_REQUEST_FUNC(CompilerConfiguration) {
   event.commit();
 }
 
+TRACE_REQUEST_FUNC(CompileQueueStatistics) {
+  // Emit stats for the C1 and C2 compile queues
+  CompileQueue* queues[] = { CompileBroker::compile_queue(CompLevel_simple),
+                             CompileBroker::compile_queue(CompLevel_full_optimization) };
+  for (size_t i = 0; i < ARRAY_SIZE(queues); i++) {
+    CompileQueue* queue = queues[i];
+    if (queue != NULL) {
+      EventCompileQueueStatistics event;
+      event.set_queue(queue->name());
+      event.set_size(queue->size());
+      event.set_peakSize(queue->peak_size());
+      event.set_addedCount(queue->total_added());
+      event.set_selectedCount(queue->total_selected());
+      event.set_staleCount(queue->total_stale());
+      event.set_totalWaitTime((jlong)TimeHelper::counter_to_millis(queue->total_wait_ticks()));
+      event.set_peakWaitTime((jlong)TimeHelper::counter_to_millis(queue->max_wait_ticks()));
+      event.commit();
+    }
+  }
+}
+
 TRACE_REQUEST_FUNC(CodeCacheStatistics) {
   // Emit stats for all available code heaps
   for (int bt = 0; bt < CodeBlobType::NumTypes; ++bt) {
@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "jfr/periodic/sampling/jfrCPUTimeSampler.hpp"
+
+#if defined(LINUX)
+
+#include "jfr/recorder/service/jfrOptionSet.hpp"
+#include "jfr/support/jfrThreadLocal.hpp"
+#include "logging/log.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/orderAccess.hpp"
+#include "runtime/os.hpp"
+#include "runtime/semaphore.hpp"
+#include "runtime/thread.inline.hpp"
+#include "runtime/threadSMR.hpp"
+#include "utilities/spinYield.hpp"
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+
+// Older headers do not define the Linux specific notification to a thread.
+#ifndef SIGEV_THREAD_ID
+#define SIGEV_THREAD_ID 4
+#endif
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+// The timer functions live in librt on older glibc versions, which the
+// JVM is not linked against. Look them up the same way as clock_gettime.
+typedef int (*timer_create_func_t)(clockid_t, struct sigevent*, timer_t*);
+typedef int (*timer_settime_func_t)(timer_t, int, const struct itimerspec*, struct itimerspec*);
+typedef int (*timer_delete_func_t)(timer_t);
+
+static timer_create_func_t _timer_create = NULL;
+static timer_settime_func_t _timer_settime = NULL;
+static timer_delete_func_t _timer_delete = NULL;
+
+// State of the timer of a thread. Creating, arming and deleting the timer
+// can race between the thread itself (start and exit), and the thread that
+// sets the period, so the state is locked with BUSY while the timer is used.
+// A timer that expires in native code is disarmed and PAUSED until the
+// sampler sees the thread back in Java.
+enum JfrCPUTimerState {
+  CPU_TIMER_NONE = 0,
+  CPU_TIMER_BUSY = 1,
+  CPU_TIMER_ACTIVE = 2,
+  CPU_TIMER_EXITED = 3,
+  CPU_TIMER_PAUSED = 4
+};
+
+static bool _initialized = false;
+static bool _available = false;
+static volatile size_t _period_millis = 0;
+static PosixSemaphore* _requests = NULL;
+
+static bool resolve_timer_functions() {
+  STATIC_ASSERT(sizeof(timer_t) <= sizeof(void*));
+  void* handle = RTLD_DEFAULT;
+  if (dlsym(handle, "timer_create") == NULL) {
+    handle = dlopen("librt.so.1", RTLD_LAZY);
+    if (handle == NULL) {
+      handle = dlopen("librt.so", RTLD_LAZY);
+    }
+    if (handle == NULL) {
+      return false;
+    }
+  }
+  _timer_create = CAST_TO_FN_PTR(timer_create_func_t, dlsym(handle, "timer_create"));
+  _timer_settime = CAST_TO_FN_PTR(timer_settime_func_t, dlsym(handle, "timer_settime"));
+  _timer_delete = CAST_TO_FN_PTR(timer_delete_func_t, dlsym(handle, "timer_delete"));
+  return _timer_create != NULL && _timer_settime != NULL && _timer_delete != NULL;
+}
+
+static jint lock_timer(JfrThreadLocal* tl) {
+  volatile jint* const state_addr = tl->cpu_timer_state_addr();
+  SpinYield yield;
+  while (true) {
+    const jint state = OrderAccess::load_acquire(state_addr);
+    if (state == CPU_TIMER_EXITED) {
+      return state;
+    }
+    if (state != CPU_TIMER_BUSY && Atomic::cmpxchg((jint)CPU_TIMER_BUSY, state_addr, state) == state) {
+      return state;
+    }
+    yield.wait();
+  }
+}
+
+static void unlock_timer(JfrThreadLocal* tl, jint state) {
+  OrderAccess::release_store(tl->cpu_timer_state_addr(), state);
+}
+
+static bool create_timer(JavaThread* jt, JfrThreadLocal* tl) {
+  clockid_t clock;
+  if (os::Linux::pthread_getcpuclockid(jt->osthread()->pthread_id(), &clock) != 0) {
+    return false;
+  }
+  struct sigevent sev;
+  memset(&sev, 0, sizeof(sev));
+  sev.sigev_notify = SIGEV_THREAD_ID;
+  sev.sigev_signo = SIGPROF;
+  sev.sigev_notify_thread_id = jt->osthread()->thread_id();
+  timer_t timer;
+  if (_timer_create(clock, &sev, &timer) != 0) {
+    log_debug(jfr)("Failed to create CPU time timer, errno %d", errno);
+    return false;
+  }
+  tl->set_cpu_timer((void*)timer);
+  return true;
+}
+
+static void arm_timer(JfrThreadLocal* tl, size_t period_millis) {
+  struct itimerspec spec;
+  spec.it_interval.tv_sec = (time_t)(period_millis / MILLIUNITS);
+  spec.it_interval.tv_nsec = (long)((period_millis % MILLIUNITS) * NANOSECS_PER_MILLISEC);
+  spec.it_value = spec.it_interval;
+  _timer_settime((timer_t)tl->cpu_timer(), 0, &spec, NULL);
+}
+
+// Called from the signal handler, so it does not wait for a BUSY timer.
+// The thread then gets another signal after the next period.
+static void pause_timer(JfrThreadLocal* tl) {
+  volatile jint* const state_addr = tl->cpu_timer_state_addr();
+  if (Atomic::cmpxchg((jint)CPU_TIMER_BUSY, state_addr, (jint)CPU_TIMER_ACTIVE) == CPU_TIMER_ACTIVE) {
+    // A zero period disarms the timer.
+    arm_timer(tl, 0);
+    unlock_timer(tl, CPU_TIMER_PAUSED);
+  }
+}
+
+// Must be async-signal-safe. The stack is not walked here, the sampler
+// thread does that after suspending the thread.
+//
+// The signal can interrupt a system call of the thread. SA_RESTART restarts
+// most of them, and the VM and the JDK libraries retry on EINTR, since they
+// already share the thread with other signals. Native code of applications
+// might not, so a timer that expires outside of Java is paused, and the
+// thread gets at most one signal per stretch of native code.
+static void handle_sigprof(int sig, siginfo_t* info, void* context) {
+  const int saved_errno = errno;
+  if (info != NULL && info->si_code == SI_TIMER) {
+    Thread* const t = Thread::current_or_null_safe();
+    if (t != NULL && t->is_Java_thread()) {
+      JavaThread* const jt = (JavaThread*)t;
+      const JavaThreadState state = jt->thread_state();
+      if (state == _thread_in_native || state == _thread_in_native_trans) {
+        pause_timer(jt->jfr_thread_local());
+      } else {
+        volatile jint* const request = jt->jfr_thread_local()->cpu_time_sample_request_addr();
+        if (Atomic::cmpxchg((jint)1, request, (jint)0) == 0) {
+          _requests->signal();
+        }
+      }
+    }
+  }
+  errno = saved_errno;
+}
+
+static bool install_signal_handler() {
+  struct sigaction old_action;
+  if (sigaction(SIGPROF, NULL, &old_action) != 0) {
+    return false;
+  }
+  const address old_handler = (old_action.sa_flags & SA_SIGINFO) != 0 ?
+    CAST_FROM_FN_PTR(address, old_action.sa_sigaction) :
+    CAST_FROM_FN_PTR(address, old_action.sa_handler);
+  if (old_handler != CAST_FROM_FN_PTR(address, SIG_DFL) &&
+      old_handler != CAST_FROM_FN_PTR(address, SIG_IGN)) {
+    // Someone else, e.g. a native profiler, uses SIGPROF.
+    return false;
+  }
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_SIGINFO | SA_RESTART;
+  action.sa_sigaction = handle_sigprof;
+  return sigaction(SIGPROF, &action, NULL) == 0;
+}
+
+static bool initialize() {
+  if (!resolve_timer_functions()) {
+    log_warning(jfr)("Timer functions not found, sampling threads by wall clock time");
+    return false;
+  }
+  _requests = new PosixSemaphore(0);
+  if (!install_signal_handler()) {
+    log_warning(jfr)("SIGPROF is in use, sampling threads by wall clock time");
+    return false;
+  }
+  log_info(jfr)("Sampling threads by CPU time");
+  return true;
+}
+
+static void update_timer(JavaThread* jt, size_t period_millis) {
+  JfrThreadLocal* const tl = jt->jfr_thread_local();
+  const jint state = lock_timer(tl);
+  if (state == CPU_TIMER_EXITED) {
+    return;
+  }
+  jint new_state = state;
+  if (state == CPU_TIMER_NONE && period_millis > 0 && create_timer(jt, tl)) {
+    new_state = CPU_TIMER_ACTIVE;
+  }
+  if (new_state == CPU_TIMER_ACTIVE || new_state == CPU_TIMER_PAUSED) {
+    // A zero period disarms the timer.
+    arm_timer(tl, period_millis);
+    new_state = CPU_TIMER_ACTIVE;
+  }
+  unlock_timer(tl, new_state);
+}
+
+bool JfrCPUTimeSampling::is_active() {
+  return _available && OrderAccess::load_acquire(&_period_millis) > 0;
+}
+
+void JfrCPUTimeSampling::set_period(size_t period_millis) {
+  if (!JfrOptionSet::cpu_time_sampling()) {
+    return;
+  }
+  if (!_initialized) {
+    _available = initialize();
+    _initialized = true;
+  }
+  if (!_available) {
+    return;
+  }
+  OrderAccess::release_store(&_period_millis, period_millis);
+  // Threads that start after the list is taken see the new period.
+  for (JavaThreadIteratorWithHandle jtiwh; JavaThread* jt = jtiwh.next(); ) {
+    update_timer(jt, period_millis);
+  }
+}
+
+void JfrCPUTimeSampling::on_javathread_start(JavaThread* jt) {
+  if (is_active()) {
+    update_timer(jt, OrderAccess::load_acquire(&_period_millis));
+  }
+}
+
+void JfrCPUTimeSampling::on_javathread_exit(JavaThread* jt) {
+  // Not checking _available, which might be set concurrently.
+  if (!JfrOptionSet::cpu_time_sampling()) {
+    return;
+  }
+  JfrThreadLocal* const tl = jt->jfr_thread_local();
+  const jint state = lock_timer(tl);
+  if (state == CPU_TIMER_ACTIVE || state == CPU_TIMER_PAUSED) {
+    _timer_delete((timer_t)tl->cpu_timer());
+    tl->set_cpu_timer(NULL);
+  }
+  unlock_timer(tl, CPU_TIMER_EXITED);
+}
+
+void JfrCPUTimeSampling::resume(JavaThread* jt) {
+  JfrThreadLocal* const tl = jt->jfr_thread_local();
+  if (OrderAccess::load_acquire(tl->cpu_timer_state_addr()) != CPU_TIMER_PAUSED ||
+      jt->thread_state() != _thread_in_Java) {
+    return;
+  }
+  const jint state = lock_timer(tl);
+  if (state != CPU_TIMER_PAUSED) {
+    unlock_timer(tl, state);
+    return;
+  }
+  arm_timer(tl, OrderAccess::load_acquire(&_period_millis));
+  unlock_timer(tl, CPU_TIMER_ACTIVE);
+}
+
+bool JfrCPUTimeSampling::take_request(JavaThread* jt) {
+  volatile jint* const request = jt->jfr_thread_local()->cpu_time_sample_request_addr();
+  return OrderAccess::load_acquire(request) != 0 && Atomic::xchg((jint)0, request) != 0;
+}
+
+void JfrCPUTimeSampling::wait_for_requests(jlong timeout_millis) {
+  assert(_available, "invariant");
+  // Bound the wait, to notice when sampling is disenrolled.
+  timeout_millis = MIN2<jlong>(timeout_millis, MILLIUNITS);
+  struct timespec deadline;
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_sec += timeout_millis / MILLIUNITS;
+  deadline.tv_nsec += (timeout_millis % MILLIUNITS) * NANOSECS_PER_MILLISEC;
+  if (deadline.tv_nsec >= NANOSECS_PER_SEC) {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= NANOSECS_PER_SEC;
+  }
+  _requests->timedwait(deadline);
+}
+
+#else // !LINUX
+
+bool JfrCPUTimeSampling::is_active() {
+  return false;
+}
+
+void JfrCPUTimeSampling::set_period(size_t period_millis) {}
+
+void JfrCPUTimeSampling::on_javathread_start(JavaThread* jt) {}
+
+void JfrCPUTimeSampling::on_javathread_exit(JavaThread* jt) {}
+
+void JfrCPUTimeSampling::resume(JavaThread* jt) {}
+
+bool JfrCPUTimeSampling::take_request(JavaThread* jt) {
+  return false;
+}
+
+void JfrCPUTimeSampling::wait_for_requests(jlong timeout_millis) {
+  ShouldNotReachHere();
+}
+
+#endif // LINUX
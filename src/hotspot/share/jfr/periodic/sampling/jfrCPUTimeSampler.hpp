@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_VM_JFR_PERIODIC_SAMPLING_JFRCPUTIMESAMPLER_HPP
+#define SHARE_VM_JFR_PERIODIC_SAMPLING_JFRCPUTIMESAMPLER_HPP
+
+#include "memory/allocation.hpp"
+
+class JavaThread;
+
+// Execution sampling by CPU time (-XX:FlightRecorderOptions=cputimesampling=true).
+//
+// The Java sampling period is then measured in CPU time used by each thread,
+// instead of in wall clock time. Every Java thread gets a timer on its thread
+// CPU clock, which sends SIGPROF to the thread itself each time it has used
+// up a period. The signal handler only records the request and wakes up the
+// thread sampler, which samples the requesting threads with the usual
+// suspend and stack walk, under crash protection. Busy threads are sampled in
+// proportion to the CPU time they use, and idle threads are not visited at
+// all, so the number of samples is not limited to a few threads per period.
+// A timer that expires while its thread is in native code is paused until
+// the thread is back in Java, to keep signals away from native code.
+//
+// Only supported on Linux. Elsewhere, or if SIGPROF is already in use, the
+// thread sampler keeps sampling by wall clock time.
+class JfrCPUTimeSampling : AllStatic {
+ public:
+  // True if sampling by CPU time is enabled and a Java sampling period is set.
+  static bool is_active();
+
+  // Arms the timers of all Java threads with the given period, 0 disarms them.
+  static void set_period(size_t period_millis);
+
+  static void on_javathread_start(JavaThread* jt);
+  static void on_javathread_exit(JavaThread* jt);
+
+  // Re-arms the timer of a thread that was paused in native code, once the
+  // thread is back in Java.
+  static void resume(JavaThread* jt);
+
+  // Returns true, and clears the request, if the thread has used up a period.
+  static bool take_request(JavaThread* jt);
+
+  // Waits until a thread has used up a period, or the timeout has expired.
+  static void wait_for_requests(jlong timeout_millis);
+};
+
+#endif // SHARE_VM_JFR_PERIODIC_SAMPLING_JFRCPUTIMESAMPLER_HPP
@@ -26,6 +26,7 @@
 #include "jfr/jfrEvents.hpp"
 #include "jfr/recorder/jfrRecorder.hpp"
 #include "jfr/periodic/sampling/jfrCallTrace.hpp"
+#include "jfr/periodic/sampling/jfrCPUTimeSampler.hpp"
 #include "jfr/periodic/sampling/jfrThreadSampler.hpp"
 #include "jfr/recorder/service/jfrOptionSet.hpp"
 #include "jfr/recorder/stacktrace/jfrStackTraceRepository.hpp"
@@ -324,6 +325,7 @@ class JfrThreadSampler : public NonJavaThread {
 
   JavaThread* next_thread(ThreadsList* t_list, JavaThread* first_sampled, JavaThread* current);
   void task_stacktrace(JfrSampleType type, JavaThread** last_thread);
+  bool task_cpu_time_stacktrace();
   JfrThreadSampler(size_t interval_java, size_t interval_native, u4 max_frames);
   ~JfrThreadSampler();
 
@@ -464,7 +466,9 @@ void JfrThreadSampler::run() {
       last_native_ms = last_java_ms;
     }
     _sample.signal();
-    jlong java_interval = _interval_java == 0 ? max_jlong : MAX2<jlong>(_interval_java, 1);
+    // When sampling by CPU time, Java samples are requested by the threads themselves.
+    const bool cpu_time_sampling = JfrCPUTimeSampling::is_active();
+    jlong java_interval = _interval_java == 0 || cpu_time_sampling ? max_jlong : MAX2<jlong>(_interval_java, 1);
     jlong native_interval = _interval_native == 0 ? max_jlong : MAX2<jlong>(_interval_native, 1);
 
     jlong now_ms = get_monotonic_ms();
@@ -483,13 +487,23 @@ void JfrThreadSampler::run() {
 
     jlong sleep_to_next = MIN2<jlong>(next_j, next_n);
 
-    if (sleep_to_next > 0) {
-      os::naked_short_sleep(sleep_to_next);
-    }
-
-    if ((next_j - sleep_to_next) <= 0) {
-      task_stacktrace(JAVA_SAMPLE, &_last_thread_java);
-      last_java_ms = get_monotonic_ms();
+    if (cpu_time_sampling) {
+      if (sleep_to_next > 0) {
+        JfrCPUTimeSampling::wait_for_requests(sleep_to_next);
+      }
+      while (task_cpu_time_stacktrace()) {
+        // more threads have requested a sample
+      }
+      // Woken up early by a request, so the time slept is not known.
+      sleep_to_next = get_monotonic_ms() - now_ms;
+    } else {
+      if (sleep_to_next > 0) {
+        os::naked_short_sleep(sleep_to_next);
+      }
+      if ((next_j - sleep_to_next) <= 0) {
+        task_stacktrace(JAVA_SAMPLE, &_last_thread_java);
+        last_java_ms = get_monotonic_ms();
+      }
     }
     if ((next_n - sleep_to_next) <= 0) {
       task_stacktrace(NATIVE_SAMPLE, &_last_thread_native);
@@ -547,6 +561,41 @@ void JfrThreadSampler::task_stacktrace(JfrSampleType type, JavaThread** last_thr
   }
 }
 
+// Samples the threads that have used up a period of CPU time. Returns true
+// if the sample limit was reached, and more requests might be pending.
+bool JfrThreadSampler::task_cpu_time_stacktrace() {
+  ResourceMark rm;
+  EventExecutionSample samples[MAX_NR_OF_JAVA_SAMPLES];
+  EventNativeMethodSample samples_native[MAX_NR_OF_NATIVE_SAMPLES];
+  JfrThreadSampleClosure sample_task(samples, samples_native);
+
+  uint num_samples = 0;
+  bool limit_reached = false;
+  {
+    MonitorLockerEx tlock(Threads_lock, Mutex::_allow_vm_block_flag);
+    ThreadsListHandle tlh;
+    for (uint i = 0; i < tlh.length(); i++) {
+      if (num_samples == MAX_NR_OF_JAVA_SAMPLES) {
+        limit_reached = true;
+        break;
+      }
+      JavaThread* const current = tlh.thread_at(i);
+      JfrCPUTimeSampling::resume(current);
+      if (current->is_Compiler_thread() || !JfrCPUTimeSampling::take_request(current)) {
+        continue;
+      }
+      if (sample_task.do_sample_thread(current, _frames, _max_frames, JAVA_SAMPLE)) {
+        num_samples++;
+      }
+    }
+  }
+  log_trace(jfr)("JFR CPU time sampling done with %d java samples", sample_task.java_entries());
+  if (num_samples > 0) {
+    sample_task.commit_events(JAVA_SAMPLE);
+  }
+  return limit_reached;
+}
+
 static JfrThreadSampling* _instance = NULL;
 
 JfrThreadSampling& JfrThreadSampling::instance() {
@@ -595,6 +644,7 @@ void JfrThreadSampling::set_sampling_interval(bool java_interval, size_t period)
   }
   if (java_interval) {
     interval_java = period;
+    JfrCPUTimeSampling::set_period(period);
   } else {
     interval_native = period;
   }
@@ -340,6 +340,11 @@ size_t JfrCheckpointManager::write() {
   return processed;
 }
 
+// Unlike write(), there is no epoch shift to synchronize with.
+size_t JfrCheckpointManager::write_flushpoint() {
+  return write_mspace<MutexedWriteOp, CompositeOperation>(_free_list_mspace, _chunkwriter);
+}
+
 size_t JfrCheckpointManager::write_epoch_transition_mspace() {
   return write_mspace<ExclusiveOp, CompositeOperation>(_epoch_transition_mspace, _chunkwriter);
 }
@@ -385,6 +390,17 @@ void JfrCheckpointManager::write_type_set() {
   }
 }
 
+// Writes the artifacts tagged so far in the current epoch, but not yet written
+// to the chunk. The leak profiler's artifacts are left to the rotation.
+// The caller holds the Module_lock and then the stream lock.
+void JfrCheckpointManager::flush_type_set() {
+  assert(!SafepointSynchronize::is_at_safepoint(), "invariant");
+  assert(Module_lock->owned_by_self(), "invariant");
+  assert(JfrStream_lock->owned_by_self(), "invariant");
+  JfrCheckpointWriter writer(true, true, Thread::current());
+  JfrTypeSet::serialize(&writer, NULL, false, true);
+}
+
 void JfrCheckpointManager::write_type_set_for_unloaded_classes() {
   assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint!");
   JfrCheckpointWriter writer(false, true, Thread::current());
@@ -33,6 +33,8 @@
 #include "runtime/thread.inline.hpp"
 
 static jbyteArray _metadata_blob = NULL;
+static u8 metadata_id = 0;       // incremented on each update
+static u8 last_metadata_id = 0;  // the id of the blob written last
 static Semaphore metadata_mutex_semaphore(1);
 
 void JfrMetadataEvent::lock() {
@@ -68,6 +70,7 @@ size_t JfrMetadataEvent::write(JfrChunkWriter& chunkwriter, jlong metadata_offse
   chunkwriter.write((u8)0); // duration
   chunkwriter.write((u8)0); // metadata id
   write_metadata_blob(chunkwriter, _metadata_blob); // payload
+  last_metadata_id = metadata_id;
   unlock(); // open up for java to provide updated metadata
   // fill in size of metadata descriptor event
   const jlong size_written = chunkwriter.current_offset() - metadata_offset;
@@ -75,6 +78,20 @@ size_t JfrMetadataEvent::write(JfrChunkWriter& chunkwriter, jlong metadata_offse
   return size_written;
 }
 
+// Writes the metadata descriptor on a flush, unless the chunk already has the current one.
+// Returns the offset of the descriptor event, or 0 if nothing was written.
+jlong JfrMetadataEvent::flush(JfrChunkWriter& chunkwriter) {
+  assert(chunkwriter.is_valid(), "invariant");
+  lock();
+  if (chunkwriter.metadata_offset() != 0 && last_metadata_id == metadata_id) {
+    unlock();
+    return 0;
+  }
+  const jlong metadata_offset = chunkwriter.current_offset();
+  write(chunkwriter, metadata_offset);
+  return metadata_offset;
+}
+
 void JfrMetadataEvent::update(jbyteArray metadata) {
   JavaThread* thread = (JavaThread*)Thread::current();
   assert(thread->is_Java_thread(), "invariant");
@@ -85,5 +102,6 @@ void JfrMetadataEvent::update(jbyteArray metadata) {
   }
   const oop new_desc_oop = JfrJavaSupport::resolve_non_null(metadata);
   _metadata_blob = new_desc_oop != NULL ? (jbyteArray)JfrJavaSupport::global_jni_handle(new_desc_oop, thread) : NULL;
+  ++metadata_id;
   unlock();
 }
@@ -40,6 +40,7 @@ class JfrMetadataEvent : AllStatic {
   static void lock();
   static void unlock();
   static size_t write(JfrChunkWriter& writer, jlong metadata_offset);
+  static jlong flush(JfrChunkWriter& writer);
   static void update(jbyteArray metadata);
 };
 
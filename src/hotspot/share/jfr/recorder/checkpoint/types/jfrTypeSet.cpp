@@ -75,7 +75,7 @@ static traceid create_symbol_id(traceid artifact_id) {
 }
 
 static bool current_epoch() {
-  return _class_unload;
+  return _class_unload || _flushpoint;
 }
 
 static bool previous_epoch() {
@@ -997,10 +997,11 @@ static size_t teardown() {
   return total_count;
 }
 
-static void setup(JfrCheckpointWriter* writer, JfrCheckpointWriter* leakp_writer, bool class_unload) {
+static void setup(JfrCheckpointWriter* writer, JfrCheckpointWriter* leakp_writer, bool class_unload, bool flushpoint) {
   _writer = writer;
   _leakp_writer = leakp_writer;
   _class_unload = class_unload;
+  _flushpoint = flushpoint;
   if (_artifacts == NULL) {
     _artifacts = new JfrArtifactSet(class_unload);
   } else {
@@ -1012,11 +1013,17 @@ static void setup(JfrCheckpointWriter* writer, JfrCheckpointWriter* leakp_writer
 
 /**
  * Write all "tagged" (in-use) constant artifacts and their dependencies.
+ *
+ * A flushpoint writes the artifacts tagged in the current epoch that are not
+ * yet serialized. Their tag bits are left in place; the serialized bits keep
+ * them from being written again until the next rotation clears them.
  */
-size_t JfrTypeSet::serialize(JfrCheckpointWriter* writer, JfrCheckpointWriter* leakp_writer, bool class_unload) {
+size_t JfrTypeSet::serialize(JfrCheckpointWriter* writer, JfrCheckpointWriter* leakp_writer, bool class_unload, bool flushpoint /* false */) {
   assert(writer != NULL, "invariant");
+  assert(!(class_unload && flushpoint), "invariant");
+  assert(!flushpoint || leakp_writer == NULL, "invariant");
   ResourceMark rm;
-  setup(writer, leakp_writer, class_unload);
+  setup(writer, leakp_writer, class_unload, flushpoint);
   // write order is important because an individual write step
   // might tag an artifact to be written in a subsequent step
   if (!write_klasses()) {
@@ -37,6 +37,7 @@ class JfrChunkState : public JfrCHeapObj {
   int64_t _previous_start_ticks;
   int64_t _previous_start_nanos;
   int64_t _last_checkpoint_offset;
+  int64_t _metadata_offset;
 
   void update_start_ticks();
   void update_start_nanos();
@@ -48,9 +49,14 @@ class JfrChunkState : public JfrCHeapObj {
   void reset();
   int64_t last_checkpoint_offset() const;
   void set_last_checkpoint_offset(int64_t offset);
+  int64_t metadata_offset() const;
+  void set_metadata_offset(int64_t offset);
   int64_t previous_start_ticks() const;
   int64_t previous_start_nanos() const;
   int64_t last_chunk_duration() const;
+  int64_t start_ticks() const;
+  int64_t start_nanos() const;
+  int64_t duration_to_now() const;
   void update_time_to_now();
   void set_path(const char* path);
   const char* path() const;
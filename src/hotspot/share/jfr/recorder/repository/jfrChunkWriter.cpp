@@ -97,6 +97,29 @@ void JfrChunkWriter::write_header(int64_t metadata_offset) {
   this->write_be_at_offset(_chunkstate->previous_start_ticks(), CHUNK_SIZE_OFFSET + (5 * FILEHEADER_SLOT_SIZE));
 }
 
+// Publishes the data written so far to readers of the chunk file.
+// The header then describes a complete chunk ending at the flushpoint,
+// which a reader can parse like a finished one.
+// The chunk size is written last, after all data it covers is on disk.
+void JfrChunkWriter::flushpoint() {
+  assert(this->is_valid(), "invariant");
+  assert(_chunkstate->metadata_offset() != 0, "invariant");
+  const int64_t size = size_written();
+  // last checkpoint event offset
+  this->write_be_at_offset(_chunkstate->last_checkpoint_offset(), CHUNK_SIZE_OFFSET + (1 * FILEHEADER_SLOT_SIZE));
+  // latest metadata event offset
+  this->write_be_at_offset(_chunkstate->metadata_offset(), CHUNK_SIZE_OFFSET + (2 * FILEHEADER_SLOT_SIZE));
+  // start of chunk in nanos since epoch
+  this->write_be_at_offset(_chunkstate->start_nanos(), CHUNK_SIZE_OFFSET + (3 * FILEHEADER_SLOT_SIZE));
+  // duration of chunk in nanos, so far
+  this->write_be_at_offset(_chunkstate->duration_to_now(), CHUNK_SIZE_OFFSET + (4 * FILEHEADER_SLOT_SIZE));
+  // start of chunk in ticks
+  this->write_be_at_offset(_chunkstate->start_ticks(), CHUNK_SIZE_OFFSET + (5 * FILEHEADER_SLOT_SIZE));
+  // chunk size
+  this->write_be_at_offset(size, CHUNK_SIZE_OFFSET);
+  this->flush();
+}
+
 void JfrChunkWriter::set_chunk_path(const char* chunk_path) {
   _chunkstate->set_path(chunk_path);
 }
@@ -113,6 +136,14 @@ void JfrChunkWriter::set_last_checkpoint_offset(int64_t offset) {
   _chunkstate->set_last_checkpoint_offset(offset);
 }
 
+int64_t JfrChunkWriter::metadata_offset() const {
+  return _chunkstate->metadata_offset();
+}
+
+void JfrChunkWriter::set_metadata_offset(int64_t offset) {
+  _chunkstate->set_metadata_offset(offset);
+}
+
 void JfrChunkWriter::time_stamp_chunk_now() {
   _chunkstate->update_time_to_now();
 }
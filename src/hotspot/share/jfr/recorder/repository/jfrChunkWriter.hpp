@@ -51,7 +51,10 @@ class JfrChunkWriter : public JfrChunkWriterBase {
   int64_t size_written() const;
   int64_t last_checkpoint_offset() const;
   void set_last_checkpoint_offset(int64_t offset);
+  int64_t metadata_offset() const;
+  void set_metadata_offset(int64_t offset);
   void time_stamp_chunk_now();
+  void flushpoint();
 };
 
 #endif // SHARE_VM_JFR_RECORDER_REPOSITORY_JFRCHUNKWRITER_HPP
@@ -103,6 +103,14 @@ void JfrOptionSet::set_old_object_queue_size(jlong value) {
   _old_object_queue_size = value;
 }
 
+jlong JfrOptionSet::flush_interval() {
+  return _flush_interval;
+}
+
+void JfrOptionSet::set_flush_interval(jlong millis) {
+  _flush_interval = millis;
+}
+
 u4 JfrOptionSet::stackdepth() {
   return _stack_depth;
 }
@@ -143,6 +151,14 @@ void JfrOptionSet::set_sample_protection(jboolean protection) {
 }
 #endif
 
+bool JfrOptionSet::cpu_time_sampling() {
+  return _cpu_time_sampling == JNI_TRUE;
+}
+
+void JfrOptionSet::set_cpu_time_sampling(jboolean value) {
+  _cpu_time_sampling = value;
+}
+
 bool JfrOptionSet::compressed_integers() {
   // Set this to false for debugging purposes.
   return true;
@@ -171,7 +187,9 @@ const char* const default_sample_threads = "true";
 const char* const default_stack_depth = "64";
 const char* const default_retransform = "true";
 const char* const default_old_object_queue_size = "256";
+const char* const default_flush_interval = "1s";
 DEBUG_ONLY(const char* const default_sample_protection = "false";)
+const char* const default_cpu_time_sampling = "false";
 
 // statics
 static DCmdArgument<char*> _dcmd_repository(
@@ -223,6 +241,13 @@ static DCmdArgument<jlong> _dcmd_old_object_queue_size (
   false,
   default_old_object_queue_size);
 
+static DCmdArgument<NanoTimeArgument> _dcmd_flush_interval(
+  "flushinterval",
+  "Interval at which recorded data is flushed to the disk repository (0 disables)",
+  "NANOTIME",
+  false,
+  default_flush_interval);
+
 static DCmdArgument<bool> _dcmd_sample_threads(
   "samplethreads",
   "Thread sampling enable / disable (only sampling when event enabled and sampling enabled)",
@@ -239,6 +264,13 @@ static DCmdArgument<bool> _dcmd_sample_protection(
   default_sample_protection);
 #endif
 
+static DCmdArgument<bool> _dcmd_cpu_time_sampling(
+  "cputimesampling",
+  "Take execution samples per period of CPU time used by each thread (Linux only, false by default)",
+  "BOOLEAN",
+  false,
+  default_cpu_time_sampling);
+
 static DCmdArgument<jlong> _dcmd_stackdepth(
   "stackdepth",
   "Stack depth for stacktraces (minimum 1, maximum 2048)",
@@ -264,8 +296,10 @@ static void register_parser_options() {
   _parser.add_dcmd_option(&_dcmd_maxchunksize);
   _parser.add_dcmd_option(&_dcmd_stackdepth);
   _parser.add_dcmd_option(&_dcmd_sample_threads);
+  _parser.add_dcmd_option(&_dcmd_cpu_time_sampling);
   _parser.add_dcmd_option(&_dcmd_retransform);
   _parser.add_dcmd_option(&_dcmd_old_object_queue_size);
+  _parser.add_dcmd_option(&_dcmd_flush_interval);
   DEBUG_ONLY(_parser.add_dcmd_option(&_dcmd_sample_protection);)
 }
 
@@ -304,6 +338,7 @@ jlong JfrOptionSet::_thread_buffer_size = 0;
 jlong JfrOptionSet::_memory_size = 0;
 jlong JfrOptionSet::_num_global_buffers = 0;
 jlong JfrOptionSet::_old_object_queue_size = 0;
+jlong JfrOptionSet::_flush_interval = 0;
 u4 JfrOptionSet::_stack_depth = STACK_DEPTH_DEFAULT;
 jboolean JfrOptionSet::_sample_threads = JNI_TRUE;
 jboolean JfrOptionSet::_retransform = JNI_TRUE;
@@ -312,6 +347,7 @@ jboolean JfrOptionSet::_sample_protection = JNI_FALSE;
 #else
 jboolean JfrOptionSet::_sample_protection = JNI_TRUE;
 #endif
+jboolean JfrOptionSet::_cpu_time_sampling = JNI_FALSE;
 
 bool JfrOptionSet::initialize(Thread* thread) {
   register_parser_options();
@@ -321,7 +357,10 @@ bool JfrOptionSet::initialize(Thread* thread) {
   if (_dcmd_retransform.is_set()) {
     set_retransform(_dcmd_retransform.value());
   }
+  set_cpu_time_sampling(_dcmd_cpu_time_sampling.value());
   set_old_object_queue_size(_dcmd_old_object_queue_size.value());
+  const jlong flush_interval_nanos = _dcmd_flush_interval.value()._nanotime;
+  set_flush_interval(flush_interval_nanos > 0 ? MAX2(flush_interval_nanos / (jlong)NANOSECS_PER_MILLISEC, (jlong)1) : 0);
   return adjust_memory_options();
 }
 
@@ -44,10 +44,12 @@ class JfrOptionSet : public AllStatic {
   static jlong _memory_size;
   static jlong _num_global_buffers;
   static jlong _old_object_queue_size;
+  static jlong _flush_interval;
   static u4 _stack_depth;
   static jboolean _sample_threads;
   static jboolean _retransform;
   static jboolean _sample_protection;
+  static jboolean _cpu_time_sampling;
 
   static bool initialize(Thread* thread);
   static bool configure(TRAPS);
@@ -66,6 +68,8 @@ class JfrOptionSet : public AllStatic {
   static void set_num_global_buffers(jlong value);
   static jint old_object_queue_size();
   static void set_old_object_queue_size(jlong value);
+  static jlong flush_interval();
+  static void set_flush_interval(jlong millis);
   static u4 stackdepth();
   static void set_stackdepth(u4 depth);
   static bool sample_threads();
@@ -77,6 +81,8 @@ class JfrOptionSet : public AllStatic {
   static bool allow_event_retransforms();
   static bool sample_protection();
   DEBUG_ONLY(static void set_sample_protection(jboolean protection);)
+  static bool cpu_time_sampling();
+  static void set_cpu_time_sampling(jboolean value);
 
   static bool parse_flight_recorder_option(const JavaVMOption** option, char* delimiter);
   static bool parse_start_flight_recording_option(const JavaVMOption** option, char* delimiter);
@@ -95,7 +95,7 @@ class RotationLock : public StackObj {
       "%s", error_msg);
   }
  public:
-  RotationLock(Thread* thread) : _thread(thread), _acquired(false) {
+  RotationLock(Thread* thread, bool wait = true) : _thread(thread), _acquired(false) {
     assert(_thread != NULL, "invariant");
     if (_thread == rotation_thread) {
       // recursion not supported
@@ -110,6 +110,9 @@ class RotationLock : public StackObj {
         assert(_thread == rotation_thread, "invariant");
         return;
       }
+      if (!wait) {
+        return;
+      }
       if (_thread->is_Java_thread()) {
         // in order to allow the system to move to a safepoint
         MutexLockerEx msg_lock(JfrMsg_lock);
@@ -132,7 +135,7 @@ class RotationLock : public StackObj {
   bool not_acquired() const { return !_acquired; }
 };
 
-static int64_t write_checkpoint_event_prologue(JfrChunkWriter& cw, u8 type_id) {
+static int64_t write_checkpoint_event_prologue(JfrChunkWriter& cw, u8 type_id, bool flushpoint) {
   const int64_t last_cp_offset = cw.last_checkpoint_offset();
   const int64_t delta_to_last_checkpoint = 0 == last_cp_offset ? 0 : last_cp_offset - cw.current_offset();
   cw.reserve(sizeof(u8));
@@ -140,7 +143,7 @@ static int64_t write_checkpoint_event_prologue(JfrChunkWriter& cw, u8 type_id) {
   cw.write(JfrTicks::now());
   cw.write((int64_t)0); // duration
   cw.write(delta_to_last_checkpoint);
-  cw.write<bool>(false); // flushpoint
+  cw.write<bool>(flushpoint);
   cw.write((u4)1); // nof types in this checkpoint
   cw.write(type_id);
   const int64_t number_of_elements_offset = cw.current_offset();
@@ -154,17 +157,19 @@ class WriteCheckpointEvent : public StackObj {
   JfrChunkWriter& _cw;
   u8 _type_id;
   ContentFunctor& _content_functor;
+  bool _flushpoint;
  public:
-  WriteCheckpointEvent(JfrChunkWriter& cw, u8 type_id, ContentFunctor& functor) :
+  WriteCheckpointEvent(JfrChunkWriter& cw, u8 type_id, ContentFunctor& functor, bool flushpoint = false) :
     _cw(cw),
     _type_id(type_id),
-    _content_functor(functor) {
+    _content_functor(functor),
+    _flushpoint(flushpoint) {
     assert(_cw.is_valid(), "invariant");
   }
   bool process() {
     // current_cp_offset is also offset for the event size header field
     const int64_t current_cp_offset = _cw.current_offset();
-    const int64_t num_elements_offset = write_checkpoint_event_prologue(_cw, _type_id);
+    const int64_t num_elements_offset = write_checkpoint_event_prologue(_cw, _type_id, _flushpoint);
     // invocation
     _content_functor.process();
     const u4 number_of_elements = (u4)_content_functor.processed();
@@ -390,14 +395,14 @@ typedef ServiceFunctor<JfrStringPool, &JfrStringPool::write> WriteStringPool;
 typedef WriteCheckpointEvent<WriteStackTraceRepository> WriteStackTraceCheckpoint;
 typedef WriteCheckpointEvent<WriteStringPool> WriteStringPoolCheckpoint;
 
-static void write_stacktrace_checkpoint(JfrStackTraceRepository& stack_trace_repo, JfrChunkWriter& chunkwriter, bool clear) {
+static void write_stacktrace_checkpoint(JfrStackTraceRepository& stack_trace_repo, JfrChunkWriter& chunkwriter, bool clear, bool flushpoint = false) {
   WriteStackTraceRepository write_stacktrace_repo(stack_trace_repo, chunkwriter, clear);
-  WriteStackTraceCheckpoint write_stack_trace_checkpoint(chunkwriter, TYPE_STACKTRACE, write_stacktrace_repo);
+  WriteStackTraceCheckpoint write_stack_trace_checkpoint(chunkwriter, TYPE_STACKTRACE, write_stacktrace_repo, flushpoint);
   write_stack_trace_checkpoint.process();
 }
-static void write_stringpool_checkpoint(JfrStringPool& string_pool, JfrChunkWriter& chunkwriter) {
+static void write_stringpool_checkpoint(JfrStringPool& string_pool, JfrChunkWriter& chunkwriter, bool flushpoint = false) {
   WriteStringPool write_string_pool(string_pool);
-  WriteStringPoolCheckpoint write_string_pool_checkpoint(chunkwriter, TYPE_STRING, write_string_pool);
+  WriteStringPoolCheckpoint write_string_pool_checkpoint(chunkwriter, TYPE_STRING, write_string_pool, flushpoint);
   write_string_pool_checkpoint.process();
 }
 
@@ -525,6 +530,60 @@ void JfrRecorderService::process_full_buffers() {
   }
 }
 
+//
+// flush sequence
+//
+//  try rotation lock ->
+//    lock module lock ->
+//      lock stream lock ->
+//        write non-safepoint dependent types, once per chunk ->
+//          write storage ->
+//            write type set ->
+//              write stack trace checkpoint ->
+//                write string pool checkpoint ->
+//                  write checkpoints ->
+//                    write metadata event, if changed ->
+//                      publish flushpoint in chunk header ->
+//                        release stream lock ->
+//                          release module lock
+//
+// Only data not yet in the chunk is written, so the data up to the
+// flushpoint can be read as a complete chunk. The type set, stack traces
+// and strings are serialized after the storage is written, under the same
+// stream lock, so that the checkpoints following the flushed events cover
+// every artifact these events reference. The safepoint dependent types
+// (threads and thread groups) of the threads alive when the chunk was
+// opened are still only written when the chunk is closed.
+//
+void JfrRecorderService::flush() {
+  // A flush is skipped if a rotation is in progress, the next one will pick up the data.
+  RotationLock rl(Thread::current(), false);
+  if (rl.not_acquired()) {
+    return;
+  }
+  if (!is_recording() || !_chunkwriter.is_valid()) {
+    return;
+  }
+  ResourceMark rm;
+  HandleMark hm;
+  // can safepoint here
+  MutexLocker module_lock(Module_lock);
+  MutexLockerEx stream_lock(JfrStream_lock, Mutex::_no_safepoint_check_flag);
+  if (_chunkwriter.metadata_offset() == 0) {
+    _checkpoint_manager.write_types();
+  }
+  _storage.write();
+  _checkpoint_manager.flush_type_set();
+  write_stacktrace_checkpoint(_stack_trace_repository, _chunkwriter, false, true);
+  write_stringpool_checkpoint(_string_pool, _chunkwriter, true);
+  _checkpoint_manager.write_flushpoint();
+  const int64_t metadata_offset = JfrMetadataEvent::flush(_chunkwriter);
+  if (metadata_offset != 0) {
+    _chunkwriter.set_metadata_offset(metadata_offset);
+  }
+  _chunkwriter.flushpoint();
+}
+
 void JfrRecorderService::scavenge() {
   _storage.scavenge();
 }
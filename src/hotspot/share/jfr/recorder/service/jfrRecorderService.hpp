@@ -69,6 +69,7 @@ class JfrRecorderService : public StackObj {
   void start();
   void rotate(int msgs);
   void process_full_buffers();
+  void flush();
   void scavenge();
   void evaluate_chunk_size_for_rotation();
   static bool is_recording();
@@ -24,11 +24,13 @@
 
 #include "precompiled.hpp"
 #include "jfr/recorder/jfrRecorder.hpp"
+#include "jfr/recorder/service/jfrOptionSet.hpp"
 #include "jfr/recorder/service/jfrPostBox.hpp"
 #include "jfr/recorder/service/jfrRecorderService.hpp"
 #include "jfr/recorder/service/jfrRecorderThread.hpp"
 #include "logging/log.hpp"
 #include "runtime/mutexLocker.hpp"
+#include "runtime/os.hpp"
 #include "runtime/thread.inline.hpp"
 
 //
@@ -50,12 +52,15 @@ void recorderthread_entry(JavaThread* thread, Thread* unused) {
     bool done = false;
     int msgs = 0;
     JfrRecorderService service;
+    // periodic flush of recorded data to the current chunk, 0 means no flushing
+    const jlong flush_interval = JfrOptionSet::flush_interval();
+    jlong last_flush = os::javaTimeNanos();
     MutexLockerEx msg_lock(JfrMsg_lock);
 
     // JFR MESSAGE LOOP PROCESSING - BEGIN
     while (!done) {
       if (post_box.is_empty()) {
-        JfrMsg_lock->wait(false);
+        JfrMsg_lock->wait(false, flush_interval);
       }
       msgs = post_box.collect();
       JfrMsg_lock->unlock();
@@ -68,10 +73,16 @@ void recorderthread_entry(JavaThread* thread, Thread* unused) {
       // Check amount of data written to chunk already
       // if it warrants asking for a new chunk
       service.evaluate_chunk_size_for_rotation();
+      const jlong now = os::javaTimeNanos();
       if (START) {
         service.start();
+        last_flush = now;
       } else if (ROTATE) {
         service.rotate(msgs);
+        last_flush = now;
+      } else if (flush_interval > 0 && (now - last_flush) / NANOSECS_PER_MILLISEC >= flush_interval) {
+        service.flush();
+        last_flush = now;
       }
       JfrMsg_lock->lock();
       post_box.notify_waiters();
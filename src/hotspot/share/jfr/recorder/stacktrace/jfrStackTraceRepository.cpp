@@ -28,7 +28,12 @@
 #include "jfr/recorder/repository/jfrChunkWriter.hpp"
 #include "jfr/recorder/stacktrace/jfrStackTraceRepository.hpp"
 #include "jfr/support/jfrThreadLocal.hpp"
+#include "logging/log.hpp"
+#include "memory/allocation.inline.hpp"
+#include "runtime/atomic.hpp"
 #include "runtime/mutexLocker.hpp"
+#include "runtime/orderAccess.hpp"
+#include "utilities/globalCounter.inline.hpp"
 
 /*
  * There are two separate repository instances.
@@ -39,7 +44,129 @@
 
 static JfrStackTraceRepository* _instance = NULL;
 static JfrStackTraceRepository* _leak_profiler_instance = NULL;
-static traceid _next_id = 0;
+static volatile traceid _next_id = 0;
+
+static traceid next_id() {
+  traceid compare_value;
+  traceid exchange_value;
+  do {
+    compare_value = OrderAccess::load_acquire(&_next_id);
+    exchange_value = compare_value + 1;
+  } while (Atomic::cmpxchg(exchange_value, &_next_id, compare_value) != compare_value);
+  return exchange_value;
+}
+
+/*
+ * Lookups and inserts are lock-free. An entry is pushed onto its bucket chain
+ * with a CAS and is never unlinked, so a chain can be walked while other threads
+ * add to it. Instead of removing entries, the table is replaced as a whole:
+ * with an empty one when the repository is cleared on rotation, and with a
+ * larger copy when it has grown too loaded. The old table is deleted only after
+ * GlobalCounter::write_synchronize(), when no adding thread can still be using it.
+ *
+ * JfrStacktrace_lock serializes writing, clearing and growing.
+ */
+static const u4 table_sizes[] = { 2053, 4099, 8209, 16411, 32771, 65537, 131101, 262147, 524309, 1048583 };
+static const int number_of_table_sizes = sizeof(table_sizes) / sizeof(u4);
+
+// Smallest table size not below the number of entries, up to the largest size.
+static u4 table_size_for(u4 entries) {
+  int index = 0;
+  while (index < number_of_table_sizes - 1 && table_sizes[index] < entries) {
+    ++index;
+  }
+  return table_sizes[index];
+}
+
+class JfrStackTraceRepository::Table : public JfrCHeapObj {
+ private:
+  typedef const JfrStackTrace* volatile Bucket;
+  Bucket* const _buckets;
+  const u4 _size;
+  volatile u4 _entries;
+
+ public:
+  Table(u4 size) : _buckets(NEW_C_HEAP_ARRAY(Bucket, size, mtTracing)), _size(size), _entries(0) {
+    for (u4 i = 0; i < _size; ++i) {
+      _buckets[i] = NULL;
+    }
+  }
+
+  ~Table() {
+    for (u4 i = 0; i < _size; ++i) {
+      const JfrStackTrace* entry = _buckets[i];
+      while (entry != NULL) {
+        const JfrStackTrace* const next = entry->next();
+        delete entry;
+        entry = next;
+      }
+    }
+    FREE_C_HEAP_ARRAY(Bucket, _buckets);
+  }
+
+  u4 size() const { return _size; }
+  u4 entries() const { return _entries; }
+
+  Bucket* bucket(unsigned int hash) const {
+    return &_buckets[hash % _size];
+  }
+
+  const JfrStackTrace* head(u4 index) const {
+    assert(index < _size, "invariant");
+    return OrderAccess::load_acquire(&_buckets[index]);
+  }
+
+  // Walks the chain from 'from' up to, but not including, 'until'.
+  static const JfrStackTrace* find(const JfrStackTrace* from, const JfrStackTrace* until, const JfrStackTrace& stacktrace) {
+    for (const JfrStackTrace* entry = from; entry != until; entry = entry->next()) {
+      if (entry->equals(stacktrace)) {
+        return entry;
+      }
+    }
+    return NULL;
+  }
+
+  static const JfrStackTrace* find_id(const JfrStackTrace* from, traceid id) {
+    for (const JfrStackTrace* entry = from; entry != NULL; entry = entry->next()) {
+      if (entry->id() == id) {
+        return entry;
+      }
+    }
+    return NULL;
+  }
+
+  // Adds a copy of entry, with the same id and written state.
+  void add_copy(const JfrStackTrace* entry) {
+    JfrStackTrace* const copy = new JfrStackTrace(entry->id(), *entry, NULL);
+    copy->_written = entry->_written;
+    Bucket* const b = bucket(copy->hash());
+    const JfrStackTrace* head;
+    do {
+      head = OrderAccess::load_acquire(b);
+      copy->_next = head;
+    } while (Atomic::cmpxchg((const JfrStackTrace*)copy, b, head) != head);
+    Atomic::inc(&_entries);
+  }
+
+  // Pushes entry onto its bucket chain, unless a racing thread has pushed an equal
+  // trace since 'head' was read. Returns the entry that is in the table.
+  const JfrStackTrace* insert(JfrStackTrace* entry, const JfrStackTrace* head) {
+    Bucket* const b = bucket(entry->hash());
+    while (true) {
+      entry->_next = head;
+      const JfrStackTrace* const current = Atomic::cmpxchg((const JfrStackTrace*)entry, b, head);
+      if (current == head) {
+        Atomic::inc(&_entries);
+        return entry;
+      }
+      const JfrStackTrace* const existing = find(current, head, *entry);
+      if (existing != NULL) {
+        return existing;
+      }
+      head = current;
+    }
+  }
+};
 
 JfrStackTraceRepository& JfrStackTraceRepository::instance() {
   assert(_instance != NULL, "invariant");
@@ -51,8 +178,10 @@ static JfrStackTraceRepository& leak_profiler_instance() {
   return *_leak_profiler_instance;
 }
 
-JfrStackTraceRepository::JfrStackTraceRepository() : _last_entries(0), _entries(0) {
-  memset(_table, 0, sizeof(_table));
+JfrStackTraceRepository::JfrStackTraceRepository() : _table(new Table(table_sizes[0])), _last_entries(0) {}
+
+JfrStackTraceRepository::~JfrStackTraceRepository() {
+  delete _table;
 }
 
 JfrStackTraceRepository* JfrStackTraceRepository::create() {
@@ -94,54 +223,87 @@ void JfrStackTraceRepository::destroy() {
 }
 
 bool JfrStackTraceRepository::is_modified() const {
-  return _last_entries != _entries;
+  return _last_entries != entries();
+}
+
+u4 JfrStackTraceRepository::entries() const {
+  return OrderAccess::load_acquire(&_table)->entries();
+}
+
+// Publishes new_table and returns the previous table, which no other thread uses any longer.
+JfrStackTraceRepository::Table* JfrStackTraceRepository::install_table(Table* new_table) {
+  assert(JfrStacktrace_lock->owned_by_self(), "invariant");
+  Table* const old_table = _table;
+  OrderAccess::release_store(&_table, new_table);
+  GlobalCounter::write_synchronize();
+  return old_table;
+}
+
+// Replaces the table with a larger copy when the chains have become long.
+// Entries keep their ids and written state. Entries that other threads add
+// to the old table while it is copied are moved over after it has been retired.
+// Such an entry can duplicate a trace added to the new table in the meantime;
+// both ids are then valid and written.
+void JfrStackTraceRepository::grow_if_needed() {
+  assert(JfrStacktrace_lock->owned_by_self(), "invariant");
+  const Table* const table = _table;
+  const u4 entries = table->entries();
+  if (entries <= 2 * table->size() || table->size() == table_sizes[number_of_table_sizes - 1]) {
+    return;
+  }
+  Table* const new_table = new Table(table_size_for(entries));
+  for (u4 i = 0; i < table->size(); ++i) {
+    for (const JfrStackTrace* entry = table->head(i); entry != NULL; entry = entry->next()) {
+      new_table->add_copy(entry);
+    }
+  }
+  Table* const old_table = install_table(new_table);
+  assert(old_table == table, "invariant");
+  for (u4 i = 0; i < old_table->size(); ++i) {
+    for (const JfrStackTrace* entry = old_table->head(i); entry != NULL; entry = entry->next()) {
+      if (Table::find_id(OrderAccess::load_acquire(new_table->bucket(entry->hash())), entry->id()) == NULL) {
+        new_table->add_copy(entry);
+      }
+    }
+  }
+  delete old_table;
+  log_debug(jfr, system)("Stack trace table grown to %u buckets for %u entries", new_table->size(), new_table->entries());
 }
 
 size_t JfrStackTraceRepository::write(JfrChunkWriter& sw, bool clear) {
-  if (_entries == 0) {
+  if (entries() == 0) {
     return 0;
   }
   MutexLockerEx lock(JfrStacktrace_lock, Mutex::_no_safepoint_check_flag);
-  assert(_entries > 0, "invariant");
+  // When clearing, traces added from now on go into a new table and are written with the next chunk.
+  Table* const table = clear ? install_table(new Table(table_size_for(entries()))) : _table;
+  assert(table->entries() > 0, "invariant");
   int count = 0;
-  for (u4 i = 0; i < TABLE_SIZE; ++i) {
-    JfrStackTrace* stacktrace = _table[i];
-    while (stacktrace != NULL) {
-      JfrStackTrace* next = const_cast<JfrStackTrace*>(stacktrace->next());
+  for (u4 i = 0; i < table->size(); ++i) {
+    for (const JfrStackTrace* stacktrace = table->head(i); stacktrace != NULL; stacktrace = stacktrace->next()) {
       if (stacktrace->should_write()) {
         stacktrace->write(sw);
         ++count;
       }
-      if (clear) {
-        delete stacktrace;
-      }
-      stacktrace = next;
     }
   }
   if (clear) {
-    memset(_table, 0, sizeof(_table));
-    _entries = 0;
+    delete table;
+  } else {
+    grow_if_needed();
   }
-  _last_entries = _entries;
+  _last_entries = entries();
   return count;
 }
 
 size_t JfrStackTraceRepository::clear(JfrStackTraceRepository& repo) {
   MutexLockerEx lock(JfrStacktrace_lock, Mutex::_no_safepoint_check_flag);
-  if (repo._entries == 0) {
+  if (repo.entries() == 0) {
     return 0;
   }
-  for (u4 i = 0; i < TABLE_SIZE; ++i) {
-    JfrStackTrace* stacktrace = repo._table[i];
-    while (stacktrace != NULL) {
-      JfrStackTrace* next = const_cast<JfrStackTrace*>(stacktrace->next());
-      delete stacktrace;
-      stacktrace = next;
-    }
-  }
-  memset(repo._table, 0, sizeof(repo._table));
-  const size_t processed = repo._entries;
-  repo._entries = 0;
+  Table* const table = repo.install_table(new Table(table_size_for(repo.entries())));
+  const size_t processed = table->entries();
+  delete table;
   repo._last_entries = 0;
   return processed;
 }
@@ -198,34 +360,31 @@ void JfrStackTraceRepository::record_for_leak_profiler(JavaThread* thread, int s
 }
 
 traceid JfrStackTraceRepository::add_trace(const JfrStackTrace& stacktrace) {
-  MutexLockerEx lock(JfrStacktrace_lock, Mutex::_no_safepoint_check_flag);
-  const size_t index = stacktrace._hash % TABLE_SIZE;
-  const JfrStackTrace* table_entry = _table[index];
-
-  while (table_entry != NULL) {
-    if (table_entry->equals(stacktrace)) {
-      return table_entry->id();
-    }
-    table_entry = table_entry->next();
+  GlobalCounter::CriticalSection cs(Thread::current());
+  Table* const table = OrderAccess::load_acquire(&_table);
+  const JfrStackTrace* const head = OrderAccess::load_acquire(table->bucket(stacktrace._hash));
+  const JfrStackTrace* const table_entry = Table::find(head, NULL, stacktrace);
+  if (table_entry != NULL) {
+    return table_entry->id();
   }
 
   if (!stacktrace.have_lineno()) {
     return 0;
   }
 
-  traceid id = ++_next_id;
-  _table[index] = new JfrStackTrace(id, stacktrace, _table[index]);
-  ++_entries;
-  return id;
+  // Ids of entries that lose an insertion race to an equal trace are not reused.
+  JfrStackTrace* const new_entry = new JfrStackTrace(next_id(), stacktrace, NULL);
+  const JfrStackTrace* const entry = table->insert(new_entry, head);
+  if (entry != new_entry) {
+    delete new_entry;
+  }
+  return entry->id();
 }
 
 // invariant is that the entry to be resolved actually exists in the table
 const JfrStackTrace* JfrStackTraceRepository::lookup_for_leak_profiler(unsigned int hash, traceid id) {
-  const size_t index = (hash % TABLE_SIZE);
-  const JfrStackTrace* trace = leak_profiler_instance()._table[index];
-  while (trace != NULL && trace->id() != id) {
-    trace = trace->next();
-  }
+  const Table* const table = leak_profiler_instance()._table;
+  const JfrStackTrace* trace = Table::find_id(OrderAccess::load_acquire(table->bucket(hash)), id);
   assert(trace != NULL, "invariant");
   assert(trace->hash() == hash, "invariant");
   assert(trace->id() == id, "invariant");
@@ -36,6 +36,7 @@ class JfrChunkWriter;
 class JfrStackTraceRepository : public JfrCHeapObj {
   friend class JfrRecorder;
   friend class JfrRecorderService;
+  friend class JfrStackTraceRepositoryTest;
   friend class JfrThreadSampleClosure;
   friend class ObjectSampleCheckpoint;
   friend class ObjectSampler;
@@ -44,22 +45,26 @@ class JfrStackTraceRepository : public JfrCHeapObj {
   friend class WriteStackTraceRepository;
 
  private:
-  static const u4 TABLE_SIZE = 2053;
-  JfrStackTrace* _table[TABLE_SIZE];
+  class Table;
+  Table* volatile _table;
   u4 _last_entries;
-  u4 _entries;
 
   JfrStackTraceRepository();
+  ~JfrStackTraceRepository();
   static JfrStackTraceRepository& instance();
   static JfrStackTraceRepository* create();
   bool initialize();
   static void destroy();
 
   bool is_modified() const;
+  u4 entries() const;
   static size_t clear();
   static size_t clear(JfrStackTraceRepository& repo);
   size_t write(JfrChunkWriter& cw, bool clear);
 
+  Table* install_table(Table* new_table);
+  void grow_if_needed();
+
   static const JfrStackTrace* lookup_for_leak_profiler(unsigned int hash, traceid id);
   static void record_for_leak_profiler(JavaThread* thread, int skip = 0);
   static void clear_leak_profiler();
@@ -27,6 +27,7 @@
 #include "jfr/jni/jfrJavaSupport.hpp"
 #include "jfr/leakprofiler/checkpoint/objectSampleCheckpoint.hpp"
 #include "jfr/periodic/jfrThreadCPULoadEvent.hpp"
+#include "jfr/periodic/sampling/jfrCPUTimeSampler.hpp"
 #include "jfr/recorder/jfrRecorder.hpp"
 #include "jfr/recorder/checkpoint/jfrCheckpointManager.hpp"
 #include "jfr/recorder/checkpoint/types/traceid/jfrTraceId.inline.hpp"
@@ -55,6 +56,9 @@ JfrThreadLocal::JfrThreadLocal() :
   _stack_trace_hash(0),
   _stackdepth(0),
   _entering_suspend_flag(0),
+  _cpu_timer(NULL),
+  _cpu_timer_state(0),
+  _cpu_time_sample_request(0),
   _dead(false) {
 
   Thread* thread = Thread::current_or_null();
@@ -94,6 +98,9 @@ void JfrThreadLocal::on_start(Thread* t) {
       send_java_thread_start_event((JavaThread*)t);
     }
   }
+  if (t->is_Java_thread()) {
+    JfrCPUTimeSampling::on_javathread_start((JavaThread*)t);
+  }
   if (t->jfr_thread_local()->has_cached_stack_trace()) {
     t->jfr_thread_local()->clear_cached_stack_trace();
   }
@@ -139,6 +146,7 @@ void JfrThreadLocal::on_exit(Thread* t) {
   assert(!tl->is_dead(), "invariant");
   if (t->is_Java_thread()) {
     JavaThread* const jt = (JavaThread*)t;
+    JfrCPUTimeSampling::on_javathread_exit(jt);
     ObjectSampleCheckpoint::on_thread_exit(jt);
     send_java_thread_end_events(tl->thread_id(), jt);
   }
@@ -50,6 +50,9 @@ class JfrThreadLocal {
   unsigned int _stack_trace_hash;
   mutable u4 _stackdepth;
   volatile jint _entering_suspend_flag;
+  void* _cpu_timer;
+  volatile jint _cpu_timer_state;
+  volatile jint _cpu_time_sample_request;
   bool _dead;
   traceid _parent_trace_id;
 
@@ -166,6 +169,23 @@ class JfrThreadLocal {
     return _entering_suspend_flag != 0;
   }
 
+  // Per-thread CPU time timer, see JfrCPUTimeSampling
+  void* cpu_timer() const {
+    return _cpu_timer;
+  }
+
+  void set_cpu_timer(void* timer) {
+    _cpu_timer = timer;
+  }
+
+  volatile jint* cpu_timer_state_addr() {
+    return &_cpu_timer_state;
+  }
+
+  volatile jint* cpu_time_sample_request_addr() {
+    return &_cpu_time_sample_request;
+  }
+
   u8 data_lost() const {
     return _data_lost;
   }
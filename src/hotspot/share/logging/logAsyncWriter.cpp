@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+#include "precompiled.hpp"
+#include "jvm.h"
+#include "logging/log.hpp"
+#include "logging/logAsyncWriter.hpp"
+#include "logging/logConfiguration.hpp"
+#include "logging/logFileOutput.hpp"
+#include "logging/logTagSet.hpp"
+#include "memory/allocation.inline.hpp"
+#include "runtime/globals.hpp"
+#include "runtime/os.hpp"
+#include "utilities/align.hpp"
+
+// A message in a Buffer. The message text follows the object.
+class AsyncLogWriter::Message {
+ private:
+  LogFileOutput* const _output;
+  const size_t _size;
+  const LogDecorations _decorations;
+
+ public:
+  Message(LogFileOutput* output, const LogDecorations& decorations, size_t size)
+    : _output(output), _size(size), _decorations(decorations) {}
+
+  static size_t size_for(size_t msg_len) {
+    return align_up(sizeof(Message) + msg_len + 1, sizeof(jlong));
+  }
+
+  LogFileOutput* output() const            { return _output; }
+  size_t size() const                      { return _size; }
+  const LogDecorations& decorations() const { return _decorations; }
+  char* message() const                    { return (char*)(this + 1); }
+};
+
+// A bounded buffer of messages, filled by the logging threads
+// and emptied by the writer thread.
+class AsyncLogWriter::Buffer : public CHeapObj<mtLogging> {
+ private:
+  char* const _buf;
+  const size_t _capacity;
+  size_t _pos;
+
+ public:
+  Buffer(size_t capacity)
+    : _buf(NEW_C_HEAP_ARRAY(char, capacity, mtLogging)), _capacity(capacity), _pos(0) {}
+
+  ~Buffer() {
+    FREE_C_HEAP_ARRAY(char, _buf);
+  }
+
+  bool is_empty() const { return _pos == 0; }
+  void reset()          { _pos = 0; }
+
+  bool push_back(LogFileOutput* output, const LogDecorations& decorations, const char* msg) {
+    size_t len = strlen(msg);
+    size_t size = Message::size_for(len);
+    if (size > _capacity - _pos) {
+      return false;
+    }
+    Message* m = ::new (_buf + _pos) Message(output, decorations, size);
+    memcpy(m->message(), msg, len + 1);
+    _pos += size;
+    return true;
+  }
+
+  class Iterator {
+    const Buffer& _buffer;
+    size_t _pos;
+   public:
+    Iterator(const Buffer& buffer) : _buffer(buffer), _pos(0) {}
+    bool is_at_end() const { return _pos >= _buffer._pos; }
+    Message* current() const { return (Message*)(_buffer._buf + _pos); }
+    void next() { _pos += current()->size(); }
+  };
+};
+
+// Stack object that takes the lock of the writer.
+// The lock is never held while doing I/O.
+class AsyncLogLocker : public StackObj {
+ private:
+  Semaphore& _lock;
+ public:
+  AsyncLogLocker(Semaphore& lock) : _lock(lock) {
+    _lock.wait();
+  }
+  ~AsyncLogLocker() {
+    _lock.signal();
+  }
+};
+
+AsyncLogWriter* AsyncLogWriter::_instance = NULL;
+
+AsyncLogWriter::AsyncLogWriter()
+  : _lock(1), _data_available(0),
+    _buffer(new Buffer(AsyncLogBufferSize / 2)),
+    _buffer_staging(new Buffer(AsyncLogBufferSize / 2)),
+    _enqueued(0), _written(0), _write_cycles(0) {
+}
+
+void AsyncLogWriter::initialize() {
+  if (!LogConfiguration::is_async_mode()) {
+    return;
+  }
+  assert(_instance == NULL, "initialize called twice");
+
+  AsyncLogWriter* writer = new AsyncLogWriter();
+  if (os::create_thread(writer, os::os_thread)) {
+    _instance = writer;
+    os::start_thread(writer);
+    log_debug(logging)("Async logging enabled, buffer size " SIZE_FORMAT "K", AsyncLogBufferSize / K);
+  } else {
+    // Keep logging synchronously.
+    log_warning(logging)("Failed to create thread for asynchronous logging");
+    delete writer;
+  }
+}
+
+void AsyncLogWriter::enqueue_locked(LogFileOutput* output, const LogDecorations& decorations, const char* msg) {
+  bool was_empty = _buffer->is_empty();
+  if (_buffer->push_back(output, decorations, msg)) {
+    _enqueued++;
+    if (was_empty) {
+      _data_available.signal();
+    }
+  } else {
+    uint32_t* count = _dropped.get(output);
+    if (count == NULL) {
+      _dropped.put(output, 1);
+    } else {
+      (*count)++;
+    }
+  }
+}
+
+void AsyncLogWriter::enqueue(LogFileOutput& output, const LogDecorations& decorations, const char* msg) {
+  AsyncLogLocker locker(_lock);
+  enqueue_locked(&output, decorations, msg);
+}
+
+void AsyncLogWriter::enqueue(LogFileOutput& output, LogMessageBuffer::Iterator msg_iterator) {
+  // Keep the lines of a multi-part message together.
+  AsyncLogLocker locker(_lock);
+  for (; !msg_iterator.is_at_end(); msg_iterator++) {
+    enqueue_locked(&output, msg_iterator.decorations(), msg_iterator.message());
+  }
+}
+
+class AsyncLogDroppedMover : public StackObj {
+ private:
+  AsyncLogDroppedCounts* _to;
+ public:
+  AsyncLogDroppedMover(AsyncLogDroppedCounts* to) : _to(to) {}
+  bool do_entry(LogFileOutput* const& output, uint32_t const& count) {
+    _to->put(output, count);
+    return true;
+  }
+};
+
+static void report_dropped(LogFileOutput* output, uint32_t count) {
+  char msg[64];
+  jio_snprintf(msg, sizeof(msg), UINT32_FORMAT " messages dropped due to async logging", count);
+  LogDecorations decorations(LogLevel::Warning, LogTagSetMapping<LOG_TAGS(logging)>::tagset(), output->decorators());
+  output->write_blocking(decorations, msg);
+}
+
+class AsyncLogDroppedReporter : public StackObj {
+ public:
+  bool do_entry(LogFileOutput* const& output, uint32_t const& count) {
+    report_dropped(output, count);
+    return true;
+  }
+};
+
+// Writes out the messages that have been added so far.
+void AsyncLogWriter::write() {
+  AsyncLogDroppedCounts dropped;
+  {
+    AsyncLogLocker locker(_lock);
+    Buffer* tmp = _buffer;
+    _buffer = _buffer_staging;
+    _buffer_staging = tmp;
+    // Take over the dropped counts, so that they are reported after
+    // the messages that were added before the buffer overflowed.
+    AsyncLogDroppedMover mover(&dropped);
+    _dropped.unlink(&mover);
+  }
+
+  uint64_t count = 0;
+  for (Buffer::Iterator it(*_buffer_staging); !it.is_at_end(); it.next()) {
+    Message* m = it.current();
+    m->output()->write_blocking(m->decorations(), m->message());
+    count++;
+  }
+  _buffer_staging->reset();
+
+  AsyncLogDroppedReporter reporter;
+  dropped.unlink(&reporter);
+
+  AsyncLogLocker locker(_lock);
+  _written += count;
+  _write_cycles++;
+}
+
+void AsyncLogWriter::run() {
+  this->set_native_thread_name(this->name());
+  while (true) {
+    _data_available.wait();
+    write();
+  }
+}
+
+void AsyncLogWriter::flush_all() {
+  uint64_t target;
+  uint64_t cycles;
+  {
+    AsyncLogLocker locker(_lock);
+    target = _enqueued;
+    cycles = _write_cycles;
+  }
+  while (true) {
+    {
+      AsyncLogLocker locker(_lock);
+      // Also wait for the write() that may be in progress, as it may still
+      // be reporting the dropped counts that it has taken over.
+      if (_written >= target && _write_cycles > cycles) {
+        return;
+      }
+    }
+    // Make sure the writer thread wakes up, even if it missed the data.
+    _data_available.signal();
+    os::naked_short_sleep(1);
+  }
+}
+
+void AsyncLogWriter::flush() {
+  if (_instance != NULL && Thread::current_or_null() != _instance) {
+    _instance->flush_all();
+  }
+}
+
+void AsyncLogWriter::flush_output(LogFileOutput* output) {
+  if (_instance == NULL || Thread::current_or_null() == _instance) {
+    return;
+  }
+  _instance->flush_all();
+  // Messages that were dropped after the last write() are only counted in
+  // _dropped, which must not keep a pointer to the deleted output.
+  uint32_t count = 0;
+  {
+    AsyncLogLocker locker(_instance->_lock);
+    uint32_t* dropped = _instance->_dropped.get(output);
+    if (dropped != NULL) {
+      count = *dropped;
+      _instance->_dropped.remove(output);
+    }
+  }
+  if (count > 0) {
+    report_dropped(output, count);
+  }
+}
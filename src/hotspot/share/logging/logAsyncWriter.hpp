@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+#ifndef SHARE_VM_LOGGING_LOGASYNCWRITER_HPP
+#define SHARE_VM_LOGGING_LOGASYNCWRITER_HPP
+
+#include "logging/logDecorations.hpp"
+#include "logging/logMessageBuffer.hpp"
+#include "runtime/semaphore.hpp"
+#include "runtime/thread.hpp"
+#include "utilities/resourceHash.hpp"
+
+class LogFileOutput;
+
+typedef ResourceHashtable<LogFileOutput*, uint32_t,
+                          primitive_hash<LogFileOutput*>,
+                          primitive_equals<LogFileOutput*>,
+                          17, ResourceObj::C_HEAP, mtLogging> AsyncLogDroppedCounts;
+
+// Asynchronous logging (-Xlog:async).
+//
+// Messages to file outputs are not written by the logging thread. They are
+// copied, together with their decorations, into a bounded buffer, and the
+// AsyncLog Thread writes them to the files. Logging threads therefore never
+// wait for file I/O, which can take very long on a slow or busy disk.
+//
+// The writer uses two buffers of AsyncLogBufferSize / 2 bytes. Logging threads
+// append to one of them, while the writer thread writes out the other one.
+// The lock that protects the buffers is only held for copying a message, or
+// for swapping the buffers. If a message does not fit into the buffer it is
+// dropped, and the number of dropped messages is reported in the output it
+// was meant for once the writer has caught up.
+//
+// Messages to stdout and stderr are always written synchronously.
+class AsyncLogWriter : public NonJavaThread {
+ private:
+  class Message;
+  class Buffer;
+
+  static AsyncLogWriter* _instance;
+
+  Semaphore _lock;            // Protects the buffers, the counters and the dropped counts
+  Semaphore _data_available;  // Signaled when a message is added to an empty buffer
+  Buffer* _buffer;            // Buffer that new messages are added to
+  Buffer* _buffer_staging;    // Buffer that is being written out by the writer thread
+  AsyncLogDroppedCounts _dropped;  // Number of dropped messages per output
+  uint64_t _enqueued;         // Number of messages added to the buffers
+  uint64_t _written;          // Number of messages written out
+  uint64_t _write_cycles;     // Number of completed calls to write()
+
+  AsyncLogWriter();
+
+  void enqueue_locked(LogFileOutput* output, const LogDecorations& decorations, const char* msg);
+  void write();
+  void flush_all();
+
+ public:
+  // Starts the writer thread if -Xlog:async was specified.
+  static void initialize();
+
+  static AsyncLogWriter* instance() { return _instance; }
+
+  // Waits until all messages that were added before the call have been written.
+  static void flush();
+
+  // Like flush(), and also reports the messages to the output that have
+  // been dropped since, and forgets about the output. Must be called
+  // before a log output is deleted.
+  static void flush_output(LogFileOutput* output);
+
+  void enqueue(LogFileOutput& output, const LogDecorations& decorations, const char* msg);
+  void enqueue(LogFileOutput& output, LogMessageBuffer::Iterator msg_iterator);
+
+  void run();
+  char* name() const { return (char*)"AsyncLog Thread"; }
+};
+
+#endif // SHARE_VM_LOGGING_LOGASYNCWRITER_HPP
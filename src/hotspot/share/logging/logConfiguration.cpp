@@ -24,6 +24,7 @@
 #include "precompiled.hpp"
 #include "jvm.h"
 #include "logging/log.hpp"
+#include "logging/logAsyncWriter.hpp"
 #include "logging/logConfiguration.hpp"
 #include "logging/logDecorations.hpp"
 #include "logging/logDecorators.hpp"
@@ -44,6 +45,7 @@ size_t      LogConfiguration::_n_outputs = 0;
 
 LogConfiguration::UpdateListenerFunction* LogConfiguration::_listener_callbacks = NULL;
 size_t      LogConfiguration::_n_listener_callbacks = 0;
+bool        LogConfiguration::_async_mode = false;
 
 // LogFileOutput is the default type of output, its type prefix should be used if no type was specified
 static const char* implicit_output_prefix = LogFileOutput::Prefix;
@@ -207,6 +209,9 @@ void LogConfiguration::delete_output(size_t idx) {
          "idx must be in range 1 < idx < _n_outputs, but idx = " SIZE_FORMAT
          " and _n_outputs = " SIZE_FORMAT, idx, _n_outputs);
   LogOutput* output = _outputs[idx];
+  // Write out the messages to the output that are still buffered. Only
+  // stdout and stderr (idx 0 and 1) are not file outputs.
+  AsyncLogWriter::flush_output(static_cast<LogFileOutput*>(output));
   // Swap places with the last output and shrink the array
   _outputs[idx] = _outputs[--_n_outputs];
   _outputs = REALLOC_C_HEAP_ARRAY(LogOutput*, _outputs, _n_outputs, mtLogging);
@@ -538,6 +543,14 @@ void LogConfiguration::print_command_line_help(outputStream* out) {
                                     " This will cause existing log files to be overwritten.");
   out->cr();
 
+  out->print_cr("Asynchronous logging (off by default):");
+  out->print_cr(" -Xlog:async");
+  out->print_cr("  All log messages to file outputs are written to an intermediate buffer first,"
+                " and are then written to the files by a separate thread."
+                " The buffer size is set with -XX:AsyncLogBufferSize."
+                " Messages are dropped if the buffer is full.");
+  out->cr();
+
   out->print_cr("Some examples:");
   out->print_cr(" -Xlog");
   out->print_cr("\t Log all messages up to 'info' level to stdout with 'uptime', 'levels' and 'tags' decorations.");
@@ -37,6 +37,15 @@ LogDecorations::LogDecorations(LogLevelType level, const LogTagSet &tagset, cons
   create_decorations(decorators);
 }
 
+LogDecorations::LogDecorations(const LogDecorations& other)
+    : _level(other._level), _tagset(other._tagset), _millis(other._millis) {
+  memcpy(_decorations_buffer, other._decorations_buffer, DecorationsBufferSize);
+  for (uint i = 0; i < LogDecorators::Count; i++) {
+    const char* decoration = other._decoration_offset[i];
+    _decoration_offset[i] = decoration == NULL ? NULL : _decorations_buffer + (decoration - other._decorations_buffer);
+  }
+}
+
 void LogDecorations::initialize(jlong vm_start_time) {
   char buffer[1024];
   if (os::get_host_name(buffer, sizeof(buffer))){
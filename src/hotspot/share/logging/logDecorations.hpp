@@ -52,6 +52,10 @@ class LogDecorations {
 
   LogDecorations(LogLevelType level, const LogTagSet& tagset, const LogDecorators& decorators);
 
+  // The decorations point into the buffer of the object, so they have to be
+  // relocated when the decorations are copied (for asynchronous logging).
+  LogDecorations(const LogDecorations& other);
+
   void set_level(LogLevelType level) {
     _level = level;
   }
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "memory/archiveUtils.hpp"
+#include "runtime/globals.hpp"
+#include "utilities/align.hpp"
+#include "utilities/bitMap.inline.hpp"
+
+CHeapBitMap* ArchivePtrMarker::_ptrmap = NULL;
+address* ArchivePtrMarker::_ptr_base = NULL;
+address* ArchivePtrMarker::_ptr_end = NULL;
+
+void ArchivePtrMarker::initialize(address* ptr_base, address* ptr_end) {
+  assert(DumpSharedSpaces, "dump-time only");
+  assert(_ptrmap == NULL, "initialize only once");
+  _ptr_base = ptr_base;
+  _ptr_end = ptr_base;
+  _ptrmap = new CHeapBitMap(mtClassShared);
+  expand_ptr_end(ptr_end);
+}
+
+void ArchivePtrMarker::expand_ptr_end(address* new_ptr_end) {
+  assert(_ptrmap != NULL, "not initialized");
+  assert(_ptr_end <= new_ptr_end, "must not shrink");
+  size_t new_size = new_ptr_end - _ptr_base;
+  if (_ptrmap->size() < new_size) {
+    _ptrmap->resize(new_size);
+  }
+  _ptr_end = new_ptr_end;
+}
+
+void ArchivePtrMarker::mark_pointer(address* ptr_loc) {
+  assert(_ptrmap != NULL, "not initialized");
+  assert(is_aligned(ptr_loc, sizeof(address)), "pointers must be word aligned");
+
+  if (!is_in_range((address)ptr_loc)) {
+    // E.g., a root pointer in libjvm that points into the archive.
+    return;
+  }
+  address value = *ptr_loc;
+  if (value != NULL && is_in_range(value)) {
+    size_t idx = ptr_loc - _ptr_base;
+    assert(idx < _ptrmap->size(), "must be");
+    _ptrmap->set_bit(idx);
+  }
+}
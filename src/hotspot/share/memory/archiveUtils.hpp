@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_VM_MEMORY_ARCHIVEUTILS_HPP
+#define SHARE_VM_MEMORY_ARCHIVEUTILS_HPP
+
+#include "memory/allocation.hpp"
+#include "utilities/bitMap.hpp"
+
+// ArchivePtrMarker records the location of every pointer in the mc/rw/ro/md
+// regions that points back into these regions. For example, when an
+// InstanceKlass k is copied into the archive, the location of k->_name is
+// marked by calling mark_pointer(&k->_name).
+//
+// Bit i of the pointer map corresponds to the word at _ptr_base + i. The map
+// is written into the archive file, so at run time the archive can be mapped
+// at an address other than SharedBaseAddress, and all the marked pointers can
+// be patched in a single pass. See FileMapInfo::relocate_pointers().
+//
+// _ptr_base is fixed, but _ptr_end grows as more of the shared space is committed.
+class ArchivePtrMarker : AllStatic {
+  static CHeapBitMap* _ptrmap;
+  static address*     _ptr_base;
+  static address*     _ptr_end;
+
+  static bool is_in_range(address p) {
+    return (address)_ptr_base <= p && p < (address)_ptr_end;
+  }
+public:
+  static void initialize(address* ptr_base, address* ptr_end);
+  static void expand_ptr_end(address* new_ptr_end);
+
+  // Mark the location ptr_loc if it's inside the archive and contains a
+  // pointer into the archive. NULL pointers and pointers to other memory
+  // (e.g., into libjvm) are not relocated.
+  static void mark_pointer(address* ptr_loc);
+
+  template <typename T>
+  static void mark_pointer(T* ptr_loc) {
+    mark_pointer((address*)ptr_loc);
+  }
+
+  static CHeapBitMap* ptrmap() { return _ptrmap; }
+};
+
+#endif // SHARE_VM_MEMORY_ARCHIVEUTILS_HPP
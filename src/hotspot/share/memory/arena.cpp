@@ -76,7 +76,7 @@ class ChunkPool: public CHeapObj<mtInternal> {
       _num_used++;
       p = get_first();
     }
-    if (p == NULL) p = os::malloc(bytes, mtChunk, CURRENT_PC);
+    if (p == NULL) p = os::malloc(bytes, mtChunk, MALLOC_CURRENT_PC);
     if (p == NULL && alloc_failmode == AllocFailStrategy::EXIT_OOM) {
       vm_exit_out_of_memory(bytes, OOM_MALLOC_ERROR, "ChunkPool::allocate");
     }
@@ -192,7 +192,7 @@ void* Chunk::operator new (size_t requested_size, AllocFailType alloc_failmode,
    case Chunk::init_size:   return ChunkPool::small_pool()->allocate(bytes, alloc_failmode);
    case Chunk::tiny_size:   return ChunkPool::tiny_pool()->allocate(bytes, alloc_failmode);
    default: {
-     void* p = os::malloc(bytes, mtChunk, CALLER_PC);
+     void* p = os::malloc(bytes, mtChunk, MALLOC_CALLER_PC);
      if (p == NULL && alloc_failmode == AllocFailStrategy::EXIT_OOM) {
        vm_exit_out_of_memory(bytes, OOM_MALLOC_ERROR, "Chunk::new");
      }
@@ -298,11 +298,11 @@ void* Arena::operator new (size_t size, const std::nothrow_t&  nothrow_constant)
 
   // dynamic memory type binding
 void* Arena::operator new(size_t size, MEMFLAGS flags) throw() {
-  return (void *) AllocateHeap(size, flags, CALLER_PC);
+  return (void *) AllocateHeap(size, flags, MALLOC_CALLER_PC);
 }
 
 void* Arena::operator new(size_t size, const std::nothrow_t& nothrow_constant, MEMFLAGS flags) throw() {
-  return (void*)AllocateHeap(size, flags, CALLER_PC, AllocFailStrategy::RETURN_NULL);
+  return (void*)AllocateHeap(size, flags, MALLOC_CALLER_PC, AllocFailStrategy::RETURN_NULL);
 }
 
 void Arena::operator delete(void* p) {
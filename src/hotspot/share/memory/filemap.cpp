@@ -33,6 +33,7 @@
 #include "classfile/symbolTable.hpp"
 #include "classfile/systemDictionaryShared.hpp"
 #include "classfile/altHashing.hpp"
+#include "gc/shared/collectedHeap.hpp"
 #include "logging/log.hpp"
 #include "logging/logStream.hpp"
 #include "logging/logMessage.hpp"
@@ -54,6 +55,7 @@
 #include "runtime/vm_version.hpp"
 #include "services/memTracker.hpp"
 #include "utilities/align.hpp"
+#include "utilities/bitMap.inline.hpp"
 #include "utilities/defaultStream.hpp"
 #if INCLUDE_G1GC
 #include "gc/g1/g1CollectedHeap.hpp"
@@ -165,7 +167,8 @@ template <int N> static void get_header_version(char (&header_version) [N]) {
 }
 
 FileMapInfo::FileMapInfo() :
-  _file_open(false), _fd(-1), _file_offset(0), _full_path(NULL), _paths_misc_info(NULL) {
+  _file_open(false), _fd(-1), _file_offset(0), _relocation_delta(0),
+  _full_path(NULL), _paths_misc_info(NULL) {
   assert(_current_info == NULL, "must be singleton"); // not thread safe
   _current_info = this;
   _header = (FileMapHeader*)os::malloc(sizeof(FileMapHeader), mtInternal);
@@ -606,6 +609,11 @@ bool FileMapInfo::init_from_file(int fd) {
     fail_continue("The shared archive file has been truncated.");
     return false;
   }
+  size_t ptrmap_size = BitMap::calc_size_in_bytes(_header->_ptrmap_size_in_bits);
+  if (_header->_ptrmap_file_offset > len || len - _header->_ptrmap_file_offset < ptrmap_size) {
+    fail_continue("The shared archive file has been truncated.");
+    return false;
+  }
 
   _file_offset += (long)n;
 
@@ -774,6 +782,27 @@ size_t FileMapInfo::write_archive_heap_regions(GrowableArray<MemRegion> *heap_me
   return total_size;
 }
 
+// Write the bitmap of the pointers in the core spaces, which is used for
+// relocating the archive if it cannot be mapped at the requested address.
+
+void FileMapInfo::write_pointer_bitmap(BitMap* ptrmap) {
+  align_file_position();
+  if (_file_open) {
+    guarantee(_header->_ptrmap_file_offset == _file_offset, "file offset mismatch.");
+    log_info(cds)("Pointer bitmap: " SIZE_FORMAT " bits, file offset " SIZE_FORMAT_HEX_W(08),
+                  _header->_ptrmap_size_in_bits, _file_offset);
+  } else {
+    _header->_ptrmap_file_offset = _file_offset;
+    _header->_ptrmap_size_in_bits = ptrmap->size();
+  }
+
+  size_t size_in_bytes = ptrmap->size_in_bytes();
+  BitMap::bm_word_t* buffer = NEW_C_HEAP_ARRAY(BitMap::bm_word_t, ptrmap->size_in_words(), mtClassShared);
+  ptrmap->write_to(buffer, size_in_bytes);
+  write_bytes_aligned(buffer, size_in_bytes);
+  FREE_C_HEAP_ARRAY(BitMap::bm_word_t, buffer);
+}
+
 // Dump bytes to file -- at the current file position.
 
 void FileMapInfo::write_bytes(const void* buffer, size_t nbytes) {
@@ -866,21 +895,64 @@ bool FileMapInfo::remap_shared_readonly_as_readwrite() {
 }
 
 // Map the whole region at once, assumed to be allocated contiguously.
-ReservedSpace FileMapInfo::reserve_shared_memory() {
+//
+// If the space cannot be reserved at the requested address (e.g., because of
+// ASLR or because another mapping is in the way), reserve it at any address
+// and relocate the archive. See FileMapInfo::relocate_pointers().
+//
+// With compressed class pointers, the compressed class space is reserved
+// together with the archive, right above it, and returned in class_space_rs.
+// The narrow klass encoding covers both, so reserving the class space
+// separately after the archive has been placed at an arbitrary address would
+// often fail and disable sharing.
+ReservedSpace FileMapInfo::reserve_shared_memory(ReservedSpace* class_space_rs) {
   char* requested_addr = region_addr(0);
-  size_t size = FileMapInfo::core_spaces_size();
+  size_t archive_size = FileMapInfo::core_spaces_size();
+  size_t class_space_size = 0;
+  size_t alignment = os::vm_allocation_granularity();
+#ifdef _LP64
+  if (Metaspace::using_class_space()) {
+    const uint64_t UnscaledClassSpaceMax = (uint64_t(max_juint) + 1);
+    alignment = Metaspace::reserve_alignment();
+    archive_size = align_up(archive_size, alignment);
+    if (archive_size + Metaspace::compressed_class_space_size() <= UnscaledClassSpaceMax &&
+        is_aligned(requested_addr, alignment)) {
+      class_space_size = Metaspace::compressed_class_space_size();
+    }
+  }
+#endif
+  size_t size = archive_size + class_space_size;
 
   // Reserve the space first, then map otherwise map will go right over some
   // other reserved memory (like the code cache).
-  ReservedSpace rs(size, os::vm_allocation_granularity(), false, requested_addr);
+  ReservedSpace rs;
+  if (ArchiveRelocationMode != 1) {
+    rs = ReservedSpace(size, alignment, false, requested_addr);
+  }
   if (!rs.is_reserved()) {
-    fail_continue("Unable to reserve shared space at required address "
-                  INTPTR_FORMAT, p2i(requested_addr));
-    return rs;
+    if (ArchiveRelocationMode == 2) {
+      fail_continue("Unable to reserve shared space at required address "
+                    INTPTR_FORMAT, p2i(requested_addr));
+      return rs;
+    }
+    log_info(cds)("Unable to reserve shared space at required address " INTPTR_FORMAT
+                  ", trying to map at an alternative address", p2i(requested_addr));
+    rs = ReservedSpace(size, MAX2(alignment, Metaspace::reserve_alignment()), false);
+    if (!rs.is_reserved()) {
+      fail_continue("Unable to reserve shared space at alternative address");
+      return rs;
+    }
+    relocate_header((intx)(rs.base() - requested_addr));
   }
   // the reserved virtual memory is for mapping class data sharing archive
   MemTracker::record_virtual_memory_type((address)rs.base(), mtClassShared);
 
+  if (class_space_size > 0) {
+    *class_space_rs = rs.last_part(archive_size);
+    rs = rs.first_part(archive_size);
+    log_info(cds)("Reserved class space at " INTPTR_FORMAT " together with the archive",
+                  p2i(class_space_rs->base()));
+  }
   return rs;
 }
 
@@ -896,8 +968,10 @@ char* FileMapInfo::map_region(int i, char** top_ret) {
   size_t size = align_up(used, alignment);
   char *requested_addr = region_addr(i);
 
-  // If a tool agent is in use (debugging enabled), we must map the address space RW
-  if (JvmtiExport::can_modify_any_class() || JvmtiExport::can_walk_any_space()) {
+  // If a tool agent is in use (debugging enabled), we must map the address space RW.
+  // The same is true if the pointers in the region need to be patched.
+  if (JvmtiExport::can_modify_any_class() || JvmtiExport::can_walk_any_space() ||
+      _relocation_delta != 0) {
     si->_read_only = false;
   }
 
@@ -924,6 +998,80 @@ char* FileMapInfo::map_region(int i, char** top_ret) {
   return base;
 }
 
+// Update the addresses in the header that refer to the core spaces, so the
+// regions are mapped at the reserved address.
+void FileMapInfo::relocate_header(intx delta) {
+  assert(_relocation_delta == 0, "relocate only once");
+  _relocation_delta = delta;
+  for (int i = 0; i < MetaspaceShared::num_core_spaces; i++) {
+    space_at(i)->_addr._base += delta;
+  }
+  _header->_misc_data_patching_start += delta;
+  _header->_read_only_tables_start += delta;
+  _header->_cds_i2i_entry_code_buffers += delta;
+  _header->_shared_path_table = (Array<u8>*)((address)_header->_shared_path_table + delta);
+}
+
+class SharedPointerRelocator: public BitMapClosure {
+  address* _patch_base;
+  intx     _delta;
+  size_t   _count;
+public:
+  SharedPointerRelocator(address* patch_base, intx delta) :
+    _patch_base(patch_base), _delta(delta), _count(0) {}
+
+  bool do_bit(BitMap::idx_t offset) {
+    address* p = _patch_base + offset;
+    if (*p != NULL) {
+      *p += _delta;
+      _count++;
+    }
+    return true; // keep iterating
+  }
+  size_t count() const { return _count; }
+};
+
+// Patch all the pointers in the mapped core spaces that have been marked by
+// ArchivePtrMarker at dump time. This must be done after all the core spaces
+// are mapped, and before any of their contents are accessed.
+bool FileMapInfo::relocate_pointers() {
+  if (_relocation_delta == 0) {
+    return true;
+  }
+
+  jlong start = os::javaTimeNanos();
+  size_t size_in_bits = _header->_ptrmap_size_in_bits;
+  size_t size_in_bytes = BitMap::calc_size_in_bytes(size_in_bits);
+  if (size_in_bits != core_spaces_size() / sizeof(address)) {
+    fail_continue("The shared archive file has an invalid pointer bitmap.");
+    return false;
+  }
+
+  BitMap::bm_word_t* buffer = NEW_C_HEAP_ARRAY_RETURN_NULL(BitMap::bm_word_t,
+                                                           BitMap::calc_size_in_words(size_in_bits),
+                                                           mtClassShared);
+  if (buffer == NULL) {
+    fail_continue("Unable to allocate the pointer bitmap.");
+    return false;
+  }
+  if (lseek(_fd, (long)_header->_ptrmap_file_offset, SEEK_SET) < 0 ||
+      os::read(_fd, buffer, (unsigned int)size_in_bytes) != size_in_bytes) {
+    FREE_C_HEAP_ARRAY(BitMap::bm_word_t, buffer);
+    fail_continue("Unable to read the pointer bitmap.");
+    return false;
+  }
+
+  BitMapView ptrmap(buffer, size_in_bits);
+  SharedPointerRelocator patcher((address*)region_addr(0), _relocation_delta);
+  ptrmap.iterate(&patcher);
+  FREE_C_HEAP_ARRAY(BitMap::bm_word_t, buffer);
+
+  log_info(cds)("Relocated archive by " INTX_FORMAT " bytes: patched " SIZE_FORMAT
+                " pointers in " JLONG_FORMAT " us", _relocation_delta, patcher.count(),
+                (os::javaTimeNanos() - start) / NANOSECS_PER_MICROSEC);
+  return true;
+}
+
 address FileMapInfo::decode_start_address(CDSFileMapRegion* spc, bool with_current_oop_encoding_mode) {
   if (with_current_oop_encoding_mode) {
     return (address)CompressedOops::decode_not_null(offset_of_space(spc));
@@ -983,12 +1131,20 @@ MemRegion FileMapInfo::get_heap_regions_range_with_current_oop_encoding_mode() {
 // regions may be added. GC may mark and update references in the mapped
 // open archive objects.
 void FileMapInfo::map_heap_regions_impl() {
-  if (!MetaspaceShared::is_heap_object_archiving_allowed()) {
-    log_info(cds)("CDS heap data is being ignored. UseG1GC, "
+  if (!MetaspaceShared::is_heap_object_archiving_allowed() &&
+      !MetaspaceShared::is_heap_object_loading_allowed()) {
+    log_info(cds)("CDS heap data is being ignored. "
                   "UseCompressedOops and UseCompressedClassPointers are required.");
     return;
   }
 
+  if (_relocation_delta != 0) {
+    // The archived mirrors and other heap objects refer to Klasses at their
+    // requested addresses, and these references are not covered by the pointer bitmap.
+    log_info(cds)("CDS heap data is being ignored because the archive has been relocated.");
+    return;
+  }
+
   if (JvmtiExport::should_post_class_file_load_hook() && JvmtiExport::has_early_class_hook_env()) {
     ShouldNotReachHere(); // CDS should have been disabled.
     // The archived objects are mapped at JVM start-up, but we don't know if
@@ -1024,6 +1180,11 @@ void FileMapInfo::map_heap_regions_impl() {
     return;
   }
 
+  if (!UseG1GC) {
+    load_heap_regions();
+    return;
+  }
+
   if (narrow_oop_mode() != Universe::narrow_oop_mode() ||
       narrow_oop_base() != Universe::narrow_oop_base() ||
       narrow_oop_shift() != Universe::narrow_oop_shift()) {
@@ -1175,6 +1336,99 @@ bool FileMapInfo::map_heap_data(MemRegion **heap_mem, int first,
   return true;
 }
 
+// The part of the old generation that was allocated by load_heap_regions() but
+// could not be used. It's made parsable by fixup_mapped_heap_regions().
+static MemRegion unused_loaded_heap_range;
+
+//
+// Load the shared string objects and open archive heap objects with collectors
+// other than G1 (see CollectedHeap::allocate_loaded_archive_space).
+//
+// All the archived heap regions are read, back to back, into a single block at
+// the bottom of the old generation. Each region keeps its dump-time layout, so
+// HeapShared::decode_from_archive only needs a per-region delta to find the
+// loaded copy of an archived object. The embedded pointers are patched in
+// patch_archived_heap_embedded_pointers(), as for mapped regions that have
+// been relocated.
+void FileMapInfo::load_heap_regions() {
+  jlong start_time = os::javaTimeNanos();
+  HeapShared::init_narrow_oop_decoding(narrow_oop_base(), narrow_oop_shift());
+
+  size_t total_bytes = 0;
+  for (int i = MetaspaceShared::first_string; i <= MetaspaceShared::last_valid_region; i++) {
+    total_bytes += space_at(i)->_used;
+  }
+  assert(is_aligned(total_bytes, HeapWordSize), "must be");
+
+  HeapWord* bottom = Universe::heap()->allocate_loaded_archive_space(total_bytes / HeapWordSize);
+  if (bottom == NULL) {
+    log_info(cds)("CDS heap data is being ignored. Unable to allocate " SIZE_FORMAT
+                  " bytes at the bottom of the old generation of the %s heap.",
+                  total_bytes, Universe::heap()->name());
+    return;
+  }
+
+  MemRegion* regions = new MemRegion[MetaspaceShared::max_strings +
+                                     MetaspaceShared::max_open_archive_heap_region];
+  address dumptime_starts[MetaspaceShared::max_strings + MetaspaceShared::max_open_archive_heap_region];
+  int num_strings = 0;
+  int num_open = 0;
+  HeapWord* top = bottom;
+  for (int i = MetaspaceShared::first_string; i <= MetaspaceShared::last_valid_region; i++) {
+    CDSFileMapRegion* si = space_at(i);
+    size_t size = si->_used;
+    if (size == 0) {
+      continue;
+    }
+    if (lseek(_fd, (long)si->_file_offset, SEEK_SET) < 0 ||
+        os::read(_fd, top, (unsigned int)size) != size) {
+      log_info(cds)("UseSharedSpaces: Unable to read heap data: region[%d]", i);
+      unused_loaded_heap_range = MemRegion(bottom, total_bytes / HeapWordSize);
+      delete[] regions;
+      return;
+    }
+    if (VerifySharedSpaces && ClassLoader::crc32(0, (const char*)top, (jint)size) != si->_crc) {
+      log_info(cds)("UseSharedSpaces: loaded heap regions are corrupt");
+      unused_loaded_heap_range = MemRegion(bottom, total_bytes / HeapWordSize);
+      delete[] regions;
+      return;
+    }
+    int n = num_strings + num_open;
+    dumptime_starts[n] = start_address_as_decoded_from_archive(si);
+    regions[n] = MemRegion(top, size / HeapWordSize);
+    if (MetaspaceShared::is_string_region(i)) {
+      num_strings ++;
+    } else {
+      num_open ++;
+    }
+    top += size / HeapWordSize;
+  }
+  assert(top == bottom + total_bytes / HeapWordSize, "must be");
+
+  // Register the regions only after all of them have been read, as
+  // start_address_as_decoded_from_archive() uses the registered regions.
+  for (int n = 0; n < num_strings + num_open; n++) {
+    HeapShared::add_loaded_region(dumptime_starts[n], regions[n].start(), regions[n].byte_size());
+  }
+  HeapShared::set_loaded_range(bottom, top);
+  Universe::heap()->complete_loaded_archive_space(MemRegion(bottom, top));
+  _heap_pointers_need_patching = true;
+
+  if (num_strings > 0) {
+    string_ranges = regions;
+    num_string_ranges = num_strings;
+    StringTable::set_shared_string_mapped();
+  }
+  if (num_open > 0) {
+    open_archive_heap_ranges = regions + num_strings;
+    num_open_archive_heap_ranges = num_open;
+    MetaspaceShared::set_open_archive_heap_region_mapped();
+  }
+
+  log_info(cds)("Loaded " SIZE_FORMAT " bytes of heap data at " PTR_FORMAT " in " JLONG_FORMAT " us",
+                total_bytes, p2i(bottom), (os::javaTimeNanos() - start_time) / NANOSECS_PER_MICROSEC);
+}
+
 bool FileMapInfo::verify_mapped_heap_regions(int first, int num) {
   assert(num > 0, "sanity");
   for (int i = first; i < first + num; i++) {
@@ -1211,6 +1465,17 @@ void FileMapInfo::patch_archived_heap_embedded_pointers(MemRegion* ranges, int n
 // This internally allocates objects using SystemDictionary::Object_klass(), so it
 // must be called after the well-known classes are resolved.
 void FileMapInfo::fixup_mapped_heap_regions() {
+  if (!UseG1GC) {
+    // The loaded heap regions are parsable, but a block that could not be
+    // loaded must be filled.
+    if (!unused_loaded_heap_range.is_empty()) {
+      CollectedHeap::fill_with_objects(unused_loaded_heap_range.start(),
+                                       unused_loaded_heap_range.word_size());
+      Universe::heap()->complete_loaded_archive_space(unused_loaded_heap_range);
+    }
+    return;
+  }
+
   // If any string regions were found, call the fill routine to make them parseable.
   // Note that string_ranges may be non-NULL even if no ranges were found.
   if (num_string_ranges != 0) {
@@ -40,6 +40,10 @@
 //  read-only space
 //  misc data (block offset table, string table, symbols, dictionary, etc.)
 //  tag(666)
+//  ... archived heap regions
+//  bitmap of the pointers in the core spaces, for relocating the archive at run time
+
+class BitMap;
 
 static const int JVM_IDENT_MAX = 256;
 
@@ -110,6 +114,8 @@ struct FileMapHeader : public CDSFileMapHeaderBase {
   size_t  _core_spaces_size;        // number of bytes allocated by the core spaces
                                     // (mc, md, ro, rw and od).
   MemRegion _heap_reserved;         // reserved region for the entire heap at dump time.
+  size_t  _ptrmap_file_offset;      // file offset of the bitmap for relocating the archive
+  size_t  _ptrmap_size_in_bits;     // one bit for each word in the core spaces
 
   // The following fields are all sanity checks for whether this archive
   // will function correctly with this JVM and the bootclasspath it's
@@ -177,6 +183,7 @@ private:
   bool    _file_open;
   int     _fd;
   size_t  _file_offset;
+  intx    _relocation_delta;        // mapped address - requested address of the core spaces
 
 private:
   static Array<u8>*            _shared_path_table;
@@ -246,6 +253,7 @@ public:
   }
   void set_core_spaces_size(size_t s)    {  _header->_core_spaces_size = s; }
   size_t core_spaces_size()              { return _header->_core_spaces_size; }
+  intx relocation_delta() const          { return _relocation_delta; }
 
   static FileMapInfo* current_info() {
     CDS_ONLY(return _current_info;)
@@ -264,6 +272,7 @@ public:
   size_t write_archive_heap_regions(GrowableArray<MemRegion> *heap_mem,
                                     GrowableArray<ArchiveHeapOopmapInfo> *oopmaps,
                                     int first_region_id, int max_num_regions);
+  void  write_pointer_bitmap(BitMap* ptrmap);
   void  write_bytes(const void* buffer, size_t count);
   void  write_bytes_aligned(const void* buffer, size_t count);
   char* map_region(int i, char** top_ret);
@@ -277,9 +286,10 @@ public:
   MemRegion get_heap_regions_range_with_current_oop_encoding_mode() NOT_CDS_JAVA_HEAP_RETURN_(MemRegion());
   void  unmap_region(int i);
   bool  verify_region_checksum(int i);
+  bool  relocate_pointers();
   void  close();
   bool  is_open() { return _file_open; }
-  ReservedSpace reserve_shared_memory();
+  ReservedSpace reserve_shared_memory(ReservedSpace* class_space_rs);
 
   // JVM/TI RedefineClasses() support:
   // Remap the shared readonly space to shared readwrite, private.
@@ -328,6 +338,8 @@ public:
   bool  map_heap_data(MemRegion **heap_mem, int first, int max, int* num,
                       bool is_open = false) NOT_CDS_JAVA_HEAP_RETURN_(false);
   bool  verify_mapped_heap_regions(int first, int num) NOT_CDS_JAVA_HEAP_RETURN_(false);
+  void  load_heap_regions() NOT_CDS_JAVA_HEAP_RETURN;
+  void  relocate_header(intx delta);
   void  dealloc_archive_heap_regions(MemRegion* regions, int num, bool is_open) NOT_CDS_JAVA_HEAP_RETURN;
 
   CDSFileMapRegion* space_at(int i) {
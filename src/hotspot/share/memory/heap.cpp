@@ -211,7 +211,16 @@ bool CodeHeap::reserve(ReservedSpace rs, size_t committed_size, size_t segment_s
 
   // Reserve and initialize space for _memory.
   size_t page_size = os::vm_page_size();
-  if (os::can_execute_large_page_memory()) {
+  bool commit_large_pages = false;
+  const size_t large_page_size = os::code_large_page_size();
+  if (UseLargePagesInCodeCache && large_page_size > (size_t)os::vm_page_size() &&
+      is_aligned(rs.base(), large_page_size) && is_aligned(rs.size(), large_page_size)) {
+    // Commit in whole large pages from the start, also when the initial size is
+    // small, so that all the code (including the stubs generated at startup)
+    // is on large pages.
+    page_size = large_page_size;
+    commit_large_pages = true;
+  } else if (os::can_execute_large_page_memory()) {
     const size_t min_pages = 8;
     page_size = MIN2(os::page_size_for_region_aligned(committed_size, min_pages),
                      os::page_size_for_region_aligned(rs.size(), min_pages));
@@ -222,7 +231,11 @@ bool CodeHeap::reserve(ReservedSpace rs, size_t committed_size, size_t segment_s
 
   os::trace_page_sizes(_name, committed_size, rs.size(), page_size,
                        rs.base(), rs.size());
-  if (!_memory.initialize(rs, c_size)) {
+  if (commit_large_pages) {
+    if (!_memory.initialize_with_granularity(rs, c_size, page_size)) {
+      return false;
+    }
+  } else if (!_memory.initialize(rs, c_size)) {
     return false;
   }
 
@@ -171,7 +171,7 @@ KlassInfoTable::KlassInfoTable(bool add_all_classes) {
   _ref = (HeapWord*) Universe::boolArrayKlassObj();
   _buckets =
     (KlassInfoBucket*)  AllocateHeap(sizeof(KlassInfoBucket) * _num_buckets,
-       mtInternal, CURRENT_PC, AllocFailStrategy::RETURN_NULL);
+       mtInternal, MALLOC_CURRENT_PC, AllocFailStrategy::RETURN_NULL);
   if (_buckets != NULL) {
     _size = _num_buckets;
     for (int index = 0; index < _size; index++) {
@@ -856,6 +856,17 @@ void HeapInspection::heap_inspection(outputStream* st, uint parallel_thread_num)
   st->flush();
 }
 
+void HeapInspection::print_histogram(KlassInfoTable* cit, outputStream* st) {
+  ResourceMark rm;
+  KlassInfoHisto histo(cit);
+  HistoClosure hc(&histo);
+
+  cit->iterate(&hc);
+
+  histo.sort();
+  histo.print_histo_on(st, false, false, NULL);
+}
+
 class FindInstanceClosure : public ObjectClosure {
  private:
   Klass* _klass;
@@ -235,7 +235,7 @@ class KlassInfoBucket: public CHeapObj<mtInternal> {
   void iterate(KlassInfoClosure* cic);
 };
 
-class KlassInfoTable: public StackObj {
+class KlassInfoTable: public CHeapObj<mtInternal> {
  private:
   int _size;
   static const int _num_buckets = 20011;
@@ -372,6 +372,8 @@ class HeapInspection : public StackObj {
   void heap_inspection(outputStream* st, uint parallel_thread_num = 1) NOT_SERVICES_RETURN;
   uintx populate_table(KlassInfoTable* cit, BoolObjectClosure* filter = NULL, uint parallel_thread_num = 1) NOT_SERVICES_RETURN_(0);
   static void find_instances_at_safepoint(Klass* k, GrowableArray<oop>* result) NOT_SERVICES_RETURN;
+  // Prints the histogram of a table populated elsewhere, e.g. during marking.
+  static void print_histogram(KlassInfoTable* cit, outputStream* st) NOT_SERVICES_RETURN;
  private:
   void iterate_over_heap(KlassInfoTable* cit, BoolObjectClosure* filter = NULL);
 };
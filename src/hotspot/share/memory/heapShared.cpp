@@ -29,6 +29,7 @@
 #include "logging/log.hpp"
 #include "logging/logMessage.hpp"
 #include "logging/logStream.hpp"
+#include "memory/archiveUtils.hpp"
 #include "memory/heapShared.inline.hpp"
 #include "memory/iterator.inline.hpp"
 #include "memory/metadataFactory.hpp"
@@ -73,6 +74,11 @@ KlassSubGraphInfo* HeapShared::get_subgraph_info(Klass* k) {
 
 address   HeapShared::_narrow_oop_base;
 int       HeapShared::_narrow_oop_shift;
+HeapShared::LoadedRegion HeapShared::_loaded_regions[MetaspaceShared::max_strings +
+                                                     MetaspaceShared::max_open_archive_heap_region];
+int       HeapShared::_num_loaded_regions = 0;
+HeapWord* HeapShared::_loaded_bottom = NULL;
+HeapWord* HeapShared::_loaded_top = NULL;
 
 int HeapShared::num_of_subgraph_infos() {
   int num = 0;
@@ -187,8 +193,13 @@ void ArchivedKlassSubGraphInfoRecord::init(KlassSubGraphInfo* info) {
           _k->external_name(), i, subgraph_k->external_name());
       }
       _subgraph_object_klasses->at_put(i, subgraph_k);
+      ArchivePtrMarker::mark_pointer(_subgraph_object_klasses->adr_at(i));
     }
   }
+
+  ArchivePtrMarker::mark_pointer(&_k);
+  ArchivePtrMarker::mark_pointer(&_entry_field_records);
+  ArchivePtrMarker::mark_pointer(&_subgraph_object_klasses);
 }
 
 // Build the records of archived subgraph infos, which include:
@@ -252,6 +263,7 @@ void HeapShared::write_archived_subgraph_infos() {
   *p = (intptr_t)_num_archived_subgraph_info_records;
   p ++;
   *p = (intptr_t)_archived_subgraph_info_records;
+  ArchivePtrMarker::mark_pointer(p);
 }
 
 char* HeapShared::read_archived_subgraph_infos(char* buffer) {
@@ -827,6 +839,44 @@ void HeapShared::init_narrow_oop_decoding(address base, int shift) {
   _narrow_oop_shift = shift;
 }
 
+void HeapShared::add_loaded_region(address dumptime_start, HeapWord* runtime_start,
+                                   size_t size_in_bytes) {
+  assert(!UseG1GC, "G1 maps the archived heap regions");
+  assert(_num_loaded_regions < MetaspaceShared::max_strings +
+                               MetaspaceShared::max_open_archive_heap_region, "sanity");
+  LoadedRegion* r = &_loaded_regions[_num_loaded_regions++];
+  r->_dumptime_start = (uintptr_t)dumptime_start;
+  r->_dumptime_end   = (uintptr_t)dumptime_start + size_in_bytes;
+  r->_runtime_delta  = (intx)((address)runtime_start - dumptime_start);
+}
+
+void HeapShared::set_loaded_range(HeapWord* bottom, HeapWord* top) {
+  assert(_num_loaded_regions > 0, "must have loaded regions");
+  _loaded_bottom = bottom;
+  _loaded_top = top;
+}
+
+bool HeapShared::is_loaded() {
+  return _loaded_bottom != NULL;
+}
+
+bool HeapShared::is_loaded_object(oop p) {
+  return _loaded_bottom <= (HeapWord*)p && (HeapWord*)p < _loaded_top;
+}
+
+void HeapShared::oops_do(OopClosure* f) {
+  HeapWord* p = _loaded_bottom;
+  while (p < _loaded_top) {
+    HeapWord* obj_start = p;
+    oop o = (oop)p;
+    p += o->size();
+    // The closure may update the slot, but the objects are never moved,
+    // so the local copy is just discarded.
+    f->do_oop(&o);
+    assert((HeapWord*)o == obj_start, "loaded archive object must not move");
+  }
+}
+
 // Patch all the embedded oop pointers inside an archived heap region,
 // to be consistent with the runtime oop encoding.
 class PatchEmbeddedPointers: public BitMapClosure {
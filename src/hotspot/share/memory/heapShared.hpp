@@ -27,6 +27,7 @@
 
 #include "classfile/systemDictionary.hpp"
 #include "memory/allocation.hpp"
+#include "memory/metaspaceShared.hpp"
 #include "memory/universe.hpp"
 #include "oops/objArrayKlass.hpp"
 #include "oops/oop.hpp"
@@ -141,6 +142,24 @@ class HeapShared: AllStatic {
   static address _narrow_oop_base;
   static int     _narrow_oop_shift;
 
+  // When the archived heap regions are loaded (copied) into the old generation
+  // instead of being mapped (see FileMapInfo::load_heap_regions), each region
+  // keeps its dump-time layout but may be moved by a different distance.
+  // decode_from_archive uses this table to translate a dump-time address
+  // into the address of the loaded copy.
+  struct LoadedRegion {
+    uintptr_t _dumptime_start;
+    uintptr_t _dumptime_end;
+    intx      _runtime_delta;
+  };
+  static LoadedRegion _loaded_regions[MetaspaceShared::max_strings +
+                                      MetaspaceShared::max_open_archive_heap_region];
+  static int       _num_loaded_regions;
+  static HeapWord* _loaded_bottom;
+  static HeapWord* _loaded_top;
+
+  inline static uintptr_t to_loaded_address(uintptr_t dumptime_addr);
+
   static bool oop_equals(oop const& p1, oop const& p2) {
     return primitive_equals<oop>(p1, p2);
   }
@@ -201,6 +220,21 @@ class HeapShared: AllStatic {
   static void patch_archived_heap_embedded_pointers(MemRegion mem, address  oopmap,
                                                     size_t oopmap_in_bits) NOT_CDS_JAVA_HEAP_RETURN;
 
+  // Support for loading the archived heap regions with collectors other than G1.
+  // The loaded objects occupy [bottom, top) at the bottom of the old generation.
+  static void add_loaded_region(address dumptime_start, HeapWord* runtime_start,
+                                size_t size_in_bytes) NOT_CDS_JAVA_HEAP_RETURN;
+  static void set_loaded_range(HeapWord* bottom, HeapWord* top) NOT_CDS_JAVA_HEAP_RETURN;
+  static bool is_loaded() NOT_CDS_JAVA_HEAP_RETURN_(false);
+  static bool is_loaded_object(oop p) NOT_CDS_JAVA_HEAP_RETURN_(false);
+
+  // The GC must never move the loaded objects, because the archived metadata
+  // (e.g., Klass::_archived_mirror and the shared string table) refers to them
+  // with narrowOops that are not visible to the GC. They are placed at the
+  // bottom of the old generation, and all of them are kept alive here, so a
+  // sliding compaction always leaves them in place.
+  static void oops_do(OopClosure* f) NOT_CDS_JAVA_HEAP_RETURN;
+
   static void init_archivable_static_fields(Thread* THREAD) NOT_CDS_JAVA_HEAP_RETURN;
   static void archive_static_fields(Thread* THREAD) NOT_CDS_JAVA_HEAP_RETURN;
 
@@ -30,9 +30,24 @@
 
 #if INCLUDE_CDS_JAVA_HEAP
 
+inline uintptr_t HeapShared::to_loaded_address(uintptr_t dumptime_addr) {
+  for (int i = 0; i < _num_loaded_regions; i++) {
+    LoadedRegion* r = &_loaded_regions[i];
+    if (r->_dumptime_start <= dumptime_addr && dumptime_addr < r->_dumptime_end) {
+      return dumptime_addr + r->_runtime_delta;
+    }
+  }
+  fatal("archived object " INTPTR_FORMAT " is not in any loaded region", dumptime_addr);
+  return 0;
+}
+
 inline oop HeapShared::decode_from_archive(narrowOop v) {
   assert(!CompressedOops::is_null(v), "narrow oop value can never be zero");
-  oop result = (oop)(void*)((uintptr_t)_narrow_oop_base + ((uintptr_t)v << _narrow_oop_shift));
+  uintptr_t p = (uintptr_t)_narrow_oop_base + ((uintptr_t)v << _narrow_oop_shift);
+  if (_num_loaded_regions > 0) {
+    p = to_loaded_address(p);
+  }
+  oop result = (oop)(void*)p;
   assert(check_obj_alignment(result), "address not aligned: " INTPTR_FORMAT, p2i((void*) result));
   return result;
 }
@@ -103,12 +103,12 @@ MemRegion MemRegion::minus(const MemRegion mr2) const {
 }
 
 void* MemRegion::operator new(size_t size) throw() {
-  return (address)AllocateHeap(size, mtGC, CURRENT_PC,
+  return (address)AllocateHeap(size, mtGC, MALLOC_CURRENT_PC,
     AllocFailStrategy::RETURN_NULL);
 }
 
 void* MemRegion::operator new [](size_t size) throw() {
-  return (address)AllocateHeap(size, mtGC, CURRENT_PC,
+  return (address)AllocateHeap(size, mtGC, MALLOC_CURRENT_PC,
     AllocFailStrategy::RETURN_NULL);
 }
 void  MemRegion::operator delete(void* p) {
@@ -1179,7 +1179,11 @@ void Metaspace::allocate_metaspace_compressed_klass_ptrs(char* requested_addr, a
     }
   }
 
-  // If we got here then the metaspace got allocated.
+  initialize_compressed_class_space(metaspace_rs, requested_addr, cds_base);
+}
+
+void Metaspace::initialize_compressed_class_space(ReservedSpace metaspace_rs, char* requested_addr, address cds_base) {
+  assert(metaspace_rs.is_reserved() && metaspace_rs.size() == compressed_class_space_size(), "sanity");
   MemTracker::record_virtual_memory_type((address)metaspace_rs.base(), mtClass);
 
 #if INCLUDE_CDS
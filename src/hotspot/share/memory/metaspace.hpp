@@ -174,6 +174,9 @@ class Metaspace : public AllStatic {
   }
 #ifdef _LP64
   static void allocate_metaspace_compressed_klass_ptrs(char* requested_addr, address cds_base);
+  // Sets up the compressed class space in the given reserved space, e.g. one that
+  // was reserved together with the CDS archive.
+  static void initialize_compressed_class_space(ReservedSpace metaspace_rs, char* requested_addr, address cds_base);
 #endif
 
  private:
@@ -120,6 +120,11 @@ public:
       return (address)(p & (~FLAG_MASK));
     }
 
+    // The location of the pointer that refers to obj().
+    address* addr() const {
+      return (address*)mpp();
+    }
+
     void update(address new_loc) const;
 
   private:
@@ -38,6 +38,7 @@
 #include "interpreter/bytecodes.hpp"
 #include "logging/log.hpp"
 #include "logging/logMessage.hpp"
+#include "memory/archiveUtils.hpp"
 #include "memory/filemap.hpp"
 #include "memory/heapShared.inline.hpp"
 #include "memory/metaspace.hpp"
@@ -53,7 +54,9 @@
 #include "oops/oop.inline.hpp"
 #include "oops/typeArrayKlass.hpp"
 #include "prims/jvmtiRedefineClasses.hpp"
+#include "runtime/arguments.hpp"
 #include "runtime/handles.inline.hpp"
+#include "runtime/interfaceSupport.inline.hpp"
 #include "runtime/os.hpp"
 #include "runtime/safepointVerifiers.hpp"
 #include "runtime/signature.hpp"
@@ -70,6 +73,7 @@
 #endif
 
 ReservedSpace MetaspaceShared::_shared_rs;
+ReservedSpace MetaspaceShared::_class_space_rs;
 VirtualSpace MetaspaceShared::_shared_vs;
 MetaspaceSharedStats MetaspaceShared::_stats;
 bool MetaspaceShared::_has_error_classes;
@@ -141,12 +145,15 @@ public:
     return p;
   }
 
-  void append_intptr_t(intptr_t n) {
+  void append_intptr_t(intptr_t n, bool need_to_mark = false) {
     assert(is_aligned(_top, sizeof(intptr_t)), "bad alignment");
     intptr_t *p = (intptr_t*)_top;
     char* newtop = _top + sizeof(intptr_t);
     expand_top_to(newtop);
     *p = n;
+    if (need_to_mark) {
+      ArchivePtrMarker::mark_pointer(p);
+    }
   }
 
   char* base()      const { return _base;        }
@@ -233,9 +240,14 @@ void MetaspaceShared::initialize_runtime_shared_and_meta_spaces() {
     if (Metaspace::using_class_space()) {
       char* cds_end = (char*)(cds_address + cds_total);
       cds_end = (char *)align_up(cds_end, Metaspace::reserve_alignment());
-      // If UseCompressedClassPointers is set then allocate the metaspace area
-      // above the heap and above the CDS area (if it exists).
-      Metaspace::allocate_metaspace_compressed_klass_ptrs(cds_end, cds_address);
+      if (_class_space_rs.is_reserved()) {
+        // Reserved right above the CDS area, see FileMapInfo::reserve_shared_memory().
+        Metaspace::initialize_compressed_class_space(_class_space_rs, cds_end, cds_address);
+      } else {
+        // If UseCompressedClassPointers is set then allocate the metaspace area
+        // above the heap and above the CDS area (if it exists).
+        Metaspace::allocate_metaspace_compressed_klass_ptrs(cds_end, cds_address);
+      }
       // map_heap_regions() compares the current narrow oop and klass encodings
       // with the archived ones, so it must be done after all encodings are determined.
       mapinfo->map_heap_regions();
@@ -322,6 +334,7 @@ void MetaspaceShared::initialize_dumptime_shared_and_meta_spaces() {
   if (!_shared_vs.initialize(_shared_rs, 0)) {
     vm_exit_during_initialization("Unable to allocate memory for shared space");
   }
+  ArchivePtrMarker::initialize((address*)_shared_vs.low(), (address*)_shared_vs.high());
 
   _mc_region.init(&_shared_rs);
   tty->print_cr("Allocated shared space: " SIZE_FORMAT " bytes at " PTR_FORMAT,
@@ -389,6 +402,7 @@ void MetaspaceShared::commit_shared_space_to(char* newtop) {
     vm_exit_during_initialization(err_msg("Failed to expand shared space to " SIZE_FORMAT " bytes",
                                           need_committed_size));
   }
+  ArchivePtrMarker::expand_ptr_end((address*)_shared_vs.high());
 
   log_info(cds)("Expanding shared spaces by " SIZE_FORMAT_W(7) " bytes [total " SIZE_FORMAT_W(9)  " bytes ending at %p]",
                 commit, _shared_vs.actual_committed_size(), _shared_vs.high());
@@ -640,6 +654,7 @@ public:
   static void patch(Metadata* obj) {
     assert(DumpSharedSpaces, "dump-time only");
     *(void**)obj = (void*)(_info->cloned_vtable());
+    ArchivePtrMarker::mark_pointer((address*)obj);
   }
 
   static bool is_valid_shared_object(const T* obj) {
@@ -789,6 +804,8 @@ void MetaspaceShared::patch_cpp_vtable_pointers() {
         Method* m = ik->methods()->at(j);
         CppVtableCloner<Method>::patch(m);
         assert(CppVtableCloner<Method>::is_valid_shared_object(m), "must be");
+        // The entry points were set to the mc region by Method::unlink_method().
+        m->mark_archived_entry_points();
       }
     } else if (obj->is_objArray_klass()) {
       CppVtableCloner<ObjArrayKlass>::patch(obj);
@@ -817,17 +834,15 @@ public:
   }
 
   void do_ptr(void** p) {
-    _dump_region->append_intptr_t((intptr_t)*p);
+    _dump_region->append_intptr_t((intptr_t)*p, true);
   }
 
   void do_u4(u4* p) {
-    void* ptr = (void*)(uintx(*p));
-    do_ptr(&ptr);
+    _dump_region->append_intptr_t((intptr_t)(*p));
   }
 
   void do_bool(bool *p) {
-    void* ptr = (void*)(uintx(*p));
-    do_ptr(&ptr);
+    _dump_region->append_intptr_t((intptr_t)(*p));
   }
 
   void do_tag(int tag) {
@@ -850,7 +865,7 @@ public:
     assert(size % sizeof(intptr_t) == 0, "bad size");
     do_tag((int)size);
     while (size > 0) {
-      _dump_region->append_intptr_t(*(intptr_t*)start);
+      _dump_region->append_intptr_t(*(intptr_t*)start, true);
       start += sizeof(intptr_t);
       size -= sizeof(intptr_t);
     }
@@ -1151,12 +1166,14 @@ private:
     }
   };
 
-  // Relocate a reference to point to its shallow copy
+  // Relocate a reference to point to its shallow copy. If the reference itself
+  // is inside the archive, also mark it for run time relocation of the archive.
   class RefRelocator: public MetaspaceClosure {
   public:
     virtual bool do_ref(Ref* ref, bool read_only) {
       if (ref->not_null()) {
         ref->update(get_new_loc(ref));
+        ArchivePtrMarker::mark_pointer(ref->addr());
       }
       return false; // Do not recurse.
     }
@@ -1440,6 +1457,9 @@ void VM_PopulateDumpSharedSpace::doit() {
   mapinfo->set_cds_i2i_entry_code_buffers_size(MetaspaceShared::cds_i2i_entry_code_buffers_size());
   mapinfo->set_core_spaces_size(core_spaces_size);
 
+  // One bit for each word in the core spaces, so the archive can be relocated at run time.
+  ArchivePtrMarker::ptrmap()->resize(core_spaces_size / sizeof(address));
+
   for (int pass=1; pass<=2; pass++) {
     if (pass == 1) {
       // The first pass doesn't actually write the data to disk. All it
@@ -1470,6 +1490,7 @@ void VM_PopulateDumpSharedSpace::doit() {
                                         _open_archive_heap_oopmaps,
                                         MetaspaceShared::first_open_archive_heap_region,
                                         MetaspaceShared::max_open_archive_heap_region);
+    mapinfo->write_pointer_bitmap(ArchivePtrMarker::ptrmap());
   }
 
   mapinfo->close();
@@ -1627,6 +1648,114 @@ void MetaspaceShared::prepare_for_dumping() {
   ClassLoader::initialize_shared_path();
 }
 
+// Appends prefix followed by arg to the dump command as one argument that
+// the shell does not interpret. The prefix must not need quoting. Returns
+// false if arg cannot be passed through the shell unchanged.
+static bool print_dump_arg(outputStream* st, const char* prefix, const char* arg) {
+#ifdef _WINDOWS
+  // cmd /C expands %VAR% and ends the quoted argument at '"' even inside
+  // double quotes, os::fork_and_exec turns newlines into '&', and a trailing
+  // backslash would escape the closing quote.
+  size_t len = strlen(arg);
+  if (strpbrk(arg, "\"%\n") != NULL || (len > 0 && arg[len - 1] == '\\')) {
+    return false;
+  }
+  st->print(" \"%s%s\"", prefix, arg);
+#else
+  // Nothing is special inside single quotes; a single quote ends the quoted
+  // string, is escaped and starts a new one.
+  st->print(" '%s", prefix);
+  for (const char* p = arg; *p != '\0'; p++) {
+    if (*p == '\'') {
+      st->print("'\\''");
+    } else {
+      st->put(*p);
+    }
+  }
+  st->put('\'');
+#endif
+  return true;
+}
+
+// -XX:ArchiveClassesAtExit: the classes loaded in this run have been written to
+// the DumpLoadedClassList file as they were loaded, with the sources of the
+// classes of custom loaders. A dump VM with the same class path, module
+// options and archive compatible settings archives exactly these classes into
+// ArchiveClassesAtExit, which later runs map with -XX:SharedArchiveFile.
+void MetaspaceShared::dump_archive_at_exit(JavaThread* thread) {
+  assert(ArchiveClassesAtExit != NULL && DumpLoadedClassList != NULL, "must be");
+  if (classlist_file == NULL || !classlist_file->is_open()) {
+    log_warning(cds)("Cannot write %s: class list %s is not available",
+                     ArchiveClassesAtExit, DumpLoadedClassList);
+    return;
+  }
+  classlist_file->flush();
+
+  ResourceMark rm(thread);
+  const char* fs = os::file_separator();
+  size_t java_len = strlen(Arguments::get_java_home()) + 2 * strlen(fs) + 8;
+  char* java = NEW_RESOURCE_ARRAY(char, java_len);
+  jio_snprintf(java, java_len, "%s%sbin%sjava", Arguments::get_java_home(), fs, fs);
+
+  stringStream cmd;
+  bool ok = print_dump_arg(&cmd, "", java);
+  cmd.print(" -Xshare:dump");
+  ok = ok && print_dump_arg(&cmd, "-XX:SharedClassListFile=", DumpLoadedClassList);
+  ok = ok && print_dump_arg(&cmd, "-XX:SharedArchiveFile=", ArchiveClassesAtExit);
+  // The archive is only mapped by VMs with the same object layout.
+  cmd.print(" -XX:%cUseCompressedOops -XX:%cUseCompressedClassPointers",
+            UseCompressedOops ? '+' : '-', UseCompressedClassPointers ? '+' : '-');
+  cmd.print(" -XX:ObjectAlignmentInBytes=%d -XX:MaxHeapSize=" SIZE_FORMAT " -XX:%cCompactStrings",
+            ObjectAlignmentInBytes, MaxHeapSize, CompactStrings ? '+' : '-');
+
+  // The archived classes must resolve from the same paths in the dump VM.
+  const char* boot_append = Arguments::get_jdk_boot_class_path_append();
+  if (boot_append != NULL && boot_append[0] != '\0') {
+    ok = ok && print_dump_arg(&cmd, "-Xbootclasspath/a:", boot_append);
+  }
+  const char* cp = Arguments::get_appclasspath();
+  if (cp != NULL && cp[0] != '\0') {
+    cmd.print(" -cp");
+    ok = ok && print_dump_arg(&cmd, "", cp);
+  }
+  const char* module_path = Arguments::get_property("jdk.module.path");
+  if (module_path != NULL) {
+    ok = ok && print_dump_arg(&cmd, "--module-path=", module_path);
+  }
+  const char* upgrade_path = Arguments::get_property("jdk.module.upgrade.path");
+  if (upgrade_path != NULL) {
+    ok = ok && print_dump_arg(&cmd, "--upgrade-module-path=", upgrade_path);
+  }
+  for (int i = 0; ; i++) {
+    char key[32];
+    jio_snprintf(key, sizeof(key), "jdk.module.addmods.%d", i);
+    const char* mods = Arguments::get_property(key);
+    if (mods == NULL) {
+      break;
+    }
+    ok = ok && print_dump_arg(&cmd, "--add-modules=", mods);
+  }
+
+  if (!ok) {
+    log_warning(cds)("Cannot write %s: the paths contain characters that cannot be passed to the dump VM",
+                     ArchiveClassesAtExit);
+    return;
+  }
+
+  log_info(cds)("Writing CDS archive %s: %s", ArchiveClassesAtExit, cmd.as_string());
+  int status;
+  {
+    // The dump takes a while, don't hold up safepoints meanwhile.
+    ThreadToNativeFromVM ttn(thread);
+    status = os::fork_and_exec(cmd.as_string());
+  }
+  if (status != 0) {
+    log_warning(cds)("Failed to write CDS archive %s, dump exited with %d", ArchiveClassesAtExit, status);
+  } else {
+    log_info(cds)("Wrote CDS archive %s", ArchiveClassesAtExit);
+  }
+}
+
 // Preload classes from a list, populate the shared spaces and dump to a
 // file.
 void MetaspaceShared::preload_and_dump(TRAPS) {
@@ -1920,6 +2049,11 @@ oop MetaspaceShared::archive_heap_object(oop obj, Thread* THREAD) {
 oop MetaspaceShared::materialize_archived_object(narrowOop v) {
   if (!CompressedOops::is_null(v)) {
     oop obj = HeapShared::decode_from_archive(v);
+    if (HeapShared::is_loaded()) {
+      // The loaded objects are ordinary old generation objects, and the
+      // collectors that load them have no concurrent marking.
+      return obj;
+    }
     return G1CollectedHeap::heap()->materialize_archived_object(obj);
   }
   return NULL;
@@ -1942,7 +2076,13 @@ void MetaspaceShared::archive_klass_objects(Thread* THREAD) {
 }
 
 bool MetaspaceShared::is_archive_object(oop p) {
-  return (p == NULL) ? false : G1ArchiveAllocator::is_archive_object(p);
+  if (p == NULL) {
+    return false;
+  }
+  if (HeapShared::is_loaded()) {
+    return HeapShared::is_loaded_object(p);
+  }
+  return G1ArchiveAllocator::is_archive_object(p);
 }
 
 void MetaspaceShared::fixup_mapped_heap_regions() {
@@ -1996,7 +2136,8 @@ public:
     if (o == 0 || !MetaspaceShared::open_archive_heap_region_mapped()) {
       p = NULL;
     } else {
-      assert(MetaspaceShared::is_heap_object_archiving_allowed(),
+      assert(MetaspaceShared::is_heap_object_archiving_allowed() ||
+             MetaspaceShared::is_heap_object_loading_allowed(),
              "Archived heap object is not allowed");
       assert(MetaspaceShared::open_archive_heap_region_mapped(),
              "Open archive heap region is not mapped");
@@ -2030,7 +2171,9 @@ bool MetaspaceShared::is_in_trampoline_frame(address addr) {
   return false;
 }
 
-// Map shared spaces at requested addresses and return if succeeded.
+// Map shared spaces at requested addresses and return if succeeded. If the
+// requested addresses are not available, the shared spaces are mapped at
+// an alternative address and relocated (except on Windows).
 bool MetaspaceShared::map_shared_spaces(FileMapInfo* mapinfo) {
   size_t image_alignment = mapinfo->alignment();
 
@@ -2038,7 +2181,8 @@ bool MetaspaceShared::map_shared_spaces(FileMapInfo* mapinfo) {
   // Map in the shared memory and then map the regions on top of it.
   // On Windows, don't map the memory here because it will cause the
   // mappings of the regions to fail.
-  ReservedSpace shared_rs = mapinfo->reserve_shared_memory();
+  ReservedSpace class_space_rs;
+  ReservedSpace shared_rs = mapinfo->reserve_shared_memory(&class_space_rs);
   if (!shared_rs.is_reserved()) return false;
 #endif
 
@@ -2055,6 +2199,7 @@ bool MetaspaceShared::map_shared_spaces(FileMapInfo* mapinfo) {
       (ro_base = mapinfo->map_region(ro, &ro_top)) != NULL &&
       (md_base = mapinfo->map_region(md, &md_top)) != NULL &&
       (image_alignment == (size_t)os::vm_allocation_granularity()) &&
+      mapinfo->relocate_pointers() &&
       mapinfo->validate_shared_path_table()) {
     // Success -- set up MetaspaceObj::_shared_metaspace_{base,top} for
     // fast checking in MetaspaceShared::is_in_shared_metaspace() and
@@ -2071,6 +2216,9 @@ bool MetaspaceShared::map_shared_spaces(FileMapInfo* mapinfo) {
     assert(ro_top == md_base, "must be");
 
     MetaspaceObj::set_shared_metaspace_range((void*)mc_base, (void*)md_top);
+#ifndef _WINDOWS
+    _class_space_rs = class_space_rs;
+#endif
     return true;
   } else {
     // If there was a failure in mapping any of the spaces, unmap the ones
@@ -2082,6 +2230,9 @@ bool MetaspaceShared::map_shared_spaces(FileMapInfo* mapinfo) {
 #ifndef _WINDOWS
     // Release the entire mapped region
     shared_rs.release();
+    if (class_space_rs.is_reserved()) {
+      class_space_rs.release();
+    }
 #endif
     // If -Xshare:on is specified, print out the error message and exit VM,
     // otherwise, set UseSharedSpaces to false and continue.
@@ -37,6 +37,7 @@
 #define MAX_SHARED_DELTA                (0x7FFFFFFF)
 
 class FileMapInfo;
+class JavaThread;
 
 class MetaspaceSharedStats {
 public:
@@ -52,6 +53,7 @@ class MetaspaceShared : AllStatic {
 
   // CDS support
   static ReservedSpace _shared_rs;
+  static ReservedSpace _class_space_rs;  // class space reserved together with the mapped archive
   static VirtualSpace _shared_vs;
   static int _max_alignment;
   static MetaspaceSharedStats _stats;
@@ -86,6 +88,7 @@ class MetaspaceShared : AllStatic {
 
   static void prepare_for_dumping() NOT_CDS_RETURN;
   static void preload_and_dump(TRAPS) NOT_CDS_RETURN;
+  static void dump_archive_at_exit(JavaThread* thread) NOT_CDS_RETURN;
   static int preload_classes(const char * class_list_path,
                              TRAPS) NOT_CDS_RETURN_(0);
 
@@ -119,6 +122,12 @@ class MetaspaceShared : AllStatic {
     CDS_JAVA_HEAP_ONLY(return (UseG1GC && UseCompressedOops && UseCompressedClassPointers);)
     NOT_CDS_JAVA_HEAP(return false;)
   }
+  // At run time, the archived heap objects can also be loaded (copied) into the
+  // heap of some other collectors. See FileMapInfo::load_heap_regions().
+  static bool is_heap_object_loading_allowed() {
+    CDS_JAVA_HEAP_ONLY(return (!UseG1GC && UseCompressedOops && UseCompressedClassPointers);)
+    NOT_CDS_JAVA_HEAP(return false;)
+  }
   static void create_archive_object_cache() {
     CDS_JAVA_HEAP_ONLY(_archive_object_cache = new (ResourceObj::C_HEAP, mtClass)ArchivedObjectCache(););
   }
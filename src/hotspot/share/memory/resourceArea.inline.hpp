@@ -34,7 +34,7 @@ inline char* ResourceArea::allocate_bytes(size_t size, AllocFailType alloc_failm
   if (UseMallocOnly) {
     // use malloc, but save pointer in res. area for later freeing
     char** save = (char**)internal_malloc_4(sizeof(char*));
-    return (*save = (char*)os::malloc(size, mtThread, CURRENT_PC));
+    return (*save = (char*)os::malloc(size, mtThread, MALLOC_CURRENT_PC));
   }
 #endif
   return (char*)Amalloc(size, alloc_failmode);
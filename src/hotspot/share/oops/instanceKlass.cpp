@@ -27,6 +27,7 @@
 #include "aot/aotLoader.hpp"
 #include "classfile/classFileParser.hpp"
 #include "classfile/classFileStream.hpp"
+#include "classfile/classListWriter.hpp"
 #include "classfile/classLoader.hpp"
 #include "classfile/classLoaderData.inline.hpp"
 #include "classfile/javaClasses.hpp"
@@ -37,6 +38,7 @@
 #include "classfile/vmSymbols.hpp"
 #include "code/dependencyContext.hpp"
 #include "compiler/compileBroker.hpp"
+#include "compiler/methodProfileArchive.hpp"
 #include "gc/shared/collectedHeap.inline.hpp"
 #include "interpreter/oopMapCache.hpp"
 #include "interpreter/rewriter.hpp"
@@ -1008,6 +1010,7 @@ void InstanceKlass::initialize_impl(TRAPS) {
     {
       debug_only(vtable().verify(tty, true);)
     }
+    MethodProfileArchive::class_initialized(this, (JavaThread*)THREAD);
   }
   else {
     // Step 10 and 11
@@ -2183,16 +2186,17 @@ bool InstanceKlass::supers_have_passed_fingerprint_checks() {
 }
 
 bool InstanceKlass::should_store_fingerprint(bool is_anonymous) {
-#if INCLUDE_AOT
-  // We store the fingerprint into the InstanceKlass only in the following 2 cases:
+  // We store the fingerprint into the InstanceKlass only in the following 3 cases:
   if (CalculateClassFingerprint) {
-    // (1) We are running AOT to generate a shared library.
+    // (1) We are running AOT to generate a shared library, or method profiles
+    //     are saved or loaded (see MethodProfileArchive).
     return true;
   }
   if (DumpSharedSpaces) {
     // (2) We are running -Xshare:dump to create a shared archive
     return true;
   }
+#if INCLUDE_AOT
   if (UseAOT && is_anonymous) {
     // (3) We are using AOT code from a shared library and see an anonymous class
     return true;
@@ -2205,11 +2209,7 @@ bool InstanceKlass::should_store_fingerprint(bool is_anonymous) {
 }
 
 bool InstanceKlass::has_stored_fingerprint() const {
-#if INCLUDE_AOT
   return should_store_fingerprint() || is_shared();
-#else
-  return false;
-#endif
 }
 
 uint64_t InstanceKlass::get_stored_fingerprint() const {
@@ -2425,6 +2425,11 @@ void InstanceKlass::notify_unload_class(InstanceKlass* ik) {
 
   // notify ClassLoadingService of class unload
   ClassLoadingService::notify_class_unloaded(ik);
+
+#if INCLUDE_CDS
+  // the class list file refers to classes by address-based ids
+  ClassListWriter::handle_class_unloading(ik);
+#endif
 }
 
 void InstanceKlass::release_C_heap_structures(InstanceKlass* ik) {
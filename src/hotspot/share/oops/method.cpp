@@ -34,6 +34,7 @@
 #include "interpreter/interpreter.hpp"
 #include "interpreter/oopMapCache.hpp"
 #include "memory/allocation.inline.hpp"
+#include "memory/archiveUtils.hpp"
 #include "memory/heapInspection.hpp"
 #include "memory/metadataFactory.hpp"
 #include "memory/metaspaceClosure.hpp"
@@ -999,6 +1000,17 @@ void Method::unlink_method() {
   set_method_data(NULL);
   clear_method_counters();
 }
+
+// Called on the archived copy of the Method, after unlink_method(). All the
+// entry points refer to the MC region, so they must be patched if the archive
+// is mapped at a different address at run time.
+void Method::mark_archived_entry_points() {
+  assert(DumpSharedSpaces, "dump time only");
+  ArchivePtrMarker::mark_pointer(&_i2i_entry);
+  ArchivePtrMarker::mark_pointer(&_from_interpreted_entry);
+  ArchivePtrMarker::mark_pointer((address*)&_from_compiled_entry);
+  ArchivePtrMarker::mark_pointer(constMethod()->adapter_trampoline_addr());
+}
 #endif
 
 /****************************************************************************
@@ -2417,7 +2429,7 @@ void Method::log_touched(TRAPS) {
   MutexLocker ml(TouchedMethodLog_lock, THREAD);
   if (_touched_method_table == NULL) {
     _touched_method_table = NEW_C_HEAP_ARRAY2(TouchedMethodRecord*, table_size,
-                                              mtTracing, CURRENT_PC);
+                                              mtTracing, MALLOC_CURRENT_PC);
     memset(_touched_method_table, 0, sizeof(TouchedMethodRecord*)*table_size);
   }
 
@@ -481,6 +481,8 @@ class Method : public Metadata {
   void link_method(const methodHandle& method, TRAPS);
   // clear entry points. Used by sharing code during dump time
   void unlink_method() NOT_CDS_RETURN;
+  // mark the entry points for relocation of the CDS archive. Used at dump time
+  void mark_archived_entry_points() NOT_CDS_RETURN;
 
   virtual void metaspace_pointers_do(MetaspaceClosure* iter);
   virtual MetaspaceObj::Type type() const { return MethodType; }
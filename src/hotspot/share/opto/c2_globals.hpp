@@ -184,8 +184,9 @@
            "Map number of unrolls for main loop via "                       \
            "Superword Level Parallelism analysis")                          \
                                                                             \
-  experimental(bool, PostLoopMultiversioning, false,                        \
-           "Multi versioned post loops to eliminate range checks")          \
+  product(bool, PostLoopMultiversioning, false,                             \
+           "Multi versioned post loops to eliminate range checks, "         \
+           "vectorized with masked vector operations where supported")      \
                                                                             \
   notproduct(bool, TraceSuperWordLoopUnrollAnalysis, false,                 \
           "Trace what Superword Level Parallelism analysis applies")        \
@@ -540,6 +541,10 @@
   product(bool, EliminateAllocations, true,                                 \
           "Use escape analysis to eliminate allocations")                   \
                                                                             \
+  product(bool, ReduceAllocationMerges, true,                               \
+          "Split field loads through Phis of allocations so that the "      \
+          "merged allocations can be eliminated")                           \
+                                                                            \
   notproduct(bool, PrintEliminateAllocations, false,                        \
           "Print out when allocations are eliminated")                      \
                                                                             \
@@ -104,6 +104,9 @@ void ConnectionGraph::do_analysis(Compile *C, PhaseIterGVN *igvn) {
   // to create space for them in ConnectionGraph::_nodes[].
   Node* oop_null = igvn->zerocon(T_OBJECT);
   Node* noop_null = igvn->zerocon(T_NARROWOOP);
+  if (ReduceAllocationMerges && EliminateAllocations) {
+    reduce_allocation_merges(C, igvn);
+  }
   ConnectionGraph* congraph = new(C->comp_arena()) ConnectionGraph(C, igvn);
   // Perform escape analysis
   if (congraph->compute_escape()) {
@@ -117,6 +120,123 @@ void ConnectionGraph::do_analysis(Compile *C, PhaseIterGVN *igvn) {
     igvn->hash_delete(noop_null);
 }
 
+// Objects merged by a Phi are not scalar replaceable (see case 3 in
+// adjust_scalar_replaceable_state()), for example in
+//
+//    Point p = (x > 0) ? new Point(x, 0) : new Point(0, -x);
+//    return p.x + p.y;
+//
+// If the Phi is only used to load fields of the merged objects, the loads
+// are split through the Phi before the Connection Graph is built. Each
+// allocation is then only used on its own path, and the Phi dies.
+void ConnectionGraph::reduce_allocation_merges(Compile* C, PhaseIterGVN* igvn) {
+  Unique_Node_List phis;
+  for (int i = 0; i < C->macro_count(); i++) {
+    Node* n = C->macro_node(i);
+    if (!n->is_Allocate() || n->is_AllocateArray()) {
+      continue;
+    }
+    Node* res = n->as_Allocate()->result_cast();
+    if (res == NULL) {
+      continue;
+    }
+    for (DUIterator_Fast imax, j = res->fast_outs(imax); j < imax; j++) {
+      Node* use = res->fast_out(j);
+      if (use->is_Phi()) {
+        phis.push(use);
+      }
+    }
+  }
+  for (uint i = 0; i < phis.size(); i++) {
+    PhiNode* phi = phis.at(i)->as_Phi();
+    if (can_reduce_phi(phi, igvn)) {
+      reduce_phi(phi, igvn);
+    }
+  }
+}
+
+// The Phi can be reduced if all its inputs are newly allocated instances
+// and it is only used as the base of constant offset field loads. The memory
+// of each load must be available on each path into the merge: either a
+// memory Phi of the same region or a memory state which dominates it.
+bool ConnectionGraph::can_reduce_phi(PhiNode* phi, PhaseIterGVN* igvn) {
+  Node* region = phi->in(0);
+  if (igvn->type(phi)->isa_instptr() == NULL || phi->outcnt() == 0 ||
+      region == NULL || !region->is_Region() || region->is_Loop()) {
+    return false;
+  }
+  for (uint i = 1; i < phi->req(); i++) {
+    Node* in = phi->in(i);
+    Node* ctrl = region->in(i);
+    if (in == NULL || igvn->type(in) == Type::TOP ||
+        ctrl == NULL || igvn->type(ctrl) == Type::TOP) {
+      return false; // Wait stable graph
+    }
+    AllocateNode* alloc = AllocateNode::Ideal_allocation(in, igvn);
+    if (alloc == NULL || alloc->is_AllocateArray() || alloc->result_cast() != in) {
+      return false;
+    }
+  }
+  for (DUIterator_Fast imax, i = phi->fast_outs(imax); i < imax; i++) {
+    Node* addp = phi->fast_out(i);
+    if (!addp->is_AddP() ||
+        addp->in(AddPNode::Base) != phi ||
+        addp->in(AddPNode::Address) != phi ||
+        !addp->in(AddPNode::Offset)->is_Con()) {
+      return false;
+    }
+    for (DUIterator_Fast jmax, j = addp->fast_outs(jmax); j < jmax; j++) {
+      Node* use = addp->fast_out(j);
+      if (!use->is_Load() ||
+          use->as_Load()->is_mismatched_access() ||
+          use->as_Load()->is_unaligned_access()) {
+        return false;
+      }
+      Node* mem = use->in(MemNode::Memory);
+      if (!(mem->is_Phi() && mem->in(0) == region) &&
+          !MemNode::all_controls_dominate(mem, region)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void ConnectionGraph::reduce_phi(PhiNode* phi, PhaseIterGVN* igvn) {
+  Node* region = phi->in(0);
+  Node_List loads;
+  for (DUIterator_Fast imax, i = phi->fast_outs(imax); i < imax; i++) {
+    Node* addp = phi->fast_out(i);
+    for (DUIterator_Fast jmax, j = addp->fast_outs(jmax); j < jmax; j++) {
+      loads.push(addp->fast_out(j));
+    }
+  }
+#ifndef PRODUCT
+  if (PrintEliminateAllocations) {
+    tty->print_cr("=== Splitting %d loads through merge of allocations %d", loads.size(), phi->_idx);
+  }
+#endif
+  // Replacing the last load also removes the AddP nodes and the Phi.
+  for (uint k = 0; k < loads.size(); k++) {
+    Node* load = loads.at(k);
+    Node* mem = load->in(MemNode::Memory);
+    Node* offset = load->in(MemNode::Address)->in(AddPNode::Offset);
+    PhiNode* value_phi = PhiNode::make_blank(region, load);
+    for (uint i = 1; i < region->req(); i++) {
+      Node* base = phi->in(i);
+      Node* adr = igvn->transform(new AddPNode(base, base, offset));
+      Node* x = load->clone();
+      x->set_req(0, region->in(i));
+      if (mem->is_Phi() && mem->in(0) == region) {
+        x->set_req(MemNode::Memory, mem->in(i));
+      }
+      x->set_req(MemNode::Address, adr);
+      value_phi->init_req(i, igvn->transform(x));
+    }
+    igvn->replace_node(load, igvn->transform(value_phi));
+  }
+}
+
 bool ConnectionGraph::compute_escape() {
   Compile* C = _compile;
   PhaseGVN* igvn = _igvn;
@@ -1087,6 +1207,8 @@ void ConnectionGraph::process_call_arguments(CallNode *call) {
                   strcmp(call->as_CallLeaf()->_name, "counterMode_AESCrypt") == 0 ||
                   strcmp(call->as_CallLeaf()->_name, "ghash_processBlocks") == 0 ||
                   strcmp(call->as_CallLeaf()->_name, "encodeBlock") == 0 ||
+                  strcmp(call->as_CallLeaf()->_name, "md5_implCompress") == 0 ||
+                  strcmp(call->as_CallLeaf()->_name, "md5_implCompressMB") == 0 ||
                   strcmp(call->as_CallLeaf()->_name, "sha1_implCompress") == 0 ||
                   strcmp(call->as_CallLeaf()->_name, "sha1_implCompressMB") == 0 ||
                   strcmp(call->as_CallLeaf()->_name, "sha256_implCompress") == 0 ||
@@ -1098,7 +1220,8 @@ void ConnectionGraph::process_call_arguments(CallNode *call) {
                   strcmp(call->as_CallLeaf()->_name, "mulAdd") == 0 ||
                   strcmp(call->as_CallLeaf()->_name, "montgomery_multiply") == 0 ||
                   strcmp(call->as_CallLeaf()->_name, "montgomery_square") == 0 ||
-                  strcmp(call->as_CallLeaf()->_name, "vectorizedMismatch") == 0)
+                  strcmp(call->as_CallLeaf()->_name, "vectorizedMismatch") == 0 ||
+                  strcmp(call->as_CallLeaf()->_name, "vectorizedHashCode") == 0)
                  ))) {
             call->dump();
             fatal("EA unexpected CallLeaf %s", call->as_CallLeaf()->_name);
@@ -585,6 +585,11 @@ private:
   // Compute the escape information
   bool compute_escape();
 
+  // Split field loads through Phis which merge newly allocated objects.
+  static void reduce_allocation_merges(Compile* C, PhaseIterGVN* igvn);
+  static bool can_reduce_phi(PhiNode* phi, PhaseIterGVN* igvn);
+  static void reduce_phi(PhiNode* phi, PhaseIterGVN* igvn);
+
   void set_not_scalar_replaceable(PointsToNode* ptn NOT_PRODUCT(COMMA const char* reason)) const {
     ptn->set_scalar_replaceable(false);
   }
@@ -6597,13 +6597,13 @@ bool LibraryCallKit::inline_sha_implCompress(vmIntrinsics::ID id) {
 
 //------------------------------inline_digestBase_implCompressMB-----------------------
 //
-// Calculate SHA/SHA2/SHA5 for multi-block byte[] array.
+// Calculate SHA/SHA2/SHA5/MD5 for multi-block byte[] array.
 // int com.sun.security.provider.DigestBase.implCompressMultiBlock(byte[] b, int ofs, int limit)
 //
 bool LibraryCallKit::inline_digestBase_implCompressMB(int predicate) {
-  assert(UseSHA1Intrinsics || UseSHA256Intrinsics || UseSHA512Intrinsics,
-         "need SHA1/SHA256/SHA512 instruction support");
-  assert((uint)predicate < 3, "sanity");
+  assert(UseMD5Intrinsics || UseSHA1Intrinsics || UseSHA256Intrinsics || UseSHA512Intrinsics,
+         "need MD5/SHA1/SHA256/SHA512 instruction support");
+  assert((uint)predicate < 4, "sanity");
   assert(callee()->signature()->size() == 3, "digestBase_implCompressMB has 3 parameters");
 
   Node* digestBase_obj = argument(0); // The receiver was checked for NULL already.
@@ -6654,6 +6654,13 @@ bool LibraryCallKit::inline_digestBase_implCompressMB(int predicate) {
       long_state = true;
     }
     break;
+  case 3:
+    if (UseMD5Intrinsics) {
+      klass_SHA_name = "sun/security/provider/MD5";
+      stub_name = "md5_implCompressMB";
+      stub_addr = StubRoutines::md5_implCompressMB();
+    }
+    break;
   default:
     fatal("unknown SHA intrinsic predicate: %d", predicate);
   }
@@ -6705,7 +6712,7 @@ bool LibraryCallKit::inline_sha_implCompressMB(Node* digestBase_obj, ciInstanceK
 //------------------------------get_state_from_sha_object-----------------------
 Node * LibraryCallKit::get_state_from_sha_object(Node *sha_object) {
   Node* sha_state = load_field_from_object(sha_object, "state", "[I", /*is_exact*/ false);
-  assert (sha_state != NULL, "wrong version of sun.security.provider.SHA/SHA2");
+  assert (sha_state != NULL, "wrong version of sun.security.provider.SHA/SHA2/MD5");
   if (sha_state == NULL) return (Node *) NULL;
 
   // now have the array, need to get the start address of the state array
@@ -6727,12 +6734,12 @@ Node * LibraryCallKit::get_state_from_sha5_object(Node *sha_object) {
 //----------------------------inline_digestBase_implCompressMB_predicate----------------------------
 // Return node representing slow path of predicate check.
 // the pseudo code we want to emulate with this predicate is:
-//    if (digestBaseObj instanceof SHA/SHA2/SHA5) do_intrinsic, else do_javapath
+//    if (digestBaseObj instanceof SHA/SHA2/SHA5/MD5) do_intrinsic, else do_javapath
 //
 Node* LibraryCallKit::inline_digestBase_implCompressMB_predicate(int predicate) {
-  assert(UseSHA1Intrinsics || UseSHA256Intrinsics || UseSHA512Intrinsics,
-         "need SHA1/SHA256/SHA512 instruction support");
-  assert((uint)predicate < 3, "sanity");
+  assert(UseMD5Intrinsics || UseSHA1Intrinsics || UseSHA256Intrinsics || UseSHA512Intrinsics,
+         "need MD5/SHA1/SHA256/SHA512 instruction support");
+  assert((uint)predicate < 4, "sanity");
 
   // The receiver was checked for NULL already.
   Node* digestBaseObj = argument(0);
@@ -6762,6 +6769,12 @@ Node* LibraryCallKit::inline_digestBase_implCompressMB_predicate(int predicate)
       klass_SHA_name = "sun/security/provider/SHA5";
     }
     break;
+  case 3:
+    if (UseMD5Intrinsics) {
+      // we want to do an instanceof comparison against the MD5 class
+      klass_SHA_name = "sun/security/provider/MD5";
+    }
+    break;
   default:
     fatal("unknown SHA intrinsic predicate: %d", predicate);
   }
@@ -6771,7 +6784,7 @@ Node* LibraryCallKit::inline_digestBase_implCompressMB_predicate(int predicate)
     klass_SHA = tinst->klass()->as_instance_klass()->find_klass(ciSymbol::make(klass_SHA_name));
   }
   if ((klass_SHA == NULL) || !klass_SHA->is_loaded()) {
-    // if none of SHA/SHA2/SHA5 is loaded, we never take the intrinsic fast path
+    // if none of SHA/SHA2/SHA5/MD5 is loaded, we never take the intrinsic fast path
     Node* ctrl = control();
     set_control(top()); // no intrinsic path
     return ctrl;
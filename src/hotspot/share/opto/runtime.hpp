@@ -290,6 +290,7 @@ private:
   static const TypeFunc* mulAdd_Type();
 
   static const TypeFunc* vectorizedMismatch_Type();
+  static const TypeFunc* vectorizedHashCode_Type();
 
   static const TypeFunc* ghash_processBlocks_Type();
   static const TypeFunc* base64_encodeBlock_Type();
@@ -2314,6 +2314,25 @@ void SuperWord::output() {
   uint max_vlen_in_bytes = 0;
   uint max_vlen = 0;
   bool can_process_post_loop = (PostLoopMultiversioning && Matcher::has_predicated_vectors() && cl->is_post_loop());
+  // The mask of a post loop selects bytes, so all its memory accesses must
+  // have the same element size.
+  int post_loop_elt_size = 0;
+  if (can_process_post_loop) {
+    for (int i = 0; i < _packset.length(); i++) {
+      Node* p0 = _packset.at(i)->at(0);
+      if (p0->is_Load() || p0->is_Store()) {
+        int elt_size = data_size(p0);
+        if (post_loop_elt_size != 0 && post_loop_elt_size != elt_size) {
+          NOT_PRODUCT(if(is_trace_loop_reverse() || TraceLoopOpts) {tty->print_cr("SWPointer::output: mixed element sizes in post loop, exiting SuperWord");})
+          return;
+        }
+        post_loop_elt_size = elt_size;
+      }
+    }
+    if (post_loop_elt_size == 0) {
+      return;
+    }
+  }
 
   NOT_PRODUCT(if(is_trace_loop_reverse()) {tty->print_cr("SWPointer::output: print loop before create_reserve_version_of_loop"); print_loop(true);})
 
@@ -2362,6 +2381,9 @@ void SuperWord::output() {
         const TypePtr* atyp = n->adr_type();
         vn = LoadVectorNode::make(opc, ctl, mem, adr, atyp, vlen, velt_basic_type(n), control_dependency(p));
         vlen_in_bytes = vn->as_LoadVector()->memory_size();
+        if (can_process_post_loop) {
+          vn->add_flag(Node::Flag_has_vector_mask_set);
+        }
       } else if (n->is_Store()) {
         // Promote value to be stored to vector
         Node* val = vector_opd(p, MemNode::ValueIn);
@@ -2379,6 +2401,9 @@ void SuperWord::output() {
         const TypePtr* atyp = n->adr_type();
         vn = StoreVectorNode::make(opc, ctl, mem, adr, atyp, val, vlen);
         vlen_in_bytes = vn->as_StoreVector()->memory_size();
+        if (can_process_post_loop) {
+          vn->add_flag(Node::Flag_has_vector_mask_set);
+        }
       } else if (VectorNode::is_roundopD(n)) {
         Node* in1 = vector_opd(p, 1);
         Node* in2 = low_adr->in(2);
@@ -2586,7 +2611,9 @@ void SuperWord::output() {
             Node *incr = cl->incr();
             SubINode *index = new SubINode(cl->limit(), cl->init_trip());
             _igvn.register_new_node_with_optimizer(index);
-            SetVectMaskINode  *mask = new SetVectMaskINode(_phase->get_ctrl(cl->init_trip()), index);
+            // The masked loads and stores select bytes, not elements.
+            Node* log2_elt = _igvn.intcon(exact_log2(post_loop_elt_size));
+            SetVectMaskINode  *mask = new SetVectMaskINode(_phase->get_ctrl(cl->init_trip()), index, log2_elt);
             _igvn.register_new_node_with_optimizer(mask);
             // make this a single iteration loop
             AddINode *new_incr = new AddINode(incr->in(1), mask);
@@ -958,10 +958,11 @@ class ExtractDNode : public ExtractNode {
 };
 
 //------------------------------SetVectMaskINode-------------------------------
-// Provide a mask for a vector predicate machine
+// Provide a mask for a vector predicate machine. The mask selects the bytes
+// of in1 elements of size 1 << in2, and the node's value is in1.
 class SetVectMaskINode : public Node {
 public:
-  SetVectMaskINode(Node *c, Node *in1) : Node(c, in1) {}
+  SetVectMaskINode(Node *c, Node *in1, Node *in2) : Node(c, in1, in2) {}
   virtual int Opcode() const;
   const Type *bottom_type() const { return TypeInt::INT; }
   virtual uint ideal_reg() const { return Op_RegI; }
@@ -2060,6 +2060,12 @@ bool Arguments::check_vm_args_consistency() {
 #endif
   }
 
+#if INCLUDE_NMT
+  if (NMTSampleInterval > 1 && MemTracker::tracking_level() == NMT_detail) {
+    MallocTracker::set_sample_interval(NMTSampleInterval);
+  }
+#endif
+
   status = CompilerConfig::check_args_consistency(status);
 #if INCLUDE_JVMCI
   if (status && EnableJVMCI) {
@@ -2848,6 +2854,9 @@ jint Arguments::parse_each_vm_init_arg(const JavaVMInitArgs* args, bool* patch_m
       } else if (strcmp(tail, ":disable") == 0) {
         LogConfiguration::disable_logging();
         ret = true;
+      } else if (strcmp(tail, ":async") == 0) {
+        LogConfiguration::set_async_mode(true);
+        ret = true;
       } else if (*tail == '\0') {
         ret = LogConfiguration::parse_command_line_arguments();
         assert(ret, "-Xlog without arguments should never fail to parse");
@@ -3195,6 +3204,22 @@ jint Arguments::finalize_vm_init_args(bool patch_mod_javabase) {
     // Disable compilation in case user specifies -XX:+DumpSharedSpaces instead of -Xshare:dump.
     set_mode_flags(_int);
   }
+  if (ArchiveClassesAtExit != NULL) {
+    if (DumpSharedSpaces) {
+      // The dump VM started at exit inherits the options from the environment.
+      FLAG_SET_DEFAULT(ArchiveClassesAtExit, NULL);
+    } else {
+      if (!FLAG_IS_DEFAULT(DumpLoadedClassList)) {
+        warning("DumpLoadedClassList is ignored when ArchiveClassesAtExit is specified");
+      }
+      // The class list is written next to the archive.
+      size_t len = strlen(ArchiveClassesAtExit) + sizeof(".classlist");
+      char* list = NEW_C_HEAP_ARRAY(char, len, mtArguments);
+      jio_snprintf(list, len, "%s.classlist", ArchiveClassesAtExit);
+      FLAG_SET_ERGO(ccstr, DumpLoadedClassList, list);
+      FREE_C_HEAP_ARRAY(char, list);
+    }
+  }
   if (UseSharedSpaces && patch_mod_javabase) {
     no_shared_spaces("CDS is disabled when " JAVA_BASE_NAME " module is patched.");
   }
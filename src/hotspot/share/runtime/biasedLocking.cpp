@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2005, 2018, Oracle and/or its affiliates. All rights reserved.
+ * Copyright (c) 2005, 2019, Oracle and/or its affiliates. All rights reserved.
  * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
  *
  * This code is free software; you can redistribute it and/or modify it
@@ -585,6 +585,81 @@ public:
   }
 };
 
+
+// Revokes the biases of objects that are biased toward a single thread.
+// Only that thread can lock or unlock the objects without a CAS, so it is
+// enough to stop that thread (rather than all threads in a safepoint) to
+// walk its stack and fix up its lock records. The objects are revoked in
+// one handshake with the thread, or directly if it is the current thread,
+// and the monitor info of the thread is computed only once for all of them.
+//
+// An object whose bias cannot be revoked here, because it has been rebiased
+// toward another thread in the meantime, is left for the caller to retry.
+class RevokeBiasHandshake : public HandshakeClosure {
+  GrowableArray<Handle>* _objs;
+  GrowableArray<bool>*   _revoked;
+  JavaThread* _requesting_thread;
+  JavaThread* _biased_locker;
+  int _num_revoked;
+  traceid _biased_locker_id;
+
+public:
+  // revoked must have the same length as objs, so that it is never grown
+  // by the thread that executes the closure.
+  RevokeBiasHandshake(GrowableArray<Handle>* objs, GrowableArray<bool>* revoked,
+                      JavaThread* requesting_thread, JavaThread* biased_locker)
+    : HandshakeClosure("RevokeBias")
+    , _objs(objs)
+    , _revoked(revoked)
+    , _requesting_thread(requesting_thread)
+    , _biased_locker(biased_locker)
+    , _num_revoked(0)
+    , _biased_locker_id(0) {
+    assert(revoked->length() == objs->length(), "must be preallocated");
+  }
+
+  void do_thread(Thread* target) {
+    assert(target == _biased_locker, "wrong thread");
+    ResourceMark rm;
+    for (int i = 0; i < _objs->length(); i++) {
+      if (_revoked->at(i)) {
+        continue;
+      }
+      oop obj = _objs->at(i)();
+      markOop mark = obj->mark();
+      if (!mark->has_bias_pattern()) {
+        // Revoked by another thread.
+        _revoked->at_put(i, true);
+        continue;
+      }
+      markOop prototype_header = obj->klass()->prototype_header();
+      if (!prototype_header->has_bias_pattern() ||
+          prototype_header->bias_epoch() != mark->bias_epoch()) {
+        // Stale bias, which any thread may steal with a CAS. See
+        // BiasedLocking::revoke_and_rebias.
+        markOop unbiased_prototype = markOopDesc::prototype()->set_age(mark->age());
+        markOop res_mark = obj->cas_set_mark(unbiased_prototype, mark);
+        if (res_mark == mark || !res_mark->has_bias_pattern()) {
+          _revoked->at_put(i, true);
+        }
+        continue;
+      }
+      if (mark->biased_locker() != _biased_locker) {
+        continue;
+      }
+      BiasedLocking::Condition cond = revoke_bias(obj, false, false, _requesting_thread, NULL);
+      assert(cond == BiasedLocking::BIAS_REVOKED, "why not?");
+      _revoked->at_put(i, true);
+      _num_revoked++;
+    }
+    _biased_locker->set_cached_monitor_info(NULL);
+    _biased_locker_id = JFR_THREAD_ID(_biased_locker);
+  }
+
+  int num_revoked() const       { return _num_revoked; }
+  traceid biased_locker() const { return _biased_locker_id; }
+};
+
 template <typename E>
 static void set_safepoint_id(E* event) {
   assert(event != NULL, "invariant");
@@ -621,6 +696,67 @@ static void post_class_revocation_event(EventBiasedLockClassRevocation* event, K
   event->commit();
 }
 
+static void post_handshake_revocation_event(EventBiasedLockHandshakeRevocation* event, Klass* k,
+                                            RevokeBiasHandshake* revoke) {
+  assert(event != NULL, "invariant");
+  assert(k != NULL, "invariant");
+  assert(revoke != NULL, "invariant");
+  assert(event->should_commit(), "invariant");
+  event->set_lockClass(k);
+  event->set_previousOwner(revoke->biased_locker());
+  event->set_revokedCount(revoke->num_revoked());
+  event->commit();
+}
+
+// Revokes the biases of objs toward biased_locker, which must be another
+// thread, in one handshake with that thread. Sets the entries of revoked
+// for the objects that are no longer biased afterwards. Returns false if
+// the thread has exited, in which case nothing has been done.
+static bool revoke_with_handshake(GrowableArray<Handle>* objs, GrowableArray<bool>* revoked,
+                                  JavaThread* requesting_thread, JavaThread* biased_locker) {
+  assert(requesting_thread != biased_locker, "use revoke_bias on own stack");
+  EventBiasedLockHandshakeRevocation event;
+  jlong start = os::javaTimeNanos();
+  RevokeBiasHandshake revoke(objs, revoked, requesting_thread, biased_locker);
+  if (!Handshake::execute(&revoke, biased_locker)) {
+    return false;
+  }
+  log_info(biasedlocking, handshake)("Revoked %d of %d biases toward thread " INTPTR_FORMAT
+                                     " with a handshake in " JLONG_FORMAT " ns",
+                                     revoke.num_revoked(), objs->length(), p2i(biased_locker),
+                                     os::javaTimeNanos() - start);
+  if (event.should_commit() && revoke.num_revoked() > 0) {
+    post_handshake_revocation_event(&event, objs->at(0)->klass(), &revoke);
+  }
+  return true;
+}
+
+// Revokes the bias of obj at a safepoint, without updating the heuristics.
+static BiasedLocking::Condition single_revoke_at_safepoint(Handle obj, JavaThread* requesting_thread) {
+  EventBiasedLockRevocation event;
+  VM_RevokeBias revoke(&obj, requesting_thread);
+  VMThread::execute(&revoke);
+  if (event.should_commit() && revoke.status_code() != BiasedLocking::NOT_BIASED) {
+    post_revocation_event(&event, obj->klass(), &revoke);
+  }
+  return revoke.status_code();
+}
+
+static BiasedLocking::Condition bulk_revoke(Handle obj, HeuristicsResult heuristics,
+                                            bool attempt_rebias, JavaThread* requesting_thread) {
+  assert((heuristics == HR_BULK_REVOKE) ||
+         (heuristics == HR_BULK_REBIAS), "?");
+  EventBiasedLockClassRevocation event;
+  VM_BulkRevokeBias bulk_revoke(&obj, requesting_thread,
+                                (heuristics == HR_BULK_REBIAS),
+                                attempt_rebias);
+  VMThread::execute(&bulk_revoke);
+  if (event.should_commit()) {
+    post_class_revocation_event(&event, obj->klass(), heuristics != HR_BULK_REBIAS);
+  }
+  return bulk_revoke.status_code();
+}
+
 BiasedLocking::Condition BiasedLocking::revoke_and_rebias(Handle obj, bool attempt_rebias, TRAPS) {
   assert(!SafepointSynchronize::is_at_safepoint(), "must not be called while at safepoint");
 
@@ -711,37 +847,115 @@ BiasedLocking::Condition BiasedLocking::revoke_and_rebias(Handle obj, bool attem
       }
       return cond;
     } else {
-      EventBiasedLockRevocation event;
-      VM_RevokeBias revoke(&obj, (JavaThread*) THREAD);
-      VMThread::execute(&revoke);
-      if (event.should_commit() && revoke.status_code() != NOT_BIASED) {
-        post_revocation_event(&event, k, &revoke);
+      JavaThread* biased_locker = mark->biased_locker();
+      if (biased_locker != NULL && prototype_header->bias_epoch() == mark->bias_epoch()) {
+        // Only the thread owning the bias needs to be stopped to revoke it.
+        ResourceMark rm;
+        GrowableArray<Handle> objs(1);
+        GrowableArray<bool> revoked(1, 1, false);
+        objs.append(obj);
+        if (revoke_with_handshake(&objs, &revoked, (JavaThread*) THREAD, biased_locker) &&
+            revoked.at(0)) {
+          return BIAS_REVOKED;
+        }
+        // The thread has exited or the object has been rebiased toward
+        // another thread in the meantime. Fall back to a safepoint, which
+        // handles both cases.
       }
-      return revoke.status_code();
+      return single_revoke_at_safepoint(obj, (JavaThread*) THREAD);
     }
   }
 
-  assert((heuristics == HR_BULK_REVOKE) ||
-         (heuristics == HR_BULK_REBIAS), "?");
-  EventBiasedLockClassRevocation event;
-  VM_BulkRevokeBias bulk_revoke(&obj, (JavaThread*) THREAD,
-                                (heuristics == HR_BULK_REBIAS),
-                                attempt_rebias);
-  VMThread::execute(&bulk_revoke);
-  if (event.should_commit()) {
-    post_class_revocation_event(&event, obj->klass(), heuristics != HR_BULK_REBIAS);
-  }
-  return bulk_revoke.status_code();
+  return bulk_revoke(obj, heuristics, attempt_rebias, (JavaThread*) THREAD);
 }
 
 
 void BiasedLocking::revoke(GrowableArray<Handle>* objs) {
   assert(!SafepointSynchronize::is_at_safepoint(), "must not be called while at safepoint");
-  if (objs->length() == 0) {
+  int len = objs->length();
+  if (len == 0) {
     return;
   }
-  VM_RevokeBias revoke(objs, JavaThread::current());
-  VMThread::execute(&revoke);
+  JavaThread* requesting_thread = JavaThread::current();
+  ResourceMark rm;
+
+  // Find the thread owning the bias of each object. Anonymously biased
+  // objects and stale biases are left to revoke_and_rebias below, which
+  // revokes them with a CAS. The heuristics are updated once per object:
+  // here for the objects with an owner, or by revoke_and_rebias.
+  GrowableArray<JavaThread*> biased_lockers(len, len, NULL);
+  GrowableArray<bool> counted(len, len, false);
+  GrowableArray<bool> done(len, len, false);
+  for (int i = 0; i < len; i++) {
+    Handle obj = objs->at(i);
+    markOop mark = obj->mark();
+    markOop prototype_header = obj->klass()->prototype_header();
+    if (!mark->has_bias_pattern() || mark->biased_locker() == NULL ||
+        !prototype_header->has_bias_pattern() ||
+        prototype_header->bias_epoch() != mark->bias_epoch()) {
+      continue;
+    }
+    HeuristicsResult heuristics = update_heuristics(obj(), false);
+    counted.at_put(i, true);
+    if (heuristics == HR_SINGLE_REVOKE) {
+      biased_lockers.at_put(i, mark->biased_locker());
+    } else {
+      if (heuristics != HR_NOT_BIASED) {
+        bulk_revoke(obj, heuristics, false, requesting_thread);
+      }
+      done.at_put(i, true);
+    }
+  }
+
+  // Revoke the biases toward each thread in one batch, instead of stopping
+  // all threads in a safepoint: with a handshake for other threads, and by
+  // walking our own stack for the current thread.
+  for (int i = 0; i < len; i++) {
+    JavaThread* biased_locker = biased_lockers.at(i);
+    if (biased_locker == NULL) {
+      continue;
+    }
+    GrowableArray<Handle> batch(len - i);
+    GrowableArray<int> batch_index(len - i);
+    for (int j = i; j < len; j++) {
+      if (biased_lockers.at(j) == biased_locker) {
+        batch.append(objs->at(j));
+        batch_index.append(j);
+        biased_lockers.at_put(j, NULL);
+      }
+    }
+    GrowableArray<bool> revoked(batch.length(), batch.length(), false);
+    if (biased_locker == requesting_thread) {
+      log_info(biasedlocking)("Revoking bias by walking my own stack:");
+      EventBiasedLockSelfRevocation event;
+      RevokeBiasHandshake revoke(&batch, &revoked, requesting_thread, requesting_thread);
+      revoke.do_thread(requesting_thread);
+      if (event.should_commit() && revoke.num_revoked() > 0) {
+        post_self_revocation_event(&event, batch.at(0)->klass());
+      }
+    } else {
+      revoke_with_handshake(&batch, &revoked, requesting_thread, biased_locker);
+    }
+    for (int k = 0; k < batch.length(); k++) {
+      if (revoked.at(k)) {
+        done.at_put(batch_index.at(k), true);
+      }
+    }
+  }
+
+  // Whatever is left is revoked one by one. An object whose owning thread
+  // has exited, or that has been rebiased in the meantime, has already been
+  // counted and goes straight to a safepoint.
+  for (int i = 0; i < len; i++) {
+    if (done.at(i)) {
+      continue;
+    }
+    if (counted.at(i)) {
+      single_revoke_at_safepoint(objs->at(i), requesting_thread);
+    } else {
+      revoke_and_rebias(objs->at(i), false, requesting_thread);
+    }
+  }
 }
 
 
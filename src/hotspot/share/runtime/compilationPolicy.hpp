@@ -88,11 +88,16 @@ public:
   // Select task is called by CompileBroker. The queue is guaranteed to have at least one
   // element and is locked. The function should select one and return it.
   virtual CompileTask* select_task(CompileQueue* compile_queue) = 0;
+  // Compute the priority of a task in the compile queue (see CompileQueue). Called with
+  // the queue locked. By default the tasks are ordered by the time they were queued.
+  virtual void update_task_priority(CompileTask* task) { task->set_priority(0, 0.0); }
   // Tell the runtime if we think a given method is adequately profiled.
   virtual bool is_mature(Method* method) = 0;
   // Do policy initialization
   virtual void initialize() = 0;
   virtual bool should_not_inline(ciEnv* env, ciMethod* method) { return false; }
+  // The profile of the method has been restored from a previous run (see MethodProfileArchive).
+  virtual void profile_preloaded(const methodHandle& method, JavaThread* thread) { }
 };
 
 // A base class for baseline policies.
@@ -293,6 +293,12 @@ define_pd_global(uint64_t,MaxRAM,                    1ULL*G);
           "Use large page memory in metaspace. "                            \
           "Only used if UseLargePages is enabled.")                         \
                                                                             \
+  product(bool, UseLargePagesInCodeCache, false,                            \
+          "Align and commit the code cache in large pages. On Linux, "      \
+          "transparent huge pages are requested with madvise if "           \
+          "UseLargePages does not provide large pages for code, unless "    \
+          "UseTransparentHugePages is explicitly turned off")               \
+                                                                            \
   product(bool, UseNUMA, false,                                             \
           "Use NUMA if available")                                          \
                                                                             \
@@ -450,6 +456,9 @@ define_pd_global(uint64_t,MaxRAM,                    1ULL*G);
   diagnostic(bool, UseAESCTRIntrinsics, false,                              \
           "Use intrinsics for the paralleled version of AES/CTR crypto")    \
                                                                             \
+  diagnostic(bool, UseMD5Intrinsics, false,                                 \
+          "Use intrinsics for MD5 crypto hash function")                    \
+                                                                            \
   diagnostic(bool, UseSHA1Intrinsics, false,                                \
           "Use intrinsics for SHA-1 crypto hash function. "                 \
           "Requires that UseSHA is enabled.")                               \
@@ -474,6 +483,11 @@ define_pd_global(uint64_t,MaxRAM,                    1ULL*G);
   diagnostic(bool, UseVectorizedMismatchIntrinsic, false,                   \
           "Enables intrinsification of ArraysSupport.vectorizedMismatch()") \
                                                                             \
+  diagnostic(bool, UseVectorizedHashCodeIntrinsic, false,                   \
+          "Generates the vectorized stub for the hash codes of primitive "  \
+          "arrays. No method is intrinsified with it until the library "    \
+          "methods are annotated with @HotSpotIntrinsicCandidate")          \
+                                                                            \
   diagnostic(bool, UseCopySignIntrinsic, false,                             \
           "Enables intrinsification of Math.copySign")                      \
                                                                             \
@@ -558,6 +572,12 @@ define_pd_global(uint64_t,MaxRAM,                    1ULL*G);
           "Number of ring buffer event logs")                               \
           range(1, NOT_LP64(1*K) LP64_ONLY(1*M))                            \
                                                                             \
+  diagnostic(uintx, LogEventsBufferShards, 1,                               \
+          "Number of ring buffers the threads spread over in the event "    \
+          "logs of exceptions, deoptimizations and other messages, each "   \
+          "of LogEventsBufferEntries events")                               \
+          range(1, 64)                                                      \
+                                                                            \
   product(bool, BytecodeVerificationRemote, true,                           \
           "Enable the Java bytecode verifier for remote classes")           \
                                                                             \
@@ -674,6 +694,12 @@ define_pd_global(uint64_t,MaxRAM,                    1ULL*G);
   product(ccstr, NativeMemoryTracking, "off",                               \
           "Native memory tracking options")                                 \
                                                                             \
+  product(uintx, NMTSampleInterval, 1,                                      \
+          "With NativeMemoryTracking=detail, capture the call stack of "    \
+          "only every Nth malloc and scale the malloc site statistics "     \
+          "accordingly")                                                    \
+          range(1, max_juint)                                               \
+                                                                            \
   diagnostic(bool, PrintNMTStatistics, false,                               \
           "Print native memory tracking summary data if it is on")          \
                                                                             \
@@ -834,6 +860,15 @@ define_pd_global(uint64_t,MaxRAM,                    1ULL*G);
           "Allow parallel defineClass requests for class loaders "          \
           "registering as parallel capable")                                \
                                                                             \
+  experimental(ccstr, PreloadClassList, NULL,                               \
+          "Load and link the classes named in the specified class list "    \
+          "(e.g., as written by -XX:DumpLoadedClassList) with the system "  \
+          "class loader in background threads during start-up")             \
+                                                                            \
+  experimental(uint, PreloadClassThreads, 2,                                \
+          "Number of threads used for -XX:PreloadClassList")                \
+          range(1, 64)                                                      \
+                                                                            \
   product_pd(bool, DontYieldALot,                                           \
           "Throw away obvious excess yield calls")                          \
                                                                             \
@@ -1330,6 +1365,11 @@ define_pd_global(uint64_t,MaxRAM,                    1ULL*G);
   product(bool, ErrorFileToStdout, false,                                   \
           "If true, error data is printed to stdout instead of a file")     \
                                                                             \
+  product(size_t, AsyncLogBufferSize, 2*M,                                  \
+          "Memory budget (in bytes) for the buffers of asynchronous "       \
+          "logging (-Xlog:async)")                                          \
+          range(100*K, 50*M)                                                \
+                                                                            \
   product(bool, UseHeavyMonitors, false,                                    \
           "use heavyweight instead of lightweight Java monitors")           \
                                                                             \
@@ -1962,6 +2002,17 @@ define_pd_global(uint64_t,MaxRAM,                    1ULL*G);
           "Size of code heap with non-nmethods (in bytes)")                 \
           range(os::vm_page_size(), max_uintx)                              \
                                                                             \
+  experimental(uintx, HotCodeHeapSize, 0,                                   \
+          "Size of code heap with hot tier 4 methods (in bytes), taken "    \
+          "from the non-profiled code heap. Requires SegmentedCodeCache "   \
+          "and TieredCompilation")                                          \
+          range(0, max_uintx)                                               \
+                                                                            \
+  experimental(intx, HotCodeHeapMinRate, 100,                               \
+          "Minimum rate of invocations and backedges per millisecond for "  \
+          "a method to be placed in the hot code heap")                     \
+          range(0, max_jint)                                                \
+                                                                            \
   product_pd(uintx, CodeCacheExpansionSize,                                 \
           "Code cache expansion size (in bytes)")                           \
           range(32*K, max_uintx)                                            \
@@ -2001,6 +2052,14 @@ define_pd_global(uint64_t,MaxRAM,                    1ULL*G);
   product(bool, CalculateClassFingerprint, false,                           \
           "Calculate class fingerprint")                                    \
                                                                             \
+  experimental(ccstr, DumpMethodProfilesAtExit, NULL,                       \
+          "Save the profiles of the methods compiled at the highest "       \
+          "tier to the specified file at exit")                             \
+                                                                            \
+  experimental(ccstr, LoadMethodProfiles, NULL,                             \
+          "Preload the method profiles saved in the specified file by "     \
+          "-XX:DumpMethodProfilesAtExit or Compiler.dump_profiles")         \
+                                                                            \
   /* interpreter debugging */                                               \
   develop(intx, BinarySwitchThreshold, 5,                                   \
           "Minimal number of lookupswitch entries for rewriting to binary " \
@@ -2339,6 +2398,11 @@ define_pd_global(uint64_t,MaxRAM,                    1ULL*G);
           "given timeout in milliseconds")                                  \
           range(0, max_intx)                                                \
                                                                             \
+  product(intx, TieredCompileTaskAgingTime, 100,                            \
+          "Time in milliseconds after which a waiting compile task is "     \
+          "selected as if its method were twice as hot")                    \
+          range(1, max_jint)                                                \
+                                                                            \
   product(intx, TieredStopAtLevel, 4,                                       \
           "Stop at given compilation level")                                \
           range(0, 4)                                                       \
@@ -2473,6 +2537,11 @@ define_pd_global(uint64_t,MaxRAM,                    1ULL*G);
   manageable(bool, PrintConcurrentLocks, false,                             \
           "Print java.util.concurrent locks in thread dump")                \
                                                                             \
+  product(bool, ThreadDumpWithHandshakes, true,                             \
+          "Take the thread snapshots of java.lang.management thread dumps " \
+          "and Thread.getAllStackTraces with a handshake instead of at a "  \
+          "safepoint")                                                      \
+                                                                            \
   product(bool, TransmitErrorReport, false,                                 \
           "Enable error report transmission on erroneous termination")      \
                                                                             \
@@ -2508,6 +2577,14 @@ define_pd_global(uint64_t,MaxRAM,                    1ULL*G);
           "Address to allocate shared memory region for class data")        \
           range(0, SIZE_MAX)                                                \
                                                                             \
+  diagnostic(int, ArchiveRelocationMode, 0,                                 \
+          "(0) first map at preferred address, and if "                     \
+          "unsuccessful, map at alternative address (default); "           \
+          "(1) always map at alternative address; "                         \
+          "(2) always map at preferred address, and if unsuccessful, "      \
+          "do not map the archive")                                         \
+          range(0, 2)                                                       \
+                                                                            \
   product(ccstr, SharedArchiveConfigFile, NULL,                             \
           "Data to add to the CDS archive file")                            \
                                                                             \
@@ -2609,7 +2686,14 @@ define_pd_global(uint64_t,MaxRAM,                    1ULL*G);
                                                                             \
   product(ccstr, DumpLoadedClassList, NULL,                                 \
           "Dump the names all loaded classes, that could be stored into "   \
-          "the CDS archive, in the specified file")                         \
+          "the CDS archive, in the specified file. Classes loaded by "      \
+          "custom class loaders from local jar files or directories are "   \
+          "included with their super class, interfaces and source")         \
+                                                                            \
+  product(ccstr, ArchiveClassesAtExit, NULL,                                \
+          "Write a CDS archive of the classes loaded by the application, "  \
+          "including those of custom class loaders from local jar files "   \
+          "or directories, to the specified file when the VM exits")        \
                                                                             \
   product(ccstr, SharedClassListFile, NULL,                                 \
           "Override the default CDS class list")                            \
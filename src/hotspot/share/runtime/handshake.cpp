@@ -402,7 +402,8 @@ bool Handshake::execute(HandshakeClosure* thread_cl, JavaThread* target) {
   }
 }
 
-HandshakeState::HandshakeState() : _operation(NULL), _semaphore(1), _thread_in_process_handshake(false) {}
+HandshakeState::HandshakeState() : _operation(NULL), _semaphore(1), _thread_in_process_handshake(false),
+  _active_handshaker(NULL) {}
 
 void HandshakeState::set_operation(JavaThread* target, HandshakeOperation* op) {
   _operation = op;
@@ -428,7 +429,9 @@ void HandshakeState::process_self_inner(JavaThread* thread) {
     CautiouslyPreserveExceptionMark pem(thread);
     // Disarm before execute the operation
     clear_handshake(thread);
+    _active_handshaker = thread;
     op->do_handshake(thread);
+    _active_handshaker = NULL;
   }
   _semaphore.signal();
 }
@@ -504,7 +507,9 @@ HandshakeState::ProcessResult HandshakeState::try_process_by_vmThread(JavaThread
   ProcessResult pr = _not_safe;
   if (vmthread_can_process_handshake(target)) {
     guarantee(!_semaphore.trywait(), "we should already own the semaphore");
+    _active_handshaker = Thread::current();
     _operation->do_handshake(target);
+    _active_handshaker = NULL;
     // Disarm after VM thread have executed the operation.
     clear_handshake(target);
     // Release the thread
@@ -65,6 +65,8 @@ class HandshakeState {
 
   Semaphore _semaphore;
   bool _thread_in_process_handshake;
+  // The thread executing the operation, the JavaThread itself or the VM thread.
+  Thread* volatile _active_handshaker;
 
   bool claim_handshake_for_vmthread();
   bool vmthread_can_process_handshake(JavaThread* target);
@@ -81,6 +83,8 @@ public:
     return _operation != NULL;
   }
 
+  Thread* active_handshaker() const { return _active_handshaker; }
+
   void process_by_self(JavaThread* thread) {
     if (!_thread_in_process_handshake) {
       FlagSetting fs(_thread_in_process_handshake, true);
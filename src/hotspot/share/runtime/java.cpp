@@ -31,6 +31,7 @@
 #include "code/codeCache.hpp"
 #include "compiler/compileBroker.hpp"
 #include "compiler/compilerOracle.hpp"
+#include "compiler/methodProfileArchive.hpp"
 #include "interpreter/bytecodeHistogram.hpp"
 #include "jfr/jfrEvents.hpp"
 #include "jfr/support/jfrThreadId.hpp"
@@ -39,7 +40,9 @@
 #include "jvmci/jvmciRuntime.hpp"
 #endif
 #include "logging/log.hpp"
+#include "logging/logAsyncWriter.hpp"
 #include "logging/logStream.hpp"
+#include "memory/metaspaceShared.hpp"
 #include "memory/oopFactory.hpp"
 #include "memory/resourceArea.hpp"
 #include "memory/universe.hpp"
@@ -485,6 +488,16 @@ void before_exit(JavaThread* thread) {
   }
 #endif
 
+  if (DumpMethodProfilesAtExit != NULL) {
+    MethodProfileArchive::dump(DumpMethodProfilesAtExit, NULL);
+  }
+
+#if INCLUDE_CDS
+  if (ArchiveClassesAtExit != NULL) {
+    MetaspaceShared::dump_archive_at_exit(thread);
+  }
+#endif
+
   // Hang forever on exit if we're reporting an error.
   if (ShowMessageBoxOnError && VMError::is_error_reported()) {
     os::infinite_sleep();
@@ -543,6 +556,9 @@ void before_exit(JavaThread* thread) {
   print_statistics();
   Universe::heap()->print_tracing_info();
 
+  // Write out the log messages that are still buffered
+  AsyncLogWriter::flush();
+
   { MutexLocker ml(BeforeExit_lock);
     _before_exit_status = BEFORE_EXIT_DONE;
     BeforeExit_lock->notify_all();
@@ -38,6 +38,7 @@
 #include "runtime/objectMonitor.inline.hpp"
 #include "runtime/orderAccess.hpp"
 #include "runtime/osThread.hpp"
+#include "runtime/perfData.inline.hpp"
 #include "runtime/safefetch.inline.hpp"
 #include "runtime/safepointMechanism.inline.hpp"
 #include "runtime/sharedRuntime.hpp"
@@ -2240,13 +2241,13 @@ inline void ObjectMonitor::DequeueSpecificWaiter(ObjectWaiter* node) {
 
 // -----------------------------------------------------------------------------
 // PerfData support
-PerfCounter * ObjectMonitor::_sync_ContendedLockAttempts       = NULL;
-PerfCounter * ObjectMonitor::_sync_FutileWakeups               = NULL;
-PerfCounter * ObjectMonitor::_sync_Parks                       = NULL;
-PerfCounter * ObjectMonitor::_sync_Notifications               = NULL;
-PerfCounter * ObjectMonitor::_sync_Inflations                  = NULL;
-PerfCounter * ObjectMonitor::_sync_Deflations                  = NULL;
-PerfLongVariable * ObjectMonitor::_sync_MonExtant              = NULL;
+PerfStripedCounter * ObjectMonitor::_sync_ContendedLockAttempts = NULL;
+PerfStripedCounter * ObjectMonitor::_sync_FutileWakeups        = NULL;
+PerfStripedCounter * ObjectMonitor::_sync_Parks                = NULL;
+PerfStripedCounter * ObjectMonitor::_sync_Notifications        = NULL;
+PerfStripedCounter * ObjectMonitor::_sync_Inflations           = NULL;
+PerfStripedCounter * ObjectMonitor::_sync_Deflations           = NULL;
+PerfLongVariable * ObjectMonitor::_sync_MonExtant               = NULL;
 
 // One-shot global initialization for the sync subsystem.
 // We could also defer initialization and initialize on-demand
@@ -2259,10 +2260,10 @@ void ObjectMonitor::Initialize() {
   InitializationCompleted = 1;
   if (UsePerfData) {
     EXCEPTION_MARK;
-#define NEWPERFCOUNTER(n)                                                \
-  {                                                                      \
-    n = PerfDataManager::create_counter(SUN_RT, #n, PerfData::U_Events,  \
-                                        CHECK);                          \
+#define NEWPERFCOUNTER(n)                                                        \
+  {                                                                              \
+    n = PerfDataManager::create_striped_counter(SUN_RT, #n, PerfData::U_Events,  \
+                                                CHECK);                          \
   }
 #define NEWPERFVARIABLE(n)                                                \
   {                                                                       \
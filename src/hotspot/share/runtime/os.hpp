@@ -422,6 +422,9 @@ class os: AllStatic {
   static size_t large_page_size();
   static bool   can_commit_large_page_memory();
   static bool   can_execute_large_page_memory();
+  // The page size the code cache is aligned to and committed in with
+  // UseLargePagesInCodeCache, or vm_page_size() if there is none.
+  static size_t code_large_page_size();
 
   // OS interface to polling page
   static address get_polling_page()             { return _polling_page; }
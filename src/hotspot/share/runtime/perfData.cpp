@@ -27,7 +27,9 @@
 #include "classfile/vmSymbols.hpp"
 #include "logging/log.hpp"
 #include "memory/allocation.inline.hpp"
+#include "memory/padded.inline.hpp"
 #include "oops/oop.inline.hpp"
+#include "runtime/atomic.hpp"
 #include "runtime/handles.inline.hpp"
 #include "runtime/java.hpp"
 #include "runtime/mutex.hpp"
@@ -219,6 +221,32 @@ void PerfLongVariant::sample() {
   }
 }
 
+PerfLongStripedCounter::PerfLongStripedCounter(CounterNS ns, const char* namep, Units u)
+                                              : PerfLong(ns, namep, u, V_Monotonic) {
+  // At most one stripe per processor, the sum is taken at each sample.
+  const uint max_stripes = 64;
+  uint num_stripes = 1;
+  while (num_stripes < MIN2((uint)os::processor_count(), max_stripes)) {
+    num_stripes *= 2;
+  }
+  // Never freed, increments may race with the deletion at VM exit.
+  _stripes = PaddedArray<Stripe, mtInternal>::create_unfreeable(num_stripes);
+  _stripe_mask = num_stripes - 1;
+  if (is_valid()) *(jlong*)_valuep = 0;
+}
+
+jlong PerfLongStripedCounter::get_value() {
+  jlong sum = 0;
+  for (uint i = 0; i <= _stripe_mask; i++) {
+    sum += Atomic::load(&_stripes[i]._value);
+  }
+  return sum;
+}
+
+void PerfLongStripedCounter::sample() {
+  *(jlong*)_valuep = get_value();
+}
+
 PerfByteArray::PerfByteArray(CounterNS ns, const char* namep, Units u,
                              Variability v, jint length)
                             : PerfData(ns, namep, u, v), _length(length) {
@@ -564,6 +592,27 @@ PerfLongCounter* PerfDataManager::create_long_counter(CounterNS ns,
   return p;
 }
 
+PerfLongStripedCounter* PerfDataManager::create_long_striped_counter(CounterNS ns,
+                                                                    const char* name,
+                                                                    PerfData::Units u,
+                                                                    TRAPS) {
+
+  // Sampled counters not supported if UsePerfData is false
+  if (!UsePerfData) return NULL;
+
+  PerfLongStripedCounter* p = new PerfLongStripedCounter(ns, name, u);
+
+  if (!p->is_valid()) {
+    // allocation of native resources failed.
+    delete p;
+    THROW_0(vmSymbols::java_lang_OutOfMemoryError());
+  }
+
+  add_item(p, true);
+
+  return p;
+}
+
 PerfDataList::PerfDataList(int length) {
 
   _set = new(ResourceObj::C_HEAP, mtInternal) PerfDataArray(length, true);
@@ -26,6 +26,7 @@
 #define SHARE_VM_RUNTIME_PERFDATA_HPP
 
 #include "memory/allocation.hpp"
+#include "memory/padded.hpp"
 #include "runtime/perfMemory.hpp"
 #include "runtime/timer.hpp"
 
@@ -228,6 +229,19 @@ enum CounterNS {
  *
  *     As before, PerfSampleHelper is an alias for PerfLongSampleHelper.
  *
+ * Creating a striped counter for a hot path that many threads take at once.
+ *
+ *     PerfStripedCounter* baz_counter;
+ *     baz_counter = PerfDataManager::create_striped_counter(SUN_RT, "baz",
+ *                                                           PerfData::U_Events,
+ *                                                           CHECK);
+ *     baz_counter->inc();
+ *
+ *     The increments are spread over cache line padded stripes, which the
+ *     StatSampler sums into the PerfData memory region at a regular
+ *     interval. Like the other sampled counters, striped counters are not
+ *     created if UsePerfData is false.
+ *
  * For additional uses of PerfData subtypes, see the utility classes
  * PerfTraceTime and PerfTraceTimedEvent below.
  *
@@ -492,6 +506,57 @@ class PerfLongVariable : public PerfLongVariant {
 
 typedef PerfLongVariable PerfVariable;
 
+/*
+ * The PerfLongStripedCounter class, and its alias PerfStripedCounter,
+ * implement a monotonic counter for hot paths that are taken by many
+ * threads at once, such as monitor contention and class loading.
+ *
+ * A plain PerfLongCounter is a single word in the PerfData memory region,
+ * so every thread that increments it writes to the same cache line. The
+ * striped counter instead increments one of a set of cache line padded
+ * stripes, selected by the current thread, with at most one stripe per
+ * processor. The stripes are summed when the counter is sampled by the
+ * StatSampler, and by get_value(). The value seen by external readers
+ * of the PerfData memory region therefore lags by up to one sampling
+ * interval.
+ */
+class PerfLongStripedCounter : public PerfLong {
+
+  friend class PerfDataManager; // for access to protected constructor
+
+  public:
+    class Stripe {
+      public:
+        volatile jlong _value;
+        Stripe() : _value(0) { }
+    };
+
+  private:
+    PaddedEnd<Stripe>* _stripes;
+    uint               _stripe_mask;
+
+    inline PaddedEnd<Stripe>* stripe();
+
+  protected:
+
+    PerfLongStripedCounter(CounterNS ns, const char* namep, Units u);
+
+    void sample();
+
+  public:
+    inline void inc();
+    inline void inc(jlong val);
+    inline void add(jlong val) { inc(val); }
+
+    // returns the sum of the stripes, which is more recent than the
+    // value in the PerfData memory region.
+    jlong get_value();
+
+    uint num_stripes() const { return _stripe_mask + 1; }
+};
+
+typedef PerfLongStripedCounter PerfStripedCounter;
+
 /*
  * The PerfByteArray provides a PerfData subtype that allows the creation
  * of a contiguous region of the PerfData memory region for storing a vector
@@ -821,6 +886,11 @@ class PerfDataManager : AllStatic {
                                                 PerfLongSampleHelper* sh,
                                                 TRAPS);
 
+    static PerfLongStripedCounter* create_long_striped_counter(CounterNS ns,
+                                                               const char* name,
+                                                               PerfData::Units u,
+                                                               TRAPS);
+
 
     // these creation methods are provided for ease of use. These allow
     // Long performance data types to be created with a shorthand syntax.
@@ -872,6 +942,13 @@ class PerfDataManager : AllStatic {
       return create_long_counter(ns, name, u, sh, THREAD);
     }
 
+    static PerfStripedCounter* create_striped_counter(CounterNS ns,
+                                                      const char* name,
+                                                      PerfData::Units u,
+                                                      TRAPS) {
+      return create_long_striped_counter(ns, name, u, THREAD);
+    }
+
     static void destroy();
     static bool has_PerfData() { return _has_PerfData; }
 };
@@ -889,6 +966,10 @@ class PerfDataManager : AllStatic {
   {counter = PerfDataManager::create_counter(counter_ns, counter_name, \
                                              PerfData::U_Bytes,CHECK);}
 
+#define NEWPERFSTRIPEDEVENTCOUNTER(counter, counter_ns, counter_name)  \
+  {counter = PerfDataManager::create_striped_counter(counter_ns, counter_name, \
+                                                     PerfData::U_Events,CHECK);}
+
 // Utility Classes
 
 /*
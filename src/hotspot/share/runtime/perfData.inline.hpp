@@ -25,7 +25,9 @@
 #ifndef SHARE_VM_RUNTIME_PERFDATA_INLINE_HPP
 #define SHARE_VM_RUNTIME_PERFDATA_INLINE_HPP
 
+#include "runtime/atomic.hpp"
 #include "runtime/perfData.hpp"
+#include "runtime/thread.hpp"
 #include "utilities/globalDefinitions.hpp"
 #include "utilities/growableArray.hpp"
 
@@ -61,4 +63,16 @@ inline bool PerfDataManager::exists(const char* name) {
   return _all->contains(name);
 }
 
+inline PaddedEnd<PerfLongStripedCounter::Stripe>* PerfLongStripedCounter::stripe() {
+  return &_stripes[Thread::current_hash() & _stripe_mask];
+}
+
+inline void PerfLongStripedCounter::inc() {
+  Atomic::inc(&stripe()->_value);
+}
+
+inline void PerfLongStripedCounter::inc(jlong val) {
+  Atomic::add(val, &stripe()->_value);
+}
+
 #endif // SHARE_VM_RUNTIME_PERFDATA_INLINE_HPP
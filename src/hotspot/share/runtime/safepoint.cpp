@@ -617,8 +617,8 @@ private:
 
 public:
   ParallelSPCleanupThreadClosure(DeflateMonitorCounters* counters) :
-    _counters(counters),
-    _nmethod_cl(NMethodSweeper::prepare_mark_active_nmethods()) {}
+    _nmethod_cl(NMethodSweeper::prepare_reset_hotness_counters()),
+    _counters(counters) {}
 
   void do_thread(Thread* thread) {
     ObjectSynchronizer::deflate_thread_local_monitors(thread, _counters);
@@ -645,7 +645,7 @@ public:
     _counters(counters) {}
 
   void work(uint worker_id) {
-    // All threads deflate monitors and mark nmethods (if necessary).
+    // All threads deflate monitors and reset hotness counters (if necessary).
     Threads::possibly_parallel_threads_do(true, &_cleanup_threads_cl);
 
     if (!_subtasks.is_task_claimed(SafepointSynchronize::SAFEPOINT_CLEANUP_DEFLATE_MONITORS)) {
@@ -736,6 +736,10 @@ void SafepointSynchronize::do_cleanup_tasks() {
   DeflateMonitorCounters deflate_counters;
   ObjectSynchronizer::prepare_deflate_idle_monitors(&deflate_counters);
 
+  // Advance the sweeper's virtual time. Not-entrant nmethods are marked by the
+  // sweeper thread itself with a handshake, not here.
+  NMethodSweeper::safepoint_tick();
+
   CollectedHeap* heap = Universe::heap();
   assert(heap != NULL, "heap not initialized yet?");
   WorkGang* cleanup_workers = heap->get_safepoint_workers();
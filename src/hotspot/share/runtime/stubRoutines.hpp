@@ -176,6 +176,9 @@ class StubRoutines: AllStatic {
   static address _ghash_processBlocks;
   static address _base64_encodeBlock;
 
+  static address _md5_implCompress;
+  static address _md5_implCompressMB;
+
   static address _sha1_implCompress;
   static address _sha1_implCompressMB;
   static address _sha256_implCompress;
@@ -197,6 +200,7 @@ class StubRoutines: AllStatic {
   static address _montgomerySquare;
 
   static address _vectorizedMismatch;
+  static address _vectorizedHashCode;
 
   static address _dexp;
   static address _dlog;
@@ -353,6 +357,8 @@ class StubRoutines: AllStatic {
   static address counterMode_AESCrypt()  { return _counterMode_AESCrypt; }
   static address ghash_processBlocks()   { return _ghash_processBlocks; }
   static address base64_encodeBlock()    { return _base64_encodeBlock; }
+  static address md5_implCompress()      { return _md5_implCompress; }
+  static address md5_implCompressMB()    { return _md5_implCompressMB; }
   static address sha1_implCompress()     { return _sha1_implCompress; }
   static address sha1_implCompressMB()   { return _sha1_implCompressMB; }
   static address sha256_implCompress()   { return _sha256_implCompress; }
@@ -374,6 +380,7 @@ class StubRoutines: AllStatic {
   static address montgomerySquare()    { return _montgomerySquare; }
 
   static address vectorizedMismatch()  { return _vectorizedMismatch; }
+  static address vectorizedHashCode()  { return _vectorizedHashCode; }
 
   static address dexp()                { return _dexp; }
   static address dlog()                { return _dlog; }
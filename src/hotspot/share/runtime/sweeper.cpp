@@ -36,14 +36,13 @@
 #include "oops/method.hpp"
 #include "runtime/atomic.hpp"
 #include "runtime/compilationPolicy.hpp"
+#include "runtime/handshake.hpp"
 #include "runtime/interfaceSupport.inline.hpp"
 #include "runtime/mutexLocker.hpp"
 #include "runtime/orderAccess.hpp"
 #include "runtime/os.hpp"
 #include "runtime/sweeper.hpp"
 #include "runtime/thread.inline.hpp"
-#include "runtime/vmOperations.hpp"
-#include "runtime/vmThread.hpp"
 #include "utilities/events.hpp"
 #include "utilities/xmlstream.hpp"
 
@@ -151,6 +150,7 @@ volatile int  NMethodSweeper::_bytes_changed           = 0;    // Counts the tot
                                                                //   1) alive       -> not_entrant
                                                                //   2) not_entrant -> zombie
 int    NMethodSweeper::_hotness_counter_reset_val       = 0;
+jlong  NMethodSweeper::_last_stack_scan                 = 0;   // Time of the last stack scan handshake (ns)
 
 long   NMethodSweeper::_total_nof_methods_reclaimed     = 0;   // Accumulated nof methods flushed
 long   NMethodSweeper::_total_nof_c2_methods_reclaimed  = 0;   // Accumulated nof methods flushed
@@ -184,6 +184,21 @@ public:
 };
 static SetHotnessClosure set_hotness_closure;
 
+// Marks the nmethods on the stack of each Java thread, one thread at a time.
+// The code cache sweeper thread has no compiled frames and is skipped.
+class NMethodMarkingClosure : public HandshakeClosure {
+ private:
+  CodeBlobClosure* _cl;
+ public:
+  NMethodMarkingClosure(CodeBlobClosure* cl) : HandshakeClosure("NMethodMarking"), _cl(cl) {}
+  void do_thread(Thread* thread) {
+    if (thread->is_Java_thread() && ! thread->is_Code_cache_sweeper_thread()) {
+      JavaThread* jt = (JavaThread*) thread;
+      jt->nmethods_do(_cl);
+    }
+  }
+};
+
 
 int NMethodSweeper::hotness_counter_reset_val() {
   if (_hotness_counter_reset_val == 0) {
@@ -196,28 +211,40 @@ bool NMethodSweeper::wait_for_stack_scanning() {
 }
 
 /**
-  * Scans the stacks of all Java threads and marks activations of not-entrant methods.
-  * No need to synchronize access, since 'mark_active_nmethods' is always executed at a
-  * safepoint.
+  * Advances the virtual time that is used to estimate when to invoke the
+  * sweeper again. Called by the VM thread at each safepoint.
   */
-void NMethodSweeper::mark_active_nmethods() {
-  CodeBlobClosure* cl = prepare_mark_active_nmethods();
-  if (cl != NULL) {
-    Threads::nmethods_do(cl);
+void NMethodSweeper::safepoint_tick() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be executed at a safepoint");
+  _time_counter++;
+}
+
+/**
+  * Returns the closure that resets the hotness counters of the nmethods that
+  * are active on a thread's stack, or NULL if nmethods are not flushed for
+  * being cold. The safepoint cleanup applies it to all Java threads, so that
+  * methods that are running between two stack traversals stay hot.
+  */
+CodeBlobClosure* NMethodSweeper::prepare_reset_hotness_counters() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be executed at a safepoint");
+  if (!MethodFlushing || !UseCodeCacheFlushing) {
+    return NULL;
   }
+  return &set_hotness_closure;
 }
 
+/**
+  * Starts a new traversal of the code cache. Returns the closure that marks
+  * activations of not-entrant methods, or NULL if no stack scanning is needed.
+  */
 CodeBlobClosure* NMethodSweeper::prepare_mark_active_nmethods() {
-  assert(SafepointSynchronize::is_at_safepoint(), "must be executed at a safepoint");
+  assert(CodeCache_lock->owned_by_self(), "must hold the CodeCache_lock");
   // If we do not want to reclaim not-entrant or zombie methods there is no need
   // to scan stacks
   if (!MethodFlushing) {
     return NULL;
   }
 
-  // Increase time so that we can estimate when to invoke the sweeper again.
-  _time_counter++;
-
   // Check for restart
   if (_current.method() != NULL) {
     if (_current.method()->is_nmethod()) {
@@ -229,35 +256,45 @@ CodeBlobClosure* NMethodSweeper::prepare_mark_active_nmethods() {
     }
   }
 
-  if (wait_for_stack_scanning()) {
-    _seen = 0;
-    _current = CompiledMethodIterator();
-    // Initialize to first nmethod
-    _current.next();
-    _traversals += 1;
-    _total_time_this_sweep = Tickspan();
-
-    if (PrintMethodFlushing) {
-      tty->print_cr("### Sweep: stack traversal %ld", _traversals);
-    }
-    return &mark_activation_closure;
-
-  } else {
-    // Only set hotness counter
-    return &set_hotness_closure;
+  if (!wait_for_stack_scanning()) {
+    // A traversal is still in progress.
+    return NULL;
   }
 
+  _seen = 0;
+  _current = CompiledMethodIterator();
+  // Initialize to first nmethod
+  _current.next();
+  _traversals += 1;
+  _total_time_this_sweep = Tickspan();
+
+  if (PrintMethodFlushing) {
+    tty->print_cr("### Sweep: stack traversal %ld", _traversals);
+  }
+  return &mark_activation_closure;
 }
 
 /**
-  * This function triggers a VM operation that does stack scanning of active
-  * methods. Stack scanning is mandatory for the sweeper to make progress.
+  * This function performs stack scanning of active methods with a handshake.
+  * Stack scanning is mandatory for the sweeper to make progress. Only the
+  * sweeper thread starts a traversal, and it does so between two sweeps, so
+  * no other synchronization with sweep_code_cache() is needed. A method that
+  * is made not-entrant while the handshake is in progress is marked with the
+  * new traversal by mark_as_seen_on_stack().
   */
 void NMethodSweeper::do_stack_scanning() {
   assert(!CodeCache_lock->owned_by_self(), "just checking");
   if (wait_for_stack_scanning()) {
-    VM_MarkActiveNMethods op;
-    VMThread::execute(&op);
+    CodeBlobClosure* code_cl;
+    {
+      MutexLockerEx ccl(CodeCache_lock, Mutex::_no_safepoint_check_flag);
+      code_cl = prepare_mark_active_nmethods();
+    }
+    if (code_cl != NULL) {
+      NMethodMarkingClosure nm_cl(code_cl);
+      Handshake::execute(&nm_cl);
+      _last_stack_scan = os::javaTimeNanos();
+    }
     _should_sweep = true;
   }
 }
@@ -268,8 +305,23 @@ void NMethodSweeper::sweeper_loop() {
     {
       ThreadBlockInVM tbivm(JavaThread::current());
       MutexLockerEx waiter(CodeCache_lock, Mutex::_no_safepoint_check_flag);
-      const long wait_time = 60*60*24 * 1000;
-      timeout = CodeCache_lock->wait(Mutex::_no_safepoint_check_flag, wait_time);
+      // Do not wait for the next notification if the last sweep changed enough
+      // nmethods to request another one. Stack scanning no longer needs a
+      // safepoint, so the follow-up sweeps that move these nmethods to zombie
+      // and flushed state can start early. Each sweep handshakes all Java
+      // threads, so leave at least min_scan_interval between two of them,
+      // unless the sweeper is notified meanwhile.
+      if (_should_sweep) {
+        const jlong min_scan_interval = 100; // ms
+        jlong since_last_scan = (os::javaTimeNanos() - _last_stack_scan) / NANOSECS_PER_MILLISEC;
+        if (since_last_scan < min_scan_interval) {
+          CodeCache_lock->wait(Mutex::_no_safepoint_check_flag, (long)(min_scan_interval - since_last_scan));
+        }
+        timeout = false;
+      } else {
+        const long wait_time = 60*60*24 * 1000;
+        timeout = CodeCache_lock->wait(Mutex::_no_safepoint_check_flag, wait_time);
+      }
     }
     if (!timeout) {
       possibly_sweep();
@@ -347,7 +399,7 @@ void NMethodSweeper::possibly_sweep() {
   // Large ReservedCodeCacheSize :  (e.g., 256M + code cache is 10% full). The formula
   //                                              computes: (256 / 16) - 1 = 15
   //                                              As a result, we invoke the sweeper after
-  //                                              15 invocations of 'mark_active_nmethods.
+  //                                              15 safepoints.
   // Large ReservedCodeCacheSize:   (e.g., 256M + code Cache is 90% full). The formula
   //                                              computes: (256 / 16) - 10 = 6.
   if (!_should_sweep) {
@@ -381,6 +433,8 @@ void NMethodSweeper::possibly_sweep() {
 
   if (_should_sweep || forced) {
     init_sweeper_log();
+    // Every sweep starts with a new stack traversal
+    do_stack_scanning();
     sweep_code_cache();
 
     // We are done with sweeping the code cache once.
@@ -37,13 +37,18 @@ class CodeBlobClosure;
 //    - reclamation of nmethods
 // Removing nmethods from the code cache includes two operations
 //  1) mark active nmethods
-//     Is done in 'mark_active_nmethods()'. This function is called at a
-//     safepoint and marks all nmethods that are active on a thread's stack.
+//     Is done in 'do_stack_scanning()'. The sweeper thread executes a handshake
+//     that marks all nmethods that are active on a thread's stack, one thread
+//     at a time. No global safepoint is needed (unless thread-local handshakes
+//     are disabled), so Java threads are only stopped to scan their own stack.
+//     Between two traversals, the hotness counters of the nmethods active on a
+//     thread's stack are reset at each safepoint, see
+//     'prepare_reset_hotness_counters()', so that hot methods are not flushed.
 //  2) sweep nmethods
 //     Is done in sweep_code_cache(). This function is the only place in the
 //     sweeper where memory is reclaimed. Note that sweep_code_cache() is not
-//     called at a safepoint. However, sweep_code_cache() stops executing if
-//     another thread requests a safepoint. Consequently, 'mark_active_nmethods()'
+//     called at a safepoint. A new traversal is only started by the sweeper
+//     thread itself, after the previous sweep has completed, so stack scanning
 //     and sweep_code_cache() cannot execute at the same time.
 //     To reclaim memory, nmethods are first marked as 'not-entrant'. Methods can
 //     be made not-entrant by (i) the sweeper, (ii) deoptimization, (iii) dependency
@@ -82,6 +87,7 @@ class NMethodSweeper : public AllStatic {
   static long      _total_nof_c2_methods_reclaimed; // Accumulated nof C2-compiled methods flushed
   static size_t    _total_flushed_size;             // Total size of flushed methods
   static int       _hotness_counter_reset_val;
+  static jlong     _last_stack_scan;              // os::javaTimeNanos() at the end of the last stack scan
 
   static Tickspan  _total_time_sweeping;          // Accumulated time sweeping
   static Tickspan  _total_time_this_sweep;        // Total time this sweep
@@ -96,6 +102,7 @@ class NMethodSweeper : public AllStatic {
   static void handle_safepoint_request();
   static void do_stack_scanning();
   static void possibly_sweep();
+  static CodeBlobClosure* prepare_mark_active_nmethods();
  public:
   static long traversal_count()              { return _traversals; }
   static int  total_nof_methods_reclaimed()  { return _total_nof_methods_reclaimed; }
@@ -112,8 +119,8 @@ class NMethodSweeper : public AllStatic {
   static void report_events();
 #endif
 
-  static void mark_active_nmethods();      // Invoked at the end of each safepoint
-  static CodeBlobClosure* prepare_mark_active_nmethods();
+  static void safepoint_tick();            // Invoked at each safepoint
+  static CodeBlobClosure* prepare_reset_hotness_counters();
   static void sweeper_loop();
   static void notify(int code_blob_type);  // Possibly start the sweeper thread.
   static void force_sweep();
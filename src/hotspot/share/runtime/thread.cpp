@@ -26,6 +26,7 @@
 #include "precompiled.hpp"
 #include "jvm.h"
 #include "classfile/classLoader.hpp"
+#include "classfile/classPreloader.hpp"
 #include "classfile/javaClasses.hpp"
 #include "classfile/moduleEntry.hpp"
 #include "classfile/systemDictionary.hpp"
@@ -34,6 +35,7 @@
 #include "code/scopeDesc.hpp"
 #include "compiler/compileBroker.hpp"
 #include "compiler/compileTask.hpp"
+#include "compiler/methodProfileArchive.hpp"
 #include "gc/shared/barrierSet.hpp"
 #include "gc/shared/gcId.hpp"
 #include "gc/shared/gcLocker.inline.hpp"
@@ -44,6 +46,7 @@
 #include "jfr/jfrEvents.hpp"
 #include "jvmtifiles/jvmtiEnv.hpp"
 #include "logging/log.hpp"
+#include "logging/logAsyncWriter.hpp"
 #include "logging/logConfiguration.hpp"
 #include "logging/logStream.hpp"
 #include "memory/allocation.inline.hpp"
@@ -179,8 +182,8 @@ void* Thread::allocate(size_t size, bool throw_excpt, MEMFLAGS flags) {
   if (UseBiasedLocking) {
     const int alignment = markOopDesc::biased_lock_alignment;
     size_t aligned_size = size + (alignment - sizeof(intptr_t));
-    void* real_malloc_addr = throw_excpt? AllocateHeap(aligned_size, flags, CURRENT_PC)
-                                          : AllocateHeap(aligned_size, flags, CURRENT_PC,
+    void* real_malloc_addr = throw_excpt? AllocateHeap(aligned_size, flags, MALLOC_CURRENT_PC)
+                                          : AllocateHeap(aligned_size, flags, MALLOC_CURRENT_PC,
                                                          AllocFailStrategy::RETURN_NULL);
     void* aligned_addr     = align_up(real_malloc_addr, alignment);
     assert(((uintptr_t) aligned_addr + (uintptr_t) size) <=
@@ -194,8 +197,8 @@ void* Thread::allocate(size_t size, bool throw_excpt, MEMFLAGS flags) {
     ((Thread*) aligned_addr)->_real_malloc_address = real_malloc_addr;
     return aligned_addr;
   } else {
-    return throw_excpt? AllocateHeap(size, flags, CURRENT_PC)
-                       : AllocateHeap(size, flags, CURRENT_PC, AllocFailStrategy::RETURN_NULL);
+    return throw_excpt? AllocateHeap(size, flags, MALLOC_CURRENT_PC)
+                       : AllocateHeap(size, flags, MALLOC_CURRENT_PC, AllocFailStrategy::RETURN_NULL);
   }
 }
 
@@ -3844,6 +3847,9 @@ jint Threads::create_vm(JavaVMInitArgs* args, bool* canTryAgain) {
   // Initialize Java-Level synchronization subsystem
   ObjectMonitor::Initialize();
 
+  // Start the asynchronous log writer (-Xlog:async) before most of the startup logging
+  AsyncLogWriter::initialize();
+
   // Initialize global modules
   jint status = init_globals();
   if (status != JNI_OK) {
@@ -3913,6 +3919,9 @@ jint Threads::create_vm(JavaVMInitArgs* args, bool* canTryAgain) {
   // Notify JVMTI agents that VM has started (JNI is up) - nop if no agents.
   JvmtiExport::post_early_vm_start();
 
+  // Read -XX:LoadMethodProfiles before any class is initialized
+  MethodProfileArchive::load(CHECK_JNI_ERR);
+
   initialize_java_lang_classes(main_thread, CHECK_JNI_ERR);
 
   quicken_jni_functions();
@@ -4033,6 +4042,19 @@ jint Threads::create_vm(JavaVMInitArgs* args, bool* canTryAgain) {
   // Notify JVMTI agents that VM initialization is complete - nop if no agents.
   JvmtiExport::post_vm_initialized();
 
+  // Start loading the classes in -XX:PreloadClassList in the background. Only
+  // now have the java agents run premain in VMInit and registered their
+  // transformers, so the preloaded classes are transformed as usual.
+  ClassPreloader::start(THREAD);
+  if (HAS_PENDING_EXCEPTION) {
+    // Preloading is only an optimization, so start up without it (or with
+    // the threads that could be started).
+    ResourceMark rm(THREAD);
+    warning("Failed to start the class preload threads: %s",
+            PENDING_EXCEPTION->klass()->external_name());
+    CLEAR_PENDING_EXCEPTION;
+  }
+
   JFR_ONLY(Jfr::on_create_vm_3();)
 
 #if INCLUDE_MANAGEMENT
@@ -434,6 +434,11 @@ class Thread: public ThreadShadow {
   // Returns the current thread, or NULL if not attached, and is
   // safe for use from signal-handlers
   static inline Thread* current_or_null_safe();
+  // Returns a hash of the current thread's address, for spreading threads
+  // over stripes or shards. Cheaper than looking up the current processor
+  // and available on all platforms. Threads that are not attached share
+  // one hash.
+  static inline uint current_hash();
 
   // Common thread operations
 #ifdef ASSERT
@@ -814,6 +819,12 @@ inline Thread* Thread::current_or_null_safe() {
   return NULL;
 }
 
+inline uint Thread::current_hash() {
+  // Fibonacci hashing, the high bits of the product are well mixed.
+  uintptr_t key = p2i(current_or_null()) >> LogBytesPerWord;
+  return (uint)(key * 0x9E3779B97F4A7C15ULL >> 32);
+}
+
 class NonJavaThread: public Thread {
   friend class VMStructs;
 
@@ -1317,6 +1328,11 @@ class JavaThread: public Thread {
     return _handshake.has_operation();
   }
 
+  // The thread executing a handshake operation on behalf of this thread, or NULL.
+  Thread* active_handshaker() const {
+    return _handshake.active_handshaker();
+  }
+
   void handshake_process_by_self() {
     _handshake.process_by_self(this);
   }
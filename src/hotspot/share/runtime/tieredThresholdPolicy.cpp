@@ -30,6 +30,7 @@
 #include "runtime/handles.inline.hpp"
 #include "runtime/safepointVerifiers.hpp"
 #include "runtime/tieredThresholdPolicy.hpp"
+#include "runtime/timer.hpp"
 #include "code/scopeDesc.hpp"
 #include "oops/method.inline.hpp"
 #if INCLUDE_JVMCI
@@ -284,54 +285,60 @@ void TieredThresholdPolicy::handle_counter_overflow(Method* method) {
   }
 }
 
+// If a method was unloaded or has been stale for some time, remove its task from the queue.
+// Blocking tasks and tasks submitted from whitebox API don't become stale
+bool TieredThresholdPolicy::remove_if_stale(CompileQueue* compile_queue, CompileTask* task, jlong t) {
+  Method* method = task->method();
+  if (task->is_unloaded() || (task->can_become_stale() && is_stale(t, TieredCompileTaskTimeout, method) && !is_old(method))) {
+    if (!task->is_unloaded()) {
+      if (PrintTieredEvents) {
+        print_event(REMOVE_FROM_QUEUE, method, method, task->osr_bci(), (CompLevel) task->comp_level());
+      }
+      method->clear_queued_for_compilation();
+    }
+    compile_queue->remove_and_mark_stale(task);
+    return true;
+  }
+  return false;
+}
+
 // Called with the queue locked and with at least one element
 CompileTask* TieredThresholdPolicy::select_task(CompileQueue* compile_queue) {
-  CompileTask *max_blocking_task = NULL;
-  CompileTask *max_task = NULL;
-  Method* max_method = NULL;
   jlong t = os::javaTimeMillis();
-  // Iterate through the queue and find a method with a maximum rate.
-  for (CompileTask* task = compile_queue->first(); task != NULL;) {
-    CompileTask* next_task = task->next();
-    Method* method = task->method();
-    // If a method was unloaded or has been stale for some time, remove it from the queue.
-    // Blocking tasks and tasks submitted from whitebox API don't become stale
-    if (task->is_unloaded() || (task->can_become_stale() && is_stale(t, TieredCompileTaskTimeout, method) && !is_old(method))) {
-      if (!task->is_unloaded()) {
-        if (PrintTieredEvents) {
-          print_event(REMOVE_FROM_QUEUE, method, method, task->osr_bci(), (CompLevel) task->comp_level());
-        }
-        method->clear_queued_for_compilation();
+  // Once per timeout period, update the rates of all the queued methods and
+  // remove the stale ones, so that they don't pile up below the top of the queue.
+  if (t - compile_queue->last_stale_check() >= TieredCompileTaskTimeout) {
+    for (CompileTask* task = compile_queue->first(); task != NULL;) {
+      CompileTask* next_task = task->next();
+      if (!remove_if_stale(compile_queue, task, t)) {
+        update_rate(t, task->method());
+        compile_queue->update_priority(task);
       }
-      compile_queue->remove_and_mark_stale(task);
       task = next_task;
+    }
+    compile_queue->set_last_stale_check(t);
+  }
+
+  // In between, only the task at the top of the queue is looked at: update
+  // its rate, and select it if it still comes first. Give up after a few
+  // tasks have been pushed down, and take the top one as it is.
+  const int max_updates = 8;
+  int updates = 0;
+  CompileTask* max_task;
+  while ((max_task = compile_queue->peek()) != NULL) {
+    if (remove_if_stale(compile_queue, max_task, t)) {
       continue;
     }
-    update_rate(t, method);
-    if (max_task == NULL || compare_methods(method, max_method)) {
-      // Select a method with the highest rate
-      max_task = task;
-      max_method = method;
+    if (updates++ == max_updates) {
+      break;
     }
-
-    if (task->is_blocking()) {
-      if (max_blocking_task == NULL || compare_methods(method, max_blocking_task->method())) {
-        max_blocking_task = task;
-      }
+    update_rate(t, max_task->method());
+    compile_queue->update_priority(max_task);
+    if (compile_queue->peek() == max_task) {
+      break;
     }
-
-    task = next_task;
-  }
-
-  if (max_blocking_task != NULL) {
-    // In blocking compilation mode, the CompileBroker will make
-    // compilations submitted by a JVMCI compiler thread non-blocking. These
-    // compilations should be scheduled after all blocking compilations
-    // to service non-compiler related compilations sooner and reduce the
-    // chance of such compilations timing out.
-    max_task = max_blocking_task;
-    max_method = max_task->method();
   }
+  Method* max_method = max_task != NULL ? max_task->method() : NULL;
 
   if (max_task != NULL && max_task->comp_level() == CompLevel_full_profile &&
       TieredStopAtLevel > CompLevel_full_profile &&
@@ -531,18 +538,17 @@ double TieredThresholdPolicy::weight(Method* method) {
     (method->invocation_count() + 1) * (method->backedge_count() + 1);
 }
 
-// Apply heuristics and return true if x should be compiled before y
-bool TieredThresholdPolicy::compare_methods(Method* x, Method* y) {
-  if (x->highest_comp_level() > y->highest_comp_level()) {
-    // recompilation after deopt
-    return true;
-  } else
-    if (x->highest_comp_level() == y->highest_comp_level()) {
-      if (weight(x) > weight(y)) {
-        return true;
-      }
-    }
-  return false;
+// The priority of a task grows with the weight of its method, on a logarithmic
+// scale, and with the time the task has been waiting: every
+// TieredCompileTaskAgingTime ms count as much as a doubling of the weight.
+// Since all queued tasks age at the same rate, the priority is computed from
+// the time the task was queued, and the queue order does not change as time
+// passes. Recompilations after deopt come first.
+void TieredThresholdPolicy::update_task_priority(CompileTask* task) {
+  Method* method = task->method();
+  double queued = TimeHelper::counter_to_millis(task->time_queued());
+  task->set_priority(method->highest_comp_level(),
+                     log(weight(method)) / log(2.0) - queued / TieredCompileTaskAgingTime);
 }
 
 // Is method profiled enough?
@@ -660,6 +666,17 @@ bool TieredThresholdPolicy::should_not_inline(ciEnv* env, ciMethod* callee) {
   return false;
 }
 
+void TieredThresholdPolicy::profile_preloaded(const methodHandle& mh, JavaThread* thread) {
+  if (TieredStopAtLevel < CompLevel_full_optimization || is_trivial(mh())) {
+    return;
+  }
+  // The counters of the preloaded MDO start at zero, so is_method_profiled()
+  // applies the tier 4 thresholds to the counts of the previous run.
+  if (is_method_profiled(mh()) && mh->code() == NULL) {
+    compile(mh, InvocationEntryBci, CompLevel_full_optimization, thread);
+  }
+}
+
 // Create MDO if necessary.
 void TieredThresholdPolicy::create_mdo(const methodHandle& mh, JavaThread* THREAD) {
   if (mh->is_native() ||
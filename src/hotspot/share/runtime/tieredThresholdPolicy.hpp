@@ -195,8 +195,8 @@ class TieredThresholdPolicy : public CompilationPolicy {
   inline bool is_stale(jlong t, jlong timeout, Method* m);
   // Compute the weight of the method for the compilation scheduling
   inline double weight(Method* method);
-  // Apply heuristics and return true if x should be compiled before y
-  inline bool compare_methods(Method* x, Method* y);
+  // Remove the task from the queue if its method was unloaded or is stale.
+  bool remove_if_stale(CompileQueue* compile_queue, CompileTask* task, jlong t);
   // Compute event rate for a given method. The rate is the number of event (invocations + backedges)
   // per millisecond.
   inline void update_rate(jlong t, Method* m);
@@ -265,11 +265,14 @@ public:
                          int branch_bci, int bci, CompLevel comp_level, CompiledMethod* nm, JavaThread* thread);
   // Select task is called by CompileBroker. We should return a task or NULL.
   virtual CompileTask* select_task(CompileQueue* compile_queue);
+  virtual void update_task_priority(CompileTask* task);
   // Tell the runtime if we think a given method is adequately profiled.
   virtual bool is_mature(Method* method);
   // Initialize: set compiler thread count
   virtual void initialize();
   virtual bool should_not_inline(ciEnv* env, ciMethod* callee);
+  // Compile a method with a preloaded mature profile at the highest level right away.
+  virtual void profile_preloaded(const methodHandle& mh, JavaThread* thread);
 };
 
 #endif // TIERED
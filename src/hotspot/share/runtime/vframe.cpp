@@ -121,8 +121,9 @@ javaVFrame* vframe::java_sender() const {
 // ------------- javaVFrame --------------
 
 GrowableArray<MonitorInfo*>* javaVFrame::locked_monitors() {
-  assert(SafepointSynchronize::is_at_safepoint() || JavaThread::current() == thread(),
-         "must be at safepoint or it's a java frame of the current thread");
+  assert(SafepointSynchronize::is_at_safepoint() || Thread::current() == thread() ||
+         thread()->active_handshaker() == Thread::current(),
+         "must be at safepoint, in a handshake with the thread or it's a java frame of the current thread");
 
   GrowableArray<MonitorInfo*>* mons = monitors();
   GrowableArray<MonitorInfo*>* result = new GrowableArray<MonitorInfo*>(mons->length());
@@ -37,7 +37,6 @@
 #include "runtime/deoptimization.hpp"
 #include "runtime/frame.inline.hpp"
 #include "runtime/interfaceSupport.inline.hpp"
-#include "runtime/sweeper.hpp"
 #include "runtime/thread.inline.hpp"
 #include "runtime/threadSMR.inline.hpp"
 #include "runtime/vmOperations.hpp"
@@ -127,10 +126,6 @@ void VM_Deoptimize::doit() {
   CodeCache::make_marked_nmethods_not_entrant();
 }
 
-void VM_MarkActiveNMethods::doit() {
-  NMethodSweeper::mark_active_nmethods();
-}
-
 VM_DeoptimizeFrame::VM_DeoptimizeFrame(JavaThread* thread, intptr_t* id, int reason) {
   _thread = thread;
   _id     = id;
@@ -385,6 +380,30 @@ void VM_ThreadDump::snapshot_thread(JavaThread* java_thread, ThreadConcurrentLoc
   snapshot->set_concurrent_locks(tcl);
 }
 
+bool VM_ThreadDumpConcurrentLocks::doit_prologue() {
+  // Acquire Heap_lock to dump concurrent locks
+  Heap_lock->lock();
+  return true;
+}
+
+void VM_ThreadDumpConcurrentLocks::doit_epilogue() {
+  // Release Heap_lock
+  Heap_lock->unlock();
+}
+
+void VM_ThreadDumpConcurrentLocks::doit() {
+  ResourceMark rm;
+
+  ConcurrentLocksDump concurrent_locks(true);
+  concurrent_locks.dump_at_safepoint();
+
+  for (ThreadSnapshot* ts = _result->snapshots(); ts != NULL; ts = ts->next()) {
+    if (ts->thread() != NULL) {
+      ts->set_concurrent_locks(concurrent_locks.thread_concurrent_locks(ts->thread()));
+    }
+  }
+}
+
 volatile bool VM_Exit::_vm_exited = false;
 Thread * volatile VM_Exit::_shutdown_thread = NULL;
 
@@ -49,6 +49,7 @@
   template(Dummy)                                 \
   template(ThreadStop)                            \
   template(ThreadDump)                            \
+  template(ThreadDumpConcurrentLocks)             \
   template(PrintThreads)                          \
   template(FindDeadlocks)                         \
   template(ClearICs)                              \
@@ -119,7 +120,7 @@
   template(ClassLoaderHierarchyOperation)         \
   template(DumpHashtable)                         \
   template(DumpTouchedMethods)                    \
-  template(MarkActiveNMethods)                    \
+  template(DumpMethodProfiles)                    \
   template(PrintCompileQueue)                     \
   template(PrintClassHierarchy)                   \
   template(ThreadSuspend)                         \
@@ -320,14 +321,6 @@ class VM_Deoptimize: public VM_Operation {
   bool allow_nested_vm_operations() const        { return true; }
 };
 
-class VM_MarkActiveNMethods: public VM_Operation {
- public:
-  VM_MarkActiveNMethods() {}
-  VMOp_Type type() const                         { return VMOp_MarkActiveNMethods; }
-  void doit();
-  bool allow_nested_vm_operations() const        { return true; }
-};
-
 // Deopt helper that can deoptimize frames in threads other than the
 // current thread.  Only used through Deoptimization::deoptimize_frame.
 class VM_DeoptimizeFrame: public VM_Operation {
@@ -479,6 +472,21 @@ class VM_ThreadDump : public VM_Operation {
   void doit_epilogue();
 };
 
+// Adds the locked synchronizers to the snapshots of a thread dump that
+// were taken with handshakes, see ThreadService::dump_threads().
+class VM_ThreadDumpConcurrentLocks : public VM_Operation {
+ private:
+  ThreadDumpResult* _result;
+
+ public:
+  VM_ThreadDumpConcurrentLocks(ThreadDumpResult* result) : _result(result) {}
+
+  VMOp_Type type() const { return VMOp_ThreadDumpConcurrentLocks; }
+  void doit();
+  bool doit_prologue();
+  void doit_epilogue();
+};
+
 
 class VM_Exit: public VM_Operation {
  private:
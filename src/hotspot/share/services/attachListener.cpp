@@ -217,6 +217,7 @@ static jint jcmd(AttachOperation* op, outputStream* out) {
 // Input arguments :-
 //   arg0: Name of the dump file
 //   arg1: "-live" or "-all"
+//   arg2: parallel dump thread number
 jint dump_heap(AttachOperation* op, outputStream* out) {
   const char* path = op->arg(0);
   if (path == NULL || path[0] == '\0') {
@@ -232,11 +233,22 @@ jint dump_heap(AttachOperation* op, outputStream* out) {
       live_objects_only = strcmp(arg1, "-live") == 0;
     }
 
+    uint parallel_thread_num = 1;
+    const char* num_str = op->arg(2);
+    if (num_str != NULL && num_str[0] != '\0') {
+      uintx num;
+      if (!Arguments::parse_uintx(num_str, &num, 0)) {
+        out->print_cr("Invalid parallel thread number: [%s]", num_str);
+        return JNI_ERR;
+      }
+      parallel_thread_num = num == 0 ? MAX2<uint>(1, (uint)os::initial_active_processor_count() * 3 / 8) : (uint)num;
+    }
+
     // Request a full GC before heap dump if live_objects_only = true
     // This helps reduces the amount of unreachable objects in the dump
     // and makes it easier to browse.
     HeapDumper dumper(live_objects_only /* request GC */);
-    dumper.dump(op->arg(0), out);
+    dumper.dump(op->arg(0), out, -1, false, parallel_thread_num);
   }
   return JNI_OK;
 }
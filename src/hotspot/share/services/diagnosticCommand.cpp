@@ -29,9 +29,12 @@
 #include "classfile/compactHashtable.hpp"
 #include "compiler/compileBroker.hpp"
 #include "compiler/directivesParser.hpp"
+#include "compiler/methodProfileArchive.hpp"
+#include "gc/shared/collectedHeap.hpp"
 #include "gc/shared/vmGCOperations.hpp"
 #include "memory/metaspace/metaspaceDCmd.hpp"
 #include "memory/resourceArea.hpp"
+#include "memory/universe.hpp"
 #include "oops/objArrayOop.inline.hpp"
 #include "oops/oop.inline.hpp"
 #include "oops/typeArrayOop.inline.hpp"
@@ -115,6 +118,7 @@ void DCmdRegistrant::register_dcmds(){
 #endif // LINUX
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<TouchedMethodsDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<CodeHeapAnalyticsDCmd>(full_export, true, false));
+  DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<MethodProfilesDumpDCmd>(full_export, true, false));
 
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<CompilerDirectivesPrintDCmd>(full_export, true, false));
   DCmdFactory::register_DCmdFactory(new DCmdFactoryImpl<CompilerDirectivesAddDCmd>(full_export, true, false));
@@ -516,11 +520,15 @@ HeapDumpDCmd::HeapDumpDCmd(outputStream* output, bool heap) :
                "using the given compression level. 1 (recommended) is the fastest, "
                "9 the strongest compression.", "INT", false, "1"),
   _overwrite("-overwrite", "If specified, the dump file will be overwritten if it exists",
-           "BOOLEAN", false, "false") {
+           "BOOLEAN", false, "false"),
+  _parallel("-parallel", "Number of threads dumping the heap objects in parallel, "
+            "if supported by the GC. The objects are written to temporary segment "
+            "files next to the dump first. 0 lets the VM choose.", "INT", false, "1") {
   _dcmdparser.add_dcmd_option(&_all);
   _dcmdparser.add_dcmd_argument(&_filename);
   _dcmdparser.add_dcmd_option(&_gzip);
   _dcmdparser.add_dcmd_option(&_overwrite);
+  _dcmdparser.add_dcmd_option(&_parallel);
 }
 
 void HeapDumpDCmd::execute(DCmdSource source, TRAPS) {
@@ -535,11 +543,20 @@ void HeapDumpDCmd::execute(DCmdSource source, TRAPS) {
     }
   }
 
+  jlong parallel = _parallel.value();
+  if (parallel < 0) {
+    output()->print_cr("Invalid number of parallel dump threads: " JLONG_FORMAT, parallel);
+    return;
+  } else if (parallel == 0) {
+    parallel = MAX2<uint>(1, (uint)os::initial_active_processor_count() * 3 / 8);
+  }
+
   // Request a full GC before heap dump if _all is false
   // This helps reduces the amount of unreachable objects in the dump
   // and makes it easier to browse.
   HeapDumper dumper(!_all.value() /* request GC if _all is false*/);
-  dumper.dump(_filename.value(), output(), (int) level, _overwrite.value());
+  dumper.dump(_filename.value(), output(), (int) level, _overwrite.value(),
+              (uint) MIN2<jlong>(parallel, max_juint));
 }
 
 int HeapDumpDCmd::num_arguments() {
@@ -556,11 +573,22 @@ int HeapDumpDCmd::num_arguments() {
 ClassHistogramDCmd::ClassHistogramDCmd(outputStream* output, bool heap) :
                                        DCmdWithParser(output, heap),
   _all("-all", "Inspect all objects, including unreachable objects",
-       "BOOLEAN", false, "false") {
+       "BOOLEAN", false, "false"),
+  _concurrent("-concurrent", "Print the histogram of the live objects recorded by "
+              "the last concurrent marking cycle, without stopping the world. "
+              "Requires -XX:+G1ConcurrentClassHistogram", "BOOLEAN", false, "false") {
   _dcmdparser.add_dcmd_option(&_all);
+  _dcmdparser.add_dcmd_option(&_concurrent);
 }
 
 void ClassHistogramDCmd::execute(DCmdSource source, TRAPS) {
+  if (_concurrent.value()) {
+    if (!Universe::heap()->print_concurrent_class_histogram(output())) {
+      output()->print_cr("No concurrent class histogram available. It needs "
+                         "-XX:+G1ConcurrentClassHistogram and a completed concurrent cycle.");
+    }
+    return;
+  }
   VM_GC_HeapInspection heapop(output(),
                               !_all.value() /* request full gc if false */);
   VMThread::execute(&heapop);
@@ -986,6 +1014,32 @@ int CodeHeapAnalyticsDCmd::num_arguments() {
 }
 //---<  END  >--- CodeHeap State Analytics.
 
+MethodProfilesDumpDCmd::MethodProfilesDumpDCmd(outputStream* output, bool heap) :
+                           DCmdWithParser(output, heap),
+  _filename("filename", "Name of the profile file", "STRING", true) {
+  _dcmdparser.add_dcmd_argument(&_filename);
+}
+
+void MethodProfilesDumpDCmd::execute(DCmdSource source, TRAPS) {
+  if (!CalculateClassFingerprint) {
+    output()->print_cr("Class fingerprints are not recorded. Start the VM with "
+                       "-XX:+CalculateClassFingerprint or -XX:DumpMethodProfilesAtExit.");
+    return;
+  }
+  MethodProfileArchive::dump(_filename.value(), output());
+}
+
+int MethodProfilesDumpDCmd::num_arguments() {
+  ResourceMark rm;
+  MethodProfilesDumpDCmd* dcmd = new MethodProfilesDumpDCmd(NULL, false);
+  if (dcmd != NULL) {
+    DCmdMark mark(dcmd);
+    return dcmd->_dcmdparser.num_arguments();
+  } else {
+    return 0;
+  }
+}
+
 void CompilerDirectivesPrintDCmd::execute(DCmdSource source, TRAPS) {
   DirectivesStack::print(output());
 }
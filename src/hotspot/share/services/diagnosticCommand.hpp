@@ -333,6 +333,7 @@ protected:
   DCmdArgument<bool>  _all;
   DCmdArgument<jlong> _gzip;
   DCmdArgument<bool> _overwrite;
+  DCmdArgument<jlong> _parallel;
 public:
   HeapDumpDCmd(outputStream* output, bool heap);
   static const char* name() {
@@ -359,6 +360,7 @@ public:
 class ClassHistogramDCmd : public DCmdWithParser {
 protected:
   DCmdArgument<bool> _all;
+  DCmdArgument<bool> _concurrent;
 public:
   ClassHistogramDCmd(outputStream* output, bool heap);
   static const char* name() {
@@ -368,7 +370,8 @@ public:
     return "Provide statistics about the Java heap usage.";
   }
   static const char* impact() {
-    return "High: Depends on Java heap size and content.";
+    return "High: Depends on Java heap size and content. "
+           "Low with the '-concurrent' option.";
   }
   static const JavaPermission permission() {
     JavaPermission p = {"java.lang.management.ManagementPermission",
@@ -671,6 +674,30 @@ public:
 };
 //---<  END  >--- CodeHeap State Analytics.
 
+class MethodProfilesDumpDCmd : public DCmdWithParser {
+protected:
+  DCmdArgument<char*> _filename;
+public:
+  MethodProfilesDumpDCmd(outputStream* output, bool heap);
+  static const char* name() {
+    return "Compiler.dump_profiles";
+  }
+  static const char* description() {
+    return "Save the profiles of the methods compiled at the highest tier, "
+           "to be loaded with -XX:LoadMethodProfiles.";
+  }
+  static const char* impact() {
+    return "Medium: Depends on the number of loaded classes. Runs at a safepoint.";
+  }
+  static const JavaPermission permission() {
+    JavaPermission p = {"java.lang.management.ManagementPermission",
+                        "monitor", NULL};
+    return p;
+  }
+  static int num_arguments();
+  virtual void execute(DCmdSource source, TRAPS);
+};
+
 class CompilerDirectivesPrintDCmd : public DCmd {
 public:
   CompilerDirectivesPrintDCmd(outputStream* output, bool heap) : DCmd(output, heap) {}
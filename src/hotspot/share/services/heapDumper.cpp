@@ -37,6 +37,7 @@
 #include "oops/objArrayOop.inline.hpp"
 #include "oops/oop.inline.hpp"
 #include "oops/typeArrayOop.inline.hpp"
+#include "runtime/atomic.hpp"
 #include "runtime/frame.inline.hpp"
 #include "runtime/handles.inline.hpp"
 #include "runtime/javaCalls.hpp"
@@ -54,6 +55,10 @@
 #include "utilities/macros.hpp"
 #include "utilities/ostream.hpp"
 
+#ifndef O_BINARY       // if defined (Win32) use binary files.
+#define O_BINARY 0     // otherwise do nothing.
+#endif
+
 /*
  * HPROF binary format - description copied from:
  *   src/share/demo/jvmti/hprof/hprof_io.c
@@ -442,6 +447,9 @@ class DumpWriter : public StackObj {
   void writer_loop()                    { _backend.thread_loop(false); }
   // Called when finished to release the threads.
   void deactivate()                     { flush(); _backend.deactivate(); }
+  // Writes data that is already in the format of the dump, e.g. compressed,
+  // directly to the writer. Can only be called after deactivate().
+  void write_unbuffered(char* buf, size_t len) { _backend.write_unbuffered(buf, len); }
 };
 
 // Check for error after constructing the object and destroy it in case of an error.
@@ -1486,6 +1494,18 @@ class VM_HeapDumper : public VM_GC_Operation, public AbstractGangTask {
   ThreadStackTrace** _stack_traces;
   int _num_threads;
 
+  // parallel dump support
+  uint _num_dump_threads;
+  const char* _segment_base;
+  int _compression;
+  uint _dump_id;
+  ParallelObjectIterator* _poi;
+  uint _num_segments;
+  bool* _segment_created;
+  char const* volatile _segment_error;
+
+  static volatile uint _dump_count;
+
   // accessors and setters
   static VM_HeapDumper* dumper()         {  assert(_global_dumper != NULL, "Error"); return _global_dumper; }
   static DumpWriter* writer()            {  assert(_global_writer != NULL, "Error"); return _global_writer; }
@@ -1524,8 +1544,28 @@ class VM_HeapDumper : public VM_GC_Operation, public AbstractGangTask {
   // HPROF_TRACE and HPROF_FRAME records
   void dump_stack_traces();
 
+  // HPROF_GC_INSTANCE_DUMP, HPROF_GC_OBJ_ARRAY_DUMP and HPROF_GC_PRIM_ARRAY_DUMP
+  // records of the heap chunks claimed by a worker, written to its segment file
+  void dump_segment(uint worker_id);
+
+  void set_segment_error(char const* error) {
+    if (error != NULL) {
+      Atomic::cmpxchg(error, &_segment_error, (char const*)NULL);
+    }
+  }
+
+  // The pid and the dump id keep the segment files of concurrent dumps apart.
+  void segment_path(char* buf, size_t buf_len, uint id) const {
+    jio_snprintf(buf, buf_len, "%s.%d.%u.%u.seg", _segment_base,
+                 os::current_process_id(), _dump_id, id);
+  }
+
  public:
-  VM_HeapDumper(DumpWriter* writer, bool gc_before_heap_dump, bool oome) :
+  // The segment files of a parallel dump are named after 'segment_base',
+  // and compressed with the given level if it is > 0.
+  VM_HeapDumper(DumpWriter* writer, bool gc_before_heap_dump, bool oome,
+                uint num_dump_threads = 1, const char* segment_base = NULL,
+                int compression = -1) :
     VM_GC_Operation(0 /* total collections,      dummy, ignored */,
                     GCCause::_heap_dump /* GC Cause */,
                     0 /* total full collections, dummy, ignored */,
@@ -1536,6 +1576,15 @@ class VM_HeapDumper : public VM_GC_Operation, public AbstractGangTask {
     _klass_map = new (ResourceObj::C_HEAP, mtInternal) GrowableArray<Klass*>(INITIAL_CLASS_COUNT, true);
     _stack_traces = NULL;
     _num_threads = 0;
+    _num_dump_threads = num_dump_threads;
+    _segment_base = segment_base;
+    _compression = compression;
+    _dump_id = Atomic::add(1u, &_dump_count);
+    _poi = NULL;
+    _num_segments = 0;
+    _segment_created = NULL;
+    _segment_error = NULL;
+    assert(num_dump_threads == 1 || segment_base != NULL, "parallel dump needs segment files");
     if (oome) {
       assert(!Thread::current()->is_VM_thread(), "Dump from OutOfMemoryError cannot be called by the VMThread");
       // get OutOfMemoryError zero-parameter constructor
@@ -1556,17 +1605,29 @@ class VM_HeapDumper : public VM_GC_Operation, public AbstractGangTask {
       }
       FREE_C_HEAP_ARRAY(ThreadStackTrace*, _stack_traces);
     }
+    if (_segment_created != NULL) {
+      FREE_C_HEAP_ARRAY(bool, _segment_created);
+    }
     delete _klass_map;
   }
 
   VMOp_Type type() const { return VMOp_HeapDumper; }
   void doit();
   void work(uint worker_id);
+
+  // True if the objects were dumped into per-worker segment files.
+  bool is_parallel_dump() const { return _num_segments > 0; }
+
+  // Appends the segment files of a parallel dump and finishes the dump.
+  void merge_segments();
+
+  char const* segment_error() const { return _segment_error; }
 };
 
 
 VM_HeapDumper* VM_HeapDumper::_global_dumper = NULL;
 DumpWriter*    VM_HeapDumper::_global_writer = NULL;
+volatile uint  VM_HeapDumper::_dump_count = 0;
 
 bool VM_HeapDumper::skip_operation() const {
   return false;
@@ -1771,6 +1832,15 @@ void VM_HeapDumper::do_threads() {
 // HPROF_GC_INSTANCE_DUMP, HPROF_GC_OBJ_ARRAY_DUMP, and HPROF_GC_PRIM_ARRAY_DUMP
 // records as we go. Once that is done we write records for some of the GC
 // roots.
+//
+// In a parallel dump, the workers iterate over disjoint chunks of the heap,
+// and write the object sub-records into segments of their own segment file,
+// while the VM thread writes the other records to the dump. Each worker
+// compresses its own segment file, and the last one ends with the
+// HPROF_HEAP_DUMP_END record. The segment files are appended to the dump as
+// they are after the safepoint, since gzip members can be concatenated. So
+// streaming out the bulk of the dump to a slow reader does not hold up the
+// Java threads.
 
 void VM_HeapDumper::doit() {
 
@@ -1797,6 +1867,21 @@ void VM_HeapDumper::doit() {
 
   if (gang == NULL) {
     work(0);
+  } else if (_num_dump_threads > 1) {
+    // Can't run with more threads than provided by the WorkGang.
+    WithUpdatedActiveWorkers update_and_restore(gang, _num_dump_threads);
+
+    _poi = ch->parallel_object_iterator(gang->active_workers());
+    if (_poi != NULL) {
+      // The GC supports parallel object iteration.
+      _num_segments = gang->active_workers();
+      _segment_created = NEW_C_HEAP_ARRAY(bool, _num_segments, mtInternal);
+      memset(_segment_created, 0, _num_segments * sizeof(bool));
+    }
+    gang->run_task(this, gang->active_workers(), true);
+
+    delete _poi;
+    _poi = NULL;
   } else {
     gang->run_task(this, gang->active_workers(), true);
   }
@@ -1808,7 +1893,11 @@ void VM_HeapDumper::doit() {
 
 void VM_HeapDumper::work(uint worker_id) {
   if (!Thread::current()->is_VM_thread()) {
-    writer()->writer_loop();
+    if (is_parallel_dump()) {
+      dump_segment(worker_id);
+    } else {
+      writer()->writer_loop();
+    }
     return;
   }
 
@@ -1842,9 +1931,11 @@ void VM_HeapDumper::work(uint worker_id) {
   // to check if the current segment exceeds a threshold. If so, a new
   // segment is started.
   // The HPROF_GC_CLASS_DUMP and HPROF_GC_INSTANCE_DUMP are the vast bulk
-  // of the heap dump.
-  HeapObjectDumper obj_dumper(this, writer());
-  Universe::heap()->safe_object_iterate(&obj_dumper);
+  // of the heap dump. In a parallel dump the workers write these records.
+  if (!is_parallel_dump()) {
+    HeapObjectDumper obj_dumper(this, writer());
+    Universe::heap()->safe_object_iterate(&obj_dumper);
+  }
 
   // HPROF_GC_ROOT_THREAD_OBJ + frames + jni locals
   do_threads();
@@ -1865,13 +1956,92 @@ void VM_HeapDumper::work(uint worker_id) {
   StickyClassDumper class_dumper(writer());
   ClassLoaderData::the_null_class_loader_data()->classes_do(&class_dumper);
 
-  // Writes the HPROF_HEAP_DUMP_END record.
-  DumperSupport::end_of_dump(writer());
+  if (is_parallel_dump()) {
+    // The segment files are appended after the safepoint. The last one
+    // holds the HPROF_HEAP_DUMP_END record.
+    writer()->finish_dump_segment();
+  } else {
+    // Writes the HPROF_HEAP_DUMP_END record.
+    DumperSupport::end_of_dump(writer());
+  }
 
   // We are done with writing. Release the worker threads.
   writer()->deactivate();
 }
 
+void VM_HeapDumper::dump_segment(uint worker_id) {
+  assert(_poi != NULL, "must be a parallel dump");
+  char path[JVM_MAXPATHLEN];
+  segment_path(path, sizeof(path), worker_id);
+
+  AbstractCompressor* compressor = NULL;
+  if (_compression > 0) {
+    // The segment is compressed into gzip members of its own, which can be
+    // appended to the members of the dump as they are.
+    compressor = new (std::nothrow) GZipCompressor(_compression, false /* block size comment */);
+    if (compressor == NULL) {
+      set_segment_error("Could not allocate gzip compressor");
+      return;
+    }
+  }
+
+  // Never overwrite an existing file, and only remove the file we created.
+  FileWriter* file_writer = new (std::nothrow) FileWriter(path, false);
+  DumpWriter segment_writer(file_writer, compressor);
+  _segment_created[worker_id] = (file_writer != NULL) && file_writer->is_open();
+
+  if (segment_writer.error() == NULL) {
+    HeapObjectDumper obj_dumper(this, &segment_writer);
+    _poi->object_iterate(&obj_dumper, worker_id);
+    if (worker_id == _num_segments - 1) {
+      // The last segment file is appended last.
+      DumperSupport::end_of_dump(&segment_writer);
+    } else {
+      segment_writer.finish_dump_segment();
+    }
+    segment_writer.deactivate();
+  }
+  set_segment_error(segment_writer.error());
+}
+
+void VM_HeapDumper::merge_segments() {
+  assert(is_parallel_dump(), "must be a parallel dump");
+  const size_t buf_size = 1*M;
+  char* buf = NEW_C_HEAP_ARRAY_RETURN_NULL(char, buf_size, mtInternal);
+  if (buf == NULL) {
+    set_segment_error("Could not allocate memory for merging segments");
+  }
+
+  char path[JVM_MAXPATHLEN];
+  for (uint i = 0; i < _num_segments; i++) {
+    if (!_segment_created[i]) {
+      // The worker has recorded the error.
+      continue;
+    }
+    segment_path(path, sizeof(path), i);
+    int fd = os::open(path, O_RDONLY | O_BINARY, 0);
+    if (fd < 0) {
+      set_segment_error(os::strerror(errno));
+      continue;
+    }
+    // Keep removing the segment files after an error.
+    while (segment_error() == NULL && _local_writer->error() == NULL) {
+      size_t n = os::read(fd, buf, (unsigned int)buf_size);
+      if (n == 0) {
+        break;
+      } else if (n == (size_t)-1) {
+        set_segment_error(os::strerror(errno));
+      } else {
+        // The segments are already compressed if requested.
+        _local_writer->write_unbuffered(buf, n);
+      }
+    }
+    os::close(fd);
+    remove(path);
+  }
+  FREE_C_HEAP_ARRAY(char, buf);
+}
+
 void VM_HeapDumper::dump_stack_traces() {
   // write a HPROF_TRACE record without any frames to be referenced as object alloc sites
   DumperSupport::write_header(writer(), HPROF_TRACE, 3*sizeof(u4));
@@ -1928,7 +2098,7 @@ void VM_HeapDumper::dump_stack_traces() {
 }
 
 // dump the heap to given path.
-int HeapDumper::dump(const char* path, outputStream* out, int compression, bool overwrite) {
+int HeapDumper::dump(const char* path, outputStream* out, int compression, bool overwrite, uint num_dump_threads) {
   assert(path != NULL && strlen(path) > 0, "path missing");
 
   // print message in interactive case
@@ -1959,8 +2129,19 @@ int HeapDumper::dump(const char* path, outputStream* out, int compression, bool
     return -1;
   }
 
+  // The segment files of a parallel dump are put next to the dump, or into
+  // the temp directory if the dump is streamed to a pipe.
+  char segment_base[JVM_MAXPATHLEN];
+  if (FileWriter::is_pipe(path)) {
+    jio_snprintf(segment_base, sizeof(segment_base), "%s%sjava_heapdump",
+                 os::get_temp_directory(), os::file_separator());
+  } else {
+    jio_snprintf(segment_base, sizeof(segment_base), "%s", path);
+  }
+
   // generate the dump
-  VM_HeapDumper dumper(&writer, _gc_before_heap_dump, _oome);
+  VM_HeapDumper dumper(&writer, _gc_before_heap_dump, _oome, MAX2(num_dump_threads, 1u), segment_base,
+                       compression);
   if (Thread::current()->is_VM_thread()) {
     assert(SafepointSynchronize::is_at_safepoint(), "Expected to be called at a safepoint");
     dumper.doit();
@@ -1968,8 +2149,12 @@ int HeapDumper::dump(const char* path, outputStream* out, int compression, bool
     VMThread::execute(&dumper);
   }
 
-  // record any error that the writer may have encountered
-  set_error(writer.error());
+  if (dumper.is_parallel_dump()) {
+    dumper.merge_segments();
+  }
+
+  // record any error that the writer or the workers may have encountered
+  set_error(writer.error() != NULL ? writer.error() : dumper.segment_error());
 
   // print message in interactive case
   if (out != NULL) {
@@ -1978,11 +2163,11 @@ int HeapDumper::dump(const char* path, outputStream* out, int compression, bool
       out->print_cr("Heap dump file created [" JULONG_FORMAT " bytes in %3.3f secs]",
                     writer.bytes_written(), timer()->seconds());
     } else {
-      out->print_cr("Dump file is incomplete: %s", writer.error());
+      out->print_cr("Dump file is incomplete: %s", error());
     }
   }
 
-  return (writer.error() == NULL) ? 0 : -1;
+  return (error() == NULL) ? 0 : -1;
 }
 
 // stop timer (if still active), and free any error string we might be holding
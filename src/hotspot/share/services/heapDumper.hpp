@@ -70,7 +70,9 @@ class HeapDumper : public StackObj {
 
   // dumps the heap to the specified file, returns 0 if success.
   // compression >= 0 creates a gzipped file with the given compression level.
-  int dump(const char* path, outputStream* out = NULL, int compression = -1, bool overwrite = false);
+  // num_dump_threads > 1 dumps the objects in parallel, if the GC supports it.
+  int dump(const char* path, outputStream* out = NULL, int compression = -1, bool overwrite = false,
+           uint num_dump_threads = 1);
 
   // returns error message (resource allocated), or NULL if no error
   char* error_as_C_string() const;
@@ -29,11 +29,27 @@
 #include "runtime/thread.inline.hpp"
 #include "services/heapDumperCompression.hpp"
 
+#include <sys/stat.h>
+
+
+bool FileWriter::is_pipe(char const* path) {
+#ifdef S_ISFIFO
+  struct stat st;
+  return os::stat(path, &st) == 0 && S_ISFIFO(st.st_mode);
+#else
+  return false;
+#endif
+}
 
 char const* FileWriter::open_writer() {
   assert(_fd < 0, "Must not already be open");
 
-  _fd = os::create_binary_file(_path, _overwrite);    // don't replace existing file
+  if (is_pipe(_path)) {
+    // Blocks until the reading side of the pipe is opened.
+    _fd = os::open(_path, O_WRONLY, 0);
+  } else {
+    _fd = os::create_binary_file(_path, _overwrite);    // don't replace existing file
+  }
 
   if (_fd < 0) {
     return os::strerror(errno);
@@ -93,7 +109,7 @@ void* GZipCompressor::load_gzip_func(char const* name) {
 char const* GZipCompressor::init(size_t block_size, size_t* needed_out_size,
                                  size_t* needed_tmp_size) {
   _block_size = block_size;
-  _is_first = true;
+  _is_first = _write_block_size;
 
   if (gzip_compress_func == NULL) {
     gzip_compress_func = (GzipCompressFunc) load_gzip_func("ZIP_GZip_Fully");
@@ -267,6 +283,20 @@ void CompressionBackend::deactivate() {
   ml.notify_all();
 }
 
+void CompressionBackend::write_unbuffered(char* buf, size_t size) {
+  assert(!_active, "Must be deactivated");
+  assert(_nr_of_threads == 0, "Must have no active threads");
+
+  if ((_err == NULL) && (size > 0)) {
+    char const* msg = _writer->write_buf(buf, (ssize_t) size);
+    set_error(msg);
+
+    if (msg == NULL) {
+      _written += size;
+    }
+  }
+}
+
 void CompressionBackend::thread_loop(bool single_run) {
   // Register if this is a worker thread.
   if (!single_run) {
@@ -57,7 +57,8 @@ public:
 };
 
 
-// A writer for a file.
+// A writer for a file. If the path names an existing pipe, the dump is
+// streamed to it, since it is written strictly sequentially.
 class FileWriter : public AbstractWriter {
 private:
   char const* _path;
@@ -69,6 +70,12 @@ public:
 
   ~FileWriter();
 
+  // Returns true if the path names an existing pipe.
+  static bool is_pipe(char const* path);
+
+  // Returns true if the file has been opened.
+  bool is_open() const { return _fd >= 0; }
+
   // Opens the writer. Returns NULL on success and a static error message otherwise.
   virtual char const* open_writer();
 
@@ -82,12 +89,16 @@ class GZipCompressor : public AbstractCompressor {
 private:
   int _level;
   size_t _block_size;
+  bool _write_block_size;
   bool _is_first;
 
   void* load_gzip_func(char const* name);
 
 public:
-  GZipCompressor(int level) : _level(level), _block_size(0), _is_first(false) {
+  // If write_block_size is false, the first gzip chunk does not get the
+  // block size comment, since it is appended to the chunks of another dump.
+  GZipCompressor(int level, bool write_block_size = true) :
+    _level(level), _block_size(0), _write_block_size(write_block_size), _is_first(false) {
   }
 
   virtual char const* init(size_t block_size, size_t* needed_out_size,
@@ -227,6 +238,9 @@ public:
 
   // Shuts down the backend, releasing all threads.
   void deactivate();
+
+  // Writes the buffer to the writer as it is. Can only be called after deactivate().
+  void write_unbuffered(char* buf, size_t size);
 };
 
 
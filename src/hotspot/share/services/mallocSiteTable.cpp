@@ -26,6 +26,7 @@
 
 #include "memory/allocation.inline.hpp"
 #include "runtime/atomic.hpp"
+#include "runtime/orderAccess.hpp"
 #include "services/mallocSiteTable.hpp"
 
 /*
@@ -54,15 +55,12 @@
 size_t MallocSiteTable::_hash_entry_allocation_stack[CALC_OBJ_SIZE_IN_TYPE(NativeCallStack, size_t)];
 size_t MallocSiteTable::_hash_entry_allocation_site[CALC_OBJ_SIZE_IN_TYPE(MallocSiteHashtableEntry, size_t)];
 
-// Malloc site hashtable buckets
-MallocSiteHashtableEntry*  MallocSiteTable::_table[MallocSiteTable::table_size];
-
-// concurrent access counter
-volatile int MallocSiteTable::_access_count = 0;
-
-// Tracking hashtable contention
-NOT_PRODUCT(int MallocSiteTable::_peak_count = 0;)
+// The first generation of malloc site hashtable buckets
+MallocSiteHashtableEntry* volatile MallocSiteTable::_table[MallocSiteTable::table_size];
 
+MallocSiteTable::Generation MallocSiteTable::_generations[MallocSiteTable::max_generations];
+volatile int MallocSiteTable::_num_generations = 0;
+volatile int MallocSiteTable::_growing = 0;
 
 /*
  * Initialize malloc site table.
@@ -105,24 +103,42 @@ bool MallocSiteTable::initialize() {
   MallocSiteHashtableEntry* entry = ::new ((void*)_hash_entry_allocation_site)
     MallocSiteHashtableEntry(*stack, mtNMT);
 
+  Generation* gen = &_generations[0];
+  gen->_buckets = _table;
+  gen->_base = 0;
+  gen->_size = table_size;
+  gen->_entries = 1;
+  _num_generations = 1;
+
   // Add the allocation site to hashtable.
-  int index = hash_to_index(stack->hash());
+  int index = stack->hash() % table_size;
   _table[index] = entry;
 
   return true;
 }
 
+int MallocSiteTable::hash_buckets() {
+  const Generation* last = &_generations[OrderAccess::load_acquire(&_num_generations) - 1];
+  return (int)(last->_base + last->_size);
+}
+
 // Walks entries in the hashtable.
 // It stops walk if the walker returns false.
 bool MallocSiteTable::walk(MallocSiteWalker* walker) {
-  MallocSiteHashtableEntry* head;
-  for (int index = 0; index < table_size; index ++) {
-    head = _table[index];
-    while (head != NULL) {
-      if (!walker->do_malloc_site(head->peek())) {
-        return false;
+  const int num_generations = OrderAccess::load_acquire(&_num_generations);
+  for (int g = 0; g < num_generations; g++) {
+    const Generation* gen = &_generations[g];
+    for (size_t index = 0; index < gen->_size; index++) {
+      const MallocSiteHashtableEntry* head = gen->_buckets[index];
+      if (head != NULL) {
+        walker->do_bucket(gen->_base + index);
+      }
+      while (head != NULL) {
+        if (!walker->do_malloc_site(head->peek())) {
+          return false;
+        }
+        head = head->next();
       }
-      head = (MallocSiteHashtableEntry*)head->next();
     }
   }
   return true;
@@ -138,40 +154,65 @@ bool MallocSiteTable::walk(MallocSiteWalker* walker) {
  *    1. Out of memory, it cannot allocate new hash entry.
  *    2. Overflow hash bucket.
  *  Under any of above circumstances, caller should handle the situation.
+ *
+ *  If the table grows while a thread adds an entry to the previous
+ *  generation, another thread can add the same call stack to the new
+ *  generation. Both entries are then counted, which is benign.
  */
 MallocSite* MallocSiteTable::lookup_or_add(const NativeCallStack& key, size_t* bucket_idx,
   size_t* pos_idx, MEMFLAGS flags) {
   assert(flags != mtNone, "Should have a real memory type");
-  unsigned int index = hash_to_index(key.hash());
-  *bucket_idx = (size_t)index;
+  const int num_generations = OrderAccess::load_acquire(&_num_generations);
+  for (int g = 0; g < num_generations - 1; g++) {
+    MallocSite* site = lookup_or_add_in(&_generations[g], key, false, bucket_idx, pos_idx, flags);
+    if (site != NULL) {
+      return site;
+    }
+  }
+  Generation* last = &_generations[num_generations - 1];
+  MallocSite* site = lookup_or_add_in(last, key, true, bucket_idx, pos_idx, flags);
+  if (last->_entries > last->_size * max_load_factor) {
+    grow(num_generations - 1);
+  }
+  return site;
+}
+
+MallocSite* MallocSiteTable::lookup_or_add_in(Generation* gen, const NativeCallStack& key, bool add,
+  size_t* bucket_idx, size_t* pos_idx, MEMFLAGS flags) {
+  const size_t index = key.hash() % gen->_size;
+  MallocSiteHashtableEntry* volatile* bucket = &gen->_buckets[index];
+  *bucket_idx = gen->_base + index;
   *pos_idx = 0;
 
   // First entry for this hash bucket
-  if (_table[index] == NULL) {
+  if (*bucket == NULL) {
+    if (!add) return NULL;
     MallocSiteHashtableEntry* entry = new_entry(key, flags);
     // OOM check
     if (entry == NULL) return NULL;
 
     // swap in the head
-    if (Atomic::replace_if_null(entry, &_table[index])) {
+    if (Atomic::replace_if_null(entry, bucket)) {
+      Atomic::inc(&gen->_entries);
       return entry->data();
     }
 
     delete entry;
   }
 
-  MallocSiteHashtableEntry* head = _table[index];
+  MallocSiteHashtableEntry* head = *bucket;
   while (head != NULL && (*pos_idx) <= MAX_BUCKET_LENGTH) {
     MallocSite* site = head->data();
     if (site->flag() == flags && site->equals(key)) {
       return head->data();
     }
 
-    if (head->next() == NULL && (*pos_idx) < MAX_BUCKET_LENGTH) {
+    if (add && head->next() == NULL && (*pos_idx) < MAX_BUCKET_LENGTH) {
       MallocSiteHashtableEntry* entry = new_entry(key, flags);
       // OOM check
       if (entry == NULL) return NULL;
       if (head->atomic_insert(entry)) {
+        Atomic::inc(&gen->_entries);
         (*pos_idx) ++;
         return entry->data();
       }
@@ -184,15 +225,49 @@ MallocSite* MallocSiteTable::lookup_or_add(const NativeCallStack& key, size_t* b
   return NULL;
 }
 
+// Adds a generation after the given one, unless another thread already did,
+// or the bucket index would overflow the malloc header.
+void MallocSiteTable::grow(int generation) {
+  if (Atomic::cmpxchg(1, &_growing, 0) != 0) {
+    return;
+  }
+  if (generation == _num_generations - 1 && generation + 1 < max_generations) {
+    const Generation* last = &_generations[generation];
+    const size_t base = last->_base + last->_size;
+    const size_t size = last->_size * 2;
+    if (base + size < NO_MALLOC_SITE) {
+      // Recorded with the pre-installed allocation site, so it does not recurse.
+      void* buckets = AllocateHeap(size * sizeof(MallocSiteHashtableEntry*), mtNMT,
+        *hash_entry_allocation_stack(), AllocFailStrategy::RETURN_NULL);
+      if (buckets != NULL) {
+        memset(buckets, 0, size * sizeof(MallocSiteHashtableEntry*));
+        Generation* next = &_generations[generation + 1];
+        next->_buckets = (MallocSiteHashtableEntry* volatile*)buckets;
+        next->_base = base;
+        next->_size = size;
+        next->_entries = 0;
+        OrderAccess::release_store(&_num_generations, generation + 2);
+      }
+    }
+  }
+  OrderAccess::release_store(&_growing, 0);
+}
+
 // Access malloc site
 MallocSite* MallocSiteTable::malloc_site(size_t bucket_idx, size_t pos_idx) {
-  assert(bucket_idx < table_size, "Invalid bucket index");
-  MallocSiteHashtableEntry* head = _table[bucket_idx];
+  const int num_generations = OrderAccess::load_acquire(&_num_generations);
+  int g = num_generations - 1;
+  while (g > 0 && bucket_idx < _generations[g]._base) {
+    g--;
+  }
+  const Generation* gen = &_generations[g];
+  assert(bucket_idx - gen->_base < gen->_size, "Invalid bucket index");
+  const MallocSiteHashtableEntry* head = gen->_buckets[bucket_idx - gen->_base];
   for (size_t index = 0;
        index < pos_idx && head != NULL;
-       index++, head = (MallocSiteHashtableEntry*)head->next()) {}
+       index++, head = head->next()) {}
   assert(head != NULL, "Invalid position index");
-  return head->data();
+  return const_cast<MallocSiteHashtableEntry*>(head)->data();
 }
 
 // Allocates MallocSiteHashtableEntry object. Special call stack
@@ -204,64 +279,9 @@ MallocSiteHashtableEntry* MallocSiteTable::new_entry(const NativeCallStack& key,
   return ::new (p) MallocSiteHashtableEntry(key, flags);
 }
 
-void MallocSiteTable::reset() {
-  for (int index = 0; index < table_size; index ++) {
-    MallocSiteHashtableEntry* head = _table[index];
-    _table[index] = NULL;
-    delete_linked_list(head);
-  }
-}
-
-void MallocSiteTable::delete_linked_list(MallocSiteHashtableEntry* head) {
-  MallocSiteHashtableEntry* p;
-  while (head != NULL) {
-    p = head;
-    head = (MallocSiteHashtableEntry*)head->next();
-    if (p != (MallocSiteHashtableEntry*)_hash_entry_allocation_site) {
-      delete p;
-    }
-  }
-}
-
-void MallocSiteTable::shutdown() {
-  AccessLock locker(&_access_count);
-  locker.exclusiveLock();
-  reset();
-}
-
 bool MallocSiteTable::walk_malloc_site(MallocSiteWalker* walker) {
   assert(walker != NULL, "NuLL walker");
-  AccessLock locker(&_access_count);
-  if (locker.sharedLock()) {
-    NOT_PRODUCT(_peak_count = MAX2(_peak_count, _access_count);)
-    return walk(walker);
-  }
-  return false;
-}
-
-
-void MallocSiteTable::AccessLock::exclusiveLock() {
-  int target;
-  int val;
-
-  assert(_lock_state != ExclusiveLock, "Can only call once");
-  assert(*_lock >= 0, "Can not content exclusive lock");
-
-  // make counter negative to block out shared locks
-  do {
-    val = *_lock;
-    target = _MAGIC_ + *_lock;
-  } while (Atomic::cmpxchg(target, _lock, val) != val);
-
-  // wait for all readers to exit
-  while (*_lock != _MAGIC_) {
-#ifdef _WINDOWS
-    os::naked_short_sleep(1);
-#else
-    os::naked_yield();
-#endif
-  }
-  _lock_state = ExclusiveLock;
+  return walk(walker);
 }
 
 bool MallocSiteHashtableEntry::atomic_insert(MallocSiteHashtableEntry* entry) {
@@ -48,6 +48,10 @@ class MallocSite : public AllocationSite<MemoryCounter> {
   void allocate(size_t size)      { data()->allocate(size);   }
   void deallocate(size_t size)    { data()->deallocate(size); }
 
+  // An allocation that stands for weight allocations of the same size
+  void allocate(size_t size, size_t weight)   { data()->allocate(size * weight, weight);   }
+  void deallocate(size_t size, size_t weight) { data()->deallocate(size * weight, weight); }
+
   // Memory allocated from this code path
   size_t size()  const { return peek()->size(); }
   // The number of calls were made
@@ -99,14 +103,28 @@ class MallocSiteHashtableEntry : public CHeapObj<mtNMT> {
 // The walker walks every entry on MallocSiteTable
 class MallocSiteWalker : public StackObj {
  public:
+   // Called before the entries of a non-empty hash bucket are walked
+   virtual void do_bucket(size_t bucket_idx) { }
    virtual bool do_malloc_site(const MallocSite* e) { return false; }
 };
 
 /*
  * Native memory tracking call site table.
  * The table is only needed when detail tracking is enabled.
+ *
+ * The table grows by adding generations of hash buckets, each twice the
+ * size of the previous one, when the newest generation gets too full.
+ * Entries are never moved or removed, so the bucket and position indices
+ * recorded in malloc headers stay valid. The bucket index counts the buckets
+ * of all generations. A call stack is looked up from the oldest to the
+ * newest generation, and new entries are only added to the newest one.
+ *
+ * Entries are added with compare-and-swap, and lookups never block. Since
+ * concurrent readers cannot be excluded, the table is never freed, also not
+ * when detail tracking is shut down.
  */
 class MallocSiteTable : AllStatic {
+  friend class MallocSiteTableTest;
  private:
   // The number of hash bucket in this hashtable. The number should
   // be tuned if malloc activities changed significantly.
@@ -118,108 +136,59 @@ class MallocSiteTable : AllStatic {
   enum {
     table_base_size = 128,   // The base size is calculated from statistics to give
                              // table ratio around 1:6
-    table_size = (table_base_size * NMT_TrackingStackDepth - 1)
+    table_size = (table_base_size * NMT_TrackingStackDepth - 1),
+    max_generations = 16,
+    max_load_factor = 6      // A generation is added when the newest one has
+                             // more entries than max_load_factor * buckets
   };
 
-
-  // This is a very special lock, that allows multiple shared accesses (sharedLock), but
-  // once exclusive access (exclusiveLock) is requested, all shared accesses are
-  // rejected forever.
-  class AccessLock : public StackObj {
-    enum LockState {
-      NoLock,
-      SharedLock,
-      ExclusiveLock
-    };
-
-   private:
-    // A very large negative number. The only possibility to "overflow"
-    // this number is when there are more than -min_jint threads in
-    // this process, which is not going to happen in foreseeable future.
-    const static int _MAGIC_ = min_jint;
-
-    LockState      _lock_state;
-    volatile int*  _lock;
-   public:
-    AccessLock(volatile int* lock) :
-      _lock(lock), _lock_state(NoLock) {
-    }
-
-    ~AccessLock() {
-      if (_lock_state == SharedLock) {
-        Atomic::dec(_lock);
-      }
-    }
-    // Acquire shared lock.
-    // Return true if shared access is granted.
-    inline bool sharedLock() {
-      jint res = Atomic::add(1, _lock);
-      if (res < 0) {
-        Atomic::dec(_lock);
-        return false;
-      }
-      _lock_state = SharedLock;
-      return true;
-    }
-    // Acquire exclusive lock
-    void exclusiveLock();
- };
+  // A generation of hash buckets
+  struct Generation {
+    MallocSiteHashtableEntry* volatile* _buckets;
+    size_t                              _base;     // bucket index of the first bucket
+    size_t                              _size;     // number of buckets
+    volatile size_t                     _entries;
+  };
 
  public:
   static bool initialize();
-  static void shutdown();
-
-  NOT_PRODUCT(static int access_peak_count() { return _peak_count; })
 
-  // Number of hash buckets
-  static inline int hash_buckets()      { return (int)table_size; }
+  // Number of hash buckets in all generations
+  static int hash_buckets();
 
-  // Access and copy a call stack from this table. Shared lock should be
-  // acquired before access the entry.
+  // Access and copy a call stack from this table.
   static inline bool access_stack(NativeCallStack& stack, size_t bucket_idx,
     size_t pos_idx) {
-    AccessLock locker(&_access_count);
-    if (locker.sharedLock()) {
-      NOT_PRODUCT(_peak_count = MAX2(_peak_count, _access_count);)
-      MallocSite* site = malloc_site(bucket_idx, pos_idx);
-      if (site != NULL) {
-        stack = *site->call_stack();
-        return true;
-      }
+    MallocSite* site = malloc_site(bucket_idx, pos_idx);
+    if (site != NULL) {
+      stack = *site->call_stack();
+      return true;
     }
     return false;
   }
 
-  // Record a new allocation from specified call path.
+  // Record a new allocation from specified call path. With sampling detail
+  // tracking, a sampled allocation has the weight of the sample interval.
   // Return true if the allocation is recorded successfully, bucket_idx
   // and pos_idx are also updated to indicate the entry where the allocation
   // information was recorded.
   // Return false only occurs under rare scenarios:
   //  1. out of memory
   //  2. overflow hash bucket
-  static inline bool allocation_at(const NativeCallStack& stack, size_t size,
+  static inline bool allocation_at(const NativeCallStack& stack, size_t size, size_t weight,
     size_t* bucket_idx, size_t* pos_idx, MEMFLAGS flags) {
-    AccessLock locker(&_access_count);
-    if (locker.sharedLock()) {
-      NOT_PRODUCT(_peak_count = MAX2(_peak_count, _access_count);)
-      MallocSite* site = lookup_or_add(stack, bucket_idx, pos_idx, flags);
-      if (site != NULL) site->allocate(size);
-      return site != NULL;
-    }
-    return false;
+    MallocSite* site = lookup_or_add(stack, bucket_idx, pos_idx, flags);
+    if (site != NULL) site->allocate(size, weight);
+    return site != NULL;
   }
 
   // Record memory deallocation. bucket_idx and pos_idx indicate where the allocation
   // information was recorded.
-  static inline bool deallocation_at(size_t size, size_t bucket_idx, size_t pos_idx) {
-    AccessLock locker(&_access_count);
-    if (locker.sharedLock()) {
-      NOT_PRODUCT(_peak_count = MAX2(_peak_count, _access_count);)
-      MallocSite* site = malloc_site(bucket_idx, pos_idx);
-      if (site != NULL) {
-        site->deallocate(size);
-        return true;
-      }
+  static inline bool deallocation_at(size_t size, size_t weight, size_t bucket_idx, size_t pos_idx) {
+    MallocSite* site = malloc_site(bucket_idx, pos_idx);
+    if (site != NULL) {
+      site->deallocate(size, weight);
+      return true;
     }
     return false;
   }
@@ -227,33 +196,34 @@ class MallocSiteTable : AllStatic {
   // Walk this table.
   static bool walk_malloc_site(MallocSiteWalker* walker);
 
+  // The table allocates its own memory with this call stack, such
+  // allocations are always recorded, also when sampling.
+  static inline bool is_table_allocation_stack(const NativeCallStack& stack) {
+    return stack.equals(*hash_entry_allocation_stack());
+  }
+
  private:
   static MallocSiteHashtableEntry* new_entry(const NativeCallStack& key, MEMFLAGS flags);
-  static void reset();
-
-  // Delete a bucket linked list
-  static void delete_linked_list(MallocSiteHashtableEntry* head);
 
   static MallocSite* lookup_or_add(const NativeCallStack& key, size_t* bucket_idx, size_t* pos_idx, MEMFLAGS flags);
+  static MallocSite* lookup_or_add_in(Generation* gen, const NativeCallStack& key, bool add,
+                                      size_t* bucket_idx, size_t* pos_idx, MEMFLAGS flags);
+  static void grow(int generation);
   static MallocSite* malloc_site(size_t bucket_idx, size_t pos_idx);
   static bool walk(MallocSiteWalker* walker);
 
-  static inline unsigned int hash_to_index(unsigned int hash) {
-    return (hash % table_size);
-  }
-
   static inline const NativeCallStack* hash_entry_allocation_stack() {
     return (NativeCallStack*)_hash_entry_allocation_stack;
   }
 
  private:
-  // Counter for counting concurrent access
-  static volatile int                _access_count;
-
-  // The callsite hashtable. It has to be a static table,
-  // since malloc call can come from C runtime linker.
-  static MallocSiteHashtableEntry*   _table[table_size];
+  // The first generation of the callsite hashtable. It has to be a static
+  // table, since malloc call can come from C runtime linker.
+  static MallocSiteHashtableEntry* volatile _table[table_size];
 
+  static Generation     _generations[max_generations];
+  static volatile int   _num_generations;
+  static volatile int   _growing;
 
   // Reserve enough memory for placing the objects
 
@@ -261,7 +231,6 @@ class MallocSiteTable : AllStatic {
   static size_t _hash_entry_allocation_stack[CALC_OBJ_SIZE_IN_TYPE(NativeCallStack, size_t)];
   // The memory for hashtable entry allocation callsite object
   static size_t _hash_entry_allocation_site[CALC_OBJ_SIZE_IN_TYPE(MallocSiteHashtableEntry, size_t)];
-  NOT_PRODUCT(static int     _peak_count;)
 };
 
 #endif // INCLUDE_NMT
@@ -31,6 +31,9 @@
 
 size_t MallocMemorySummary::_snapshot[CALC_OBJ_SIZE_IN_TYPE(MallocMemorySnapshot, size_t)];
 
+size_t          MallocTracker::_sample_interval = 1;
+volatile size_t MallocTracker::_sample_counter = 0;
+
 // Total malloc'd memory amount
 size_t MallocMemorySnapshot::total() const {
   size_t amount = 0;
@@ -71,14 +74,24 @@ void MallocHeader::release() const {
 
   MallocMemorySummary::record_free(size(), flags());
   MallocMemorySummary::record_free_malloc_header(sizeof(MallocHeader));
-  if (MemTracker::tracking_level() == NMT_detail) {
-    MallocSiteTable::deallocation_at(size(), _bucket_idx, _pos_idx);
+  if (MemTracker::tracking_level() == NMT_detail && _bucket_idx != NO_MALLOC_SITE) {
+    const size_t weight = _sampled ? MallocTracker::sample_interval() : 1;
+    MallocSiteTable::deallocation_at(size(), weight, _bucket_idx, _pos_idx);
   }
 }
 
 bool MallocHeader::record_malloc_site(const NativeCallStack& stack, size_t size,
-  size_t* bucket_idx, size_t* pos_idx, MEMFLAGS flags) const {
-  bool ret = MallocSiteTable::allocation_at(stack, size, bucket_idx, pos_idx, flags);
+  size_t* bucket_idx, size_t* pos_idx, bool* sampled, MEMFLAGS flags) const {
+  *sampled = false;
+  if (MallocTracker::is_sampling()) {
+    if (stack.is_empty()) {
+      // Not sampled, the call stack was not captured.
+      return false;
+    }
+    *sampled = !MallocSiteTable::is_table_allocation_stack(stack);
+  }
+  const size_t weight = *sampled ? MallocTracker::sample_interval() : 1;
+  bool ret = MallocSiteTable::allocation_at(stack, size, weight, bucket_idx, pos_idx, flags);
 
   // Something went wrong, could be OOM or overflow malloc site table.
   // We want to keep tracking data under OOM circumstance, so transition to
@@ -90,6 +103,9 @@ bool MallocHeader::record_malloc_site(const NativeCallStack& stack, size_t size,
 }
 
 bool MallocHeader::get_stack(NativeCallStack& stack) const {
+  if (_bucket_idx == NO_MALLOC_SITE) {
+    return false;
+  }
   return MallocSiteTable::access_stack(stack, _bucket_idx, _pos_idx);
 }
 
@@ -109,13 +125,17 @@ bool MallocTracker::transition(NMT_TrackingLevel from, NMT_TrackingLevel to) {
   assert(to != NMT_off, "Can not transition to off state");
   assert (from != NMT_minimal, "cannot transition from minimal state");
 
-  if (from == NMT_detail) {
-    assert(to == NMT_minimal || to == NMT_summary, "Just check");
-    MallocSiteTable::shutdown();
-  }
+  // The malloc site table is not freed when leaving detail tracking,
+  // since other threads may still be using it.
+  assert(from != NMT_detail || to == NMT_minimal || to == NMT_summary, "Just check");
   return true;
 }
 
+void MallocTracker::set_sample_interval(size_t interval) {
+  assert(interval > 0, "invariant");
+  _sample_interval = interval;
+}
+
 // Record a malloc memory allocation
 void* MallocTracker::record_malloc(void* malloc_base, size_t size, MEMFLAGS flags,
   const NativeCallStack& stack, NMT_TrackingLevel level) {
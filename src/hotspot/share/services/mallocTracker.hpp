@@ -70,6 +70,25 @@ class MemoryCounter {
     }
   }
 
+  // Records count allocations of sz bytes in total
+  inline void allocate(size_t sz, size_t count) {
+    Atomic::add(count, &_count);
+    if (sz > 0) {
+      Atomic::add(sz, &_size);
+      DEBUG_ONLY(_peak_size = MAX2(_peak_size, _size));
+    }
+    DEBUG_ONLY(_peak_count = MAX2(_peak_count, _count);)
+  }
+
+  inline void deallocate(size_t sz, size_t count) {
+    assert(_count >= count, "Nothing allocated yet");
+    assert(_size >= sz, "deallocation > allocated");
+    Atomic::sub(count, &_count);
+    if (sz > 0) {
+      Atomic::sub(sz, &_size);
+    }
+  }
+
   inline void resize(ssize_t sz) {
     if (sz != 0) {
       assert(sz >= 0 || _size >= size_t(-sz), "Must be");
@@ -244,21 +263,26 @@ class MallocMemorySummary : AllStatic {
  */
 
 class MallocHeader {
+  friend class MallocSiteTableTest;
 #ifdef _LP64
   size_t           _size      : 64;
   size_t           _flags     : 8;
   size_t           _pos_idx   : 16;
-  size_t           _bucket_idx: 40;
-#define MAX_MALLOCSITE_TABLE_SIZE right_n_bits(40)
+  size_t           _sampled   : 1;
+  size_t           _bucket_idx: 39;
+#define MAX_MALLOCSITE_TABLE_SIZE right_n_bits(39)
 #define MAX_BUCKET_LENGTH         right_n_bits(16)
 #else
   size_t           _size      : 32;
   size_t           _flags     : 8;
   size_t           _pos_idx   : 8;
-  size_t           _bucket_idx: 16;
-#define MAX_MALLOCSITE_TABLE_SIZE  right_n_bits(16)
+  size_t           _sampled   : 1;
+  size_t           _bucket_idx: 15;
+#define MAX_MALLOCSITE_TABLE_SIZE  right_n_bits(15)
 #define MAX_BUCKET_LENGTH          right_n_bits(8)
 #endif  // _LP64
+// Bucket index of an allocation that is not recorded in the malloc site table
+#define NO_MALLOC_SITE             MAX_MALLOCSITE_TABLE_SIZE
 
  public:
   MallocHeader(size_t size, MEMFLAGS flags, const NativeCallStack& stack, NMT_TrackingLevel level) {
@@ -274,11 +298,16 @@ class MallocHeader {
     if (level == NMT_detail) {
       size_t bucket_idx;
       size_t pos_idx;
-      if (record_malloc_site(stack, size, &bucket_idx, &pos_idx, flags)) {
-        assert(bucket_idx <= MAX_MALLOCSITE_TABLE_SIZE, "Overflow bucket index");
+      bool sampled;
+      _bucket_idx = NO_MALLOC_SITE;
+      _pos_idx = 0;
+      _sampled = 0;
+      if (record_malloc_site(stack, size, &bucket_idx, &pos_idx, &sampled, flags)) {
+        assert(bucket_idx < MAX_MALLOCSITE_TABLE_SIZE, "Overflow bucket index");
         assert(pos_idx <= MAX_BUCKET_LENGTH, "Overflow bucket position index");
         _bucket_idx = bucket_idx;
         _pos_idx = pos_idx;
+        _sampled = sampled ? 1 : 0;
       }
     }
 
@@ -298,16 +327,34 @@ class MallocHeader {
     _size = size;
   }
   bool record_malloc_site(const NativeCallStack& stack, size_t size,
-    size_t* bucket_idx, size_t* pos_idx, MEMFLAGS flags) const;
+    size_t* bucket_idx, size_t* pos_idx, bool* sampled, MEMFLAGS flags) const;
 };
 
 
 // Main class called from MemTracker to track malloc activities
 class MallocTracker : AllStatic {
+ private:
+  static size_t          _sample_interval;
+  static volatile size_t _sample_counter;
+
  public:
   // Initialize malloc tracker for specific tracking level
   static bool initialize(NMT_TrackingLevel level);
 
+  // Sampling detail tracking (-XX:NMTSampleInterval). Only the call stack of
+  // every sample_interval()'th allocation is captured, and such an allocation
+  // is recorded in the malloc site table as sample_interval() allocations.
+  // The malloc site statistics are then estimates, the summary stays exact.
+  static void set_sample_interval(size_t interval);
+  static inline size_t sample_interval() { return _sample_interval; }
+  static inline bool is_sampling()       { return _sample_interval > 1; }
+
+  // Whether to capture the call stack of the next allocation. The counter
+  // is not updated atomically, a lost update only shifts the next sample.
+  static inline bool sample_next_stack() {
+    return !is_sampling() || (++_sample_counter % _sample_interval) == 0;
+  }
+
   static bool transition(NMT_TrackingLevel from, NMT_TrackingLevel to);
 
   // malloc tracking header size for specific tracking level
@@ -1007,8 +1007,8 @@ static void do_thread_dump(ThreadDumpResult* dump_result,
 
   {
     // Need this ThreadsListHandle for converting Java thread IDs into
-    // threadObj handles; dump_result->set_t_list() is called in the
-    // VM op below so we can't use it yet.
+    // threadObj handles; dump_result->set_t_list() is called in
+    // ThreadService::dump_threads() below so we can't use it yet.
     ThreadsListHandle tlh;
     for (int i = 0; i < num_threads; i++) {
       jlong tid = ids_ah->long_at(i);
@@ -1020,13 +1020,12 @@ static void do_thread_dump(ThreadDumpResult* dump_result,
   }
 
   // Obtain thread dumps and thread snapshot information
-  VM_ThreadDump op(dump_result,
-                   thread_handle_array,
-                   num_threads,
-                   max_depth, /* stack depth */
-                   with_locked_monitors,
-                   with_locked_synchronizers);
-  VMThread::execute(&op);
+  ThreadService::dump_threads(dump_result,
+                              thread_handle_array,
+                              num_threads,
+                              max_depth, /* stack depth */
+                              with_locked_monitors,
+                              with_locked_synchronizers);
 }
 
 // Gets an array of ThreadInfo objects. Each element is the ThreadInfo
@@ -1163,11 +1162,12 @@ JVM_ENTRY(jobjectArray, jmm_DumpThreads(JNIEnv *env, jlongArray thread_ids, jboo
                    CHECK_NULL);
   } else {
     // obtain thread dump of all threads
-    VM_ThreadDump op(&dump_result,
-                     maxDepth, /* stack depth */
-                     (locked_monitors ? true : false),     /* with locked monitors */
-                     (locked_synchronizers ? true : false) /* with locked synchronizers */);
-    VMThread::execute(&op);
+    ThreadService::dump_threads(&dump_result,
+                                NULL, /* all threads */
+                                0,
+                                maxDepth, /* stack depth */
+                                (locked_monitors ? true : false),     /* with locked monitors */
+                                (locked_synchronizers ? true : false) /* with locked synchronizers */);
   }
 
   int num_snapshots = dump_result.num_snapshots();
@@ -195,6 +195,7 @@ bool MemBaseline::baseline(bool summaryOnly) {
   // baseline details
   if (!summaryOnly &&
       MemTracker::tracking_level() == NMT_detail) {
+    _malloc_sample_interval = MallocTracker::sample_interval();
     baseline_allocation_sites();
     _baseline_type = Detail_baselined;
   }
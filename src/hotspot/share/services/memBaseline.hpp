@@ -66,6 +66,9 @@ class MemBaseline {
   size_t                 _instance_class_count;
   size_t                 _array_class_count;
 
+  // Sample interval of the malloc sites, 1 if not sampled
+  size_t                 _malloc_sample_interval;
+
   // Allocation sites information
   // Malloc allocation sites
   LinkedListImpl<MallocSite>                  _malloc_sites;
@@ -86,7 +89,8 @@ class MemBaseline {
   // create a memory baseline
   MemBaseline():
     _baseline_type(Not_baselined),
-    _instance_class_count(0), _array_class_count(0) {
+    _instance_class_count(0), _array_class_count(0),
+    _malloc_sample_interval(1) {
   }
 
   bool baseline(bool summaryOnly = true);
@@ -106,6 +110,10 @@ class MemBaseline {
   }
 
   MallocSiteIterator malloc_sites(SortingOrder order);
+
+  // The malloc sites are estimates, if they were sampled
+  bool is_malloc_sampled() const      { return _malloc_sample_interval > 1; }
+  size_t malloc_sample_interval() const { return _malloc_sample_interval; }
   VirtualMemorySiteIterator virtual_memory_sites(SortingOrder order);
 
   // Virtual memory allocation iterator always returns in virtual memory
@@ -181,6 +189,7 @@ class MemBaseline {
     // _malloc_memory_snapshot and _virtual_memory_snapshot are copied over.
     _instance_class_count  = 0;
     _array_class_count = 0;
+    _malloc_sample_interval = 1;
 
     _malloc_sites.clear();
     _virtual_memory_sites.clear();
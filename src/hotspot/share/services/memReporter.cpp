@@ -221,6 +221,10 @@ void MemDetailReporter::report_detail() {
   outputStream* out = output();
   out->print_cr("Details:\n");
 
+  if (_baseline.is_malloc_sampled()) {
+    out->print_cr("Malloc sites are sampled (NMTSampleInterval=" SIZE_FORMAT "), "
+                  "their sizes and counts are estimates.\n", _baseline.malloc_sample_interval());
+  }
   report_malloc_sites();
   report_virtual_memory_allocation_sites();
 }
@@ -625,6 +629,11 @@ void MemSummaryDiffReporter::print_metaspace_diff(Metaspace::MetadataType type,
 
 void MemDetailDiffReporter::report_diff() {
   MemSummaryDiffReporter::report_diff();
+  if (_early_baseline.is_malloc_sampled() || _current_baseline.is_malloc_sampled()) {
+    output()->print_cr("Malloc sites are sampled (NMTSampleInterval=" SIZE_FORMAT "), "
+                       "their sizes and counts are estimates.\n",
+                       MAX2(_early_baseline.malloc_sample_interval(), _current_baseline.malloc_sample_interval()));
+  }
   diff_malloc_sites();
   diff_virtual_memory_sites();
 }
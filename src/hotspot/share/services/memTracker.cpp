@@ -246,8 +246,6 @@ class StatisticsWalker : public MallocSiteWalker {
   // Number of hash buckets that have entries over the threshold
   int   _bucket_over_threshold;
 
-  // The hash bucket that walker is currently walking
-  int   _current_hash_bucket;
   // The length of current hash bucket
   int   _current_bucket_length;
   // Number of hash buckets that are not empty
@@ -266,7 +264,6 @@ class StatisticsWalker : public MallocSiteWalker {
     }
     _bucket_over_threshold = 0;
     _longest_bucket_length = 0;
-    _current_hash_bucket = -1;
     _current_bucket_length = 0;
     _used_buckets = 0;
   }
@@ -280,23 +277,22 @@ class StatisticsWalker : public MallocSiteWalker {
     _stack_depth_distribution[frames - 1] ++;
 
     // hash distribution
-    int hash_bucket = ((unsigned)e->hash()) % MallocSiteTable::hash_buckets();
-    if (_current_hash_bucket == -1) {
-      _current_hash_bucket = hash_bucket;
-      _current_bucket_length = 1;
-    } else if (_current_hash_bucket == hash_bucket) {
-      _current_bucket_length ++;
-    } else {
+    _current_bucket_length ++;
+    return true;
+  }
+
+  virtual void do_bucket(size_t bucket_idx) {
+    if (_current_bucket_length > 0) {
       record_bucket_length(_current_bucket_length);
-      _current_hash_bucket = hash_bucket;
-      _current_bucket_length = 1;
+      _current_bucket_length = 0;
     }
-    return true;
   }
 
   // walk completed
   void completed() {
-    record_bucket_length(_current_bucket_length);
+    if (_current_bucket_length > 0) {
+      record_bucket_length(_current_bucket_length);
+    }
   }
 
   void report_statistics(outputStream* out) {
@@ -355,7 +351,9 @@ void MemTracker::tuning_statistics(outputStream* out) {
   out->print_cr("Native Memory Tracking Statistics:");
   out->print_cr("Malloc allocation site table size: %d", MallocSiteTable::hash_buckets());
   out->print_cr("             Tracking stack depth: %d", NMT_TrackingStackDepth);
-  NOT_PRODUCT(out->print_cr("Peak concurrent access: %d", MallocSiteTable::access_peak_count());)
+  if (MallocTracker::is_sampling()) {
+    out->print_cr("                  Sample interval: " SIZE_FORMAT, MallocTracker::sample_interval());
+  }
   out->print_cr(" ");
   walker.report_statistics(out);
 }
@@ -33,6 +33,8 @@
 
 #define CURRENT_PC   NativeCallStack::empty_stack()
 #define CALLER_PC    NativeCallStack::empty_stack()
+#define MALLOC_CURRENT_PC NativeCallStack::empty_stack()
+#define MALLOC_CALLER_PC  NativeCallStack::empty_stack()
 
 class Tracker : public StackObj {
  public:
@@ -90,6 +92,16 @@ extern volatile bool NMT_stack_walkable;
 #define CALLER_PC  ((MemTracker::tracking_level() == NMT_detail && NMT_stack_walkable) ?  \
                     NativeCallStack(1, true) : NativeCallStack::empty_stack())
 
+// Call stacks of malloc'ed memory. With sampling detail tracking, only some
+// of them are captured, see MallocTracker::sample_next_stack(). Virtual
+// memory is tracked with CURRENT_PC and CALLER_PC, which are not sampled.
+#define MALLOC_CURRENT_PC ((MemTracker::tracking_level() == NMT_detail && NMT_stack_walkable && \
+                            MallocTracker::sample_next_stack()) ?                              \
+                           NativeCallStack(0, true) : NativeCallStack::empty_stack())
+#define MALLOC_CALLER_PC  ((MemTracker::tracking_level() == NMT_detail && NMT_stack_walkable && \
+                            MallocTracker::sample_next_stack()) ?                              \
+                           NativeCallStack(1, true) : NativeCallStack::empty_stack())
+
 class MemBaseline;
 class Mutex;
 
@@ -33,6 +33,7 @@
 #include "oops/oop.inline.hpp"
 #include "runtime/atomic.hpp"
 #include "runtime/handles.inline.hpp"
+#include "runtime/handshake.hpp"
 #include "runtime/init.hpp"
 #include "runtime/objectMonitor.inline.hpp"
 #include "runtime/thread.inline.hpp"
@@ -41,6 +42,7 @@
 #include "runtime/vmThread.hpp"
 #include "runtime/vmOperations.hpp"
 #include "services/threadService.hpp"
+#include "utilities/resourceHash.hpp"
 
 // TODO: we need to define a naming convention for perf counters
 // to distinguish counters for:
@@ -309,13 +311,12 @@ Handle ThreadService::dump_stack_traces(GrowableArray<instanceHandle>* threads,
   assert(num_threads > 0, "just checking");
 
   ThreadDumpResult dump_result;
-  VM_ThreadDump op(&dump_result,
-                   threads,
-                   num_threads,
-                   -1,    /* entire stack */
-                   false, /* with locked monitors */
-                   false  /* with locked synchronizers */);
-  VMThread::execute(&op);
+  dump_threads(&dump_result,
+               threads,
+               num_threads,
+               -1,    /* entire stack */
+               false, /* with locked monitors */
+               false  /* with locked synchronizers */);
 
   // Allocate the resulting StackTraceElement[][] object
 
@@ -344,6 +345,131 @@ Handle ThreadService::dump_stack_traces(GrowableArray<instanceHandle>* threads,
   return result_obj;
 }
 
+typedef ResourceHashtable<JavaThread*, ThreadSnapshot*,
+                          primitive_hash<JavaThread*>, primitive_equals<JavaThread*>,
+                          1031> PendingSnapshotTable;
+
+// Takes the pending snapshots of all threads in the table. Running threads
+// take their own snapshot when they reach a handshake poll, concurrently
+// with each other, and the VM thread takes those of the blocked threads.
+class ThreadSnapshotHandshake : public HandshakeClosure {
+ private:
+  PendingSnapshotTable* _table;
+  int                   _max_depth;
+  bool                  _with_locked_monitors;
+  volatile int          _num_taken;
+
+ public:
+  ThreadSnapshotHandshake(PendingSnapshotTable* table, int max_depth, bool with_locked_monitors) :
+    HandshakeClosure("ThreadSnapshot"),
+    _table(table),
+    _max_depth(max_depth),
+    _with_locked_monitors(with_locked_monitors),
+    _num_taken(0) {}
+
+  void do_thread(Thread* thread) {
+    ThreadSnapshot** ts = _table->get((JavaThread*)thread);
+    if (ts == NULL) {
+      // Not part of the dump, or the snapshot was taken in an earlier round.
+      return;
+    }
+    ResourceMark rm;
+    HandleMark hm;
+    (*ts)->initialize_in_handshake(_max_depth, _with_locked_monitors);
+    Atomic::inc(&_num_taken);
+  }
+
+  int num_taken() const { return _num_taken; }
+};
+
+void ThreadService::dump_threads(ThreadDumpResult* result,
+                                 GrowableArray<instanceHandle>* threads,
+                                 int num_threads,
+                                 int max_depth,
+                                 bool with_locked_monitors,
+                                 bool with_locked_synchronizers) {
+  if (!ThreadDumpWithHandshakes || !ThreadLocalHandshakes) {
+    // Without thread-local handshakes every handshake is a safepoint,
+    // take all snapshots in one instead.
+    if (threads == NULL) {
+      VM_ThreadDump op(result, max_depth, with_locked_monitors, with_locked_synchronizers);
+      VMThread::execute(&op);
+    } else {
+      VM_ThreadDump op(result, threads, num_threads, max_depth, with_locked_monitors, with_locked_synchronizers);
+      VMThread::execute(&op);
+    }
+    return;
+  }
+
+  // Protect the JavaThreads in the snapshots, see VM_ThreadDump::doit().
+  result->set_t_list();
+  ThreadsList* t_list = result->t_list();
+
+  if (threads == NULL) {
+    for (uint i = 0; i < t_list->length(); i++) {
+      JavaThread* jt = t_list->thread_at(i);
+      if (jt->is_exiting() ||
+          jt->is_hidden_from_external_view()) {
+        // skip terminating threads and hidden threads
+        continue;
+      }
+      result->add_pending_thread_snapshot(jt);
+    }
+  } else {
+    for (int i = 0; i < num_threads; i++) {
+      instanceHandle th = threads->at(i);
+      JavaThread* jt = (th() != NULL ? java_lang_Thread::thread(th()) : NULL);
+      if (jt != NULL && !t_list->includes(jt)) {
+        // not a valid JavaThread, see VM_ThreadDump::doit()
+        jt = NULL;
+      }
+      if (jt == NULL || jt->is_exiting() || jt->is_hidden_from_external_view()) {
+        // add a NULL snapshot if skipped
+        result->add_thread_snapshot();
+        continue;
+      }
+      result->add_pending_thread_snapshot(jt);
+    }
+  }
+
+  // All threads are handshaked at once. A thread that is asked for more
+  // than once gets one snapshot per round.
+  while (true) {
+    ResourceMark rm;
+    PendingSnapshotTable table;
+    int num_pending = 0;
+    for (ThreadSnapshot* ts = result->snapshots(); ts != NULL; ts = ts->next()) {
+      if (ts->is_pending() && table.get(ts->thread()) == NULL) {
+        table.put(ts->thread(), ts);
+        num_pending++;
+      }
+    }
+    if (num_pending == 0) {
+      break;
+    }
+    ThreadSnapshotHandshake cl(&table, max_depth, with_locked_monitors);
+    Handshake::execute(&cl);
+    if (cl.num_taken() == 0) {
+      // The remaining threads exited before their handshake.
+      break;
+    }
+  }
+  result->remove_pending_thread_snapshots(threads != NULL /* keep_empty */);
+
+  for (ThreadSnapshot* ts = result->snapshots(); ts != NULL; ts = ts->next()) {
+    if (ts->thread() != NULL) {
+      ts->resolve_blocker_owner(t_list);
+    }
+  }
+
+  if (with_locked_synchronizers) {
+    // Finding the owned synchronizers walks the heap, which still
+    // needs a safepoint.
+    VM_ThreadDumpConcurrentLocks op(result);
+    VMThread::execute(&op);
+  }
+}
+
 void ThreadService::reset_contention_count_stat(JavaThread* thread) {
   ThreadStatistics* stat = thread->get_thread_stat();
   if (stat != NULL) {
@@ -526,6 +652,41 @@ ThreadSnapshot* ThreadDumpResult::add_thread_snapshot(JavaThread* thread) {
   return ts;
 }
 
+ThreadSnapshot* ThreadDumpResult::add_pending_thread_snapshot(JavaThread* thread) {
+  ThreadSnapshot* ts = new ThreadSnapshot();
+  ts->_thread = thread;
+  ts->_pending = true;
+  link_thread_snapshot(ts);
+  return ts;
+}
+
+void ThreadDumpResult::remove_pending_thread_snapshots(bool keep_empty) {
+  ThreadSnapshot* prev = NULL;
+  ThreadSnapshot* ts = _snapshots;
+  while (ts != NULL) {
+    ThreadSnapshot* next = ts->next();
+    if (!ts->is_pending()) {
+      prev = ts;
+    } else if (keep_empty) {
+      ts->_thread = NULL;
+      ts->_pending = false;
+      prev = ts;
+    } else {
+      if (prev == NULL) {
+        _snapshots = next;
+      } else {
+        prev->set_next(next);
+      }
+      if (_last == ts) {
+        _last = prev;
+      }
+      _num_snapshots--;
+      delete ts;
+    }
+    ts = next;
+  }
+}
+
 void ThreadDumpResult::link_thread_snapshot(ThreadSnapshot* ts) {
   assert(_num_threads == 0 || _num_snapshots < _num_threads,
          "_num_snapshots must be less than _num_threads");
@@ -642,8 +803,17 @@ ThreadStackTrace::~ThreadStackTrace() {
   }
 }
 
+#ifdef ASSERT
+// The thread is stopped at a safepoint, or in a handshake processed
+// by the VM thread or by the thread itself.
+static bool is_thread_stopped(JavaThread* thread) {
+  Thread* current = Thread::current();
+  return SafepointSynchronize::is_at_safepoint() || current->is_VM_thread() || current == thread;
+}
+#endif
+
 void ThreadStackTrace::dump_stack_at_safepoint(int maxDepth) {
-  assert(SafepointSynchronize::is_at_safepoint(), "all threads are stopped");
+  assert(is_thread_stopped(_thread), "thread is stopped");
 
   if (_thread->has_last_Java_frame()) {
     RegisterMap reg_map(_thread);
@@ -674,7 +844,7 @@ void ThreadStackTrace::dump_stack_at_safepoint(int maxDepth) {
 
 
 bool ThreadStackTrace::is_owned_monitor_on_stack(oop object) {
-  assert(SafepointSynchronize::is_at_safepoint(), "all threads are stopped");
+  assert(is_thread_stopped(_thread), "thread is stopped");
 
   bool found = false;
   int num_frames = get_stack_depth();
@@ -856,6 +1026,12 @@ ThreadStatistics::ThreadStatistics() {
 
 void ThreadSnapshot::initialize(ThreadsList * t_list, JavaThread* thread) {
   _thread = thread;
+  initialize_state();
+  resolve_blocker_owner(t_list);
+}
+
+void ThreadSnapshot::initialize_state() {
+  JavaThread* thread = _thread;
   _threadObj = thread->threadObj();
 
   ThreadStatistics* stat = thread->get_thread_stat();
@@ -883,20 +1059,6 @@ void ThreadSnapshot::initialize(ThreadsList * t_list, JavaThread* thread) {
       _thread_status = java_lang_Thread::RUNNABLE;
     } else {
       _blocker_object = obj();
-      JavaThread* owner = ObjectSynchronizer::get_lock_owner(t_list, obj);
-      if ((owner == NULL && _thread_status == java_lang_Thread::BLOCKED_ON_MONITOR_ENTER)
-          || (owner != NULL && owner->is_attaching_via_jni())) {
-        // ownership information of the monitor is not available
-        // (may no longer be owned or releasing to some other thread)
-        // make this thread in RUNNABLE state.
-        // And when the owner thread is in attaching state, the java thread
-        // is not completely initialized. For example thread name and id
-        // and may not be set, so hide the attaching thread.
-        _thread_status = java_lang_Thread::RUNNABLE;
-        _blocker_object = NULL;
-      } else if (owner != NULL) {
-        _blocker_object_owner = owner->threadObj();
-      }
     }
   }
 
@@ -917,11 +1079,44 @@ ThreadSnapshot::~ThreadSnapshot() {
   delete _concurrent_locks;
 }
 
+void ThreadSnapshot::resolve_blocker_owner(ThreadsList * t_list) {
+  if (_blocker_object == NULL ||
+      (_thread_status != java_lang_Thread::BLOCKED_ON_MONITOR_ENTER &&
+       _thread_status != java_lang_Thread::IN_OBJECT_WAIT &&
+       _thread_status != java_lang_Thread::IN_OBJECT_WAIT_TIMED)) {
+    return;
+  }
+
+  // Revoking a bias may safepoint when not at a safepoint.
+  Handle obj(Thread::current(), _blocker_object);
+  JavaThread* owner = ObjectSynchronizer::get_lock_owner(t_list, obj);
+  if ((owner == NULL && _thread_status == java_lang_Thread::BLOCKED_ON_MONITOR_ENTER)
+      || (owner != NULL && owner->is_attaching_via_jni())) {
+    // ownership information of the monitor is not available
+    // (may no longer be owned or releasing to some other thread)
+    // make this thread in RUNNABLE state.
+    // And when the owner thread is in attaching state, the java thread
+    // is not completely initialized. For example thread name and id
+    // and may not be set, so hide the attaching thread.
+    _thread_status = java_lang_Thread::RUNNABLE;
+    _blocker_object = NULL;
+  } else if (owner != NULL) {
+    _blocker_object_owner = owner->threadObj();
+  }
+}
+
 void ThreadSnapshot::dump_stack_at_safepoint(int max_depth, bool with_locked_monitors) {
   _stack_trace = new ThreadStackTrace(_thread, with_locked_monitors);
   _stack_trace->dump_stack_at_safepoint(max_depth);
 }
 
+void ThreadSnapshot::initialize_in_handshake(int max_depth, bool with_locked_monitors) {
+  assert(_pending, "snapshot already taken");
+  initialize_state();
+  dump_stack_at_safepoint(max_depth, with_locked_monitors);
+  _pending = false;
+}
+
 
 void ThreadSnapshot::oops_do(OopClosure* f) {
   f->do_oop(&_threadObj);
@@ -118,6 +118,18 @@ public:
   static Handle dump_stack_traces(GrowableArray<instanceHandle>* threads,
                                   int num_threads, TRAPS);
 
+  // Takes the thread snapshots for a thread dump, of all live threads if
+  // threads is NULL. With ThreadDumpWithHandshakes the state and stack of
+  // each thread are taken in a handshake with the thread, so the threads
+  // are not stopped all at once and the snapshots are not taken at the
+  // same instant. Only the locked synchronizers need a safepoint.
+  static void   dump_threads(ThreadDumpResult* result,
+                             GrowableArray<instanceHandle>* threads,
+                             int num_threads,
+                             int max_depth,
+                             bool with_locked_monitors,
+                             bool with_locked_synchronizers);
+
   static void   reset_peak_thread_count();
   static void   reset_contention_count_stat(JavaThread* thread);
   static void   reset_contention_time_stat(JavaThread* thread);
@@ -224,12 +236,16 @@ private:
   ThreadConcurrentLocks* _concurrent_locks;
   ThreadSnapshot*        _next;
 
+  // True until the handshake with _thread has taken the snapshot.
+  bool                   _pending;
+
   // ThreadSnapshot instances should only be created via
   // ThreadDumpResult::add_thread_snapshot.
   friend class ThreadDumpResult;
   ThreadSnapshot() : _thread(NULL), _threadObj(NULL), _stack_trace(NULL), _concurrent_locks(NULL), _next(NULL),
-                     _blocker_object(NULL), _blocker_object_owner(NULL) {};
+                     _blocker_object(NULL), _blocker_object_owner(NULL), _pending(false) {};
   void        initialize(ThreadsList * t_list, JavaThread* thread);
+  void        initialize_state();
 
 public:
   ~ThreadSnapshot();
@@ -255,10 +271,18 @@ public:
   oop         blocker_object_owner()      { return _blocker_object_owner; }
 
   ThreadSnapshot*   next() const          { return _next; }
+  JavaThread*       thread() const        { return _thread; }
+  bool              is_pending() const    { return _pending; }
   ThreadStackTrace* get_stack_trace()     { return _stack_trace; }
   ThreadConcurrentLocks* get_concurrent_locks()     { return _concurrent_locks; }
 
   void        dump_stack_at_safepoint(int max_depth, bool with_locked_monitors);
+
+  // Takes a pending snapshot, in a handshake with the thread. The owner of
+  // the monitor the thread is blocked on is looked up afterwards, by the
+  // thread requesting the dump, with resolve_blocker_owner.
+  void        initialize_in_handshake(int max_depth, bool with_locked_monitors);
+  void        resolve_blocker_owner(ThreadsList * t_list);
   void        set_concurrent_locks(ThreadConcurrentLocks* l) { _concurrent_locks = l; }
   void        oops_do(OopClosure* f);
   void        metadata_do(void f(Metadata*));
@@ -389,6 +413,11 @@ class ThreadDumpResult : public StackObj {
 
   ThreadSnapshot*      add_thread_snapshot();
   ThreadSnapshot*      add_thread_snapshot(JavaThread* thread);
+  ThreadSnapshot*      add_pending_thread_snapshot(JavaThread* thread);
+
+  // Removes the snapshots of threads that exited before their handshake,
+  // or turns them into empty snapshots if keep_empty is true.
+  void                 remove_pending_thread_snapshots(bool keep_empty);
 
   void                 set_next(ThreadDumpResult* next) { _next = next; }
   ThreadDumpResult*    next()                           { return _next; }
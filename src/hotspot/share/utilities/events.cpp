@@ -64,10 +64,10 @@ void Events::print() {
 
 void Events::init() {
   if (LogEvents) {
-    _messages = new StringEventLog("Events");
-    _exceptions = new ExtendedStringEventLog("Internal exceptions");
-    _redefinitions = new StringEventLog("Classes redefined");
-    _deopt_messages = new StringEventLog("Deoptimization events");
+    _messages = new StringEventLog("Events", LogEventsBufferEntries, LogEventsBufferShards);
+    _exceptions = new ExtendedStringEventLog("Internal exceptions", LogEventsBufferEntries, LogEventsBufferShards);
+    _redefinitions = new StringEventLog("Classes redefined", LogEventsBufferEntries, LogEventsBufferShards);
+    _deopt_messages = new StringEventLog("Deoptimization events", LogEventsBufferEntries, LogEventsBufferShards);
   }
 }
 
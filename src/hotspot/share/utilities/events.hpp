@@ -26,9 +26,14 @@
 #define SHARE_VM_UTILITIES_EVENTS_HPP
 
 #include "memory/allocation.hpp"
+#include "memory/padded.hpp"
+#include "runtime/atomic.hpp"
 #include "runtime/mutexLocker.hpp"
+#include "runtime/orderAccess.hpp"
 #include "runtime/thread.hpp"
 #include "utilities/formatBuffer.hpp"
+#include "utilities/ostream.hpp"
+#include "utilities/spinYield.hpp"
 #include "utilities/vmError.hpp"
 
 // Events and EventMark provide interfaces to log events taking place in the vm.
@@ -54,6 +59,15 @@ class EventLog : public CHeapObj<mtInternal> {
 
   EventLog* next() const { return _next; }
 
+ protected:
+  // Prints at most size characters of s. A record can be overwritten
+  // while it is printed, so its text is not necessarily terminated.
+  static void print_raw_bounded(outputStream* out, const char* s, size_t size) {
+    size_t len = 0;
+    while (len < size && s[len] != '\0') len++;
+    out->print_raw(s, (int)len);
+  }
+
  public:
   // Automatically registers the log so that it will be printed during
   // crashes.
@@ -68,45 +82,100 @@ class EventLog : public CHeapObj<mtInternal> {
 // providing a more featureful log function if the existing copy
 // semantics aren't appropriate.  The name is used as the label of the
 // log when it is dumped during a crash.
+//
+// The ring buffer is lock-free. A writer takes a ticket, which selects
+// the slot, and marks the slot as being written with its sequence
+// number. Printing does not block writers; it skips the records that
+// are incomplete or have been overwritten while printing, seqlock style.
+// The log can be split into shards, each a ring buffer of its own that
+// a subset of the threads logs to, so that threads logging at a high
+// rate do not contend on a single ticket counter.
 template <class T> class EventLogBase : public EventLog {
-  template <class X> class EventRecord : public CHeapObj<mtInternal> {
+ protected:
+  // The sequence number of a record is odd while the event with ticket
+  // t is written into it, and 2 * t + 2 once the event is complete.
+  class EventRecord : public CHeapObj<mtInternal> {
    public:
+    volatile uintx seq;
     double  timestamp;
     Thread* thread;
-    X       data;
+    T       data;
+
+    EventRecord() : seq(0), timestamp(0.0), thread(NULL) {}
   };
 
- protected:
-  Mutex           _mutex;
-  const char*     _name;
-  int             _length;
-  int             _index;
-  int             _count;
-  EventRecord<T>* _records;
+ private:
+  class Shard : public CHeapObj<mtInternal> {
+   public:
+    volatile uintx _next_ticket;
+    EventRecord*   _records;
+  };
+
+  // Printing keeps a cursor per shard on the stack.
+  enum { max_shards = 64 };
+
+  const char*       _name;
+  int               _length;
+  uint              _num_shards;
+  PaddedEnd<Shard>* _shards;
+
+  static uintx writing_seq(uintx ticket)  { return 2 * ticket + 1; }
+  static uintx complete_seq(uintx ticket) { return 2 * ticket + 2; }
+
+  EventRecord* record_at(const Shard* shard, uintx ticket) const {
+    return &shard->_records[ticket % (uintx)_length];
+  }
+
+  Shard* shard_for_current_thread() {
+    if (_num_shards == 1) {
+      return &_shards[0];
+    }
+    return &_shards[Thread::current_hash() % _num_shards];
+  }
 
  public:
-  EventLogBase<T>(const char* name, int length = LogEventsBufferEntries):
+  EventLogBase<T>(const char* name, int length = LogEventsBufferEntries, uint num_shards = 1):
     _name(name),
     _length(length),
-    _count(0),
-    _index(0),
-    _mutex(Mutex::event, name, false, Monitor::_safepoint_check_never) {
-    _records = new EventRecord<T>[length];
+    _num_shards(num_shards) {
+    assert(num_shards >= 1 && num_shards <= max_shards, "invalid number of shards: %u", num_shards);
+    _shards = new PaddedEnd<Shard>[num_shards];
+    for (uint i = 0; i < num_shards; i++) {
+      _shards[i]._next_ticket = 0;
+      _shards[i]._records = new EventRecord[length];
+    }
   }
 
   double fetch_timestamp() {
     return os::elapsedTime();
   }
 
-  // move the ring buffer to next open slot and return the index of
-  // the slot to use for the current message.  Should only be called
-  // while mutex is held.
-  int compute_log_index() {
-    int index = _index;
-    if (_count < _length) _count++;
-    _index++;
-    if (_index >= _length) _index = 0;
-    return index;
+  // Claims the slot for the next event of the shard of the current thread
+  // and returns its record, to be filled in and published with end_log().
+  // Returns NULL, dropping the event, if the slot has been claimed by a
+  // newer event in the meantime.
+  EventRecord* begin_log() {
+    Shard* shard = shard_for_current_thread();
+    uintx ticket = Atomic::add((uintx)1, &shard->_next_ticket) - 1;
+    EventRecord* r = record_at(shard, ticket);
+    uintx writing = writing_seq(ticket);
+    SpinYield yield;
+    while (true) {
+      uintx seq = OrderAccess::load_acquire(&r->seq);
+      // Compared as a difference, tickets may wrap around.
+      if ((intx)(seq - writing) >= 0) {
+        return NULL;
+      }
+      if ((seq & 1) == 0 && Atomic::cmpxchg(writing, &r->seq, seq) == seq) {
+        return r;
+      }
+      // An older event is still being written into the slot.
+      yield.wait();
+    }
+  }
+
+  void end_log(EventRecord* r) {
+    OrderAccess::release_store(&r->seq, r->seq + 1);
   }
 
   bool should_log() {
@@ -119,13 +188,14 @@ template <class T> class EventLogBase : public EventLog {
   void print_log_on(outputStream* out);
 
  private:
-  void print_log_impl(outputStream* out);
+  bool read_timestamp(const Shard* shard, uintx ticket, double* timestamp);
+  void print_record(outputStream* out, const Shard* shard, uintx ticket);
 
   // Print a single element.  A templated implementation might need to
   // be declared by subclasses.
   void print(outputStream* out, T& e);
 
-  void print(outputStream* out, EventRecord<T>& e) {
+  void print(outputStream* out, EventRecord& e) {
     out->print("Event: %.3f ", e.timestamp);
     if (e.thread != NULL) {
       out->print("Thread " INTPTR_FORMAT " ", p2i(e.thread));
@@ -145,17 +215,21 @@ typedef FormatStringLogMessage<512> ExtendedStringLogMessage;
 template <size_t bufsz>
 class FormatStringEventLog : public EventLogBase< FormatStringLogMessage<bufsz> > {
  public:
-  FormatStringEventLog(const char* name, int count = LogEventsBufferEntries) : EventLogBase< FormatStringLogMessage<bufsz> >(name, count) {}
+  typedef typename EventLogBase< FormatStringLogMessage<bufsz> >::EventRecord EventRecord;
+
+  FormatStringEventLog(const char* name, int count = LogEventsBufferEntries, uint num_shards = 1) :
+    EventLogBase< FormatStringLogMessage<bufsz> >(name, count, num_shards) {}
 
   void logv(Thread* thread, const char* format, va_list ap) ATTRIBUTE_PRINTF(3, 0) {
     if (!this->should_log()) return;
 
     double timestamp = this->fetch_timestamp();
-    MutexLockerEx ml(&this->_mutex, Mutex::_no_safepoint_check_flag);
-    int index = this->compute_log_index();
-    this->_records[index].thread = thread;
-    this->_records[index].timestamp = timestamp;
-    this->_records[index].data.printv(format, ap);
+    EventRecord* r = this->begin_log();
+    if (r == NULL) return;
+    r->thread = thread;
+    r->timestamp = timestamp;
+    r->data.printv(format, ap);
+    this->end_log(r);
   }
 
   void log(Thread* thread, const char* format, ...) ATTRIBUTE_PRINTF(3, 4) {
@@ -247,53 +321,90 @@ inline void Events::log_deopt_message(Thread* thread, const char* format, ...) {
 }
 
 
+// Dump the events of all shards, merged by timestamp. Does not block,
+// so that the log can be printed while crashing.
 template <class T>
 inline void EventLogBase<T>::print_log_on(outputStream* out) {
-  if (Thread::current_or_null() == NULL) {
-    // Not yet attached? Don't try to use locking
-    print_log_impl(out);
-  } else {
-    MutexLockerEx ml(&_mutex, Mutex::_no_safepoint_check_flag);
-    print_log_impl(out);
+  uintx first[max_shards];
+  uintx end[max_shards];
+  int count = 0;
+  for (uint i = 0; i < _num_shards; i++) {
+    end[i] = OrderAccess::load_acquire(&_shards[i]._next_ticket);
+    first[i] = end[i] - MIN2(end[i], (uintx)_length);
+    count += (int)(end[i] - first[i]);
   }
-}
 
-// Dump the ring buffer entries that current have entries.
-template <class T>
-inline void EventLogBase<T>::print_log_impl(outputStream* out) {
-  out->print_cr("%s (%d events):", _name, _count);
-  if (_count == 0) {
+  out->print_cr("%s (%d events):", _name, count);
+  if (count == 0) {
     out->print_cr("No events");
     out->cr();
     return;
   }
 
-  if (_count < _length) {
-    for (int i = 0; i < _count; i++) {
-      print(out, _records[i]);
+  while (true) {
+    int next = -1;
+    double next_timestamp = 0.0;
+    for (uint i = 0; i < _num_shards; i++) {
+      double timestamp = 0.0;
+      // Skip the records that are overwritten or still being written.
+      while (first[i] < end[i] && !read_timestamp(&_shards[i], first[i], &timestamp)) {
+        first[i]++;
+      }
+      if (first[i] < end[i] && (next == -1 || timestamp < next_timestamp)) {
+        next = (int)i;
+        next_timestamp = timestamp;
+      }
     }
-  } else {
-    for (int i = _index; i < _length; i++) {
-      print(out, _records[i]);
-    }
-    for (int i = 0; i < _index; i++) {
-      print(out, _records[i]);
+    if (next == -1) {
+      break;
     }
+    print_record(out, &_shards[next], first[next]);
+    first[next]++;
   }
   out->cr();
 }
 
+template <class T>
+inline bool EventLogBase<T>::read_timestamp(const Shard* shard, uintx ticket, double* timestamp) {
+  EventRecord* r = record_at(shard, ticket);
+  uintx seq = complete_seq(ticket);
+  if (OrderAccess::load_acquire(&r->seq) != seq) {
+    return false;
+  }
+  *timestamp = r->timestamp;
+  OrderAccess::loadload();
+  return Atomic::load(&r->seq) == seq;
+}
+
+// The record is printed into a local buffer first, which is only
+// copied to the output if the record has not changed meanwhile.
+template <class T>
+inline void EventLogBase<T>::print_record(outputStream* out, const Shard* shard, uintx ticket) {
+  EventRecord* r = record_at(shard, ticket);
+  uintx seq = complete_seq(ticket);
+  if (OrderAccess::load_acquire(&r->seq) != seq) {
+    return;
+  }
+  char buf[sizeof(T) + 128];
+  stringStream st(buf, sizeof(buf));
+  print(&st, *r);
+  OrderAccess::loadload();
+  if (Atomic::load(&r->seq) == seq) {
+    out->print_raw(st.base(), (int)st.size());
+  }
+}
+
 // Implement a printing routine for the StringLogMessage
 template <>
 inline void EventLogBase<StringLogMessage>::print(outputStream* out, StringLogMessage& lm) {
-  out->print_raw(lm);
+  print_raw_bounded(out, lm.buffer(), lm.size());
   out->cr();
 }
 
 // Implement a printing routine for the ExtendedStringLogMessage
 template <>
 inline void EventLogBase<ExtendedStringLogMessage>::print(outputStream* out, ExtendedStringLogMessage& lm) {
-  out->print_raw(lm);
+  print_raw_bounded(out, lm.buffer(), lm.size());
   out->cr();
 }
 
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "jfr/recorder/stacktrace/jfrStackTrace.hpp"
+#include "jfr/recorder/stacktrace/jfrStackTraceRepository.hpp"
+#include "logging/log.hpp"
+#include "memory/allocation.inline.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/os.hpp"
+#include "unittest.hpp"
+#include "../utilities/utilitiesHelper.inline.hpp"
+
+static const u4 NUMBER_OF_TRACES = 16 * K;
+static const u4 FRAMES_PER_TRACE = 8;
+static const int NUMBER_OF_ADDERS = 4;
+
+class JfrStackTraceRepositoryTest : public AllStatic {
+ public:
+  static JfrStackTraceRepository* create() {
+    return new JfrStackTraceRepository();
+  }
+
+  static void destroy(JfrStackTraceRepository* repo) {
+    delete repo;
+  }
+
+  // Synthetic trace number n; frames only need ids, bcis and types to be compared.
+  static traceid add(JfrStackTraceRepository* repo, u4 n) {
+    JfrStackFrame* const frames = NEW_C_HEAP_ARRAY(JfrStackFrame, FRAMES_PER_TRACE, mtTracing);
+    unsigned int hash = 1;
+    for (u4 i = 0; i < FRAMES_PER_TRACE; ++i) {
+      const traceid method_id = (traceid)(n * FRAMES_PER_TRACE + i);
+      frames[i] = JfrStackFrame(method_id, (int)i, JfrStackFrame::FRAME_JIT, (int)i);
+      hash = (hash << 2) + (unsigned int)(method_id + (i << 4) + JfrStackFrame::FRAME_JIT);
+    }
+    JfrStackTrace stacktrace(frames, FRAMES_PER_TRACE);
+    stacktrace.set_nr_of_frames(FRAMES_PER_TRACE);
+    stacktrace.set_hash(hash);
+    stacktrace.set_reached_root(true);
+    stacktrace._lineno = true;
+    const traceid id = repo->add_trace(stacktrace);
+    FREE_C_HEAP_ARRAY(JfrStackFrame, frames);
+    return id;
+  }
+
+  static u4 entries(JfrStackTraceRepository* repo) {
+    return repo->entries();
+  }
+
+  static void grow(JfrStackTraceRepository* repo) {
+    MutexLockerEx lock(JfrStacktrace_lock, Mutex::_no_safepoint_check_flag);
+    repo->grow_if_needed();
+  }
+};
+
+// Adds all traces, starting at a different trace in each thread,
+// so that the threads race on inserting the same traces.
+class StackTraceAdderThread : public JavaTestThread {
+ public:
+  JfrStackTraceRepository* _repo;
+  u4 _start;
+  traceid* _ids;
+
+  StackTraceAdderThread(JfrStackTraceRepository* repo, u4 start, Semaphore* post)
+    : JavaTestThread(post), _repo(repo), _start(start),
+      _ids(NEW_C_HEAP_ARRAY(traceid, NUMBER_OF_TRACES, mtTracing)) {}
+
+  virtual ~StackTraceAdderThread() {}
+
+  void main_run() {
+    const jlong start = os::javaTimeNanos();
+    for (u4 i = 0; i < NUMBER_OF_TRACES; ++i) {
+      const u4 n = (_start + i) % NUMBER_OF_TRACES;
+      _ids[n] = JfrStackTraceRepositoryTest::add(_repo, n);
+    }
+    const jlong nanos = os::javaTimeNanos() - start;
+    log_info(jfr)("Added %u stack traces concurrently: " JLONG_FORMAT " ns/trace", NUMBER_OF_TRACES, nanos / NUMBER_OF_TRACES);
+  }
+};
+
+class StackTraceRunnerThread : public JavaTestThread {
+ public:
+  StackTraceRunnerThread(Semaphore* post) : JavaTestThread(post) {}
+  virtual ~StackTraceRunnerThread() {}
+
+  void main_run() {
+    JfrStackTraceRepository* const repo = JfrStackTraceRepositoryTest::create();
+    Semaphore done;
+    StackTraceAdderThread* adders[NUMBER_OF_ADDERS];
+    traceid* ids[NUMBER_OF_ADDERS];
+    for (int i = 0; i < NUMBER_OF_ADDERS; ++i) {
+      adders[i] = new StackTraceAdderThread(repo, i * (NUMBER_OF_TRACES / NUMBER_OF_ADDERS), &done);
+      ids[i] = adders[i]->_ids;
+    }
+    for (int i = 0; i < NUMBER_OF_ADDERS; ++i) {
+      adders[i]->doit();
+    }
+    for (int i = 0; i < NUMBER_OF_ADDERS; ++i) {
+      done.wait();
+    }
+    // The adder threads delete themselves when done, the id arrays are ours.
+
+    EXPECT_EQ(NUMBER_OF_TRACES, JfrStackTraceRepositoryTest::entries(repo)) << "Each trace should be added once";
+    for (u4 n = 0; n < NUMBER_OF_TRACES; ++n) {
+      EXPECT_NE((traceid)0, ids[0][n]);
+      for (int i = 1; i < NUMBER_OF_ADDERS; ++i) {
+        ASSERT_EQ(ids[0][n], ids[i][n]) << "Threads should get the same id for the same trace";
+      }
+    }
+
+    // The table is too loaded for its initial size, the grown table keeps the ids.
+    JfrStackTraceRepositoryTest::grow(repo);
+    EXPECT_EQ(NUMBER_OF_TRACES, JfrStackTraceRepositoryTest::entries(repo));
+    for (u4 n = 0; n < NUMBER_OF_TRACES; ++n) {
+      ASSERT_EQ(ids[0][n], JfrStackTraceRepositoryTest::add(repo, n)) << "Growing should keep ids";
+    }
+
+    for (int i = 0; i < NUMBER_OF_ADDERS; ++i) {
+      FREE_C_HEAP_ARRAY(traceid, ids[i]);
+    }
+    JfrStackTraceRepositoryTest::destroy(repo);
+  }
+};
+
+TEST_VM(JfrStackTraceRepository, concurrent_add) {
+  mt_test_doer<StackTraceRunnerThread>();
+}
+
+// Insertion throughput of a single thread, for comparing with the concurrent case above.
+class StackTraceThroughputThread : public JavaTestThread {
+ public:
+  StackTraceThroughputThread(Semaphore* post) : JavaTestThread(post) {}
+  virtual ~StackTraceThroughputThread() {}
+
+  void main_run() {
+    JfrStackTraceRepository* const repo = JfrStackTraceRepositoryTest::create();
+    for (int round = 0; round < 2; ++round) {
+      // First round inserts, second round finds existing traces.
+      const jlong start = os::javaTimeNanos();
+      for (u4 n = 0; n < NUMBER_OF_TRACES; ++n) {
+        EXPECT_NE((traceid)0, JfrStackTraceRepositoryTest::add(repo, n));
+      }
+      const jlong nanos = os::javaTimeNanos() - start;
+      log_info(jfr)("%s %u stack traces: " JLONG_FORMAT " ns/trace",
+                    round == 0 ? "Inserted" : "Looked up", NUMBER_OF_TRACES, nanos / NUMBER_OF_TRACES);
+    }
+    JfrStackTraceRepositoryTest::destroy(repo);
+  }
+};
+
+TEST_VM(JfrStackTraceRepository, throughput) {
+  mt_test_doer<StackTraceThroughputThread>();
+}
@@ -52,6 +52,25 @@ TEST_VM(LogDecorations, level) {
   }
 }
 
+TEST_VM(LogDecorations, copy) {
+  LogDecorations decorations(LogLevel::Info, tagset, default_decorators);
+  LogDecorations copy(decorations);
+  for (uint i = 0; i < LogDecorators::Count; i++) {
+    LogDecorators::Decorator decorator = static_cast<LogDecorators::Decorator>(i);
+    const char* original = decorations.decoration(decorator);
+    const char* copied = copy.decoration(decorator);
+    if (original == NULL) {
+      EXPECT_TRUE(copied == NULL);
+    } else {
+      EXPECT_STREQ(original, copied);
+    }
+  }
+  // The copy must not refer to the buffer of the original decorations
+  const char* uptime = copy.decoration(LogDecorators::uptime_decorator);
+  EXPECT_TRUE(uptime < (const char*)&decorations || uptime >= (const char*)(&decorations + 1))
+      << "Copied decoration points into the original decorations";
+}
+
 TEST_VM(LogDecorations, uptime) {
   // Verify the format of the decoration
   int a, b;
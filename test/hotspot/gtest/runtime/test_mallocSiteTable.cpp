@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+
+// Included early because the NMT flags don't include it.
+#include "utilities/macros.hpp"
+
+#if INCLUDE_NMT
+
+#include "memory/allocation.inline.hpp"
+#include "runtime/orderAccess.hpp"
+#include "services/mallocSiteTable.hpp"
+#include "services/mallocTracker.hpp"
+#include "services/memTracker.hpp"
+#include "utilities/nativeCallStack.hpp"
+#include "unittest.hpp"
+
+// Made up call stacks, each test uses its own tag to keep them apart.
+static NativeCallStack test_stack(size_t i, uintptr_t tag) {
+  address pc[2];
+  pc[0] = (address)(tag + i * BytesPerWord);
+  pc[1] = (address)tag;
+  return NativeCallStack(pc, 2);
+}
+
+class MallocSiteTableTest {
+ private:
+  // The table is only initialized with detail tracking.
+  static void ensure_initialized() {
+    if (OrderAccess::load_acquire(&MallocSiteTable::_num_generations) == 0) {
+      MallocSiteTable::initialize();
+    }
+  }
+
+  static int generations() {
+    return OrderAccess::load_acquire(&MallocSiteTable::_num_generations);
+  }
+
+  static MallocSite* lookup_or_add(const NativeCallStack& stack, size_t* bucket_idx, size_t* pos_idx) {
+    return MallocSiteTable::lookup_or_add(stack, bucket_idx, pos_idx, mtTest);
+  }
+
+  struct Entry {
+    MallocSite* _site;
+    size_t      _bucket_idx;
+    size_t      _pos_idx;
+  };
+
+  // Adds call stacks until the table has grown, then as many again into the
+  // new generation. Returns the number of entries, 0 if the table can not grow.
+  static size_t fill_until_growth(uintptr_t tag, Entry* entries, size_t max_entries) {
+    const int gens = generations();
+    if (gens == MallocSiteTable::max_generations) {
+      return 0;
+    }
+    size_t n = 0;
+    while (generations() == gens && n < max_entries / 2) {
+      Entry* e = &entries[n];
+      e->_site = lookup_or_add(test_stack(n, tag), &e->_bucket_idx, &e->_pos_idx);
+      EXPECT_TRUE(e->_site != NULL);
+      n++;
+    }
+    EXPECT_GT(generations(), gens) << "table did not grow after " << n << " entries";
+    const size_t before_growth = n;
+    for (size_t i = 0; i < before_growth; i++, n++) {
+      Entry* e = &entries[n];
+      e->_site = lookup_or_add(test_stack(n, tag), &e->_bucket_idx, &e->_pos_idx);
+      EXPECT_TRUE(e->_site != NULL);
+    }
+    return n;
+  }
+
+  static const size_t max_entries = 1 << 18;
+
+ public:
+  static void test_lookup_across_generations() {
+    ensure_initialized();
+    const uintptr_t tag = 0x10000000;
+    Entry* entries = NEW_C_HEAP_ARRAY(Entry, max_entries, mtTest);
+    const size_t n = fill_until_growth(tag, entries, max_entries);
+    for (size_t i = 0; i < n; i++) {
+      size_t bucket_idx;
+      size_t pos_idx;
+      MallocSite* site = lookup_or_add(test_stack(i, tag), &bucket_idx, &pos_idx);
+      // Found where it was added, also in an older generation
+      EXPECT_EQ(entries[i]._site, site) << "entry " << i;
+      EXPECT_EQ(entries[i]._bucket_idx, bucket_idx) << "entry " << i;
+      EXPECT_EQ(entries[i]._pos_idx, pos_idx) << "entry " << i;
+    }
+    FREE_C_HEAP_ARRAY(Entry, entries);
+  }
+
+  static void test_index_round_trip() {
+    ensure_initialized();
+    const uintptr_t tag = 0x20000000;
+    Entry* entries = NEW_C_HEAP_ARRAY(Entry, max_entries, mtTest);
+    const size_t n = fill_until_growth(tag, entries, max_entries);
+    for (size_t i = 0; i < n; i++) {
+      const Entry* e = &entries[i];
+      EXPECT_LT(e->_bucket_idx, (size_t)MallocSiteTable::hash_buckets()) << "entry " << i;
+      EXPECT_EQ(e->_site, MallocSiteTable::malloc_site(e->_bucket_idx, e->_pos_idx)) << "entry " << i;
+      NativeCallStack stack;
+      EXPECT_TRUE(MallocSiteTable::access_stack(stack, e->_bucket_idx, e->_pos_idx));
+      EXPECT_TRUE(stack.equals(test_stack(i, tag))) << "entry " << i;
+    }
+    FREE_C_HEAP_ARRAY(Entry, entries);
+  }
+
+  static void test_no_malloc_site_header() {
+    if (MemTracker::tracking_level() == NMT_detail) {
+      // The sample interval can not be changed under other threads.
+      return;
+    }
+    ensure_initialized();
+    const uintptr_t tag = 0x30000000;
+    const size_t interval = 4;
+    MallocTracker::set_sample_interval(interval);
+
+    // Not sampled, the call stack was not captured
+    MallocHeader* unsampled = ::new (os::malloc(sizeof(MallocHeader), mtTest))
+      MallocHeader(16, mtTest, NativeCallStack::empty_stack(), NMT_detail);
+    EXPECT_EQ((size_t)NO_MALLOC_SITE, (size_t)unsampled->_bucket_idx);
+    EXPECT_EQ(0u, (unsigned)unsampled->_sampled);
+    NativeCallStack stack;
+    EXPECT_FALSE(unsampled->get_stack(stack));
+
+    // Sampled, recorded with the weight of the interval
+    const NativeCallStack sampled_stack = test_stack(0, tag);
+    MallocHeader* sampled = ::new (os::malloc(sizeof(MallocHeader), mtTest))
+      MallocHeader(16, mtTest, sampled_stack, NMT_detail);
+    EXPECT_NE((size_t)NO_MALLOC_SITE, (size_t)sampled->_bucket_idx);
+    EXPECT_EQ(1u, (unsigned)sampled->_sampled);
+    EXPECT_TRUE(sampled->get_stack(stack));
+    EXPECT_TRUE(stack.equals(sampled_stack));
+    MallocSite* site = MallocSiteTable::malloc_site(sampled->_bucket_idx, sampled->_pos_idx);
+    EXPECT_EQ(interval, site->count());
+    EXPECT_EQ(interval * 16, site->size());
+    // What release() does with detail tracking
+    EXPECT_TRUE(MallocSiteTable::deallocation_at(16, interval, sampled->_bucket_idx, sampled->_pos_idx));
+    EXPECT_EQ(0u, site->count());
+    EXPECT_EQ(0u, site->size());
+
+    unsampled->release();
+    sampled->release();
+    os::free(unsampled);
+    os::free(sampled);
+    MallocTracker::set_sample_interval(1);
+  }
+
+  static void test_weighted_allocation() {
+    ensure_initialized();
+    const uintptr_t tag = 0x40000000;
+    const NativeCallStack stack = test_stack(0, tag);
+    size_t bucket_idx;
+    size_t pos_idx;
+    ASSERT_TRUE(MallocSiteTable::allocation_at(stack, 16, 4, &bucket_idx, &pos_idx, mtTest));
+    MallocSite* site = MallocSiteTable::malloc_site(bucket_idx, pos_idx);
+    EXPECT_EQ(4u, site->count());
+    EXPECT_EQ(64u, site->size());
+
+    size_t bucket_idx2;
+    size_t pos_idx2;
+    ASSERT_TRUE(MallocSiteTable::allocation_at(stack, 32, 1, &bucket_idx2, &pos_idx2, mtTest));
+    EXPECT_EQ(bucket_idx, bucket_idx2);
+    EXPECT_EQ(pos_idx, pos_idx2);
+    EXPECT_EQ(5u, site->count());
+    EXPECT_EQ(96u, site->size());
+
+    EXPECT_TRUE(MallocSiteTable::deallocation_at(16, 4, bucket_idx, pos_idx));
+    EXPECT_EQ(1u, site->count());
+    EXPECT_EQ(32u, site->size());
+    EXPECT_TRUE(MallocSiteTable::deallocation_at(32, 1, bucket_idx, pos_idx));
+    EXPECT_EQ(0u, site->count());
+    EXPECT_EQ(0u, site->size());
+  }
+};
+
+TEST_VM(NMT_MallocSiteTable, lookup_across_generations) {
+  MallocSiteTableTest::test_lookup_across_generations();
+}
+
+TEST_VM(NMT_MallocSiteTable, index_round_trip) {
+  MallocSiteTableTest::test_index_round_trip();
+}
+
+TEST_VM(NMT_MallocSiteTable, no_malloc_site_header) {
+  MallocSiteTableTest::test_no_malloc_site_header();
+}
+
+TEST_VM(NMT_MallocSiteTable, weighted_allocation) {
+  MallocSiteTableTest::test_weighted_allocation();
+}
+
+#endif // INCLUDE_NMT
@@ -22,8 +22,12 @@
  */
 
 #include "precompiled.hpp"
+#include "logging/log.hpp"
+#include "runtime/os.hpp"
+#include "runtime/perfData.inline.hpp"
 #include "runtime/perfMemory.hpp"
 #include "unittest.hpp"
+#include "../utilities/utilitiesHelper.inline.hpp"
 
 class PerfMemoryTest : public ::testing::Test {
   public:
@@ -31,6 +35,88 @@ class PerfMemoryTest : public ::testing::Test {
     static PerfDataPrologue* prologue() { return PerfMemory::_prologue; }
 };
 
+static const jlong INCREMENTS_PER_THREAD = 4 * M;
+static const int NUMBER_OF_INCREMENTERS = 8;
+
+// Increments a plain or a striped counter, started all at once.
+class PerfCounterIncrementerThread : public JavaTestThread {
+ public:
+  PerfCounter* _plain;
+  PerfStripedCounter* _striped;
+  Semaphore* _start;
+
+  PerfCounterIncrementerThread(PerfCounter* plain, PerfStripedCounter* striped,
+                               Semaphore* start, Semaphore* post)
+    : JavaTestThread(post), _plain(plain), _striped(striped), _start(start) {}
+
+  virtual ~PerfCounterIncrementerThread() {}
+
+  void main_run() {
+    _start->wait();
+    if (_plain != NULL) {
+      for (jlong i = 0; i < INCREMENTS_PER_THREAD; i++) {
+        _plain->inc();
+      }
+    } else {
+      for (jlong i = 0; i < INCREMENTS_PER_THREAD; i++) {
+        _striped->inc();
+      }
+    }
+  }
+};
+
+// Returns the elapsed time of all threads incrementing the counter.
+static jlong run_incrementers(PerfCounter* plain, PerfStripedCounter* striped) {
+  Semaphore start;
+  Semaphore done;
+  for (int i = 0; i < NUMBER_OF_INCREMENTERS; i++) {
+    (new PerfCounterIncrementerThread(plain, striped, &start, &done))->doit();
+  }
+  const jlong begin = os::javaTimeNanos();
+  start.signal(NUMBER_OF_INCREMENTERS);
+  for (int i = 0; i < NUMBER_OF_INCREMENTERS; i++) {
+    done.wait();
+  }
+  return os::javaTimeNanos() - begin;
+}
+
+class PerfStripedCounterRunnerThread : public JavaTestThread {
+ public:
+  PerfStripedCounterRunnerThread(Semaphore* post) : JavaTestThread(post) {}
+  virtual ~PerfStripedCounterRunnerThread() {}
+
+  void main_run() {
+    // The counters are allocated in the PerfData memory, which is gone
+    // after PerfMemoryTest.destroy.
+    if (!UsePerfData || !PerfMemory::is_usable()) {
+      return;
+    }
+    Thread* THREAD = this;
+    PerfCounter* plain =
+      PerfDataManager::create_counter(SUN_RT, "gtest.plainCounter", PerfData::U_Events, THREAD);
+    PerfStripedCounter* striped =
+      PerfDataManager::create_striped_counter(SUN_RT, "gtest.stripedCounter", PerfData::U_Events, THREAD);
+    ASSERT_FALSE(HAS_PENDING_EXCEPTION);
+    ASSERT_TRUE(plain != NULL && striped != NULL);
+
+    const jlong plain_nanos = run_incrementers(plain, NULL);
+    const jlong striped_nanos = run_incrementers(NULL, striped);
+    const jlong total = NUMBER_OF_INCREMENTERS * INCREMENTS_PER_THREAD;
+    log_info(perf)("%d threads, " JLONG_FORMAT " increments: plain counter " JLONG_FORMAT " ns"
+                   " (value " JLONG_FORMAT "), striped counter with %u stripes " JLONG_FORMAT " ns",
+                   NUMBER_OF_INCREMENTERS, total, plain_nanos, plain->get_value(),
+                   striped->num_stripes(), striped_nanos);
+
+    // Unlike the plain counter, the striped counter does not lose increments.
+    EXPECT_EQ(total, striped->get_value()) << "Striped counter should count all increments";
+  }
+};
+
+// Runs before PerfMemoryTest.destroy, which is defined below.
+TEST_VM(PerfStripedCounter, concurrent_inc) {
+  mt_test_doer<PerfStripedCounterRunnerThread>();
+}
+
 TEST_VM_F(PerfMemoryTest, destroy) {
   PerfMemory::destroy();
 
@@ -40,4 +126,3 @@ TEST_VM_F(PerfMemoryTest, destroy) {
   ASSERT_NE(PerfMemoryTest::prologue(), (PerfDataPrologue*)NULL) << "PerfMemory::_prologue should not be NULL";
   ASSERT_NE(PerfMemory::capacity(), (size_t)0) << "PerfMemory::_capacity should not be 0";
 }
-
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+#include "precompiled.hpp"
+#include "memory/resourceArea.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/os.hpp"
+#include "utilities/events.hpp"
+#include "utilities/ostream.hpp"
+#include "utilitiesHelper.inline.hpp"
+
+static const int NUMBER_OF_WRITERS = 8;
+static const int EVENTS_PER_WRITER = 50000;
+static const int PAYLOAD_LENGTH = 100;
+
+// A small ring with several shards, so that writers wrap around it
+// and overwrite the records while they are printed. Never deleted,
+// since the log is registered for printing at crashes.
+static StringEventLog* _events_log = NULL;
+
+// Logs events of the form "<<writer:seq:payload>>writer:seq", where the
+// payload repeats a character derived from seq, so torn records are detected.
+class EventLogWriterThread : public JavaTestThread {
+ public:
+  StringEventLog* _log;
+  int _id;
+  volatile int* _running;
+  EventLogWriterThread(Semaphore* post, StringEventLog* log, int id, volatile int* running)
+    : JavaTestThread(post), _log(log), _id(id), _running(running) {}
+  virtual ~EventLogWriterThread() {}
+
+  void main_run() {
+    char payload[PAYLOAD_LENGTH + 1];
+    for (int seq = 0; seq < EVENTS_PER_WRITER; seq++) {
+      memset(payload, 'a' + seq % 26, PAYLOAD_LENGTH);
+      payload[PAYLOAD_LENGTH] = '\0';
+      _log->log(this, "<<%d:%d:%s>>%d:%d", _id, seq, payload, _id, seq);
+    }
+    Atomic::dec(_running);
+  }
+};
+
+// Checks one printed record. Returns its seq and sets its writer.
+static int check_record(const char* line, int* writer) {
+  const char* start = strstr(line, "<<");
+  EXPECT_TRUE(start != NULL) << "Unexpected record: " << line;
+  if (start == NULL) {
+    return -1;
+  }
+  int id = -1, seq = -1, end_id = -1, end_seq = -1;
+  char payload[PAYLOAD_LENGTH + 1] = "";
+  EXPECT_EQ(5, sscanf(start, "<<%d:%d:%100[a-z]>>%d:%d", &id, &seq, payload, &end_id, &end_seq))
+      << "Torn record: " << line;
+  EXPECT_EQ(id, end_id) << "Torn record: " << line;
+  EXPECT_EQ(seq, end_seq) << "Torn record: " << line;
+  EXPECT_EQ((size_t)PAYLOAD_LENGTH, strlen(payload)) << "Torn record: " << line;
+  for (int i = 0; i < PAYLOAD_LENGTH; i++) {
+    if (payload[i] != 'a' + seq % 26) {
+      ADD_FAILURE() << "Torn record: " << line;
+      break;
+    }
+  }
+  *writer = id;
+  return seq;
+}
+
+// Prints the log until all writers are done, and checks that no printed
+// record is torn or appears more than once.
+class EventLogPrinterThread : public JavaTestThread {
+ public:
+  EventLogPrinterThread(Semaphore* post) : JavaTestThread(post) {}
+  virtual ~EventLogPrinterThread() {}
+
+  void main_run() {
+    if (_events_log == NULL) {
+      _events_log = new StringEventLog("gtest events", 64, 4);
+    }
+    Semaphore post;
+    volatile int running = NUMBER_OF_WRITERS;
+    for (int i = 0; i < NUMBER_OF_WRITERS; i++) {
+      (new EventLogWriterThread(&post, _events_log, i, &running))->doit();
+    }
+
+    int prints = 0;
+    int records = 0;
+    do {
+      ResourceMark rm;
+      stringStream st;
+      _events_log->print_log_on(&st);
+      prints++;
+
+      // All events of a writer go to the same shard, in order.
+      int last_seq[NUMBER_OF_WRITERS];
+      for (int i = 0; i < NUMBER_OF_WRITERS; i++) {
+        last_seq[i] = -1;
+      }
+      char* line = st.as_string();
+      while (*line != '\0') {
+        char* eol = strchr(line, '\n');
+        char* next = eol != NULL ? eol + 1 : line + strlen(line);
+        if (eol != NULL) {
+          *eol = '\0';
+        }
+        // Skips the header and the "No events" line.
+        if (strncmp(line, "Event:", 6) == 0) {
+          int writer = -1;
+          int seq = check_record(line, &writer);
+          if (writer < 0 || writer >= NUMBER_OF_WRITERS) {
+            ADD_FAILURE() << "Unexpected record: " << line;
+          } else {
+            EXPECT_GT(seq, last_seq[writer]) << "Duplicate or reordered record: " << line;
+            last_seq[writer] = seq;
+            records++;
+          }
+        }
+        line = next;
+      }
+    } while (Atomic::load(&running) > 0);
+
+    // The writers refer to post and running on this stack.
+    for (int i = 0; i < NUMBER_OF_WRITERS; i++) {
+      post.wait();
+    }
+    EXPECT_GT(records, 0) << "No records printed in " << prints << " prints";
+  }
+};
+
+TEST_VM(EventLog, concurrent_log_and_print) {
+  mt_test_doer<EventLogPrinterThread>();
+}
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * @test
+ * @summary C1 compiles a generated method whose parameters live across
+ *          thousands of uses and calls, with the linear scan register
+ *          allocator verified in debug builds
+ * @requires vm.compiler1.enabled
+ * @library /test/lib /
+ * @modules java.base/jdk.internal.org.objectweb.asm
+ * @build sun.hotspot.WhiteBox
+ * @run driver ClassFileInstaller sun.hotspot.WhiteBox
+ *                                sun.hotspot.WhiteBox$WhiteBoxPermission
+ * @run main/othervm -Xbootclasspath/a:. -XX:+UnlockDiagnosticVMOptions -XX:+WhiteBoxAPI
+ *                   -XX:+TieredCompilation -XX:TieredStopAtLevel=1 -XX:-BackgroundCompilation
+ *                   -XX:-DontCompileHugeMethods -XX:+TimeLinearScan
+ *                   -XX:CompileCommand=quiet -XX:CompileCommand=dontinline,*::callee
+ *                   compiler.c1.TestLinearScanLongIntervals
+ * @run main/othervm -Xbootclasspath/a:. -XX:+UnlockDiagnosticVMOptions -XX:+WhiteBoxAPI
+ *                   -XX:+TieredCompilation -XX:TieredStopAtLevel=1 -XX:-BackgroundCompilation
+ *                   -XX:-DontCompileHugeMethods -XX:+IgnoreUnrecognizedVMOptions -XX:+StressLinearScan
+ *                   -XX:CompileCommand=quiet -XX:CompileCommand=dontinline,*::callee
+ *                   compiler.c1.TestLinearScanLongIntervals
+ */
+
+package compiler.c1;
+
+import java.lang.reflect.Method;
+
+import jdk.internal.org.objectweb.asm.ClassWriter;
+import jdk.internal.org.objectweb.asm.Label;
+import jdk.internal.org.objectweb.asm.MethodVisitor;
+import jdk.test.lib.Asserts;
+import sun.hotspot.WhiteBox;
+
+import static jdk.internal.org.objectweb.asm.Opcodes.*;
+
+public class TestLinearScanLongIntervals {
+    private static final WhiteBox WB = WhiteBox.getWhiteBox();
+    private static final int COMP_LEVEL_SIMPLE = 1;
+    private static final String CLASS_NAME = "compiler/c1/LongIntervals";
+    // Each block uses all four parameters and may call, so each parameter
+    // interval has about 4 * BLOCKS use positions and is split at the calls.
+    private static final int BLOCKS = 1000;
+    private static final int[][] INPUTS = {
+        { 0, 0, 0, 0 },
+        { 1, 2, 3, 4 },
+        { -7, 11, 13, -17 },
+        { Integer.MAX_VALUE, Integer.MIN_VALUE, 12345, -54321 },
+    };
+
+    public static int callee(int x) {
+        return Integer.rotateLeft(x, 7) ^ 0x5bd1e995;
+    }
+
+    public static void main(String[] args) throws Exception {
+        Class<?> c = new ClassLoader(TestLinearScanLongIntervals.class.getClassLoader()) {
+            Class<?> define(byte[] b) {
+                return defineClass(CLASS_NAME.replace('/', '.'), b, 0, b.length);
+            }
+        }.define(generate());
+        Method huge = c.getDeclaredMethod("huge", int.class, int.class, int.class, int.class);
+
+        int[] expected = new int[INPUTS.length];
+        for (int i = 0; i < INPUTS.length; i++) {
+            expected[i] = invoke(huge, INPUTS[i]);
+        }
+
+        WB.enqueueMethodForCompilation(huge, COMP_LEVEL_SIMPLE);
+        Asserts.assertEquals(WB.getMethodCompilationLevel(huge), COMP_LEVEL_SIMPLE, "huge was not compiled by C1");
+
+        for (int i = 0; i < INPUTS.length; i++) {
+            Asserts.assertEquals(invoke(huge, INPUTS[i]), expected[i], "wrong result for input " + i);
+        }
+    }
+
+    private static int invoke(Method m, int[] args) throws Exception {
+        return (Integer) m.invoke(null, args[0], args[1], args[2], args[3]);
+    }
+
+    // static int huge(int a, int b, int c, int d) {
+    //   int acc = 0;
+    //   // BLOCKS times:
+    //   acc = (acc * 31 + a) ^ b;
+    //   acc += c * d;
+    //   if (acc < 0) acc = TestLinearScanLongIntervals.callee(acc);
+    //   // end
+    //   return acc + a + b + c + d;
+    // }
+    private static byte[] generate() {
+        ClassWriter cw = new ClassWriter(ClassWriter.COMPUTE_MAXS | ClassWriter.COMPUTE_FRAMES);
+        cw.visit(V1_8, ACC_PUBLIC | ACC_SUPER, CLASS_NAME, null, "java/lang/Object", null);
+        MethodVisitor mv = cw.visitMethod(ACC_PUBLIC | ACC_STATIC, "huge", "(IIII)I", null, null);
+        mv.visitCode();
+        final int acc = 4;
+        mv.visitInsn(ICONST_0);
+        mv.visitVarInsn(ISTORE, acc);
+        for (int i = 0; i < BLOCKS; i++) {
+            mv.visitVarInsn(ILOAD, acc);
+            mv.visitIntInsn(BIPUSH, 31);
+            mv.visitInsn(IMUL);
+            mv.visitVarInsn(ILOAD, 0);
+            mv.visitInsn(IADD);
+            mv.visitVarInsn(ILOAD, 1);
+            mv.visitInsn(IXOR);
+            mv.visitVarInsn(ILOAD, 2);
+            mv.visitVarInsn(ILOAD, 3);
+            mv.visitInsn(IMUL);
+            mv.visitInsn(IADD);
+            mv.visitVarInsn(ISTORE, acc);
+            Label skip = new Label();
+            mv.visitVarInsn(ILOAD, acc);
+            mv.visitJumpInsn(IFGE, skip);
+            mv.visitVarInsn(ILOAD, acc);
+            mv.visitMethodInsn(INVOKESTATIC, "compiler/c1/TestLinearScanLongIntervals", "callee", "(I)I", false);
+            mv.visitVarInsn(ISTORE, acc);
+            mv.visitLabel(skip);
+        }
+        mv.visitVarInsn(ILOAD, acc);
+        for (int i = 0; i < 4; i++) {
+            mv.visitVarInsn(ILOAD, i);
+            mv.visitInsn(IADD);
+        }
+        mv.visitInsn(IRETURN);
+        mv.visitMaxs(0, 0);
+        mv.visitEnd();
+        cw.visitEnd();
+        return cw.toByteArray();
+    }
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * @test
+ * @summary Methods compiled at tier 4 with a high invocation rate are
+ *          allocated in the hot code heap
+ * @requires vm.compiler2.enabled & vm.flavor == "server" & !vm.emulatedClient
+ * @requires vm.opt.SegmentedCodeCache != false & vm.opt.TieredCompilation != false
+ * @library /test/lib
+ * @modules java.management
+ * @run driver compiler.codecache.TestHotCodeHeap
+ */
+
+package compiler.codecache;
+
+import java.lang.management.ManagementFactory;
+import java.lang.management.MemoryPoolMXBean;
+
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+public class TestHotCodeHeap {
+    private static final String HOT_HEAP = "CodeHeap 'hot nmethods'";
+
+    public static void main(String[] args) throws Exception {
+        if (args.length > 0) {
+            runHotLoop(Boolean.parseBoolean(args[0]));
+            return;
+        }
+        // Every tier 4 method is hot enough.
+        run("0", true);
+        // No method is hot enough.
+        run(String.valueOf(Integer.MAX_VALUE), false);
+
+        // Without a size, there is no hot code heap.
+        OutputAnalyzer out = ProcessTools.executeTestJvm(
+            "-XX:+SegmentedCodeCache", "-XX:+TieredCompilation",
+            "-XX:+PrintCodeCache", "-version");
+        out.shouldHaveExitValue(0);
+        out.shouldNotContain(HOT_HEAP);
+    }
+
+    private static void run(String minRate, boolean expectHotCode) throws Exception {
+        OutputAnalyzer out = ProcessTools.executeTestJvm(
+            "-XX:+SegmentedCodeCache",
+            "-XX:+TieredCompilation",
+            "-XX:+UnlockExperimentalVMOptions",
+            "-XX:HotCodeHeapSize=4m",
+            "-XX:HotCodeHeapMinRate=" + minRate,
+            "-Xbatch",
+            "-XX:+PrintCodeCache",
+            TestHotCodeHeap.class.getName(),
+            String.valueOf(expectHotCode));
+        out.shouldHaveExitValue(0);
+        out.shouldContain(HOT_HEAP);
+        out.shouldContain("hot heap used: ");
+    }
+
+    static int hot(int i) {
+        return (i & 3) == 0 ? i * 7 : i >>> 1;
+    }
+
+    private static long hotHeapUsed() {
+        for (MemoryPoolMXBean pool : ManagementFactory.getMemoryPoolMXBeans()) {
+            if (pool.getName().equals(HOT_HEAP)) {
+                return pool.getUsage().getUsed();
+            }
+        }
+        throw new RuntimeException("No memory pool for " + HOT_HEAP);
+    }
+
+    private static void runHotLoop(boolean expectHotCode) {
+        long before = hotHeapUsed();
+        int sum = 0;
+        for (int i = 0; i < 1_000_000; i++) {
+            sum += hot(i);
+        }
+        long after = hotHeapUsed();
+        System.out.println("sum = " + sum + ", hot heap used: " + before + " -> " + after);
+        if (expectHotCode && after <= before) {
+            throw new RuntimeException("The tier 4 code of hot() is not in the hot code heap");
+        }
+        if (!expectHotCode && after != 0) {
+            throw new RuntimeException("The hot code heap is used although no method is hot enough");
+        }
+    }
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * @test
+ * @summary With UseCodeCacheFlushing and a small code cache, the sweeper
+ *          flushes a cold method but not a method that is running all the time
+ * @requires vm.compiler2.enabled & vm.flavor == "server" & !vm.emulatedClient
+ * @library /test/lib /
+ * @build sun.hotspot.WhiteBox
+ * @run driver ClassFileInstaller sun.hotspot.WhiteBox
+ *                                sun.hotspot.WhiteBox$WhiteBoxPermission
+ * @run main/othervm -Xbootclasspath/a:. -XX:+UnlockDiagnosticVMOptions -XX:+WhiteBoxAPI
+ *                   -XX:-TieredCompilation -XX:-BackgroundCompilation
+ *                   -XX:+UseCodeCacheFlushing -XX:ReservedCodeCacheSize=8m -XX:-UseCodeAging
+ *                   -XX:CompileCommand=dontinline,compiler.codecache.TestHotMethodsNotFlushed::*
+ *                   compiler.codecache.TestHotMethodsNotFlushed
+ */
+
+package compiler.codecache;
+
+import java.lang.reflect.Method;
+
+import jdk.test.lib.Asserts;
+import sun.hotspot.WhiteBox;
+
+public class TestHotMethodsNotFlushed {
+    private static final WhiteBox WB = WhiteBox.getWhiteBox();
+    private static final int COMP_LEVEL_FULL_OPTIMIZATION = 4;
+    // With an 8M code cache, a method that is not seen on a stack is made
+    // not-entrant after about 25 sweeps.
+    private static final int SWEEPS = 100;
+
+    private static volatile boolean stop;
+    private static volatile long sink;
+
+    public static void main(String[] args) throws Exception {
+        Method hot = TestHotMethodsNotFlushed.class.getDeclaredMethod("hot", long.class);
+        Method cold = TestHotMethodsNotFlushed.class.getDeclaredMethod("cold", long.class);
+        sink = hot(1) + cold(1);
+        compile(hot);
+        compile(cold);
+
+        Thread runner = new Thread(() -> {
+            while (!stop) {
+                sink += hot(1_000_000);
+            }
+        });
+        runner.start();
+        try {
+            for (int i = 0; i < SWEEPS; i++) {
+                // The active nmethods get their hotness counters reset at
+                // safepoints and at the start of each sweep.
+                WB.forceSafepoint();
+                WB.forceNMethodSweep();
+            }
+            Asserts.assertFalse(WB.isMethodCompiled(cold), "cold method was not flushed");
+            Asserts.assertTrue(WB.isMethodCompiled(hot), "hot method was flushed");
+        } finally {
+            stop = true;
+            runner.join();
+        }
+    }
+
+    private static void compile(Method m) {
+        WB.enqueueMethodForCompilation(m, COMP_LEVEL_FULL_OPTIMIZATION);
+        Asserts.assertTrue(WB.isMethodCompiled(m), m + " is not compiled");
+    }
+
+    // The loop has a safepoint poll, so the thread is almost always in this
+    // method at a safepoint or handshake.
+    private static long hot(long n) {
+        long sum = 0;
+        for (long i = 0; i < n; i++) {
+            sum += i ^ (sum >>> 3);
+        }
+        return sum;
+    }
+
+    private static long cold(long n) {
+        return n * 31 + 7;
+    }
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * @test
+ * @summary With UseLargePagesInCodeCache, the code heaps are aligned and
+ *          sized to the code cache large page size, with and without
+ *          SegmentedCodeCache, and use small pages if there are no large pages
+ * @requires os.family == "linux" & vm.opt.UseLargePages != true
+ * @library /test/lib
+ * @run driver compiler.codecache.TestLargePagesInCodeCache
+ */
+
+package compiler.codecache;
+
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+import jdk.test.lib.Asserts;
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+public class TestLargePagesInCodeCache {
+    private static final Pattern LARGE_PAGE_SIZE =
+        Pattern.compile("Code cache large page size: (\\d+[BKMG])");
+    private static final Pattern NO_LARGE_PAGES =
+        Pattern.compile("Code cache large pages are not available, using (\\d+[BKMG]) pages");
+    private static final Pattern CODE_HEAP =
+        Pattern.compile("\\[pagesize *\\] (CodeHeap '[^']+'|CodeCache): +min=\\S+ max=\\S+ " +
+                        "base=0x([0-9a-fA-F]+) page_size=(\\d+[BKMG]) size=(\\d+[BKMG])");
+
+    public static void main(String[] args) throws Exception {
+        for (boolean segmented : new boolean[] { true, false }) {
+            // Large pages if the system provides them, small pages otherwise.
+            OutputAnalyzer output = run(segmented);
+            Matcher m = LARGE_PAGE_SIZE.matcher(output.getStdout());
+            if (m.find()) {
+                checkHeaps(output, segmented, parseSize(m.group(1)));
+            } else {
+                checkFallback(output, segmented);
+            }
+
+            // Without transparent huge pages there are no large pages for code.
+            checkFallback(run(segmented, "-XX:-UseTransparentHugePages"), segmented);
+        }
+    }
+
+    private static OutputAnalyzer run(boolean segmented, String... extraFlags) throws Exception {
+        List<String> flags = new ArrayList<>(Arrays.asList(
+            "-XX:+UseLargePagesInCodeCache",
+            "-XX:" + (segmented ? "+" : "-") + "SegmentedCodeCache",
+            "-XX:ReservedCodeCacheSize=64m",
+            "-Xlog:pagesize"));
+        flags.addAll(Arrays.asList(extraFlags));
+        flags.add("-version");
+        OutputAnalyzer output = ProcessTools.executeTestJvm(flags.toArray(new String[0]));
+        output.shouldHaveExitValue(0);
+        return output;
+    }
+
+    private static void checkFallback(OutputAnalyzer output, boolean segmented) {
+        output.shouldNotMatch(LARGE_PAGE_SIZE.pattern());
+        Matcher m = NO_LARGE_PAGES.matcher(output.getStdout());
+        Asserts.assertTrue(m.find(), "no code cache page size logged");
+        checkHeaps(output, segmented, parseSize(m.group(1)));
+    }
+
+    // Checks that every code heap uses the given page size, and that its
+    // start and its reserved size are multiples of that page size.
+    private static void checkHeaps(OutputAnalyzer output, boolean segmented, long pageSize) {
+        Matcher m = CODE_HEAP.matcher(output.getStdout());
+        List<String> heaps = new ArrayList<>();
+        while (m.find()) {
+            String name = m.group(1);
+            long base = Long.parseUnsignedLong(m.group(2), 16);
+            long heapPageSize = parseSize(m.group(3));
+            long size = parseSize(m.group(4));
+            Asserts.assertEquals(heapPageSize, pageSize, name + " page size");
+            Asserts.assertEquals(base % pageSize, 0L, name + " base is not aligned to " + pageSize);
+            Asserts.assertEquals(size % pageSize, 0L, name + " size is not a multiple of " + pageSize);
+            heaps.add(name);
+        }
+        if (segmented) {
+            Asserts.assertTrue(heaps.contains("CodeHeap 'non-nmethods'"), "no non-nmethod code heap: " + heaps);
+            Asserts.assertGreaterThanOrEqual(heaps.size(), 2, "code heaps: " + heaps);
+        } else {
+            Asserts.assertEquals(heaps, Arrays.asList("CodeCache"), "code heaps");
+        }
+    }
+
+    private static long parseSize(String s) {
+        long value = Long.parseLong(s.substring(0, s.length() - 1));
+        switch (s.charAt(s.length() - 1)) {
+        case 'G': value *= 1024; // fall through
+        case 'M': value *= 1024; // fall through
+        case 'K': value *= 1024; // fall through
+        case 'B': break;
+        }
+        return value;
+    }
+}
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * @test
+ * @summary Allocations merged by a Phi are scalar replaced with
+ *          -XX:+ReduceAllocationMerges, and the results are unchanged
+ * @requires vm.compiler2.enabled & vm.flavor == "server" & !vm.emulatedClient
+ * @library /test/lib /
+ * @modules java.management
+ *
+ * @build sun.hotspot.WhiteBox
+ * @run driver ClassFileInstaller sun.hotspot.WhiteBox
+ *                                sun.hotspot.WhiteBox$WhiteBoxPermission
+ * @run main/othervm -Xbootclasspath/a:. -XX:+UnlockDiagnosticVMOptions -XX:+WhiteBoxAPI
+ *                   -XX:-BackgroundCompilation -XX:-UseOnStackReplacement
+ *                   -XX:CompileCommand=dontinline,compiler.escapeAnalysis.TestReduceAllocationMerges::test*
+ *                   -XX:+ReduceAllocationMerges
+ *                   compiler.escapeAnalysis.TestReduceAllocationMerges true
+ * @run main/othervm -Xbootclasspath/a:. -XX:+UnlockDiagnosticVMOptions -XX:+WhiteBoxAPI
+ *                   -XX:-BackgroundCompilation -XX:-UseOnStackReplacement
+ *                   -XX:CompileCommand=dontinline,compiler.escapeAnalysis.TestReduceAllocationMerges::test*
+ *                   -XX:-ReduceAllocationMerges
+ *                   compiler.escapeAnalysis.TestReduceAllocationMerges false
+ * @run main/othervm -Xbootclasspath/a:. -XX:+UnlockDiagnosticVMOptions -XX:+WhiteBoxAPI
+ *                   -XX:-BackgroundCompilation -XX:-UseOnStackReplacement
+ *                   -XX:CompileCommand=dontinline,compiler.escapeAnalysis.TestReduceAllocationMerges::test*
+ *                   -XX:+ReduceAllocationMerges -XX:-DoEscapeAnalysis
+ *                   compiler.escapeAnalysis.TestReduceAllocationMerges false
+ */
+
+package compiler.escapeAnalysis;
+
+import compiler.whitebox.CompilerWhiteBoxTest;
+import java.lang.management.ManagementFactory;
+import java.lang.reflect.Method;
+import jdk.test.lib.Asserts;
+import sun.hotspot.WhiteBox;
+
+public class TestReduceAllocationMerges {
+    private static final WhiteBox WHITE_BOX = WhiteBox.getWhiteBox();
+    private static final com.sun.management.ThreadMXBean THREAD_MX_BEAN =
+        (com.sun.management.ThreadMXBean) ManagementFactory.getThreadMXBean();
+
+    private static final int WARMUP = 20_000;
+    private static final int ITERATIONS = 100_000;
+
+    static class Point {
+        int x, y;
+        Point(int x, int y) {
+            this.x = x;
+            this.y = y;
+        }
+    }
+
+    static Point escaped;
+
+    // The Phi only feeds field loads: the allocations are eliminated.
+    static int testTernary(int x) {
+        Point p = (x > 0) ? new Point(x, 0) : new Point(0, -x);
+        return p.x + p.y;
+    }
+
+    static int testTernaryExpected(int x) {
+        return (x > 0) ? x : -x;
+    }
+
+    // Three allocations merged by one Phi, with a field updated on one path.
+    static int testThreeWay(int x) {
+        Point p;
+        if (x % 3 == 0) {
+            p = new Point(x, 1);
+        } else if (x % 3 == 1) {
+            p = new Point(2, x);
+            p.x = x * 2;
+        } else {
+            p = new Point(3, 3);
+        }
+        return p.x * 31 + p.y;
+    }
+
+    static int testThreeWayExpected(int x) {
+        if (x % 3 == 0) {
+            return x * 31 + 1;
+        } else if (x % 3 == 1) {
+            return x * 2 * 31 + x;
+        } else {
+            return 3 * 31 + 3;
+        }
+    }
+
+    // The merged object escapes on one path: it must stay intact.
+    static int testEscape(int x) {
+        Point p = (x > 0) ? new Point(x, 1) : new Point(1, x);
+        if ((x & 0xff) == 0) {
+            escaped = p;
+        }
+        return p.x - p.y;
+    }
+
+    static int testEscapeExpected(int x) {
+        return (x > 0) ? x - 1 : 1 - x;
+    }
+
+    interface Test {
+        int run(int x);
+    }
+
+    public static void main(String[] args) throws Exception {
+        boolean expectEliminated = Boolean.parseBoolean(args[0]);
+
+        check("testTernary", TestReduceAllocationMerges::testTernary,
+              TestReduceAllocationMerges::testTernaryExpected, expectEliminated);
+        check("testThreeWay", TestReduceAllocationMerges::testThreeWay,
+              TestReduceAllocationMerges::testThreeWayExpected, expectEliminated);
+        check("testEscape", TestReduceAllocationMerges::testEscape,
+              TestReduceAllocationMerges::testEscapeExpected, false);
+
+        Asserts.assertTrue(escaped.x == 1 || escaped.y == 1, "escaped object is corrupt");
+    }
+
+    private static void check(String name, Test test, Test expected, boolean expectEliminated)
+            throws Exception {
+        // Profile both branches, then compile with C2.
+        for (int i = -WARMUP; i < WARMUP; i++) {
+            Asserts.assertEquals(test.run(i), expected.run(i), name + "(" + i + ") in the interpreter");
+        }
+        Method m = TestReduceAllocationMerges.class.getDeclaredMethod(name, int.class);
+        WHITE_BOX.enqueueMethodForCompilation(m, CompilerWhiteBoxTest.COMP_LEVEL_FULL_OPTIMIZATION);
+        Asserts.assertTrue(WHITE_BOX.isMethodCompiled(m), name + " is not compiled");
+
+        long allocated = THREAD_MX_BEAN.getThreadAllocatedBytes(Thread.currentThread().getId());
+        int sum = 0;
+        int expectedSum = 0;
+        for (int i = -ITERATIONS / 2; i < ITERATIONS / 2; i++) {
+            sum += test.run(i);
+        }
+        allocated = THREAD_MX_BEAN.getThreadAllocatedBytes(Thread.currentThread().getId()) - allocated;
+        for (int i = -ITERATIONS / 2; i < ITERATIONS / 2; i++) {
+            expectedSum += expected.run(i);
+        }
+        Asserts.assertEquals(sum, expectedSum, name + " compiled returns a wrong result");
+        Asserts.assertTrue(WHITE_BOX.isMethodCompiled(m), name + " was deoptimized");
+
+        // A Point takes at least 16 bytes, so ITERATIONS allocations take at
+        // least 1.6 MB. Allow for the few allocations of the test itself.
+        System.out.println(name + ": " + allocated + " bytes allocated");
+        if (expectEliminated) {
+            Asserts.assertLT(allocated, (long) ITERATIONS, name + ": merged allocations are not eliminated");
+        } else {
+            Asserts.assertGTE(allocated, 16L * ITERATIONS, name + ": allocations are expected");
+        }
+    }
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * @test
+ * @summary String.hashCode() and Arrays.hashCode() for byte[], char[], short[]
+ *          and int[] return the same values compiled as interpreted for all
+ *          lengths and array alignments. The hash code stub is not bound to
+ *          these methods, which are not intrinsic candidates in this JDK.
+ * @library /test/lib
+ * @run driver compiler.intrinsics.TestVectorizedHashCode checkNotIntrinsified
+ * @run main/othervm -XX:-BackgroundCompilation
+ *                   -XX:CompileCommand=exclude,compiler.intrinsics.TestVectorizedHashCode::ref*
+ *                   compiler.intrinsics.TestVectorizedHashCode
+ * @run main/othervm -XX:-BackgroundCompilation
+ *                   -XX:CompileCommand=exclude,compiler.intrinsics.TestVectorizedHashCode::ref*
+ *                   -XX:+UnlockDiagnosticVMOptions -XX:+UseVectorizedHashCodeIntrinsic
+ *                   compiler.intrinsics.TestVectorizedHashCode
+ * @run main/othervm -XX:-BackgroundCompilation
+ *                   -XX:CompileCommand=exclude,compiler.intrinsics.TestVectorizedHashCode::ref*
+ *                   -XX:+UnlockDiagnosticVMOptions -XX:AVX3Threshold=0
+ *                   compiler.intrinsics.TestVectorizedHashCode
+ * @run main/othervm -XX:-BackgroundCompilation
+ *                   -XX:CompileCommand=exclude,compiler.intrinsics.TestVectorizedHashCode::ref*
+ *                   -XX:-CompactStrings
+ *                   compiler.intrinsics.TestVectorizedHashCode
+ */
+
+package compiler.intrinsics;
+
+import java.util.Arrays;
+import java.util.Random;
+import jdk.test.lib.Asserts;
+import jdk.test.lib.Utils;
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+public class TestVectorizedHashCode {
+    // Several vectors of 16 ints, plus every possible tail.
+    private static final int MAX_LENGTH = 200;
+    // The array base address moves in steps of the object alignment.
+    private static final int MAX_PADDING = 16;
+    private static final int ITERATIONS = 3;
+    private static final Random RANDOM = Utils.getRandomInstance();
+
+    // Keeps the padding arrays from being eliminated.
+    static Object padding;
+
+    // The reference implementations are excluded from compilation, so they
+    // are always interpreted.
+
+    static int refHash(byte[] a) {
+        if (a == null) return 0;
+        int h = 1;
+        for (byte e : a) h = 31 * h + e;
+        return h;
+    }
+
+    static int refHash(char[] a) {
+        if (a == null) return 0;
+        int h = 1;
+        for (char e : a) h = 31 * h + e;
+        return h;
+    }
+
+    static int refHash(short[] a) {
+        if (a == null) return 0;
+        int h = 1;
+        for (short e : a) h = 31 * h + e;
+        return h;
+    }
+
+    static int refHash(int[] a) {
+        if (a == null) return 0;
+        int h = 1;
+        for (int e : a) h = 31 * h + e;
+        return h;
+    }
+
+    static int refHash(String s) {
+        int h = 0;
+        for (int i = 0; i < s.length(); i++) h = 31 * h + s.charAt(i);
+        return h;
+    }
+
+    // Compiled, and intrinsified where supported.
+
+    static int hash(byte[] a)  { return Arrays.hashCode(a); }
+    static int hash(char[] a)  { return Arrays.hashCode(a); }
+    static int hash(short[] a) { return Arrays.hashCode(a); }
+    static int hash(int[] a)   { return Arrays.hashCode(a); }
+    // A new String does not have its hash cached yet.
+    static int hash(char[] a, boolean copy) { return new String(a).hashCode(); }
+
+    public static void main(String[] args) throws Exception {
+        if (args.length > 0 && args[0].equals("checkNotIntrinsified")) {
+            checkNotIntrinsified();
+            return;
+        }
+        for (int i = 0; i < ITERATIONS; i++) {
+            for (int len = 0; len <= MAX_LENGTH; len++) {
+                for (int pad = 0; pad < MAX_PADDING; pad++) {
+                    test(len, pad);
+                }
+            }
+        }
+        Asserts.assertEquals(hash((byte[]) null), 0, "Arrays.hashCode((byte[]) null)");
+        Asserts.assertEquals(hash((char[]) null), 0, "Arrays.hashCode((char[]) null)");
+        Asserts.assertEquals(hash((short[]) null), 0, "Arrays.hashCode((short[]) null)");
+        Asserts.assertEquals(hash((int[]) null), 0, "Arrays.hashCode((int[]) null)");
+    }
+
+    // With CheckIntrinsics, a debug VM exits when a class is loaded that has
+    // an intrinsic bound to a method not annotated with @HotSpotIntrinsicCandidate,
+    // and a product VM never uses it. The hash methods must not be intrinsified.
+    static void checkNotIntrinsified() throws Exception {
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(
+            "-XX:-BackgroundCompilation",
+            "-XX:CompileCommand=exclude,compiler.intrinsics.TestVectorizedHashCode::ref*",
+            "-XX:+UnlockDiagnosticVMOptions",
+            "-XX:+CheckIntrinsics",
+            "-XX:+UseVectorizedHashCodeIntrinsic",
+            "-XX:+PrintIntrinsics",
+            TestVectorizedHashCode.class.getName());
+        OutputAnalyzer out = new OutputAnalyzer(pb.start());
+        out.shouldHaveExitValue(0);
+        out.shouldNotContain("Compiler intrinsic is defined for method");
+        out.shouldNotMatch("(Arrays|StringLatin1|StringUTF16)::hashCode .*\\(intrinsic");
+    }
+
+    static void test(int len, int pad) {
+        padding = new byte[pad];
+        byte[] b = new byte[len];
+        RANDOM.nextBytes(b);
+        Asserts.assertEquals(hash(b), refHash(b), "byte[" + len + "], padding " + pad);
+
+        padding = new byte[pad];
+        char[] c = new char[len];
+        for (int i = 0; i < len; i++) c[i] = (char) RANDOM.nextInt();
+        Asserts.assertEquals(hash(c), refHash(c), "char[" + len + "], padding " + pad);
+
+        padding = new byte[pad];
+        short[] s = new short[len];
+        for (int i = 0; i < len; i++) s[i] = (short) RANDOM.nextInt();
+        Asserts.assertEquals(hash(s), refHash(s), "short[" + len + "], padding " + pad);
+
+        padding = new byte[pad];
+        int[] n = new int[len];
+        for (int i = 0; i < len; i++) n[i] = RANDOM.nextInt();
+        Asserts.assertEquals(hash(n), refHash(n), "int[" + len + "], padding " + pad);
+
+        // Latin1 strings, including the chars that are negative as bytes.
+        char[] latin1 = new char[len];
+        for (int i = 0; i < len; i++) latin1[i] = (char) RANDOM.nextInt(256);
+        padding = new byte[pad];
+        Asserts.assertEquals(hash(latin1, true), refHash(new String(latin1)),
+                             "Latin1 string of length " + len + ", padding " + pad);
+
+        // UTF16 strings
+        char[] utf16 = new char[len];
+        for (int i = 0; i < len; i++) utf16[i] = (char) RANDOM.nextInt();
+        if (len > 0) utf16[RANDOM.nextInt(len)] = '€';
+        padding = new byte[pad];
+        Asserts.assertEquals(hash(utf16, true), refHash(new String(utf16)),
+                             "UTF16 string of length " + len + ", padding " + pad);
+    }
+}
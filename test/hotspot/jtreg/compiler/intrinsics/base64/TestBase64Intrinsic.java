@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary Base64.Encoder.encodeBlock is intrinsified where the CPU supports
+ *          it, no Base64.Decoder method is, and encoding and decoding match
+ *          a reference decoder on random input, including illegal characters
+ *          and padding
+ * @key randomness
+ * @requires vm.compiler2.enabled & vm.flavor == "server" & !vm.emulatedClient
+ * @library /test/lib
+ * @modules jdk.management
+ * @run driver compiler.intrinsics.base64.TestBase64Intrinsic
+ */
+
+package compiler.intrinsics.base64;
+
+import com.sun.management.HotSpotDiagnosticMXBean;
+import java.lang.management.ManagementFactory;
+import java.util.Arrays;
+import java.util.Base64;
+import java.util.Random;
+
+import jdk.test.lib.Utils;
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+public class TestBase64Intrinsic {
+    private static final String BASIC = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    private static final String URL   = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+    private static final int ITERATIONS = 20_000;
+
+    private static final String ENCODE_INTRINSIC =
+        "java\\.util\\.Base64\\$Encoder::encodeBlock .*\\(intrinsic\\)";
+    private static final String DECODE_INTRINSIC =
+        "java\\.util\\.Base64\\$Decoder::[a-zA-Z0-9]+ .*\\(intrinsic\\)";
+
+    public static void main(String[] args) throws Exception {
+        if (args.length > 0 && args[0].equals("run")) {
+            run();
+        } else {
+            check();
+            check("-XX:-UseBASE64Intrinsics");
+        }
+    }
+
+    // Runs the test in a VM that prints the intrinsics C2 uses, and checks
+    // that the encoder intrinsic is used exactly when it is enabled.
+    private static void check(String... opts) throws Exception {
+        String[] cmd = new String[opts.length + 6];
+        cmd[0] = "-Xbatch";
+        cmd[1] = "-XX:-TieredCompilation";
+        cmd[2] = "-XX:+UnlockDiagnosticVMOptions";
+        cmd[3] = "-XX:+PrintIntrinsics";
+        System.arraycopy(opts, 0, cmd, 4, opts.length);
+        cmd[cmd.length - 2] = TestBase64Intrinsic.class.getName();
+        cmd[cmd.length - 1] = "run";
+        OutputAnalyzer out = ProcessTools.executeTestJvm(cmd);
+        out.shouldHaveExitValue(0);
+        if (out.getStdout().contains("UseBASE64Intrinsics=true")) {
+            out.shouldMatch(ENCODE_INTRINSIC);
+        } else {
+            out.shouldContain("UseBASE64Intrinsics=false");
+            out.shouldNotMatch(ENCODE_INTRINSIC);
+        }
+        out.shouldNotMatch(DECODE_INTRINSIC);
+    }
+
+    private static void run() {
+        HotSpotDiagnosticMXBean bean = ManagementFactory.getPlatformMXBean(HotSpotDiagnosticMXBean.class);
+        System.out.println("UseBASE64Intrinsics=" + bean.getVMOption("UseBASE64Intrinsics").getValue());
+
+        Random rnd = Utils.getRandomInstance();
+        for (int i = 0; i < ITERATIONS; i++) {
+            test(rnd, false);
+            test(rnd, true);
+        }
+    }
+
+    private static void test(Random rnd, boolean isURL) {
+        byte[] data = new byte[rnd.nextInt(200)];
+        rnd.nextBytes(data);
+        Base64.Encoder encoder = isURL ? Base64.getUrlEncoder() : Base64.getEncoder();
+        Base64.Decoder decoder = isURL ? Base64.getUrlDecoder() : Base64.getDecoder();
+        byte[] encoded = encoder.encode(data);
+
+        // legal input, with and without padding
+        check(data, decoder.decode(encoded), encoded);
+        byte[] unpadded = isURL ? Base64.getUrlEncoder().withoutPadding().encode(data)
+                                : Base64.getEncoder().withoutPadding().encode(data);
+        check(data, decoder.decode(unpadded), unpadded);
+
+        // one illegal byte anywhere, including bytes >= 0x80 and the
+        // characters of the other alphabet
+        if (encoded.length > 0) {
+            byte[] illegal = encoded.clone();
+            int pos = rnd.nextInt(illegal.length);
+            illegal[pos] = illegalByte(rnd, isURL);
+            byte[] expected = reference(illegal, isURL);
+            byte[] result;
+            try {
+                result = decoder.decode(illegal);
+            } catch (IllegalArgumentException e) {
+                result = null;
+            }
+            if (!Arrays.equals(expected, result)) {
+                throw new RuntimeException("mismatch for illegal byte " + illegal[pos] + " at " + pos +
+                                           " in " + new String(illegal, java.nio.charset.StandardCharsets.ISO_8859_1));
+            }
+        }
+
+        // MIME line separators are skipped by the Java code
+        byte[] mime = Base64.getMimeEncoder().encode(data);
+        check(data, Base64.getMimeDecoder().decode(mime), mime);
+    }
+
+    private static byte illegalByte(Random rnd, boolean isURL) {
+        String alphabet = isURL ? URL : BASIC;
+        while (true) {
+            byte b = (byte)rnd.nextInt(256);
+            if (alphabet.indexOf(b & 0xff) < 0) {
+                return b;
+            }
+        }
+    }
+
+    private static void check(byte[] expected, byte[] result, byte[] input) {
+        if (!Arrays.equals(expected, result)) {
+            throw new RuntimeException("mismatch for " +
+                                       new String(input, java.nio.charset.StandardCharsets.ISO_8859_1));
+        }
+    }
+
+    // The result of Base64.Decoder.decode for input without line separators,
+    // or null if it throws IllegalArgumentException
+    private static byte[] reference(byte[] src, boolean isURL) {
+        String alphabet = isURL ? URL : BASIC;
+        int len = src.length;
+        int pad = 0;
+        if (len > 0 && src[len - 1] == '=') {
+            pad++;
+            if (len > 1 && src[len - 2] == '=') {
+                pad++;
+            }
+        }
+        int chars = len - pad;
+        if (pad > 0 && len % 4 != 0) {
+            return null;
+        }
+        if (chars % 4 == 1) {
+            return null;
+        }
+        byte[] dst = new byte[chars * 3 / 4];
+        int bits = 0;
+        int dp = 0;
+        for (int i = 0; i < chars; i++) {
+            int v = alphabet.indexOf(src[i] & 0xff);
+            if (v < 0) {
+                return null;
+            }
+            bits = (bits << 6) | v;
+            if (i % 4 == 3) {
+                dst[dp++] = (byte)(bits >> 16);
+                dst[dp++] = (byte)(bits >> 8);
+                dst[dp++] = (byte)bits;
+                bits = 0;
+            }
+        }
+        switch (chars % 4) {
+        case 2:
+            dst[dp++] = (byte)(bits >> 4);
+            break;
+        case 3:
+            dst[dp++] = (byte)(bits >> 10);
+            dst[dp++] = (byte)(bits >> 2);
+            break;
+        }
+        return dst;
+    }
+}
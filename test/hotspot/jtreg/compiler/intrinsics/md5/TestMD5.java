@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2019, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * @test
+ * @summary The multi-block DigestBase intrinsic is used for MD5 exactly when
+ *          UseMD5Intrinsics is on, MD5.implCompress is never intrinsified,
+ *          and digests match a reference implementation on random input,
+ *          for single and multi-block updates
+ * @key randomness
+ * @requires vm.compiler2.enabled & vm.flavor == "server" & !vm.emulatedClient
+ * @library /test/lib
+ * @modules jdk.management
+ * @run driver compiler.intrinsics.md5.TestMD5
+ */
+
+package compiler.intrinsics.md5;
+
+import com.sun.management.HotSpotDiagnosticMXBean;
+import java.lang.management.ManagementFactory;
+import java.security.MessageDigest;
+import java.util.Arrays;
+import java.util.Random;
+
+import jdk.test.lib.Utils;
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+public class TestMD5 {
+    private static final int ITERATIONS = 20_000;
+
+    private static final String MB_INTRINSIC =
+        "sun\\.security\\.provider\\.DigestBase::implCompressMultiBlock0 .*\\(intrinsic";
+    private static final String MD5_INTRINSIC =
+        "sun\\.security\\.provider\\.MD5::[a-zA-Z0-9]+ .*\\(intrinsic";
+
+    public static void main(String[] args) throws Exception {
+        if (args.length > 0 && args[0].equals("run")) {
+            run();
+        } else {
+            // The SHA intrinsics share the multi-block intrinsic, so they
+            // are turned off to see only the MD5 one.
+            check("-XX:-UseSHA");
+            check("-XX:-UseSHA", "-XX:-UseMD5Intrinsics");
+        }
+    }
+
+    // Runs the test in a VM that prints the intrinsics C2 uses, and checks
+    // that the multi-block intrinsic is used exactly when MD5 intrinsics are
+    // enabled. CheckIntrinsics makes a debug VM exit if an intrinsic is bound
+    // to a method that is not an intrinsic candidate.
+    private static void check(String... opts) throws Exception {
+        String[] cmd = new String[opts.length + 7];
+        cmd[0] = "-Xbatch";
+        cmd[1] = "-XX:-TieredCompilation";
+        cmd[2] = "-XX:+UnlockDiagnosticVMOptions";
+        cmd[3] = "-XX:+CheckIntrinsics";
+        cmd[4] = "-XX:+PrintIntrinsics";
+        System.arraycopy(opts, 0, cmd, 5, opts.length);
+        cmd[cmd.length - 2] = TestMD5.class.getName();
+        cmd[cmd.length - 1] = "run";
+        OutputAnalyzer out = ProcessTools.executeTestJvm(cmd);
+        out.shouldHaveExitValue(0);
+        out.shouldNotContain("Compiler intrinsic is defined for method");
+        if (out.getStdout().contains("UseMD5Intrinsics=true")) {
+            out.shouldMatch(MB_INTRINSIC);
+        } else {
+            out.shouldContain("UseMD5Intrinsics=false");
+            out.shouldNotMatch(MB_INTRINSIC);
+        }
+        out.shouldNotMatch(MD5_INTRINSIC);
+    }
+
+    private static void run() throws Exception {
+        HotSpotDiagnosticMXBean bean = ManagementFactory.getPlatformMXBean(HotSpotDiagnosticMXBean.class);
+        System.out.println("UseMD5Intrinsics=" + bean.getVMOption("UseMD5Intrinsics").getValue());
+
+        MessageDigest md = MessageDigest.getInstance("MD5", "SUN");
+        Random rnd = Utils.getRandomInstance();
+        for (int i = 0; i < ITERATIONS; i++) {
+            byte[] data = new byte[rnd.nextInt(1000)];
+            rnd.nextBytes(data);
+            byte[] expected = reference(data);
+
+            // multi-block compression of the whole array
+            check(expected, md.digest(data), data);
+
+            // single-block compression through small updates at random offsets
+            int ofs = 0;
+            while (ofs < data.length) {
+                int len = Math.min(data.length - ofs, rnd.nextInt(70));
+                md.update(data, ofs, len);
+                ofs += len;
+            }
+            check(expected, md.digest(), data);
+        }
+    }
+
+    private static void check(byte[] expected, byte[] result, byte[] data) {
+        if (!Arrays.equals(expected, result)) {
+            throw new RuntimeException("MD5 mismatch for input of length " + data.length);
+        }
+    }
+
+    private static final int[] S = {
+        7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21
+    };
+
+    // RFC 1321
+    private static byte[] reference(byte[] data) {
+        int[] t = new int[64];
+        for (int i = 0; i < 64; i++) {
+            t[i] = (int)(long)(Math.abs(Math.sin(i + 1)) * (1L << 32));
+        }
+        int blocks = (data.length + 8) / 64 + 1;
+        byte[] padded = Arrays.copyOf(data, blocks * 64);
+        padded[data.length] = (byte)0x80;
+        long bits = (long)data.length * 8;
+        for (int i = 0; i < 8; i++) {
+            padded[padded.length - 8 + i] = (byte)(bits >>> (8 * i));
+        }
+
+        int[] state = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+        int[] x = new int[16];
+        for (int blk = 0; blk < blocks; blk++) {
+            for (int i = 0; i < 16; i++) {
+                int p = blk * 64 + i * 4;
+                x[i] = (padded[p] & 0xff) | (padded[p + 1] & 0xff) << 8 |
+                       (padded[p + 2] & 0xff) << 16 | (padded[p + 3] & 0xff) << 24;
+            }
+            int a = state[0], b = state[1], c = state[2], d = state[3];
+            for (int i = 0; i < 64; i++) {
+                int f, k;
+                switch (i / 16) {
+                case 0:  f = (b & c) | (~b & d); k = i;                break;
+                case 1:  f = (b & d) | (c & ~d); k = (5 * i + 1) % 16; break;
+                case 2:  f = b ^ c ^ d;          k = (3 * i + 5) % 16; break;
+                default: f = c ^ (b | ~d);       k = (7 * i) % 16;     break;
+                }
+                int tmp = d;
+                d = c;
+                c = b;
+                b = b + Integer.rotateLeft(a + f + x[k] + t[i], S[(i / 16) * 4 + i % 4]);
+                a = tmp;
+            }
+            state[0] += a;
+            state[1] += b;
+            state[2] += c;
+            state[3] += d;
+        }
+
+        byte[] digest = new byte[16];
+        for (int i = 0; i < 16; i++) {
+            digest[i] = (byte)(state[i / 4] >>> (8 * (i % 4)));
+        }
+        return digest;
+    }
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * @test
+ * @summary Benchmark of element-wise loops over arrays of every length from
+ *          1 to 256, with and without vectorized post loops. It prints the
+ *          time per call for each length and element size; run it manually
+ *          on an AVX-512 machine and compare the two tables.
+ * @requires vm.compiler2.enabled & vm.flavor == "server" & !vm.emulatedClient
+ * @run main/othervm/manual -XX:-TieredCompilation -XX:+PostLoopMultiversioning
+ *                          compiler.loopopts.PostLoopMultiversioningBench
+ * @run main/othervm/manual -XX:-TieredCompilation -XX:-PostLoopMultiversioning
+ *                          compiler.loopopts.PostLoopMultiversioningBench
+ */
+
+package compiler.loopopts;
+
+import java.lang.management.ManagementFactory;
+
+public class PostLoopMultiversioningBench {
+    private static final int MAX_LENGTH = 256;
+    // Time spent measuring each length, after a warmup of the same duration.
+    private static final long MILLIS = Long.getLong("bench.millis", 20);
+
+    private static final byte[]   BYTES_A   = new byte[MAX_LENGTH];
+    private static final byte[]   BYTES_C   = new byte[MAX_LENGTH];
+    private static final int[]    INTS_A    = new int[MAX_LENGTH];
+    private static final int[]    INTS_C    = new int[MAX_LENGTH];
+    private static final double[] DOUBLES_A = new double[MAX_LENGTH];
+    private static final double[] DOUBLES_C = new double[MAX_LENGTH];
+
+    static void addBytes(byte[] a, byte[] c, int n) {
+        for (int i = 0; i < n; i++) {
+            c[i] = (byte)(a[i] + c[i]);
+        }
+    }
+
+    static void addInts(int[] a, int[] c, int n) {
+        for (int i = 0; i < n; i++) {
+            c[i] = a[i] + c[i];
+        }
+    }
+
+    static void scaleDoubles(double[] a, double[] c, int n) {
+        for (int i = 0; i < n; i++) {
+            c[i] = a[i] * 1.5 + c[i];
+        }
+    }
+
+    interface Kernel {
+        void run(int n);
+    }
+
+    public static void main(String[] args) {
+        for (int i = 0; i < MAX_LENGTH; i++) {
+            BYTES_A[i] = (byte)i;
+            INTS_A[i] = i;
+            DOUBLES_A[i] = i;
+        }
+        System.out.println(ManagementFactory.getRuntimeMXBean().getInputArguments());
+        System.out.println("length   byte ns/op    int ns/op  double ns/op");
+        Kernel bytes = n -> addBytes(BYTES_A, BYTES_C, n);
+        Kernel ints = n -> addInts(INTS_A, INTS_C, n);
+        Kernel doubles = n -> scaleDoubles(DOUBLES_A, DOUBLES_C, n);
+        for (int len = 1; len <= MAX_LENGTH; len++) {
+            System.out.println(String.format("%6d %12.2f %12.2f %13.2f", len,
+                                             measure(bytes, len), measure(ints, len), measure(doubles, len)));
+        }
+        // Keep the results alive.
+        System.out.println("checksum " + (BYTES_C[0] + INTS_C[MAX_LENGTH - 1] + DOUBLES_C[MAX_LENGTH / 2]));
+    }
+
+    // Returns the average time of one call in nanoseconds.
+    private static double measure(Kernel k, int len) {
+        run(k, len, MILLIS);
+        long start = System.nanoTime();
+        long calls = run(k, len, MILLIS);
+        return (double)(System.nanoTime() - start) / calls;
+    }
+
+    private static long run(Kernel k, int len, long millis) {
+        long end = System.nanoTime() + millis * 1_000_000;
+        long calls = 0;
+        do {
+            for (int i = 0; i < 1000; i++) {
+                k.run(len);
+            }
+            calls += 1000;
+        } while (System.nanoTime() < end);
+        return calls;
+    }
+}
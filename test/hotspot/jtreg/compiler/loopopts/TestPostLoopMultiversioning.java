@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * @test
+ * @summary Loops compiled with and without vectorized multiversioned post
+ *          loops compute the same results as a scalar loop, for all array
+ *          lengths around the vector sizes and for all element sizes
+ * @requires vm.compiler2.enabled & vm.flavor == "server" & !vm.emulatedClient
+ * @library /test/lib
+ * @run main/othervm -XX:-TieredCompilation -XX:-BackgroundCompilation
+ *                   compiler.loopopts.TestPostLoopMultiversioning
+ * @run main/othervm -XX:-TieredCompilation -XX:-BackgroundCompilation
+ *                   -XX:+PostLoopMultiversioning
+ *                   compiler.loopopts.TestPostLoopMultiversioning
+ * @run main/othervm -XX:-TieredCompilation -XX:-BackgroundCompilation
+ *                   -XX:-PostLoopMultiversioning
+ *                   compiler.loopopts.TestPostLoopMultiversioning
+ * @run main/othervm -XX:-TieredCompilation -XX:-BackgroundCompilation
+ *                   -XX:+PostLoopMultiversioning -XX:UseAVX=2
+ *                   compiler.loopopts.TestPostLoopMultiversioning
+ */
+
+package compiler.loopopts;
+
+import java.util.Arrays;
+import java.util.Random;
+import jdk.test.lib.Asserts;
+import jdk.test.lib.Utils;
+
+public class TestPostLoopMultiversioning {
+    // Covers several 64-byte vectors of every element size, plus a remainder
+    // of each possible length.
+    private static final int MAX_LENGTH = 300;
+    private static final int WARMUP = 20_000;
+    private static final Random RANDOM = Utils.getRandomInstance();
+
+    // Compiled: each element is touched by a vector, possibly a masked one
+    // in the post loop.
+
+    static void addBytes(byte[] a, byte[] b, byte[] c, int n) {
+        for (int i = 0; i < n; i++) {
+            c[i] = (byte)(a[i] + b[i]);
+        }
+    }
+
+    static void addShorts(short[] a, short[] b, short[] c, int n) {
+        for (int i = 0; i < n; i++) {
+            c[i] = (short)(a[i] + b[i]);
+        }
+    }
+
+    static void addInts(int[] a, int[] b, int[] c, int n) {
+        for (int i = 0; i < n; i++) {
+            c[i] = a[i] + b[i];
+        }
+    }
+
+    static void addLongs(long[] a, long[] b, long[] c, int n) {
+        for (int i = 0; i < n; i++) {
+            c[i] = a[i] + b[i];
+        }
+    }
+
+    static void scaleDoubles(double[] a, double[] c, int n) {
+        for (int i = 0; i < n; i++) {
+            c[i] = a[i] * 2.5;
+        }
+    }
+
+    // Loop bounds that are not the array length, with an offset start.
+    static void copyInts(int[] a, int[] c, int from, int to) {
+        for (int i = from; i < to; i++) {
+            c[i] = a[i];
+        }
+    }
+
+    public static void main(String[] args) {
+        for (int len = 0; len <= MAX_LENGTH; len++) {
+            testBytes(len);
+            testShorts(len);
+            testInts(len);
+            testLongs(len);
+            testDoubles(len);
+        }
+        testIntBounds();
+    }
+
+    // The arrays are one element larger than the trip count, so that a
+    // vector access past the end of the loop shows up as a changed guard
+    // element rather than (or besides) an out of bounds access.
+
+    static void testBytes(int len) {
+        byte[] a = new byte[len + 1];
+        byte[] b = new byte[len + 1];
+        RANDOM.nextBytes(a);
+        RANDOM.nextBytes(b);
+        byte[] expected = new byte[len + 1];
+        for (int i = 0; i < len; i++) {
+            expected[i] = (byte)(a[i] + b[i]);
+        }
+        expected[len] = 42;
+        byte[] c = new byte[len + 1];
+        for (int i = 0; i < WARMUP / (len + 1) + 1; i++) {
+            c[len] = 42;
+            addBytes(a, b, c, len);
+        }
+        Asserts.assertTrue(Arrays.equals(c, expected), "addBytes wrong for length " + len);
+    }
+
+    static void testShorts(int len) {
+        short[] a = new short[len + 1];
+        short[] b = new short[len + 1];
+        short[] expected = new short[len + 1];
+        for (int i = 0; i < len; i++) {
+            a[i] = (short)RANDOM.nextInt();
+            b[i] = (short)RANDOM.nextInt();
+            expected[i] = (short)(a[i] + b[i]);
+        }
+        expected[len] = 42;
+        short[] c = new short[len + 1];
+        for (int i = 0; i < WARMUP / (len + 1) + 1; i++) {
+            c[len] = 42;
+            addShorts(a, b, c, len);
+        }
+        Asserts.assertTrue(Arrays.equals(c, expected), "addShorts wrong for length " + len);
+    }
+
+    static void testInts(int len) {
+        int[] a = new int[len + 1];
+        int[] b = new int[len + 1];
+        int[] expected = new int[len + 1];
+        for (int i = 0; i < len; i++) {
+            a[i] = RANDOM.nextInt();
+            b[i] = RANDOM.nextInt();
+            expected[i] = a[i] + b[i];
+        }
+        expected[len] = 42;
+        int[] c = new int[len + 1];
+        for (int i = 0; i < WARMUP / (len + 1) + 1; i++) {
+            c[len] = 42;
+            addInts(a, b, c, len);
+        }
+        Asserts.assertTrue(Arrays.equals(c, expected), "addInts wrong for length " + len);
+    }
+
+    static void testLongs(int len) {
+        long[] a = new long[len + 1];
+        long[] b = new long[len + 1];
+        long[] expected = new long[len + 1];
+        for (int i = 0; i < len; i++) {
+            a[i] = RANDOM.nextLong();
+            b[i] = RANDOM.nextLong();
+            expected[i] = a[i] + b[i];
+        }
+        expected[len] = 42;
+        long[] c = new long[len + 1];
+        for (int i = 0; i < WARMUP / (len + 1) + 1; i++) {
+            c[len] = 42;
+            addLongs(a, b, c, len);
+        }
+        Asserts.assertTrue(Arrays.equals(c, expected), "addLongs wrong for length " + len);
+    }
+
+    static void testDoubles(int len) {
+        double[] a = new double[len + 1];
+        double[] expected = new double[len + 1];
+        for (int i = 0; i < len; i++) {
+            a[i] = RANDOM.nextDouble();
+            expected[i] = a[i] * 2.5;
+        }
+        expected[len] = 42;
+        double[] c = new double[len + 1];
+        for (int i = 0; i < WARMUP / (len + 1) + 1; i++) {
+            c[len] = 42;
+            scaleDoubles(a, c, len);
+        }
+        Asserts.assertTrue(Arrays.equals(c, expected), "scaleDoubles wrong for length " + len);
+    }
+
+    static void testIntBounds() {
+        int[] a = new int[MAX_LENGTH];
+        for (int i = 0; i < MAX_LENGTH; i++) {
+            a[i] = i + 1;
+        }
+        int[] c = new int[MAX_LENGTH];
+        for (int i = 0; i < WARMUP; i++) {
+            copyInts(a, c, 0, MAX_LENGTH);
+        }
+        for (int from = 0; from < 70; from++) {
+            for (int to = from; to < MAX_LENGTH; to += 7) {
+                Arrays.fill(c, 0);
+                copyInts(a, c, from, to);
+                for (int i = 0; i < MAX_LENGTH; i++) {
+                    int expected = (i >= from && i < to) ? i + 1 : 0;
+                    Asserts.assertEquals(c[i], expected, "copyInts(" + from + ", " + to + ")[" + i + "]");
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * @test
+ * @summary Method profiles saved with -XX:DumpMethodProfilesAtExit are
+ *          restored by -XX:LoadMethodProfiles, and stale, truncated or
+ *          mismatched profile files are rejected
+ * @requires vm.compiler2.enabled & vm.flavor == "server" & !vm.emulatedClient
+ * @library /test/lib
+ * @modules java.compiler
+ * @run driver compiler.profiling.TestMethodProfileArchive
+ */
+
+package compiler.profiling;
+
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.util.Arrays;
+
+import jdk.test.lib.compiler.InMemoryJavaCompiler;
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+public class TestMethodProfileArchive {
+    private static final String APP_SOURCE =
+        "public class ProfiledApp {\n" +
+        "    public static void main(String[] args) {\n" +
+        "        int sum = 0;\n" +
+        "        for (int i = 0; i < 200_000; i++) {\n" +
+        "            sum += Hot.work(i);\n" +
+        "        }\n" +
+        "        System.out.println(\"sum = \" + sum);\n" +
+        "    }\n" +
+        "}\n";
+
+    private static String hotSource(String body) {
+        return "public class Hot {\n" +
+               "    public static int work(int i) {\n" +
+               "        " + body + "\n" +
+               "    }\n" +
+               "}\n";
+    }
+
+    private static final String PROFILE = "TestMethodProfileArchive.prof";
+    private static final String RESTORED = "Restored the profile of Hot.work(I)I";
+
+    public static void main(String[] args) throws Exception {
+        Path v1 = compile("v1", hotSource("return (i & 1) == 0 ? i : -i;"));
+        // Same method, but a different class file
+        Path v2 = compile("v2", hotSource("return (i & 1) == 0 ? i : i * 3;"));
+
+        OutputAnalyzer out = run(v1, "-XX:DumpMethodProfilesAtExit=" + PROFILE);
+        out.shouldHaveExitValue(0);
+        out.shouldMatch("Saved the profiles of [1-9][0-9]* methods in [1-9][0-9]* classes to " + PROFILE);
+        byte[] profile = Files.readAllBytes(Paths.get(PROFILE));
+
+        // The profile of the unchanged class is restored.
+        out = run(v1, "-XX:LoadMethodProfiles=" + PROFILE);
+        out.shouldHaveExitValue(0);
+        out.shouldMatch("Loaded the profiles of [1-9][0-9]* methods");
+        out.shouldContain(RESTORED);
+
+        // The class has changed since the profile was saved.
+        out = run(v2, "-XX:LoadMethodProfiles=" + PROFILE);
+        out.shouldHaveExitValue(0);
+        out.shouldContain("Class Hot has changed, its saved profiles are ignored");
+        out.shouldNotContain(RESTORED);
+
+        // Cut off within the last method profile.
+        rejected(v1, Arrays.copyOf(profile, profile.length - 3), "the file is corrupt");
+
+        // A record count that runs past the end of the file.
+        byte[] bad = profile.clone();
+        Arrays.fill(bad, profile.length / 2, profile.length, (byte)0xff);
+        rejected(v1, bad, "the file is corrupt");
+
+        // Saved by another VM build: the VM info string, which starts after
+        // the magic, the version and its u2 length, does not match.
+        bad = profile.clone();
+        bad[10] ^= 0x20;
+        rejected(v1, bad, "it was created by a different VM");
+
+        // A different file format version.
+        bad = profile.clone();
+        bad[4] ^= 0x7f;
+        rejected(v1, bad, "not a method profile file");
+
+        rejected(v1, "not a profile".getBytes(), "not a method profile file");
+    }
+
+    private static void rejected(Path classes, byte[] contents, String reason) throws Exception {
+        Path file = Files.write(Paths.get("bad.prof"), contents);
+        OutputAnalyzer out = run(classes, "-XX:LoadMethodProfiles=" + file);
+        out.shouldHaveExitValue(0);
+        out.shouldContain("Ignoring LoadMethodProfiles " + file + ": " + reason);
+        out.shouldNotContain("Loaded the profiles of");
+        out.shouldNotContain(RESTORED);
+        out.shouldContain("sum = ");
+    }
+
+    private static Path compile(String dir, String hotSource) throws Exception {
+        Path path = Files.createDirectories(Paths.get(dir));
+        Files.write(path.resolve("Hot.class"), InMemoryJavaCompiler.compile("Hot", hotSource));
+        Files.write(path.resolve("ProfiledApp.class"),
+                    InMemoryJavaCompiler.compile("ProfiledApp", APP_SOURCE, "-cp", dir));
+        return path;
+    }
+
+    private static OutputAnalyzer run(Path classes, String option) throws Exception {
+        return ProcessTools.executeProcess(ProcessTools.createJavaProcessBuilder(
+            "-Xbatch",
+            "-XX:+UnlockExperimentalVMOptions",
+            option,
+            "-Xlog:jit+profile=debug",
+            "-cp", classes.toString(),
+            "ProfiledApp"));
+    }
+}
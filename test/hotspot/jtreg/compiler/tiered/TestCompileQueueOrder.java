@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * @test
+ * @summary Tasks are taken from the compile queue blocking ones first, then
+ *          hottest first, waiting tasks are aged by TieredCompileTaskAgingTime
+ *          and tasks of methods that stopped running are removed as stale
+ * @requires vm.compiler1.enabled & vm.compiler2.enabled & vm.flavor == "server" & !vm.emulatedClient
+ * @library /test/lib /
+ * @build sun.hotspot.WhiteBox
+ * @run driver ClassFileInstaller sun.hotspot.WhiteBox
+ *                                sun.hotspot.WhiteBox$WhiteBoxPermission
+ * @run driver compiler.tiered.TestCompileQueueOrder
+ */
+
+package compiler.tiered;
+
+import java.lang.reflect.Method;
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+import java.util.function.BooleanSupplier;
+
+import jdk.test.lib.Asserts;
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+import sun.hotspot.WhiteBox;
+
+public class TestCompileQueueOrder {
+    private static final int COMP_LEVEL_SIMPLE = 1;
+    // Far below the 50000 invocations after which a method is never stale,
+    // and far above the single invocation of the cold method.
+    private static final int HOT_CALLS = 20_000;
+    // Longer than TieredCompileTaskTimeout.
+    private static final long WAIT_MILLIS = 300;
+
+    public static void main(String[] args) throws Exception {
+        if (args.length > 0) {
+            Child.run(args[0]);
+            return;
+        }
+
+        // A blocking task is taken before a hotter one, and the hotter one
+        // before the cold one, which has been waiting slightly longer.
+        checkOrder(run("order"), "blocking", "hot", "cold");
+
+        // The cold task waits WAIT_MILLIS more than the hot one. That is a few
+        // aging periods by default, which is not enough to make up for being
+        // 2^13 times less hot, but it is with a 10 ms aging time.
+        checkOrder(run("aging"), "hot", "cold");
+        checkOrder(run("aging", "-XX:TieredCompileTaskAgingTime=10"), "cold", "hot");
+
+        // The stale task is checked in the child, nothing is printed for it.
+        OutputAnalyzer output = run("stale");
+        Asserts.assertFalse(output.getStdout().contains("Work::stale "),
+                            "stale task was compiled");
+    }
+
+    private static OutputAnalyzer run(String scenario, String... extraFlags) throws Exception {
+        List<String> flags = new ArrayList<>(Arrays.asList(
+            "-Xbootclasspath/a:.",
+            "-XX:+UnlockDiagnosticVMOptions",
+            "-XX:+WhiteBoxAPI",
+            "-XX:+TieredCompilation",
+            "-XX:CICompilerCount=2",
+            "-XX:-UseDynamicNumberOfCompilerThreads",
+            "-XX:+PrintCompilation",
+            // No safepoint may end shortly before the stale check.
+            "-XX:GuaranteedSafepointInterval=0",
+            "-XX:CompileCommand=quiet",
+            "-XX:CompileCommand=compileonly," + Work.class.getName() + "::*"));
+        if (!scenario.equals("stale")) {
+            // The policy must not queue the hot method by itself, only the
+            // stale scenario relies on the thresholds.
+            flags.add("-XX:CompileThresholdScaling=1000");
+        }
+        flags.addAll(Arrays.asList(extraFlags));
+        flags.add(TestCompileQueueOrder.class.getName());
+        flags.add(scenario);
+        OutputAnalyzer output = ProcessTools.executeTestJvm(flags.toArray(new String[0]));
+        output.shouldHaveExitValue(0);
+        return output;
+    }
+
+    // Checks that the methods are printed by PrintCompilation, which happens
+    // when their tasks are taken from the queue, in the given order.
+    private static void checkOrder(OutputAnalyzer output, String... methods) {
+        String stdout = output.getStdout();
+        int last = -1;
+        for (String m : methods) {
+            int index = stdout.indexOf("Work::" + m + " ");
+            Asserts.assertGreaterThan(index, -1, m + " was not compiled");
+            Asserts.assertGreaterThan(index, last, m + " was compiled out of order: " + Arrays.toString(methods));
+            last = index;
+        }
+    }
+
+    static class Work {
+        static volatile int sink;
+
+        static int blocker(int x) { return x * 31 + 1; }
+        static int cold(int x)    { return x * 31 + 2; }
+        static int hot(int x)     { return x * 31 + 3; }
+        static int blocking(int x) { return x * 31 + 4; }
+        static int stale(int x)   { return x * 31 + 5; }
+    }
+
+    static class Child {
+        private static final WhiteBox WB = WhiteBox.getWhiteBox();
+
+        static void run(String scenario) throws Exception {
+            Method blocker = method("blocker");
+            Method cold = method("cold");
+            Method hot = method("hot");
+            Method blocking = method("blocking");
+            Method stale = method("stale");
+
+            Work.sink = Work.cold(1);
+            for (int i = 0; i < HOT_CALLS; i++) {
+                Work.sink += Work.hot(i);
+            }
+
+            // Keep the only C1 compiler thread busy with the first task, so
+            // that the next ones pile up in the queue.
+            WB.lockCompilation();
+            WB.enqueueMethodForCompilation(blocker, COMP_LEVEL_SIMPLE);
+            waitFor(() -> WB.getCompileQueueSize(COMP_LEVEL_SIMPLE) == 0);
+
+            Thread waiter = null;
+            switch (scenario) {
+            case "order":
+                enqueue(cold);
+                enqueue(hot);
+                WB.addCompilerDirective("[{ match: \"*.blocking\", BackgroundCompilation: false }]");
+                // The caller of a blocking compilation waits for it.
+                waiter = new Thread(() -> enqueue(blocking));
+                waiter.start();
+                waitFor(() -> WB.getCompileQueueSize(COMP_LEVEL_SIMPLE) == 3);
+                break;
+            case "aging":
+                enqueue(cold);
+                Thread.sleep(WAIT_MILLIS);
+                enqueue(hot);
+                break;
+            case "stale":
+                // Run the method until the policy queues it, then stop.
+                for (int i = 0; !WB.isMethodQueuedForCompilation(stale); i++) {
+                    Asserts.assertLessThan(i, 1_000_000, "stale method was not queued");
+                    Work.sink += Work.stale(i);
+                }
+                Thread.sleep(WAIT_MILLIS);
+                break;
+            default:
+                throw new IllegalArgumentException(scenario);
+            }
+            WB.unlockCompilation();
+
+            if (waiter != null) {
+                waiter.join();
+            }
+            switch (scenario) {
+            case "order":
+                waitFor(() -> WB.isMethodCompiled(blocking) && WB.isMethodCompiled(hot) && WB.isMethodCompiled(cold));
+                break;
+            case "aging":
+                waitFor(() -> WB.isMethodCompiled(hot) && WB.isMethodCompiled(cold));
+                break;
+            case "stale":
+                waitFor(() -> WB.isMethodCompiled(blocker) && WB.getCompileQueueSize(COMP_LEVEL_SIMPLE) == 0);
+                Asserts.assertFalse(WB.isMethodQueuedForCompilation(stale), "stale task is still queued");
+                Asserts.assertFalse(WB.isMethodCompiled(stale), "stale task was compiled");
+                break;
+            }
+        }
+
+        private static void enqueue(Method m) {
+            Asserts.assertTrue(WB.enqueueMethodForCompilation(m, COMP_LEVEL_SIMPLE), m + " was not enqueued");
+        }
+
+        private static Method method(String name) throws NoSuchMethodException {
+            return Work.class.getDeclaredMethod(name, int.class);
+        }
+
+        private static void waitFor(BooleanSupplier condition) throws InterruptedException {
+            while (!condition.getAsBoolean()) {
+                Thread.sleep(10);
+            }
+        }
+    }
+}
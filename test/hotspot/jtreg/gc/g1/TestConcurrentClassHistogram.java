@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+package gc.g1;
+
+/*
+ * @test TestConcurrentClassHistogram
+ * @summary GC.class_histogram -concurrent prints the class histogram recorded by
+ *          the last completed concurrent cycle, also after the marking restarted
+ *          for mark stack overflow or a Full GC aborted a cycle
+ * @key gc
+ * @requires vm.gc.G1
+ * @library /test/lib
+ * @modules java.base/jdk.internal.misc
+ *          java.management
+ * @build sun.hotspot.WhiteBox
+ * @run driver ClassFileInstaller sun.hotspot.WhiteBox
+ *    sun.hotspot.WhiteBox$WhiteBoxPermission
+ * @run driver gc.g1.TestConcurrentClassHistogram
+ */
+
+import java.lang.management.ManagementFactory;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+import javax.management.ObjectName;
+
+import jdk.test.lib.Asserts;
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+import sun.hotspot.WhiteBox;
+
+public class TestConcurrentClassHistogram {
+    private static final String NO_HISTOGRAM = "No concurrent class histogram available";
+    private static final String RESTART = "Concurrent Mark reset for overflow";
+    private static final String ABORT = "Concurrent Mark Abort";
+
+    public static void main(String[] args) throws Exception {
+        testDisabled();
+        testCompleted();
+        testOverflow();
+        testAborted();
+    }
+
+    private static OutputAnalyzer run(String mode, String... opts) throws Exception {
+        List<String> cmd = new ArrayList<>();
+        cmd.add("-Xbootclasspath/a:.");
+        cmd.add("-XX:+UnlockDiagnosticVMOptions");
+        cmd.add("-XX:+WhiteBoxAPI");
+        cmd.add("-XX:+UseG1GC");
+        cmd.add("-Xmx256m");
+        cmd.add("-Xlog:gc,gc+marking");
+        for (String opt : opts) {
+            cmd.add(opt);
+        }
+        cmd.add(ConcurrentClassHistogramApp.class.getName());
+        cmd.add(mode);
+        OutputAnalyzer out = ProcessTools.executeProcess(
+            ProcessTools.createJavaProcessBuilder(cmd.toArray(new String[0])));
+        out.shouldHaveExitValue(0);
+        return out;
+    }
+
+    // Returns the number of marker instances in the histogram.
+    private static long markers(OutputAnalyzer out) {
+        Pattern p = Pattern.compile("^\\s*\\d+:\\s+(\\d+)\\s+\\d+\\s+" +
+                                    Pattern.quote(ConcurrentClassHistogramApp.Marker.class.getName()) + "\\s*$",
+                                    Pattern.MULTILINE);
+        Matcher m = p.matcher(out.getStdout());
+        Asserts.assertTrue(m.find(), "No markers in the histogram");
+        return Long.parseLong(m.group(1));
+    }
+
+    // The markers are counted once, even if the marking restarted.
+    private static void checkMarkers(OutputAnalyzer out) {
+        long count = markers(out);
+        long expected = ConcurrentClassHistogramApp.NUM_MARKERS;
+        // A few objects may be counted twice when the global finger races with marking.
+        Asserts.assertGTE(count, expected, "Markers missing in the histogram");
+        Asserts.assertLTE(count, expected + expected / 10, "Markers counted more than once");
+    }
+
+    private static void testDisabled() throws Exception {
+        OutputAnalyzer out = run("complete");
+        out.shouldContain(NO_HISTOGRAM);
+        out.shouldNotContain("Live objects in the old generation");
+    }
+
+    private static void testCompleted() throws Exception {
+        OutputAnalyzer out = run("complete", "-XX:+G1ConcurrentClassHistogram");
+        // Nothing is available before the first cycle completes.
+        out.shouldContain("before: " + NO_HISTOGRAM);
+        out.shouldContain("Live objects in the old generation at the start of the concurrent cycle");
+        checkMarkers(out);
+    }
+
+    private static void testOverflow() throws Exception {
+        // A single chunk of global mark stack overflows when the local task queues
+        // spill the wide and deep marker graph.
+        OutputAnalyzer out = run("complete", "-XX:+G1ConcurrentClassHistogram",
+                                 "-XX:MarkStackSize=1", "-XX:MarkStackSizeMax=1",
+                                 "-XX:ConcGCThreads=1");
+        out.shouldContain(RESTART);
+        checkMarkers(out);
+    }
+
+    private static void testAborted() throws Exception {
+        OutputAnalyzer out = run("abort", "-XX:+G1ConcurrentClassHistogram");
+        if (out.getStdout().contains(ABORT)) {
+            // The histogram of the aborted cycle is dropped.
+            out.shouldContain("aborted: " + NO_HISTOGRAM);
+        }
+        // A cycle completed after the abort records a histogram again.
+        out.shouldContain("Live objects in the old generation at the start of the concurrent cycle");
+        checkMarkers(out);
+    }
+}
+
+class ConcurrentClassHistogramApp {
+    static final int LEVELS = 200;
+    static final int WIDTH = 1500;
+    static final int NUM_MARKERS = LEVELS * WIDTH;
+
+    static final WhiteBox WB = WhiteBox.getWhiteBox();
+
+    static class Marker {
+        final Object[] next;
+
+        Marker(Object[] next) {
+            this.next = next;
+        }
+    }
+
+    // The levels are chained by the last marker of each level, and the deeper
+    // levels are allocated first, so marking finds them below the finger and
+    // pushes all markers of a level before it descends to the next one.
+    static Object[] markers;
+
+    static String histogram() throws Exception {
+        ObjectName name = new ObjectName("com.sun.management:type=DiagnosticCommand");
+        return (String) ManagementFactory.getPlatformMBeanServer().invoke(
+            name, "gcClassHistogram",
+            new Object[] { new String[] { "-concurrent" } },
+            new String[] { String[].class.getName() });
+    }
+
+    static void completeCycle() throws Exception {
+        while (!WB.g1StartConcMarkCycle()) {
+            Thread.sleep(10);
+        }
+        while (WB.g1InConcurrentMark()) {
+            Thread.sleep(10);
+        }
+    }
+
+    public static void main(String[] args) throws Exception {
+        Object[] level = null;
+        for (int i = 0; i < LEVELS; i++) {
+            Object[] a = new Object[WIDTH];
+            for (int j = 0; j < WIDTH; j++) {
+                a[j] = new Marker(j == WIDTH - 1 ? level : null);
+            }
+            level = a;
+        }
+        markers = level;
+        // Moves the markers into the old generation, in allocation order.
+        WB.fullGC();
+
+        if (args[0].equals("complete")) {
+            System.out.println("before: " + histogram());
+        } else {
+            WB.g1StartConcMarkCycle();
+            // Aborts the concurrent cycle if it is still running.
+            WB.fullGC();
+            while (WB.g1InConcurrentMark()) {
+                Thread.sleep(10);
+            }
+            System.out.println("aborted: " + histogram());
+        }
+
+        completeCycle();
+        System.out.println(histogram());
+        System.out.println("markers: " + markers.length);
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * @test
+ * @summary Classes preloaded with -XX:PreloadClassList are transformed by a
+ *          java agent, as the preload threads start after premain has run
+ * @library /test/lib /testlibrary/jvmti
+ * @modules java.instrument
+ * @build TransformerAgent TransformUtil
+ * @run driver TransformPreloadedClass
+ */
+
+import java.io.File;
+import java.io.FileOutputStream;
+import java.io.InputStream;
+import java.io.PrintWriter;
+import java.util.jar.Attributes;
+import java.util.jar.JarEntry;
+import java.util.jar.JarOutputStream;
+import java.util.jar.Manifest;
+
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+public class TransformPreloadedClass {
+    public static void main(String[] args) throws Exception {
+        String agentJar = createAgentJar();
+        File classList = new File("preload.classlist");
+        try (PrintWriter pw = new PrintWriter(classList)) {
+            pw.println("PreloadedClass");
+        }
+
+        OutputAnalyzer out = ProcessTools.executeTestJvm(
+            "-javaagent:" + agentJar + "=PreloadedClass",
+            "-XX:+UnlockExperimentalVMOptions",
+            "-XX:PreloadClassList=" + classList.getPath(),
+            "-Xlog:class+preload=info",
+            "-cp", System.getProperty("test.class.path"),
+            "PreloadedClassApp");
+        out.shouldHaveExitValue(0);
+        out.shouldContain("Preloaded 1 of 1 classes");
+        out.shouldContain("TransformerAgent: transforming: class name = PreloadedClass");
+        out.shouldContain("message: " + TransformUtil.AfterPattern);
+        out.shouldNotContain("message: " + TransformUtil.BeforePattern);
+    }
+
+    // The agent classes are written with the manifest that names the premain class.
+    private static String createAgentJar() throws Exception {
+        Manifest manifest = new Manifest();
+        Attributes attrs = manifest.getMainAttributes();
+        attrs.put(Attributes.Name.MANIFEST_VERSION, "1.0");
+        attrs.put(new Attributes.Name("Premain-Class"), "TransformerAgent");
+        attrs.put(new Attributes.Name("Can-Retransform-Classes"), "true");
+        String jar = "agent.jar";
+        try (JarOutputStream jos = new JarOutputStream(new FileOutputStream(jar), manifest)) {
+            String[] classes = { "TransformerAgent", "TransformerAgent$SimpleTransformer", "TransformUtil" };
+            for (String name : classes) {
+                jos.putNextEntry(new JarEntry(name + ".class"));
+                try (InputStream is = ClassLoader.getSystemResourceAsStream(name + ".class")) {
+                    is.transferTo(jos);
+                }
+                jos.closeEntry();
+            }
+        }
+        return jar;
+    }
+}
+
+class PreloadedClass {
+    static String message() {
+        return "this-should-be-transformed";
+    }
+}
+
+class PreloadedClassApp {
+    public static void main(String[] args) throws Exception {
+        // Only use the class once the preload threads are done, so it is
+        // loaded by them and not by the main thread.
+        while (preloadThreadsRunning()) {
+            Thread.sleep(10);
+        }
+        System.out.println("message: " + PreloadedClass.message());
+    }
+
+    private static boolean preloadThreadsRunning() {
+        for (Thread t : Thread.getAllStackTraces().keySet()) {
+            if (t.getName().startsWith("Class Preload Thread")) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
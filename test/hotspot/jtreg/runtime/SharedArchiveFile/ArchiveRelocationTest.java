@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * @test
+ * @summary The CDS archive is relocated, together with the compressed class
+ *          space, if its requested address is already taken
+ * @requires vm.cds
+ * @requires vm.bits == "64" & os.family != "windows"
+ * @library /test/lib
+ * @run driver ArchiveRelocationTest
+ */
+
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+public class ArchiveRelocationTest {
+    private static final String ARCHIVE = "ArchiveRelocationTest.jsa";
+    private static final String BASE = "0x800000000";
+
+    public static void main(String[] args) throws Exception {
+        OutputAnalyzer out = ProcessTools.executeTestJvm(
+            "-Xshare:dump",
+            "-XX:SharedArchiveFile=" + ARCHIVE,
+            "-XX:SharedBaseAddress=" + BASE);
+        out.shouldHaveExitValue(0);
+
+        // The Java heap is reserved first, and takes the requested address of the archive.
+        out = run("-XX:+UseCompressedOops", "-XX:HeapBaseMinAddress=" + BASE, "-Xmx256m");
+        out.shouldHaveExitValue(0);
+        out.shouldContain("trying to map at an alternative address");
+        out.shouldContain("Reserved class space at");
+        out.shouldMatch("Relocated archive by -?[0-9]+ bytes: patched [0-9]+ pointers");
+
+        // Always relocate.
+        out = run("-XX:ArchiveRelocationMode=1");
+        out.shouldHaveExitValue(0);
+        out.shouldContain("Reserved class space at");
+        out.shouldMatch("Relocated archive by -?[0-9]+ bytes");
+
+        // Never relocate: sharing is disabled if the address is taken.
+        out = ProcessTools.executeTestJvm(
+            "-Xshare:auto",
+            "-XX:SharedArchiveFile=" + ARCHIVE,
+            "-XX:+UnlockDiagnosticVMOptions",
+            "-XX:ArchiveRelocationMode=2",
+            "-XX:+UseCompressedOops", "-XX:HeapBaseMinAddress=" + BASE, "-Xmx256m",
+            "-Xlog:cds",
+            "-version");
+        out.shouldHaveExitValue(0);
+        out.shouldContain("Unable to reserve shared space at required address");
+        out.shouldNotContain("Relocated archive by");
+    }
+
+    // -Xshare:on fails if the archive cannot be mapped.
+    private static OutputAnalyzer run(String... opts) throws Exception {
+        String[] prefix = {
+            "-Xshare:on",
+            "-XX:SharedArchiveFile=" + ARCHIVE,
+            "-XX:+UnlockDiagnosticVMOptions",
+            "-XX:+VerifySharedSpaces",
+            "-Xlog:cds",
+        };
+        String[] cmd = new String[prefix.length + opts.length + 1];
+        System.arraycopy(prefix, 0, cmd, 0, prefix.length);
+        System.arraycopy(opts, 0, cmd, prefix.length, opts.length);
+        // Loads and links many shared classes.
+        cmd[cmd.length - 1] = "-version";
+        return ProcessTools.executeTestJvm(cmd);
+    }
+}
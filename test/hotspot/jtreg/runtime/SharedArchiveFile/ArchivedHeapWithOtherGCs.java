@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * @test
+ * @summary The archived heap objects dumped with G1 are loaded into the old
+ *          generation of the Serial, Parallel and Epsilon heaps, and survive
+ *          verified young and full GCs there
+ * @requires vm.cds.archived.java.heap
+ * @requires vm.gc == null
+ * @library /test/lib
+ * @run driver ArchivedHeapWithOtherGCs
+ */
+
+import java.util.ArrayList;
+import java.util.List;
+
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+public class ArchivedHeapWithOtherGCs {
+    private static final String ARCHIVE = "ArchivedHeapWithOtherGCs.jsa";
+
+    public static void main(String[] args) throws Exception {
+        OutputAnalyzer out = ProcessTools.executeTestJvm(
+            "-Xshare:dump",
+            "-XX:SharedArchiveFile=" + ARCHIVE,
+            "-XX:+UseG1GC",
+            "-Xlog:cds");
+        out.shouldHaveExitValue(0);
+
+        run("-XX:+UseSerialGC");
+        run("-XX:+UseParallelGC");
+        run("-XX:+UseParallelGC", "-XX:-UseParallelOldGC");
+        run("-XX:+UnlockExperimentalVMOptions", "-XX:+UseEpsilonGC");
+    }
+
+    private static void run(String... gcOpts) throws Exception {
+        List<String> cmd = new ArrayList<>();
+        cmd.add("-Xshare:on");
+        cmd.add("-XX:SharedArchiveFile=" + ARCHIVE);
+        cmd.add("-Xmx128m");
+        cmd.add("-Xmn8m");
+        cmd.add("-XX:+UnlockDiagnosticVMOptions");
+        cmd.add("-XX:+VerifySharedSpaces");
+        // Heap verification checks the block offset table or the object start
+        // array of the old generation for every object.
+        cmd.add("-XX:+VerifyBeforeGC");
+        cmd.add("-XX:+VerifyAfterGC");
+        cmd.add("-Xlog:cds");
+        for (String opt : gcOpts) {
+            cmd.add(opt);
+        }
+        cmd.add(ArchivedHeapApp.class.getName());
+        OutputAnalyzer out = ProcessTools.executeTestJvm(cmd.toArray(new String[0]));
+        out.shouldHaveExitValue(0);
+        out.shouldMatch("Loaded [0-9]+ bytes of heap data at");
+        out.shouldNotContain("CDS heap data is being ignored");
+        out.shouldContain("ArchivedHeapApp: done");
+    }
+}
+
+class ArchivedHeapApp {
+    static final boolean EPSILON = hasFlag("-XX:+UseEpsilonGC");
+
+    public static void main(String[] args) throws Exception {
+        // Archived strings are returned by intern().
+        String s = new String("java.lang.Object");
+        if (s.intern() != "java.lang.Object") {
+            throw new RuntimeException("interned string is not unique");
+        }
+        if (Integer.valueOf(100) != Integer.valueOf(100)) {
+            throw new RuntimeException("Integer cache is broken");
+        }
+
+        // Store young objects into archived mirrors (the reflection data of
+        // shared classes), so that young GCs scan cards of the loaded block.
+        Class<?>[] classes = { Object.class, String.class, Integer.class, Thread.class,
+                               ClassLoader.class, Class.class, List.class, ArrayList.class };
+        List<Object> live = new ArrayList<>();
+        int rounds = EPSILON ? 1 : 20;
+        for (int i = 0; i < rounds; i++) {
+            for (Class<?> c : classes) {
+                live.add(c.getDeclaredMethods());
+                live.add(c.getDeclaredFields());
+            }
+            for (int j = 0; j < 10_000; j++) {
+                live.add(new int[16]);
+                if (live.size() > 50_000) {
+                    live.clear();
+                }
+            }
+            if (!EPSILON && i % 5 == 0) {
+                System.gc();
+            }
+        }
+
+        if (s.intern() != "java.lang.Object") {
+            throw new RuntimeException("interned string moved after GC");
+        }
+        System.out.println("ArchivedHeapApp: done");
+    }
+
+    static boolean hasFlag(String flag) {
+        return java.lang.management.ManagementFactory.getRuntimeMXBean()
+            .getInputArguments().contains(flag);
+    }
+}
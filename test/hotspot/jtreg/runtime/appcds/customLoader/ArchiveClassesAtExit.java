@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * @test
+ * @summary -XX:ArchiveClassesAtExit writes an archive of the classes of the app
+ *          and of custom loaders at exit, which the next run maps. Shell
+ *          metacharacters in the archive name are not interpreted, and the
+ *          boot class path append is passed to the dump VM.
+ * @requires vm.cds
+ * @requires (os.family == "linux" | os.family == "solaris") & vm.bits == "64"
+ * @library /test/lib test-classes
+ * @build CustomLoaderApp CustomLoadee CustomInterface
+ * @run driver ClassFileInstaller -jar app.jar CustomLoaderApp
+ * @run driver ClassFileInstaller -jar custom.jar CustomLoadee CustomInterface
+ * @run driver ArchiveClassesAtExit
+ */
+
+import java.io.File;
+
+import jdk.test.lib.Asserts;
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+public class ArchiveClassesAtExit {
+    public static void main(String[] args) throws Exception {
+        String appJar = ClassFileInstaller.getJarPath("app.jar");
+        String customJar = ClassFileInstaller.getJarPath("custom.jar");
+        String archive = "app-at-exit.jsa";
+
+        OutputAnalyzer out = ProcessTools.executeTestJvm(
+            "-XX:ArchiveClassesAtExit=" + archive,
+            "-Xlog:cds",
+            "-cp", appJar, "CustomLoaderApp", customJar);
+        out.shouldHaveExitValue(0);
+        out.shouldContain("Wrote CDS archive " + archive);
+        Asserts.assertTrue(new File(archive).isFile(), "Archive was not written");
+        Asserts.assertTrue(new File(archive + ".classlist").isFile(), "Class list was not written");
+
+        out = ProcessTools.executeTestJvm(
+            "-XX:SharedArchiveFile=" + archive,
+            "-Xshare:on",
+            "-Xlog:class+load=info",
+            "-cp", appJar, "CustomLoaderApp", customJar);
+        out.shouldHaveExitValue(0);
+        out.shouldContain("CustomLoaderApp source: shared objects file");
+        out.shouldContain("CustomInterface source: shared objects file");
+        out.shouldContain("CustomLoadee source: shared objects file");
+
+        // The dump VM inherits the options from the environment, it must not archive at exit itself.
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(true, "-cp", appJar, "CustomLoaderApp", customJar);
+        pb.environment().put("JAVA_TOOL_OPTIONS", "-XX:ArchiveClassesAtExit=env-" + archive);
+        out = new OutputAnalyzer(pb.start());
+        out.shouldHaveExitValue(0);
+        out = ProcessTools.executeTestJvm(
+            "-XX:SharedArchiveFile=env-" + archive,
+            "-Xshare:on",
+            "-Xlog:class+load=info",
+            "-cp", appJar, "CustomLoaderApp", customJar);
+        out.shouldHaveExitValue(0);
+        out.shouldContain("CustomLoadee source: shared objects file");
+
+        // The archive name reaches the dump VM unchanged and runs no command.
+        File injected = new File("injected");
+        String quoted = "app\"$(touch injected)`touch injected`';touch injected;'.jsa";
+        out = ProcessTools.executeTestJvm(
+            "-XX:ArchiveClassesAtExit=" + quoted,
+            "-Xlog:cds",
+            "-cp", appJar, "CustomLoaderApp", customJar);
+        out.shouldHaveExitValue(0);
+        out.shouldContain("Wrote CDS archive " + quoted);
+        Asserts.assertTrue(new File(quoted).isFile(), "Archive was not written");
+        Asserts.assertFalse(injected.exists(), "Shell command in the archive name was run");
+
+        // Classes from -Xbootclasspath/a are archived by a dump VM with the same append.
+        String bootArchive = "boot-at-exit.jsa";
+        out = ProcessTools.executeTestJvm(
+            "-XX:ArchiveClassesAtExit=" + bootArchive,
+            "-Xlog:cds",
+            "-Xbootclasspath/a:" + appJar,
+            "CustomLoaderApp", customJar);
+        out.shouldHaveExitValue(0);
+        out.shouldContain("Wrote CDS archive " + bootArchive);
+        out = ProcessTools.executeTestJvm(
+            "-XX:SharedArchiveFile=" + bootArchive,
+            "-Xshare:on",
+            "-Xlog:class+load=info",
+            "-Xbootclasspath/a:" + appJar,
+            "CustomLoaderApp", customJar);
+        out.shouldHaveExitValue(0);
+        out.shouldContain("CustomLoaderApp source: shared objects file");
+    }
+}
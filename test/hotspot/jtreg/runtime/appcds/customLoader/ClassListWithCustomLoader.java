@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * @test
+ * @summary -XX:DumpLoadedClassList writes the classes of custom class loaders
+ *          with id, super, interfaces and source, in a form -Xshare:dump accepts
+ * @requires vm.cds
+ * @requires (os.family == "linux" | os.family == "solaris") & vm.bits == "64"
+ * @library /test/lib test-classes
+ * @build CustomLoaderApp CustomLoadee CustomInterface
+ * @run driver ClassFileInstaller -jar app.jar CustomLoaderApp
+ * @run driver ClassFileInstaller -jar custom.jar CustomLoadee CustomInterface
+ * @run driver ClassListWithCustomLoader
+ */
+
+import java.io.File;
+import java.nio.file.Files;
+import java.nio.file.Paths;
+import java.util.HashMap;
+import java.util.HashSet;
+import java.util.List;
+import java.util.Map;
+import java.util.Set;
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+import jdk.test.lib.Asserts;
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+public class ClassListWithCustomLoader {
+    private static final Pattern ENTRY = Pattern.compile("(\\S+) id: (\\d+)(.*)");
+
+    public static void main(String[] args) throws Exception {
+        String appJar = ClassFileInstaller.getJarPath("app.jar");
+        String customJar = ClassFileInstaller.getJarPath("custom.jar");
+        String classList = "custom-loader.classlist";
+
+        OutputAnalyzer out = ProcessTools.executeTestJvm(
+            "-XX:DumpLoadedClassList=" + classList,
+            "-cp", appJar, "CustomLoaderApp", customJar);
+        out.shouldHaveExitValue(0);
+
+        Map<String, Integer> ids = new HashMap<>();
+        Map<String, String> rest = new HashMap<>();
+        Set<Integer> seen = new HashSet<>();
+        List<String> lines = Files.readAllLines(Paths.get(classList));
+        for (String line : lines) {
+            Matcher m = ENTRY.matcher(line);
+            Asserts.assertTrue(m.matches(), "Class list entry without id: " + line);
+            int id = Integer.parseInt(m.group(2));
+            Asserts.assertTrue(seen.add(id), "Duplicate id in: " + line);
+            // Only the first entry counts, ClassListParser rejects later ones.
+            if (!ids.containsKey(m.group(1))) {
+                ids.put(m.group(1), id);
+                rest.put(m.group(1), m.group(3));
+            }
+        }
+
+        Asserts.assertTrue(ids.containsKey("CustomLoaderApp"), "Class of the app loader is missing");
+        Asserts.assertEquals("", rest.get("CustomLoaderApp"), "App loader classes have no source");
+        Integer object = ids.get("java/lang/Object");
+        Asserts.assertNotNull(object, "java/lang/Object is missing");
+
+        String source = new File(customJar).getAbsolutePath();
+        Asserts.assertEquals(" super: " + object + " source: " + source, rest.get("CustomInterface"));
+        Asserts.assertEquals(" super: " + object + " interfaces: " + ids.get("CustomInterface") + " source: " + source,
+                             rest.get("CustomLoadee"));
+        // The super class and interfaces must be listed before the class.
+        Asserts.assertLT(lines.indexOf("CustomInterface id: " + ids.get("CustomInterface") + rest.get("CustomInterface")),
+                         lines.indexOf("CustomLoadee id: " + ids.get("CustomLoadee") + rest.get("CustomLoadee")));
+
+        out = ProcessTools.executeTestJvm(
+            "-Xshare:dump",
+            "-XX:SharedClassListFile=" + classList,
+            "-XX:SharedArchiveFile=custom-loader.jsa",
+            "-cp", appJar);
+        out.shouldHaveExitValue(0);
+        out.shouldNotContain("Preload Warning");
+    }
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+import java.io.File;
+import java.net.URL;
+import java.net.URLClassLoader;
+
+// Loads CustomLoadee and CustomInterface from the jar file or directory
+// given as argument, with a URLClassLoader. Neither class is on the class
+// path of the application, so both are defined by the custom loader.
+public class CustomLoaderApp {
+    public static void main(String[] args) throws Exception {
+        URL url = new File(args[0]).toURI().toURL();
+        try (URLClassLoader loader = new URLClassLoader(new URL[] { url }, CustomLoaderApp.class.getClassLoader())) {
+            Class<?> c = loader.loadClass("CustomLoadee");
+            if (c.getClassLoader() != loader) {
+                throw new RuntimeException("CustomLoadee must be defined by the custom loader, not " + c.getClassLoader());
+            }
+            Object o = c.getDeclaredConstructor().newInstance();
+            System.out.println(c.getMethod("hello").invoke(o));
+        }
+    }
+}
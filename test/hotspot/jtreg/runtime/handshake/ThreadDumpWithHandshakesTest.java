@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * @test ThreadDumpWithHandshakesTest
+ * @summary Thread dumps report the same lock owners, locked monitors and
+ *          locked synchronizers with and without ThreadDumpWithHandshakes
+ * @library /test/lib
+ * @modules java.management
+ * @run main/othervm ThreadDumpWithHandshakesTest
+ * @run main/othervm -XX:+ThreadDumpWithHandshakes ThreadDumpWithHandshakesTest
+ * @run main/othervm -XX:-ThreadDumpWithHandshakes ThreadDumpWithHandshakesTest
+ */
+
+import java.lang.management.LockInfo;
+import java.lang.management.ManagementFactory;
+import java.lang.management.MonitorInfo;
+import java.lang.management.ThreadInfo;
+import java.lang.management.ThreadMXBean;
+import java.util.Map;
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.locks.ReentrantLock;
+
+import jdk.test.lib.Asserts;
+
+public class ThreadDumpWithHandshakesTest {
+    static final Object monitor = new Object();
+    static final ReentrantLock lock = new ReentrantLock();
+    static final CountDownLatch locked = new CountDownLatch(1);
+    static final CountDownLatch release = new CountDownLatch(1);
+    static volatile boolean done;
+
+    static final ThreadMXBean mbean = ManagementFactory.getThreadMXBean();
+
+    // Holds the monitor and the lock until released.
+    static void holdLocks() {
+        synchronized (monitor) {
+            lock.lock();
+            try {
+                locked.countDown();
+                release.await();
+            } catch (InterruptedException e) {
+                throw new Error(e);
+            } finally {
+                lock.unlock();
+            }
+        }
+    }
+
+    static void enterMonitor() {
+        synchronized (monitor) {
+        }
+    }
+
+    // Keeps running with a locked monitor, so it takes its own snapshot at a handshake poll.
+    static void spin() {
+        Object spinLock = new Object();
+        while (!done) {
+            synchronized (spinLock) {
+                Thread.onSpinWait();
+            }
+        }
+    }
+
+    public static void main(String[] args) throws Exception {
+        Thread owner = new Thread(ThreadDumpWithHandshakesTest::holdLocks, "owner");
+        Thread blocked = new Thread(ThreadDumpWithHandshakesTest::enterMonitor, "blocked");
+        Thread spinner = new Thread(ThreadDumpWithHandshakesTest::spin, "spinner");
+        Thread dead = new Thread(() -> {}, "dead");
+        dead.start();
+        dead.join();
+
+        owner.start();
+        locked.await();
+        blocked.start();
+        while (blocked.getState() != Thread.State.BLOCKED) {
+            Thread.sleep(10);
+        }
+        spinner.start();
+
+        try {
+            for (int i = 0; i < 20; i++) {
+                checkDumpAllThreads(owner, blocked, spinner);
+                checkGetThreadInfo(owner, blocked, dead);
+                checkStackTraces(owner, blocked);
+            }
+        } finally {
+            done = true;
+            release.countDown();
+            owner.join();
+            blocked.join();
+            spinner.join();
+        }
+    }
+
+    static ThreadInfo find(ThreadInfo[] infos, Thread t) {
+        ThreadInfo found = null;
+        for (ThreadInfo info : infos) {
+            if (info != null && info.getThreadId() == t.getId()) {
+                Asserts.assertNull(found, "Thread " + t.getName() + " dumped twice");
+                found = info;
+            }
+        }
+        Asserts.assertNotNull(found, "Thread " + t.getName() + " not dumped");
+        return found;
+    }
+
+    static void checkOwner(ThreadInfo info) {
+        MonitorInfo[] monitors = info.getLockedMonitors();
+        Asserts.assertEquals(1, monitors.length, "Locked monitors of owner: " + info);
+        Asserts.assertEquals(System.identityHashCode(monitor), monitors[0].getIdentityHashCode());
+        Asserts.assertEquals("holdLocks", monitors[0].getLockedStackFrame().getMethodName());
+
+        LockInfo[] synchronizers = info.getLockedSynchronizers();
+        Asserts.assertEquals(1, synchronizers.length, "Locked synchronizers of owner: " + info);
+        Asserts.assertTrue(synchronizers[0].getClassName().startsWith(ReentrantLock.class.getName()),
+                           "Wrong synchronizer " + synchronizers[0]);
+    }
+
+    static void checkBlocked(ThreadInfo info, Thread owner) {
+        Asserts.assertEquals(Thread.State.BLOCKED, info.getThreadState());
+        Asserts.assertEquals(System.identityHashCode(monitor), info.getLockInfo().getIdentityHashCode());
+        Asserts.assertEquals(owner.getId(), info.getLockOwnerId());
+        Asserts.assertEquals(owner.getName(), info.getLockOwnerName());
+        Asserts.assertEquals(0, info.getLockedMonitors().length, "Locked monitors of blocked: " + info);
+    }
+
+    static void checkDumpAllThreads(Thread owner, Thread blocked, Thread spinner) {
+        ThreadInfo[] infos = mbean.dumpAllThreads(true, true);
+        checkOwner(find(infos, owner));
+        checkBlocked(find(infos, blocked), owner);
+        // The running thread is dumped exactly once, whichever thread takes its snapshot.
+        ThreadInfo spin = find(infos, spinner);
+        Asserts.assertTrue(spin.getLockedMonitors().length <= 1, "Locked monitors of spinner: " + spin);
+    }
+
+    static void checkGetThreadInfo(Thread owner, Thread blocked, Thread dead) {
+        long[] ids = new long[] { owner.getId(), blocked.getId(), owner.getId(), dead.getId(), blocked.getId() };
+        ThreadInfo[] infos = mbean.getThreadInfo(ids, true, true);
+        Asserts.assertEquals(ids.length, infos.length);
+        // Each occurrence of a thread id gets a complete snapshot.
+        checkOwner(infos[0]);
+        checkOwner(infos[2]);
+        checkBlocked(infos[1], owner);
+        checkBlocked(infos[4], owner);
+        Asserts.assertNull(infos[3], "Terminated thread dumped");
+
+        infos = mbean.getThreadInfo(ids, Integer.MAX_VALUE);
+        Asserts.assertEquals(ids.length, infos.length);
+        Asserts.assertEquals(owner.getId(), infos[2].getThreadId());
+        Asserts.assertEquals(owner.getId(), infos[1].getLockOwnerId());
+        Asserts.assertNull(infos[3], "Terminated thread dumped");
+    }
+
+    static void checkStackTraces(Thread owner, Thread blocked) {
+        Map<Thread, StackTraceElement[]> traces = Thread.getAllStackTraces();
+        Asserts.assertTrue(hasFrame(traces.get(owner), "holdLocks"), "No holdLocks frame");
+        Asserts.assertTrue(hasFrame(traces.get(blocked), "enterMonitor"), "No enterMonitor frame");
+    }
+
+    static boolean hasFrame(StackTraceElement[] trace, String method) {
+        Asserts.assertNotNull(trace);
+        for (StackTraceElement e : trace) {
+            if (e.getMethodName().equals(method)) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
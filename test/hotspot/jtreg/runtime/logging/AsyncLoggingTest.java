@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * @test
+ * @summary -Xlog:async writes the same messages as synchronous logging,
+ *          rotates its files, reports dropped messages, and survives the
+ *          deletion of an output that is being written to
+ * @library /test/lib
+ * @modules java.management
+ * @run driver AsyncLoggingTest
+ */
+
+import java.io.File;
+import java.lang.management.ManagementFactory;
+import java.nio.file.Files;
+import java.nio.file.Paths;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.TreeSet;
+import javax.management.ObjectName;
+
+import jdk.test.lib.Asserts;
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+public class AsyncLoggingTest {
+    private static final String DROPPED = "[0-9]+ messages dropped due to async logging";
+
+    public static void main(String[] args) throws Exception {
+        testContents();
+        testRotation();
+        testDropped();
+        testDisable();
+    }
+
+    private static OutputAnalyzer run(String... opts) throws Exception {
+        List<String> cmd = new ArrayList<>();
+        for (String opt : opts) {
+            cmd.add(opt);
+        }
+        cmd.add(AsyncLogApp.class.getName());
+        OutputAnalyzer out = ProcessTools.executeProcess(
+            ProcessTools.createJavaProcessBuilder(cmd.toArray(new String[0])));
+        out.shouldHaveExitValue(0);
+        out.shouldContain("AsyncLogApp: done");
+        return out;
+    }
+
+    private static List<String> lines(String file) throws Exception {
+        return Files.readAllLines(Paths.get(file));
+    }
+
+    // The same class loading messages are logged with and without -Xlog:async.
+    private static void testContents() throws Exception {
+        run("-Xlog:class+load=info:file=sync.log:none");
+        run("-Xlog:async", "-Xlog:class+load=info:file=async.log:none");
+        TreeSet<String> sync = new TreeSet<>(lines("sync.log"));
+        TreeSet<String> async = new TreeSet<>(lines("async.log"));
+        Asserts.assertGT(sync.size(), 100, "too few classes loaded");
+        Asserts.assertTrue(async.stream().anyMatch(l -> l.startsWith("AsyncLogApp ")),
+                           "AsyncLogApp is not logged");
+        // Apart from classes loaded by racing threads, the sets must agree.
+        TreeSet<String> missing = new TreeSet<>(sync);
+        missing.removeAll(async);
+        Asserts.assertLT(missing.size(), 10, "messages missing with -Xlog:async: " + missing);
+        for (String line : lines("async.log")) {
+            Asserts.assertFalse(line.matches(DROPPED), "unexpected dropped messages: " + line);
+        }
+    }
+
+    // Rotated files are created, and none of them is much bigger than the
+    // size limit.
+    private static void testRotation() throws Exception {
+        run("-Xlog:async", "-Xlog:all=debug:file=rotate.log::filecount=3,filesize=32k");
+        Asserts.assertTrue(new File("rotate.log").exists(), "rotate.log does not exist");
+        Asserts.assertTrue(new File("rotate.log.0").exists(), "rotate.log.0 does not exist");
+        Asserts.assertTrue(new File("rotate.log.1").exists(), "rotate.log.1 does not exist");
+        Asserts.assertFalse(new File("rotate.log.3").exists(), "more than filecount files");
+        for (String name : new String[] { "rotate.log", "rotate.log.0", "rotate.log.1", "rotate.log.2" }) {
+            File f = new File(name);
+            if (f.exists()) {
+                Asserts.assertLT(f.length(), 64L * 1024, name + " is too big");
+            }
+        }
+    }
+
+    // With the smallest buffer, trace logging of everything drops messages,
+    // and the count is reported in the log file.
+    private static void testDropped() throws Exception {
+        run("-Xlog:async", "-XX:AsyncLogBufferSize=100k", "-Xlog:all=trace:file=dropped.log");
+        boolean found = false;
+        for (String line : lines("dropped.log")) {
+            if (line.matches(".*\\[logging *\\] " + DROPPED)) {
+                found = true;
+                break;
+            }
+        }
+        Asserts.assertTrue(found, "no dropped messages reported in dropped.log");
+    }
+
+    // The output is deleted by VM.log disable while messages to it are
+    // being dropped and buffered.
+    private static void testDisable() throws Exception {
+        run("-Xlog:async", "-XX:AsyncLogBufferSize=100k", "-Xlog:all=trace:file=disable.log",
+            "-Dasync.disable=true");
+        List<String> lines = lines("disable.log");
+        Asserts.assertFalse(lines.isEmpty(), "disable.log is empty");
+    }
+}
+
+class AsyncLogApp {
+    public static void main(String[] args) throws Exception {
+        List<Object> garbage = new ArrayList<>();
+        for (int i = 0; i < 5; i++) {
+            for (int j = 0; j < 100_000; j++) {
+                garbage.add(new int[8]);
+            }
+            garbage.clear();
+            System.gc();
+        }
+        if (Boolean.getBoolean("async.disable")) {
+            ManagementFactory.getPlatformMBeanServer().invoke(
+                new ObjectName("com.sun.management:type=DiagnosticCommand"),
+                "vmLog",
+                new Object[] { new String[] { "disable" } },
+                new String[] { String[].class.getName() });
+            System.gc();
+        }
+        System.out.println("AsyncLogApp: done");
+    }
+}
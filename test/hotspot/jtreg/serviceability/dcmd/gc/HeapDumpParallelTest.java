@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+import java.io.File;
+import java.nio.file.Files;
+import java.nio.file.Paths;
+import java.util.List;
+
+import jdk.test.lib.Asserts;
+import jdk.test.lib.dcmd.PidJcmdExecutor;
+import jdk.test.lib.hprof.HprofParser;
+import jdk.test.lib.hprof.model.JavaClass;
+import jdk.test.lib.hprof.model.Snapshot;
+import jdk.test.lib.hprof.parser.Reader;
+import jdk.test.lib.process.OutputAnalyzer;
+
+/*
+ * @test
+ * @summary Test of diagnostic command GC.heap_dump -parallel
+ * @library /test/lib
+ * @requires vm.gc.G1
+ * @modules java.base/jdk.internal.misc
+ *          java.compiler
+ *          java.management
+ *          jdk.internal.jvmstat/sun.jvmstat.monitor
+ * @run main/othervm -XX:+UseG1GC -XX:ParallelGCThreads=4 HeapDumpParallelTest
+ */
+public class HeapDumpParallelTest {
+
+    static class Marker {
+        final int value;
+
+        Marker(int value) {
+            this.value = value;
+        }
+    }
+
+    static final int MARKER_COUNT = 100_000;
+
+    // Spread over the heap regions, so all dump threads get some.
+    static Object[] markers;
+
+    public static void main(String[] args) throws Exception {
+        markers = new Object[MARKER_COUNT];
+        for (int i = 0; i < MARKER_COUNT; i++) {
+            markers[i] = new Marker(i);
+        }
+
+        test("hprof", "");
+        test("hprof.gz", "-gz=1");
+    }
+
+    private static void test(String suffix, String options) throws Exception {
+        File dir = Files.createTempDirectory(Paths.get("."), "dump").toFile();
+        File dump = new File(dir, "parallel." + suffix);
+
+        OutputAnalyzer output = new PidJcmdExecutor().execute(
+                "GC.heap_dump -parallel=4 " + options + " " + dump.getAbsolutePath());
+        output.shouldContain("Heap dump file created");
+        Asserts.assertTrue(dump.exists(), "No dump file");
+
+        // The segment files are merged into the dump and removed.
+        String[] files = dir.list();
+        Asserts.assertEquals(1, files.length, "Segment files left: " + List.of(files));
+
+        // Throws if the dump can not be parsed.
+        HprofParser.parse(dump);
+
+        // The objects written by all dump threads are in the dump exactly once.
+        Snapshot snapshot = Reader.readFile(dump.getAbsolutePath(), true, 0);
+        try {
+            snapshot.resolve(true);
+            JavaClass cls = snapshot.findClass(Marker.class.getName());
+            Asserts.assertNotNull(cls, "Class " + Marker.class.getName() + " not in dump");
+            Asserts.assertEquals(MARKER_COUNT, cls.getInstancesCount(false), "Wrong instance count");
+        } finally {
+            snapshot.closeFile();
+        }
+
+        dump.delete();
+        dir.delete();
+    }
+}
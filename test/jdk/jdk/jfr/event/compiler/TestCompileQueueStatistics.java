@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+package jdk.jfr.event.compiler;
+
+import java.lang.reflect.Method;
+import java.util.List;
+import java.util.function.BooleanSupplier;
+import java.util.stream.Collectors;
+
+import jdk.jfr.Recording;
+import jdk.jfr.consumer.RecordedEvent;
+import jdk.test.lib.Asserts;
+import jdk.test.lib.jfr.Events;
+import sun.hotspot.WhiteBox;
+
+/*
+ * @test
+ * @summary CompileQueueStatistics reports the tasks added to, selected from
+ *          and removed as stale from the C1 compile queue, and their wait times
+ * @key jfr
+ * @requires vm.hasJFR
+ * @requires vm.compiler1.enabled & vm.compiler2.enabled & vm.flavor == "server" & !vm.emulatedClient
+ * @library /test/lib /
+ * @build sun.hotspot.WhiteBox
+ * @run driver ClassFileInstaller sun.hotspot.WhiteBox
+ *                                sun.hotspot.WhiteBox$WhiteBoxPermission
+ * @run main/othervm -Xbootclasspath/a:. -XX:+UnlockDiagnosticVMOptions -XX:+WhiteBoxAPI
+ *                   -XX:+TieredCompilation -XX:CICompilerCount=2
+ *                   -XX:-UseDynamicNumberOfCompilerThreads -XX:GuaranteedSafepointInterval=0
+ *                   -XX:CompileCommand=quiet
+ *                   -XX:CompileCommand=compileonly,jdk.jfr.event.compiler.TestCompileQueueStatistics::work*
+ *                   jdk.jfr.event.compiler.TestCompileQueueStatistics
+ */
+public class TestCompileQueueStatistics {
+    private static final String EVENT_NAME = "jdk.CompileQueueStatistics";
+    private static final WhiteBox WB = WhiteBox.getWhiteBox();
+    private static final int COMP_LEVEL_SIMPLE = 1;
+    // Longer than TieredCompileTaskTimeout.
+    private static final long WAIT_MILLIS = 300;
+
+    private static volatile int sink;
+
+    static int workBlocker(int x) { return x * 31 + 1; }
+    static int workWaiter(int x)  { return x * 31 + 2; }
+    static int workStale(int x)   { return x * 31 + 3; }
+
+    public static void main(String[] args) throws Throwable {
+        Method blocker = TestCompileQueueStatistics.class.getDeclaredMethod("workBlocker", int.class);
+        Method waiter = TestCompileQueueStatistics.class.getDeclaredMethod("workWaiter", int.class);
+        Method stale = TestCompileQueueStatistics.class.getDeclaredMethod("workStale", int.class);
+
+        // Keep the only C1 compiler thread busy with the first task, so that
+        // the next ones wait in the queue.
+        WB.lockCompilation();
+        WB.enqueueMethodForCompilation(blocker, COMP_LEVEL_SIMPLE);
+        waitFor(() -> WB.getCompileQueueSize(COMP_LEVEL_SIMPLE) == 0);
+
+        WB.enqueueMethodForCompilation(waiter, COMP_LEVEL_SIMPLE);
+        // Run the method until the policy queues it, then stop, so that its
+        // task is found stale.
+        for (int i = 0; !WB.isMethodQueuedForCompilation(stale); i++) {
+            Asserts.assertLessThan(i, 1_000_000, "stale method was not queued");
+            sink += workStale(i);
+        }
+        Thread.sleep(WAIT_MILLIS);
+        WB.unlockCompilation();
+        waitFor(() -> WB.isMethodCompiled(blocker) && WB.isMethodCompiled(waiter)
+                      && !WB.isMethodQueuedForCompilation(stale));
+        Asserts.assertFalse(WB.isMethodCompiled(stale), "stale task was compiled");
+
+        // The statistics are emitted at the end of the chunk.
+        Recording recording = new Recording();
+        recording.enable(EVENT_NAME);
+        recording.start();
+        recording.stop();
+
+        List<RecordedEvent> events = Events.fromRecording(recording).stream()
+            .filter(e -> e.getEventType().getName().equals(EVENT_NAME))
+            .collect(Collectors.toList());
+        Asserts.assertFalse(events.isEmpty(), "no " + EVENT_NAME + " events");
+        boolean foundC1 = false;
+        for (RecordedEvent event : events) {
+            System.out.println(event);
+            int size = event.getInt("size");
+            int peakSize = event.getInt("peakSize");
+            long added = event.getLong("addedCount");
+            long selected = event.getLong("selectedCount");
+            long staleCount = event.getLong("staleCount");
+            long totalWait = event.getLong("totalWaitTime");
+            long peakWait = event.getLong("peakWaitTime");
+            Asserts.assertGreaterThanOrEqual(peakSize, size);
+            Asserts.assertEquals(added, selected + staleCount + size, "tasks lost by the queue");
+            Asserts.assertGreaterThanOrEqual(totalWait, peakWait);
+            Asserts.assertGreaterThanOrEqual(peakWait, 0L);
+
+            if (event.getString("queue").equals("C1 compile queue")) {
+                foundC1 = true;
+                // The waiter and the stale task were in the queue together.
+                Asserts.assertGreaterThanOrEqual(peakSize, 2);
+                Asserts.assertGreaterThanOrEqual(added, 3L);
+                Asserts.assertGreaterThanOrEqual(selected, 2L);
+                Asserts.assertGreaterThanOrEqual(staleCount, 1L);
+                Asserts.assertGreaterThanOrEqual(peakWait, WAIT_MILLIS - 50);
+            }
+        }
+        Asserts.assertTrue(foundC1, "no event for the C1 compile queue");
+        recording.close();
+    }
+
+    private static void waitFor(BooleanSupplier condition) throws InterruptedException {
+        while (!condition.getAsBoolean()) {
+            Thread.sleep(10);
+        }
+    }
+}
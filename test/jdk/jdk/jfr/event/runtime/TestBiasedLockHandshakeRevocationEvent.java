@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+package jdk.jfr.event.runtime;
+
+import java.util.List;
+import java.util.concurrent.CountDownLatch;
+import java.util.stream.Collectors;
+
+import jdk.jfr.Recording;
+import jdk.jfr.consumer.RecordedEvent;
+import jdk.test.lib.Asserts;
+import jdk.test.lib.jfr.Events;
+
+/*
+ * @test
+ * @summary Locking objects biased toward another running thread revokes
+ *          the biases with a handshake with that thread, not at a safepoint,
+ *          and reports each revocation with a BiasedLockHandshakeRevocation event
+ * @key jfr
+ * @requires vm.hasJFR
+ * @library /test/lib
+ * @run main/othervm -XX:+UseBiasedLocking -XX:BiasedLockingStartupDelay=0
+ *                   jdk.jfr.event.runtime.TestBiasedLockHandshakeRevocationEvent
+ */
+public class TestBiasedLockHandshakeRevocationEvent {
+    private static final String HANDSHAKE_REVOCATION = "jdk.BiasedLockHandshakeRevocation";
+    private static final String SAFEPOINT_REVOCATION = "jdk.BiasedLockRevocation";
+    private static final String OWNER_NAME = "BiasOwner";
+    // Less than BiasedLockingBulkRebiasThreshold, so no bulk rebias happens.
+    private static final int LOCKS = 10;
+
+    static class MyLock {
+    }
+
+    public static void main(String[] args) throws Throwable {
+        Recording recording = new Recording();
+        recording.enable(HANDSHAKE_REVOCATION);
+        recording.enable(SAFEPOINT_REVOCATION);
+        recording.start();
+
+        MyLock[] locks = new MyLock[LOCKS];
+        for (int i = 0; i < LOCKS; i++) {
+            locks[i] = new MyLock();
+        }
+        CountDownLatch biased = new CountDownLatch(1);
+        CountDownLatch release = new CountDownLatch(1);
+        Thread owner = new Thread(() -> {
+            for (MyLock lock : locks) {
+                synchronized (lock) {
+                }
+            }
+            biased.countDown();
+            try {
+                release.await();
+            } catch (InterruptedException e) {
+                throw new RuntimeException(e);
+            }
+        }, OWNER_NAME);
+        owner.start();
+        biased.await();
+
+        // The owner is still running, so each bias is revoked with a handshake.
+        for (MyLock lock : locks) {
+            synchronized (lock) {
+            }
+        }
+        release.countDown();
+        owner.join();
+        recording.stop();
+
+        String lockClass = MyLock.class.getName();
+        List<RecordedEvent> events = Events.fromRecording(recording).stream()
+            .filter(e -> e.getClass("lockClass").getName().equals(lockClass))
+            .collect(Collectors.toList());
+        int revoked = 0;
+        for (RecordedEvent event : events) {
+            System.out.println(event);
+            Asserts.assertEquals(event.getEventType().getName(), HANDSHAKE_REVOCATION,
+                                 "bias revoked at a safepoint");
+            Asserts.assertEquals(event.getThread("previousOwner").getJavaName(), OWNER_NAME);
+            Asserts.assertGreaterThan(event.getInt("revokedCount"), 0);
+            revoked += event.getInt("revokedCount");
+        }
+        Asserts.assertEquals(revoked, LOCKS, "biases revoked with handshakes");
+        recording.close();
+    }
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+package jdk.jfr.event.sampling;
+
+import java.time.Duration;
+import java.time.Instant;
+import java.util.HashMap;
+import java.util.HashSet;
+import java.util.List;
+import java.util.Map;
+import java.util.Set;
+import java.util.concurrent.CountDownLatch;
+
+import jdk.internal.misc.Signal;
+import jdk.jfr.Recording;
+import jdk.jfr.consumer.RecordedEvent;
+import jdk.jfr.consumer.RecordedThread;
+import jdk.test.lib.jfr.EventNames;
+import jdk.test.lib.jfr.Events;
+import jdk.test.lib.process.OutputAnalyzer;
+import jdk.test.lib.process.ProcessTools;
+
+/*
+ * @test
+ * @summary Sampling by CPU time samples more busy threads per period than
+ *          the wall clock sampler, and falls back to it when SIGPROF is in use
+ * @key jfr
+ * @requires vm.hasJFR & os.family == "linux"
+ * @library /test/lib
+ * @modules java.base/jdk.internal.misc
+ * @run driver jdk.jfr.event.sampling.TestCPUTimeSampling
+ */
+public class TestCPUTimeSampling {
+    private static final int BUSY_THREADS = 12;
+    private static final long PERIOD_MILLIS = 20;
+    private static final long RECORDING_MILLIS = 3_000;
+    // The wall clock sampler takes at most this many Java samples per period
+    private static final int WALL_CLOCK_LIMIT = 5;
+
+    public static void main(String[] args) throws Exception {
+        if (args.length > 0) {
+            record(args[0].equals("sigprof"));
+            return;
+        }
+        OutputAnalyzer out = run("cputime");
+        out.shouldContain("Sampling threads by CPU time");
+        out.shouldContain("max busy threads sampled in a period: ");
+
+        out = run("sigprof");
+        out.shouldContain("SIGPROF is in use, sampling threads by wall clock time");
+        out.shouldNotContain("Sampling threads by CPU time");
+    }
+
+    private static OutputAnalyzer run(String mode) throws Exception {
+        ProcessBuilder pb = ProcessTools.createJavaProcessBuilder(true,
+            "--add-exports", "java.base/jdk.internal.misc=ALL-UNNAMED",
+            "-XX:FlightRecorderOptions=cputimesampling=true",
+            "-Xlog:jfr=info",
+            TestCPUTimeSampling.class.getName(), mode);
+        OutputAnalyzer out = ProcessTools.executeProcess(pb);
+        System.out.println(out.getOutput());
+        out.shouldHaveExitValue(0);
+        return out;
+    }
+
+    private static volatile boolean done;
+    private static volatile long sink;
+
+    private static void record(boolean sigprof) throws Exception {
+        if (sigprof) {
+            // Take SIGPROF before the sampler is started
+            Signal.handle(new Signal("PROF"), s -> { });
+        }
+        CountDownLatch started = new CountDownLatch(BUSY_THREADS);
+        Thread[] threads = new Thread[BUSY_THREADS];
+        for (int i = 0; i < BUSY_THREADS; i++) {
+            threads[i] = new Thread(() -> {
+                started.countDown();
+                long sum = 0;
+                while (!done) {
+                    sum += busy(sum);
+                }
+                sink = sum;
+            }, "Busy-" + i);
+            threads[i].start();
+        }
+        started.await();
+
+        List<RecordedEvent> events;
+        try (Recording r = new Recording()) {
+            r.enable(EventNames.ExecutionSample).withPeriod(Duration.ofMillis(PERIOD_MILLIS));
+            r.start();
+            Thread.sleep(RECORDING_MILLIS);
+            r.stop();
+            events = Events.fromRecording(r);
+        } finally {
+            done = true;
+            for (Thread t : threads) {
+                t.join();
+            }
+        }
+
+        // Busy threads sampled in each period, keyed by the start of the period
+        Map<Long, Set<String>> periods = new HashMap<>();
+        Set<String> sampled = new HashSet<>();
+        for (RecordedEvent e : events) {
+            RecordedThread t = e.getThread("sampledThread");
+            if (t == null || t.getJavaName() == null || !t.getJavaName().startsWith("Busy-")) {
+                continue;
+            }
+            Instant start = e.getStartTime();
+            long period = start.toEpochMilli() / PERIOD_MILLIS;
+            periods.computeIfAbsent(period, p -> new HashSet<>()).add(t.getJavaName());
+            sampled.add(t.getJavaName());
+        }
+        int max = 0;
+        for (Set<String> names : periods.values()) {
+            max = Math.max(max, names.size());
+        }
+        System.out.println("busy threads sampled: " + sampled.size());
+        if (sampled.isEmpty()) {
+            throw new Exception("No busy threads sampled");
+        }
+        if (sigprof) {
+            // Sampling by wall clock time continues
+            return;
+        }
+        if (sampled.size() != BUSY_THREADS) {
+            throw new Exception("Only " + sampled.size() + " of " + BUSY_THREADS + " busy threads sampled");
+        }
+        // Threads can only use up a period in parallel on enough CPUs
+        if (Runtime.getRuntime().availableProcessors() > WALL_CLOCK_LIMIT && max <= WALL_CLOCK_LIMIT) {
+            throw new Exception("At most " + max + " busy threads sampled in a period, expected more than " +
+                                WALL_CLOCK_LIMIT);
+        }
+        System.out.println("max busy threads sampled in a period: " + max);
+    }
+
+    private static long busy(long seed) {
+        long x = seed;
+        for (int i = 0; i < 10_000; i++) {
+            x = x * 6364136223846793005L + 1442695040888963407L;
+        }
+        return x & 1;
+    }
+}
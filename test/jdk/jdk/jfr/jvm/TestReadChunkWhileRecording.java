@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2018, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+package jdk.jfr.jvm;
+
+import java.io.IOException;
+import java.io.RandomAccessFile;
+import java.nio.ByteBuffer;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+import java.util.List;
+import java.util.Optional;
+import java.util.stream.Stream;
+
+import jdk.jfr.Event;
+import jdk.jfr.Name;
+import jdk.jfr.Recording;
+import jdk.jfr.consumer.RecordedClass;
+import jdk.jfr.consumer.RecordedEvent;
+import jdk.jfr.consumer.RecordedFrame;
+import jdk.jfr.consumer.RecordingFile;
+
+/*
+ * @test
+ * @summary Reads the chunk in the disk repository while it is being recorded,
+ *          checking that flushed events come with their types and metadata
+ * @key jfr
+ * @requires vm.hasJFR
+ * @run main/othervm -XX:FlightRecorderOptions=repository=./repository,flushinterval=100ms
+ *                   jdk.jfr.jvm.TestReadChunkWhileRecording
+ */
+public class TestReadChunkWhileRecording {
+
+    @Name("test.Flushed")
+    static class FlushedEvent extends Event {
+        String message;
+        Class<?> clazz;
+    }
+
+    private static final long TIMEOUT_MILLIS = 60_000;
+    private static final int HEADER_SIZE = 68;
+
+    public static void main(String[] args) throws Exception {
+        try (Recording r = new Recording()) {
+            r.enable(FlushedEvent.class).withStackTrace();
+            r.start();
+            long deadline = System.currentTimeMillis() + TIMEOUT_MILLIS;
+            int attempt = 0;
+            while (System.currentTimeMillis() < deadline) {
+                FlushedEvent e = new FlushedEvent();
+                e.message = "flushed " + attempt;
+                e.clazz = TestReadChunkWhileRecording.class;
+                e.commit();
+                Thread.sleep(200);
+                if (readFlushedEvent()) {
+                    r.stop();
+                    return;
+                }
+                attempt++;
+            }
+            throw new Exception("No complete event found in the chunk being recorded");
+        }
+    }
+
+    // Copies the part of the current chunk covered by the last flushpoint
+    // and parses it as a finished chunk.
+    private static boolean readFlushedEvent() throws Exception {
+        Path chunk = currentChunk();
+        if (chunk == null) {
+            return false;
+        }
+        byte[] data;
+        try (RandomAccessFile raf = new RandomAccessFile(chunk.toFile(), "r")) {
+            byte[] header = new byte[HEADER_SIZE];
+            if (raf.length() < HEADER_SIZE) {
+                return false;
+            }
+            raf.readFully(header);
+            ByteBuffer bb = ByteBuffer.wrap(header);
+            if (bb.getInt(0) != 0x464c5200) { // "FLR\0"
+                throw new Exception("Bad magic in " + chunk);
+            }
+            long size = bb.getLong(8);
+            long constantPoolOffset = bb.getLong(16);
+            long metadataOffset = bb.getLong(24);
+            System.out.println(chunk + ": size " + size + ", constant pool " + constantPoolOffset +
+                               ", metadata " + metadataOffset);
+            if (size <= HEADER_SIZE || metadataOffset == 0) {
+                return false; // nothing flushed yet
+            }
+            if (constantPoolOffset >= size || metadataOffset >= size) {
+                return false; // the header was read while it was being updated
+            }
+            data = new byte[(int) size];
+            raf.seek(0);
+            raf.readFully(data);
+            // Restore the header that matches the size
+            System.arraycopy(header, 0, data, 0, HEADER_SIZE);
+        }
+        Path copy = Paths.get("flushed.jfr");
+        Files.write(copy, data);
+        List<RecordedEvent> events = RecordingFile.readAllEvents(copy);
+        for (RecordedEvent event : events) {
+            if (!event.getEventType().getName().equals("test.Flushed")) {
+                continue;
+            }
+            System.out.println(event);
+            String message = event.getString("message");
+            RecordedClass clazz = event.getClass("clazz");
+            if (message == null || !message.startsWith("flushed ")) {
+                throw new Exception("Flushed event without string constant: " + event);
+            }
+            if (clazz == null || !clazz.getName().equals(TestReadChunkWhileRecording.class.getName())) {
+                throw new Exception("Flushed event without class constant: " + event);
+            }
+            if (event.getStackTrace() == null) {
+                throw new Exception("Flushed event without stack trace: " + event);
+            }
+            Optional<RecordedFrame> main = event.getStackTrace().getFrames().stream()
+                .filter(f -> f.getMethod().getName().equals("main"))
+                .findFirst();
+            if (!main.isPresent()) {
+                throw new Exception("Flushed event without main() frame: " + event);
+            }
+            String holder = main.get().getMethod().getType().getName();
+            if (!holder.equals(TestReadChunkWhileRecording.class.getName())) {
+                throw new Exception("Unexpected method holder " + holder);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    private static Path currentChunk() throws IOException {
+        Path repository = Paths.get("repository");
+        if (!Files.exists(repository)) {
+            return null;
+        }
+        try (Stream<Path> files = Files.walk(repository)) {
+            return files.filter(p -> p.toString().endsWith(".jfr"))
+                        .max((a, b) -> Long.compare(a.toFile().lastModified(), b.toFile().lastModified()))
+                        .orElse(null);
+        }
+    }
+}